@@ -49,7 +49,7 @@ ly_vecode(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ctx ? pthread_getspecific(ctx->errlist_key) : NULL;
     if (i) {
         return i->prev->vecode;
     }
@@ -64,7 +64,7 @@ ly_errmsg(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ctx ? pthread_getspecific(ctx->errlist_key) : NULL;
     if (i) {
         return i->prev->msg;
     }
@@ -94,7 +94,7 @@ ly_errapptag(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ctx ? pthread_getspecific(ctx->errlist_key) : NULL;
     if (i) {
         return i->prev->apptag;
     }
@@ -111,6 +111,10 @@ ly_err_first(const struct ly_ctx *ctx)
         return NULL;
     }
 
+    if (ly_err_lazy_count) {
+        /* the caller may read any of the paths */
+        ly_err_build_lazy_paths(ctx);
+    }
     return pthread_getspecific(ctx->errlist_key);
 }
 
@@ -122,6 +126,9 @@ ly_err_free(void *ptr)
     /* clean the error list */
     for (i = (struct ly_err_item *)ptr; i; i = next) {
         next = i->next;
+        if (((struct ly_err_item_int *)i)->path_type != LY_VLOG_NONE) {
+            --ly_err_lazy_count;
+        }
         free(i->msg);
         free(i->path);
         free(i->apptag);
@@ -136,7 +143,7 @@ ly_err_clean(struct ly_ctx *ctx, struct ly_err_item *eitem)
 
     struct ly_err_item *i, *first;
 
-    first = ly_err_first(ctx);
+    first = pthread_getspecific(ctx->errlist_key);
     if (first == eitem) {
         eitem = NULL;
     }
@@ -159,6 +166,126 @@ ly_err_clean(struct ly_ctx *ctx, struct ly_err_item *eitem)
     }
 }
 
+struct ly_err_item *
+ly_err_detach(struct ly_ctx *ctx, struct ly_err_item *last)
+{
+    struct ly_err_item *first, *eitem;
+
+    ly_err_build_lazy_paths(ctx);
+
+    first = pthread_getspecific(ctx->errlist_key);
+    if (!first) {
+        return NULL;
+    }
+
+    if (!last) {
+        pthread_setspecific(ctx->errlist_key, NULL);
+        return first;
+    } else if (!last->next) {
+        return NULL;
+    }
+
+    eitem = last->next;
+    eitem->prev = first->prev;
+    first->prev = last;
+    last->next = NULL;
+    return eitem;
+}
+
+void
+ly_err_attach(struct ly_ctx *ctx, struct ly_err_item *eitem)
+{
+    struct ly_err_item *first, *last;
+
+    if (!eitem) {
+        return;
+    }
+
+    first = pthread_getspecific(ctx->errlist_key);
+    if (!first) {
+        pthread_setspecific(ctx->errlist_key, eitem);
+    } else {
+        last = eitem->prev;
+        first->prev->next = eitem;
+        eitem->prev = first->prev;
+        first->prev = last;
+    }
+
+    for (; eitem; eitem = eitem->next) {
+        if (eitem->level == LY_LLERR) {
+            ly_errno = eitem->no;
+        }
+    }
+}
+
+struct ly_parallel_pool {
+    pthread_mutex_t lock;
+    unsigned int next;
+    unsigned int count;
+    void (*task)(void *arg, unsigned int idx);
+    void *arg;
+};
+
+static void *
+ly_parallel_worker(void *arg)
+{
+    struct ly_parallel_pool *pool = arg;
+    unsigned int idx;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        idx = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if (idx >= pool->count) {
+            break;
+        }
+
+        pool->task(pool->arg, idx);
+    }
+
+    return NULL;
+}
+
+void
+ly_parallel(unsigned int count, void (*task)(void *arg, unsigned int idx), void *arg)
+{
+    struct ly_parallel_pool pool;
+    pthread_t *threads;
+    long cpus;
+    unsigned int i, started = 0;
+
+    pthread_mutex_init(&pool.lock, NULL);
+    pool.next = 0;
+    pool.count = count;
+    pool.task = task;
+    pool.arg = arg;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > count) {
+        cpus = count;
+    }
+
+    /* the calling thread is one of the workers */
+    threads = (cpus > 1) ? malloc((cpus - 1) * sizeof *threads) : NULL;
+    if (threads) {
+        for (i = 0; i < cpus - 1; ++i) {
+            if (pthread_create(&threads[started], NULL, ly_parallel_worker, &pool)) {
+                /* use the threads we have */
+                break;
+            }
+            ++started;
+        }
+    }
+
+    ly_parallel_worker(&pool);
+
+    for (i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&pool.lock);
+}
+
 const char *
 strpbrk_backwards(const char *s, const char *accept, unsigned int s_len)
 {
@@ -1382,8 +1509,8 @@ lyb_hash(struct lys_node *sibling, uint8_t collision_id)
 
     mod = lys_node_module(sibling);
 
-    full_hash = dict_hash_multi(0, mod->name, strlen(mod->name));
-    full_hash = dict_hash_multi(full_hash, sibling->name, strlen(sibling->name));
+    full_hash = dict_hash_stable_multi(0, mod->name, strlen(mod->name));
+    full_hash = dict_hash_stable_multi(full_hash, sibling->name, strlen(sibling->name));
     if (collision_id) {
         if (collision_id > strlen(mod->name)) {
             /* fine, we will not hash more bytes, just use more bits from the hash than previously */
@@ -1392,9 +1519,9 @@ lyb_hash(struct lys_node *sibling, uint8_t collision_id)
             /* use one more byte from the module name than before */
             ext_len = collision_id;
         }
-        full_hash = dict_hash_multi(full_hash, mod->name, ext_len);
+        full_hash = dict_hash_stable_multi(full_hash, mod->name, ext_len);
     }
-    full_hash = dict_hash_multi(full_hash, NULL, 0);
+    full_hash = dict_hash_stable_multi(full_hash, NULL, 0);
 
     /* use the shortened hash */
     hash = full_hash & (LYB_HASH_MASK >> collision_id);
@@ -13,6 +13,7 @@
  */
 
 #define _GNU_SOURCE
+#include <dirent.h>
 #include <pthread.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -215,11 +216,10 @@ static struct ly_ctx *
 ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT format, int options,
                      struct lyd_node* (*parser_func)(struct ly_ctx*, const char*, LYD_FORMAT, int,...))
 {
-    unsigned int i, u;
-    struct lyd_node *module, *node;
-    const char *name, *revision;
-    struct ly_set features = {0, 0, {NULL}};
-    const struct lys_module *mod;
+    unsigned int i;
+    struct lyd_node *node;
+    const char **names = NULL, **revisions = NULL;
+    const struct lys_module **mods = NULL;
     struct lyd_node *yltree = NULL;
     struct ly_ctx *ctx = NULL;
     struct ly_set *set = NULL;
@@ -248,35 +248,36 @@ ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT forma
             goto error;
         }
     } else {
+        names = malloc(set->number * sizeof *names);
+        revisions = malloc(set->number * sizeof *revisions);
+        mods = malloc(set->number * sizeof *mods);
+        LY_CHECK_ERR_GOTO(!names || !revisions || !mods, LOGMEM(ctx), error);
+
         /* process the data tree */
         for (i = 0; i < set->number; ++i) {
-            module = set->set.d[i];
-
-            /* initiate */
-            name = NULL;
-            revision = NULL;
-            ly_set_clean(&features);
-
-            LY_TREE_FOR(module->child, node) {
+            names[i] = NULL;
+            revisions[i] = NULL;
+            LY_TREE_FOR(set->set.d[i]->child, node) {
                 if (!strcmp(node->schema->name, "name")) {
-                    name = ((struct lyd_node_leaf_list*)node)->value_str;
+                    names[i] = ((struct lyd_node_leaf_list*)node)->value_str;
                 } else if (!strcmp(node->schema->name, "revision")) {
-                    revision = ((struct lyd_node_leaf_list*)node)->value_str;
-                } else if (!strcmp(node->schema->name, "feature")) {
-                    ly_set_add(&features, node, LY_SET_OPT_USEASLIST);
+                    revisions[i] = ((struct lyd_node_leaf_list*)node)->value_str;
                 }
             }
+        }
 
-            /* use the gathered data to load the module */
-            mod = ly_ctx_load_module(ctx, name, revision);
-            if (!mod) {
-                LOGERR(NULL, LY_EINVAL, "Unable to load module specified by yang library data.");
-                goto error;
-            }
+        /* use the gathered data to load the modules, their files are read in parallel */
+        if (ly_ctx_load_modules(ctx, names, revisions, set->number, 0, mods)) {
+            LOGERR(NULL, LY_EINVAL, "Unable to load module specified by yang library data.");
+            goto error;
+        }
 
-            /* set features */
-            for (u = 0; u < features.number; u++) {
-                lys_features_enable(mod, ((struct lyd_node_leaf_list*)features.set.d[u])->value_str);
+        /* set features */
+        for (i = 0; i < set->number; ++i) {
+            LY_TREE_FOR(set->set.d[i]->child, node) {
+                if (!strcmp(node->schema->name, "feature")) {
+                    lys_features_enable(mods[i], ((struct lyd_node_leaf_list*)node)->value_str);
+                }
             }
         }
     }
@@ -295,6 +296,9 @@ error:
     if (set) {
         ly_set_free(set);
     }
+    free(names);
+    free(revisions);
+    free(mods);
     if (err) {
         ly_ctx_destroy(ctx, NULL);
         ctx = NULL;
@@ -319,6 +323,599 @@ ly_ctx_new_ylmem(const char *search_dir, const char *data, LYD_FORMAT format, in
     return ly_ctx_new_yl_common(search_dir, data, format, options, lyd_parse_mem);
 }
 
+/**
+ * @brief Magic bytes of context images.
+ */
+#define LY_CTX_IMAGE_MAGIC "LYCI"
+
+/**
+ * @brief Version of the context image layout, incremented on every incompatible change.
+ */
+#define LY_CTX_IMAGE_VERSION 1
+
+/**
+ * @brief Kinds of context image entries.
+ */
+#define LY_CTX_IMAGE_INTERNAL 0     /**< internal module, only checked */
+#define LY_CTX_IMAGE_MODULE 1       /**< main module */
+#define LY_CTX_IMAGE_SUBMODULE 2    /**< submodule */
+
+/**
+ * @brief Module or submodule of a context image, all the strings point into the image.
+ */
+struct ly_ctx_image_entry {
+    uint8_t kind;                   /**< LY_CTX_IMAGE_* */
+    uint8_t implemented;
+    uint8_t disabled;
+    const char *name;
+    const char *revision;           /**< NULL if there is none */
+    const char *belongsto;          /**< name of the main module of a submodule */
+    const char *text;               /**< module text in YANG */
+    uint32_t feature_count;         /**< number of enabled features */
+    const char *features;           /**< names of the enabled features, one after another */
+};
+
+/**
+ * @brief Context image being read, also the user data of its import callback.
+ */
+struct ly_ctx_image {
+    struct ly_ctx_image_entry *entries;
+    uint32_t count;
+    uint32_t internal_count;
+};
+
+/**
+ * @brief Context image being written.
+ */
+struct ly_ctx_image_wr {
+    char *buf;
+    size_t len;
+    size_t size;
+};
+
+static int
+ly_ctx_image_write(struct ly_ctx_image_wr *wr, const void *data, size_t len)
+{
+    char *buf;
+    size_t size;
+
+    if (wr->len + len > wr->size) {
+        for (size = wr->size ? wr->size : 4096; size < wr->len + len; size *= 2);
+        buf = realloc(wr->buf, size);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM(NULL), -1);
+        wr->buf = buf;
+        wr->size = size;
+    }
+
+    memcpy(wr->buf + wr->len, data, len);
+    wr->len += len;
+    return 0;
+}
+
+static int
+ly_ctx_image_write_u32(struct ly_ctx_image_wr *wr, uint32_t val)
+{
+    return ly_ctx_image_write(wr, &val, sizeof val);
+}
+
+/* strings are stored with their length and the terminating zero byte so that they can be used in place */
+static int
+ly_ctx_image_write_str(struct ly_ctx_image_wr *wr, const char *str)
+{
+    size_t len;
+
+    len = str ? strlen(str) : 0;
+    if (len > UINT32_MAX - 1) {
+        LOGERR(NULL, LY_EINVAL, "Context image string too long.");
+        return -1;
+    }
+    if (ly_ctx_image_write_u32(wr, len) || ly_ctx_image_write(wr, str ? str : "", len + 1)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Write a module or a submodule entry into a context image.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] mod Module or submodule to write.
+ * @param[in] kind Kind of the entry (LY_CTX_IMAGE_*).
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_image_write_entry(struct ly_ctx_image_wr *wr, const struct lys_module *mod, uint8_t kind)
+{
+    const char **features = NULL;
+    uint8_t hdr[4], *states = NULL;
+    char *text = NULL;
+    uint32_t i, count = 0;
+    int ret = -1;
+
+    hdr[0] = kind;
+    hdr[1] = mod->implemented;
+    hdr[2] = mod->disabled;
+    hdr[3] = 0;
+    if (kind != LY_CTX_IMAGE_INTERNAL) {
+        /* print the module as parsed, with no deviations applied */
+        if (lys_print_mem(&text, mod, LYS_OUT_YANG, NULL, 0, 0)) {
+            goto cleanup;
+        }
+    }
+    if (kind == LY_CTX_IMAGE_MODULE) {
+        features = lys_features_list(mod, &states);
+        LY_CHECK_ERR_GOTO(!features, LOGMEM(mod->ctx), cleanup);
+        for (i = 0; features[i]; ++i) {
+            count += states[i] ? 1 : 0;
+        }
+    }
+
+    if (ly_ctx_image_write(wr, hdr, sizeof hdr) || ly_ctx_image_write_str(wr, mod->name)
+            || ly_ctx_image_write_str(wr, mod->rev_size ? mod->rev[0].date : NULL)
+            || ly_ctx_image_write_str(wr, mod->type ? ((struct lys_submodule *)mod)->belongsto->name : NULL)
+            || ly_ctx_image_write_str(wr, text) || ly_ctx_image_write_u32(wr, count)) {
+        goto cleanup;
+    }
+    for (i = 0; features && features[i]; ++i) {
+        if (states[i] && ly_ctx_image_write_str(wr, features[i])) {
+            goto cleanup;
+        }
+    }
+    ret = 0;
+
+cleanup:
+    free(text);
+    free(features);
+    free(states);
+    return ret;
+}
+
+API int
+ly_ctx_print_image_mem(const struct ly_ctx *ctx, void **image, size_t *size)
+{
+    FUN_IN;
+
+    struct ly_ctx_image_wr wr;
+    const struct lys_module *mod;
+    uint16_t hdr[2];
+    uint32_t count = 0;
+    int i, j;
+
+    if (!ctx || !image || !size) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&wr, 0, sizeof wr);
+    for (i = 0; i < ctx->models.used; ++i) {
+        count += 1 + ((i < ctx->internal_module_count) ? 0 : ctx->models.list[i]->inc_size);
+    }
+
+    hdr[0] = LY_CTX_IMAGE_VERSION;
+    hdr[1] = 0x0102;
+    if (ly_ctx_image_write(&wr, LY_CTX_IMAGE_MAGIC, 4) || ly_ctx_image_write(&wr, hdr, sizeof hdr)
+            || ly_ctx_image_write_u32(&wr, ctx->internal_module_count) || ly_ctx_image_write_u32(&wr, count)) {
+        goto error;
+    }
+
+    /* modules in the order they were added to the context, so that every module follows its imports */
+    for (i = 0; i < ctx->models.used; ++i) {
+        mod = ctx->models.list[i];
+        if (i < ctx->internal_module_count) {
+            if (ly_ctx_image_write_entry(&wr, mod, LY_CTX_IMAGE_INTERNAL)) {
+                goto error;
+            }
+            continue;
+        }
+
+        if (ly_ctx_image_write_entry(&wr, mod, LY_CTX_IMAGE_MODULE)) {
+            goto error;
+        }
+        for (j = 0; j < mod->inc_size; ++j) {
+            if (ly_ctx_image_write_entry(&wr, (struct lys_module *)mod->inc[j].submodule, LY_CTX_IMAGE_SUBMODULE)) {
+                goto error;
+            }
+        }
+    }
+
+    *image = wr.buf;
+    *size = wr.len;
+    return EXIT_SUCCESS;
+
+error:
+    free(wr.buf);
+    return EXIT_FAILURE;
+}
+
+static int
+ly_ctx_image_read_u32(const char **p, const char *end, uint32_t *val)
+{
+    if ((size_t)(end - *p) < sizeof *val) {
+        return -1;
+    }
+    memcpy(val, *p, sizeof *val);
+    *p += sizeof *val;
+    return 0;
+}
+
+static int
+ly_ctx_image_read_str(const char **p, const char *end, const char **str)
+{
+    uint32_t len;
+
+    if (ly_ctx_image_read_u32(p, end, &len) || ((size_t)(end - *p) <= len) || (*p)[len]) {
+        return -1;
+    }
+    *str = *p;
+    *p += len + 1;
+    return 0;
+}
+
+/**
+ * @brief Read the entries of a context image.
+ *
+ * @param[in] data Image.
+ * @param[in] size Size of \p data.
+ * @param[out] image Read image.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_image_read(const char *data, size_t size, struct ly_ctx_image *image)
+{
+    struct ly_ctx_image_entry *entry;
+    const char *p = data, *end = data + size, *str;
+    uint16_t hdr[2];
+    uint32_t i, j;
+
+    memset(image, 0, sizeof *image);
+    if ((size < 8) || memcmp(data, LY_CTX_IMAGE_MAGIC, 4)) {
+        goto invalid;
+    }
+    memcpy(hdr, data + 4, sizeof hdr);
+    p += 8;
+    if ((hdr[0] != LY_CTX_IMAGE_VERSION) || (hdr[1] != 0x0102)) {
+        LOGERR(NULL, LY_EINVAL, "Unsupported context image version or byte order.");
+        return -1;
+    }
+    if (ly_ctx_image_read_u32(&p, end, &image->internal_count) || ly_ctx_image_read_u32(&p, end, &image->count)
+            || (image->count > size / 21)) {
+        goto invalid;
+    }
+
+    image->entries = calloc(image->count ? image->count : 1, sizeof *image->entries);
+    LY_CHECK_ERR_RETURN(!image->entries, LOGMEM(NULL), -1);
+    for (i = 0; i < image->count; ++i) {
+        entry = &image->entries[i];
+        if ((end - p < 4) || ((uint8_t)p[0] > LY_CTX_IMAGE_SUBMODULE)) {
+            goto invalid;
+        }
+        entry->kind = p[0];
+        entry->implemented = p[1];
+        entry->disabled = p[2];
+        p += 4;
+        if (ly_ctx_image_read_str(&p, end, &entry->name) || ly_ctx_image_read_str(&p, end, &entry->revision)
+                || ly_ctx_image_read_str(&p, end, &entry->belongsto) || ly_ctx_image_read_str(&p, end, &entry->text)
+                || ly_ctx_image_read_u32(&p, end, &entry->feature_count)) {
+            goto invalid;
+        }
+        if (!entry->revision[0]) {
+            entry->revision = NULL;
+        }
+        entry->features = p;
+        for (j = 0; j < entry->feature_count; ++j) {
+            if (ly_ctx_image_read_str(&p, end, &str)) {
+                goto invalid;
+            }
+        }
+    }
+    if ((p != end) || (image->internal_count > image->count)) {
+        goto invalid;
+    }
+
+    return 0;
+
+invalid:
+    LOGERR(NULL, LY_EINVAL, "Invalid context image.");
+    free(image->entries);
+    image->entries = NULL;
+    return -1;
+}
+
+/**
+ * @brief Import callback serving modules and submodules from a context image.
+ */
+static const char *
+ly_ctx_image_imp_clb(const char *mod_name, const char *mod_rev, const char *submod_name, const char *sub_rev,
+                     void *user_data, LYS_INFORMAT *format, void (**free_module_data)(void *model_data, void *user_data))
+{
+    struct ly_ctx_image *image = user_data;
+    struct ly_ctx_image_entry *entry, *match = NULL;
+    const char *name, *rev;
+    uint32_t i;
+
+    name = submod_name ? submod_name : mod_name;
+    rev = submod_name ? sub_rev : mod_rev;
+    for (i = image->internal_count; i < image->count; ++i) {
+        entry = &image->entries[i];
+        if ((entry->kind != (submod_name ? LY_CTX_IMAGE_SUBMODULE : LY_CTX_IMAGE_MODULE)) || strcmp(entry->name, name)
+                || (submod_name && strcmp(entry->belongsto, mod_name))) {
+            continue;
+        }
+        if (rev) {
+            if (entry->revision && !strcmp(entry->revision, rev)) {
+                match = entry;
+                break;
+            }
+        } else if (!match || (entry->revision && (!match->revision || (strcmp(entry->revision, match->revision) > 0)))) {
+            /* the latest revision */
+            match = entry;
+        }
+    }
+
+    *free_module_data = NULL;
+    *format = LYS_IN_YANG;
+    return match ? match->text : NULL;
+}
+
+/**
+ * @brief Find the module of a context image entry in a context.
+ */
+static struct lys_module *
+ly_ctx_image_find(struct ly_ctx *ctx, const struct ly_ctx_image_entry *entry)
+{
+    struct lys_module *mod;
+    int i;
+
+    for (i = 0; i < ctx->models.used; ++i) {
+        mod = ctx->models.list[i];
+        if (!strcmp(mod->name, entry->name) && (mod->rev_size ? (entry->revision && !strcmp(mod->rev[0].date, entry->revision))
+                : !entry->revision)) {
+            return mod;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Load all the modules of a context image into a new context and check that the context matches the image.
+ *
+ * @param[in] ctx New context with only the internal modules.
+ * @param[in] image Read context image.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_image_load(struct ly_ctx *ctx, struct ly_ctx_image *image)
+{
+    struct ly_ctx_image_entry *entry;
+    struct lys_module *mod;
+    const char *feature;
+    uint32_t i, j, count = 0;
+
+    /* the internal modules of this build must be the same */
+    if (image->internal_count != ctx->internal_module_count) {
+        LOGERR(ctx, LY_EINVAL, "Context image internal modules do not match the context options.");
+        return -1;
+    }
+    for (i = 0; i < image->internal_count; ++i) {
+        entry = &image->entries[i];
+        if ((entry->kind != LY_CTX_IMAGE_INTERNAL) || (ly_ctx_image_find(ctx, entry) != ctx->models.list[i])) {
+            LOGERR(ctx, LY_EINVAL, "Context image internal module \"%s\" does not match.", entry->name);
+            return -1;
+        }
+    }
+
+    for (i = image->internal_count; i < image->count; ++i) {
+        entry = &image->entries[i];
+        if (entry->kind != LY_CTX_IMAGE_MODULE) {
+            continue;
+        }
+        ++count;
+        if (!ly_ctx_load_sub_module(ctx, NULL, entry->name, entry->revision, entry->implemented, NULL)) {
+            LOGERR(ctx, LY_EINVAL, "Unable to load module \"%s\" from the context image.", entry->name);
+            return -1;
+        }
+    }
+
+    /* check revisions and implemented modules and set the features and disabled modules */
+    if (ctx->models.used != (int)(ctx->internal_module_count + count)) {
+        LOGERR(ctx, LY_EINVAL, "Context image modules do not match the loaded modules.");
+        return -1;
+    }
+    for (i = image->internal_count; i < image->count; ++i) {
+        entry = &image->entries[i];
+        if (entry->kind != LY_CTX_IMAGE_MODULE) {
+            continue;
+        }
+        mod = ly_ctx_image_find(ctx, entry);
+        if (!mod || (mod->implemented != entry->implemented)) {
+            LOGERR(ctx, LY_EINVAL, "Context image module \"%s%s%s\" does not match the loaded module.", entry->name,
+                   entry->revision ? "@" : "", entry->revision ? entry->revision : "");
+            return -1;
+        }
+
+        lys_features_disable_force(mod, "*");
+        for (j = 0, feature = entry->features; j < entry->feature_count; ++j) {
+            feature += sizeof(uint32_t);
+            if (lys_features_enable_force(mod, feature)) {
+                LOGERR(ctx, LY_EINVAL, "Context image feature \"%s\" not found in module \"%s\".", feature, mod->name);
+                return -1;
+            }
+            feature += strlen(feature) + 1;
+        }
+    }
+    for (i = image->internal_count; i < image->count; ++i) {
+        entry = &image->entries[i];
+        if ((entry->kind == LY_CTX_IMAGE_MODULE) && entry->disabled) {
+            lys_set_disabled(ly_ctx_image_find(ctx, entry));
+        }
+    }
+
+    return 0;
+}
+
+API struct ly_ctx *
+ly_ctx_new_image(const char *search_dir, const void *data, size_t size, int options)
+{
+    FUN_IN;
+
+    struct ly_ctx_image image;
+    struct ly_ctx *ctx;
+    int r;
+
+    if (!data) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (ly_ctx_image_read(data, size, &image)) {
+        return NULL;
+    }
+
+    ctx = ly_ctx_new(search_dir, options);
+    if (!ctx) {
+        free(image.entries);
+        return NULL;
+    }
+
+    /* all the modules come from the image and they were already validated when the image was written */
+    ly_ctx_set_module_imp_clb(ctx, ly_ctx_image_imp_clb, &image);
+    ctx->models.flags |= LY_CTX_DISABLE_SEARCHDIRS | LY_CTX_TRUSTED;
+    ctx->models.flags &= ~LY_CTX_PREFER_SEARCHDIRS;
+
+    r = ly_ctx_image_load(ctx, &image);
+
+    ly_ctx_set_module_imp_clb(ctx, NULL, NULL);
+    ctx->models.flags = options;
+    free(image.entries);
+    if (r) {
+        ly_ctx_destroy(ctx, NULL);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+API struct ly_ctx *
+ly_ctx_new_image_path(const char *search_dir, const char *path, int options)
+{
+    FUN_IN;
+
+    struct ly_ctx *ctx;
+    struct stat sb;
+    size_t length;
+    void *addr;
+    int fd;
+
+    if (!path) {
+        LOGARG;
+        return NULL;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        LOGERR(NULL, LY_ESYS, "Opening file \"%s\" failed (%s).", path, strerror(errno));
+        return NULL;
+    }
+    if (fstat(fd, &sb) || lyp_mmap(NULL, fd, 0, &length, &addr)) {
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+    if (!addr) {
+        LOGERR(NULL, LY_EINVAL, "Empty context image file \"%s\".", path);
+        return NULL;
+    }
+
+    /* the texts of the modules are parsed right from the mapped file */
+    ctx = ly_ctx_new_image(search_dir, addr, sb.st_size, options);
+    lyp_munmap(addr, length);
+    return ctx;
+}
+
+API struct ly_ctx *
+ly_ctx_clone(const struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    struct ly_ctx *clone;
+    void *image;
+    size_t size;
+    int i;
+
+    if (!ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (ly_ctx_print_image_mem(ctx, &image, &size)) {
+        return NULL;
+    }
+    clone = ly_ctx_new_image(NULL, image, size, ctx->models.flags);
+    free(image);
+    if (!clone) {
+        return NULL;
+    }
+
+    for (i = 0; ctx->models.search_paths && ctx->models.search_paths[i]; ++i) {
+        if (ly_ctx_set_searchdir(clone, ctx->models.search_paths[i])) {
+            ly_ctx_destroy(clone, NULL);
+            return NULL;
+        }
+    }
+    clone->imp_clb = ctx->imp_clb;
+    clone->imp_clb_data = ctx->imp_clb_data;
+    clone->data_clb = ctx->data_clb;
+    clone->data_clb_data = ctx->data_clb_data;
+#ifdef LY_ENABLED_LYD_PRIV
+    clone->priv_dup_clb = ctx->priv_dup_clb;
+#endif
+
+    return clone;
+}
+
+API int
+ly_ctx_freeze(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    if (!ctx) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (lydict_freeze(&ctx->dict)) {
+        return EXIT_FAILURE;
+    }
+    ctx->frozen = 1;
+
+    return EXIT_SUCCESS;
+}
+
+API int
+ly_ctx_is_frozen(const struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    if (!ctx) {
+        LOGARG;
+        return 0;
+    }
+
+    return ctx->frozen;
+}
+
+int
+ly_ctx_check_frozen(const struct ly_ctx *ctx)
+{
+    if (ctx->frozen) {
+        LOGERR(ctx, LY_EINVAL, "Context is frozen, its schemas cannot be modified.");
+        return 1;
+    }
+
+    return 0;
+}
+
 static void
 ly_ctx_set_option(struct ly_ctx *ctx, int options)
 {
@@ -387,6 +984,38 @@ ly_ctx_unset_prefer_searchdirs(struct ly_ctx *ctx)
     ly_ctx_unset_option(ctx, LY_CTX_PREFER_SEARCHDIRS);
 }
 
+API void
+ly_ctx_set_check_searchdirs(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    ly_ctx_set_option(ctx, LY_CTX_CHECK_SEARCHDIRS);
+}
+
+API void
+ly_ctx_unset_check_searchdirs(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    ly_ctx_unset_option(ctx, LY_CTX_CHECK_SEARCHDIRS);
+}
+
+API void
+ly_ctx_set_schema_order(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    ly_ctx_set_option(ctx, LY_CTX_SCHEMA_ORDER);
+}
+
+API void
+ly_ctx_unset_schema_order(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    ly_ctx_unset_option(ctx, LY_CTX_SCHEMA_ORDER);
+}
+
 API void
 ly_ctx_set_allimplemented(struct ly_ctx *ctx)
 {
@@ -424,7 +1053,378 @@ ly_ctx_get_options(struct ly_ctx *ctx)
 {
     FUN_IN;
 
-    return ctx->models.flags;
+    return ctx->models.flags;
+}
+
+/**
+ * @brief Free a search dirs index.
+ *
+ * @param[in] index Index to free.
+ */
+static void
+ly_searchdir_index_free(struct ly_searchdir_index *index)
+{
+    uint32_t u;
+
+    if (!index) {
+        return;
+    }
+
+    for (u = 0; index->search_paths && index->search_paths[u]; ++u) {
+        free(index->search_paths[u]);
+    }
+    free(index->search_paths);
+    for (u = 0; u < index->file_count; ++u) {
+        free(index->files[u].path);
+    }
+    free(index->files);
+    free(index->keys);
+    for (u = 0; u < index->dir_count; ++u) {
+        free(index->dirs[u].path);
+    }
+    free(index->dirs);
+    free(index);
+}
+
+/**
+ * @brief Compare search dirs index keys by their name and then by the order of their files.
+ */
+static int
+ly_ctx_searchdir_key_cmp(const void *ptr1, const void *ptr2)
+{
+    const struct ly_searchdir_key *key1 = ptr1, *key2 = ptr2;
+    int ret;
+
+    ret = strncmp(key1->name, key2->name, key1->len < key2->len ? key1->len : key2->len);
+    if (ret) {
+        return ret;
+    }
+    if (key1->len != key2->len) {
+        return key1->len < key2->len ? -1 : 1;
+    }
+    return (key1->file > key2->file) - (key1->file < key2->file);
+}
+
+/**
+ * @brief Add a file to the search dirs index, with all its keys.
+ *
+ * @param[in] index Index to add to.
+ * @param[in] path Path of the file, it is taken over.
+ * @param[in] dir_len Length of the directory part of \p path.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation error.
+ */
+static int
+ly_ctx_searchdir_index_add(struct ly_searchdir_index *index, char *path, size_t dir_len)
+{
+    const char *filename = path + dir_len + 1, *ptr;
+    size_t flen;
+    void *r;
+
+    flen = strlen(filename);
+    if (!((flen > 4) && !strcmp(&filename[flen - 4], ".yin")) && !((flen > 5) && !strcmp(&filename[flen - 5], ".yang"))) {
+        /* cannot contain a (sub)module */
+        free(path);
+        return EXIT_SUCCESS;
+    }
+
+    if (!(index->file_count % 64)) {
+        r = realloc(index->files, (index->file_count + 64) * sizeof *index->files);
+        LY_CHECK_ERR_RETURN(!r, free(path); LOGMEM(NULL), EXIT_FAILURE);
+        index->files = r;
+    }
+    index->files[index->file_count].path = path;
+    index->files[index->file_count].dir_len = dir_len;
+    ++index->file_count;
+
+    for (ptr = filename + 1; *ptr; ++ptr) {
+        if ((*ptr != '.') && (*ptr != '@')) {
+            continue;
+        }
+        if (!(index->key_count % 64)) {
+            r = realloc(index->keys, (index->key_count + 64) * sizeof *index->keys);
+            LY_CHECK_ERR_RETURN(!r, LOGMEM(NULL), EXIT_FAILURE);
+            index->keys = r;
+        }
+        index->keys[index->key_count].name = filename;
+        index->keys[index->key_count].len = ptr - filename;
+        index->keys[index->key_count].file = index->file_count - 1;
+        ++index->key_count;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Build the search dirs index of a context by scanning them in the same order as lys_search_localfile().
+ *
+ * @param[in] ctx Context with the search dirs.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+ly_ctx_searchdir_index_build(struct ly_ctx *ctx)
+{
+    struct ly_searchdir_index *index;
+    struct ly_searchdir_dir *idir;
+    struct ly_set *dirs;
+    struct dirent *file;
+    struct stat st;
+    DIR *dir;
+    char *wd = NULL, *wn;
+    size_t dir_len;
+    unsigned int u;
+    int i, ret = EXIT_FAILURE;
+    void *r;
+
+    index = calloc(1, sizeof *index);
+    LY_CHECK_ERR_RETURN(!index, LOGMEM(ctx), EXIT_FAILURE);
+    dirs = ly_set_new();
+    LY_CHECK_ERR_GOTO(!dirs, LOGMEM(ctx), cleanup);
+
+    for (i = 0; ctx->models.search_paths && ctx->models.search_paths[i]; ++i);
+    index->search_paths = calloc(i + 1, sizeof *index->search_paths);
+    LY_CHECK_ERR_GOTO(!index->search_paths, LOGMEM(ctx), cleanup);
+    for (i = 0; ctx->models.search_paths && ctx->models.search_paths[i]; ++i) {
+        index->search_paths[i] = strdup(ctx->models.search_paths[i]);
+        wd = strdup(ctx->models.search_paths[i]);
+        LY_CHECK_ERR_GOTO(!index->search_paths[i] || !wd, LOGMEM(ctx), cleanup);
+        LY_CHECK_GOTO(ly_set_add(dirs, wd, LY_SET_OPT_USEASLIST) == -1, cleanup);
+    }
+    wd = NULL;
+
+    while (dirs->number) {
+        free(wd);
+        wd = (char *)dirs->set.g[--dirs->number];
+        dir_len = strlen(wd);
+
+        /* remember the directory to be able to check it for changes */
+        if (!(index->dir_count % 16)) {
+            r = realloc(index->dirs, (index->dir_count + 16) * sizeof *index->dirs);
+            LY_CHECK_ERR_GOTO(!r, LOGMEM(ctx), cleanup);
+            index->dirs = r;
+        }
+        idir = &index->dirs[index->dir_count];
+        idir->path = strdup(wd);
+        LY_CHECK_ERR_GOTO(!idir->path, LOGMEM(ctx), cleanup);
+        ++index->dir_count;
+        idir->exists = stat(wd, &st) ? 0 : 1;
+        if (idir->exists) {
+            idir->mtime = st.st_mtim;
+        }
+
+        LOGVRB("Indexing schemas in %s.", wd);
+        dir = opendir(wd);
+        if (!dir) {
+            LOGWRN(ctx, "Unable to open directory \"%s\" for searching (sub)modules (%s).", wd, strerror(errno));
+            continue;
+        }
+        while ((file = readdir(dir))) {
+            if (!strcmp(".", file->d_name) || !strcmp("..", file->d_name)) {
+                /* skip . and .. */
+                continue;
+            }
+            if (asprintf(&wn, "%s/%s", wd, file->d_name) == -1) {
+                LOGMEM(ctx);
+                closedir(dir);
+                goto cleanup;
+            }
+            if (stat(wn, &st) == -1) {
+                LOGWRN(ctx, "Unable to get information about \"%s\" file in \"%s\" when searching for (sub)modules (%s)",
+                       file->d_name, wd, strerror(errno));
+                free(wn);
+                continue;
+            }
+            if (S_ISDIR(st.st_mode)) {
+                /* subdirectory to explore */
+                if (ly_set_add(dirs, wn, LY_SET_OPT_USEASLIST) == -1) {
+                    free(wn);
+                    closedir(dir);
+                    goto cleanup;
+                }
+            } else if (!S_ISREG(st.st_mode)) {
+                /* not a regular file (note that we see the target of symlinks instead of symlinks */
+                free(wn);
+            } else if (ly_ctx_searchdir_index_add(index, wn, dir_len)) {
+                closedir(dir);
+                goto cleanup;
+            }
+        }
+        closedir(dir);
+    }
+
+    if (index->key_count) {
+        qsort(index->keys, index->key_count, sizeof *index->keys, ly_ctx_searchdir_key_cmp);
+    }
+    ly_searchdir_index_free(ctx->searchdir_index);
+    ctx->searchdir_index = index;
+    index = NULL;
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(wd);
+    if (dirs) {
+        for (u = 0; u < dirs->number; ++u) {
+            free(dirs->set.g[u]);
+        }
+        ly_set_free(dirs);
+    }
+    ly_searchdir_index_free(index);
+    return ret;
+}
+
+/**
+ * @brief Make sure the search dirs index of a context is built for its current search dirs and, with
+ * #LY_CTX_CHECK_SEARCHDIRS, that none of the indexed directories was modified since.
+ *
+ * @param[in] ctx Context with the search dirs.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+ly_ctx_searchdir_index_update(struct ly_ctx *ctx)
+{
+    struct ly_searchdir_dir *idir;
+    struct stat st;
+    uint32_t u;
+
+    if (ctx->searchdir_index) {
+        for (u = 0; ctx->models.search_paths && ctx->models.search_paths[u]; ++u) {
+            if (!ctx->searchdir_index->search_paths[u]
+                    || strcmp(ctx->searchdir_index->search_paths[u], ctx->models.search_paths[u])) {
+                break;
+            }
+        }
+        if ((ctx->models.search_paths && ctx->models.search_paths[u]) || ctx->searchdir_index->search_paths[u]) {
+            /* built for other search dirs */
+            ly_searchdir_index_free(ctx->searchdir_index);
+            ctx->searchdir_index = NULL;
+        }
+    }
+
+    if (ctx->searchdir_index && (ctx->models.flags & LY_CTX_CHECK_SEARCHDIRS)) {
+        for (u = 0; u < ctx->searchdir_index->dir_count; ++u) {
+            idir = &ctx->searchdir_index->dirs[u];
+            if (stat(idir->path, &st) ? idir->exists : (!idir->exists || (st.st_mtim.tv_sec != idir->mtime.tv_sec)
+                    || (st.st_mtim.tv_nsec != idir->mtime.tv_nsec))) {
+                /* files were added, removed or renamed */
+                ly_searchdir_index_free(ctx->searchdir_index);
+                ctx->searchdir_index = NULL;
+                break;
+            }
+        }
+    }
+
+    if (!ctx->searchdir_index) {
+        return ly_ctx_searchdir_index_build(ctx);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Search for the file of a (sub)module using the search dirs index of a context. The result is the same
+ * as of lys_search_localfile() for the search dirs (and the current working directory unless disabled).
+ *
+ * The index must be updated by ly_ctx_searchdir_index_update() first, the function itself does not modify
+ * the context so it can be used by several threads.
+ *
+ * @param[in] ctx Context with the search dirs.
+ * @param[in] name Name of the (sub)module.
+ * @param[in] revision Revision of the (sub)module, NULL for the newest one.
+ * @param[out] localfile Path of the file found, NULL if there is none.
+ * @param[out] format Format of the file found.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+ly_ctx_search_localfile(const struct ly_ctx *ctx, const char *name, const char *revision, char **localfile,
+                        LYS_INFORMAT *format)
+{
+    const struct ly_searchdir_index *index = ctx->searchdir_index;
+    struct ly_searchdir_key key;
+    struct lys_search_match match = {name, 0, revision, NULL, 0, 0};
+    struct dirent *file;
+    struct stat st;
+    DIR *dir;
+    char *wd = NULL, *wn;
+    uint32_t lo, hi, mid;
+    int i, ret = EXIT_FAILURE, cwd = !(ctx->models.flags & LY_CTX_DISABLE_SEARCHDIR_CWD);
+
+    if (cwd) {
+        wd = get_current_dir_name();
+        LY_CHECK_ERR_RETURN(!wd, LOGMEM(ctx), EXIT_FAILURE);
+        for (i = 0; ctx->models.search_paths && ctx->models.search_paths[i]; ++i) {
+            if (!strcmp(wd, ctx->models.search_paths[i])) {
+                /* the working directory is searched recursively then, not worth handling here */
+                index = NULL;
+                break;
+            }
+        }
+    }
+    if (!index) {
+        free(wd);
+        return lys_search_localfile(ly_ctx_get_searchdirs(ctx), cwd, name, revision, localfile, format);
+    }
+
+    /* find the first file with the name */
+    match.len = strlen(name);
+    key.name = name;
+    key.len = match.len;
+    key.file = 0;
+    lo = 0;
+    hi = index->key_count;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (ly_ctx_searchdir_key_cmp(&index->keys[mid], &key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    /* the search dirs */
+    for (; (lo < index->key_count) && (index->keys[lo].len == key.len) && !strncmp(index->keys[lo].name, name, key.len); ++lo) {
+        wn = strdup(index->files[index->keys[lo].file].path);
+        LY_CHECK_ERR_GOTO(!wn, LOGMEM(ctx), cleanup);
+        if (lys_search_match_file(&match, &wn, index->files[index->keys[lo].file].dir_len)) {
+            goto success;
+        }
+        free(wn);
+    }
+
+    /* the current working directory, it is searched last and not recursively */
+    if (cwd) {
+        dir = opendir(wd);
+        if (!dir) {
+            LOGWRN(ctx, "Unable to open directory \"%s\" for searching (sub)modules (%s).", wd, strerror(errno));
+        } else {
+            while ((file = readdir(dir))) {
+                if (strncmp(name, file->d_name, match.len) || ((file->d_name[match.len] != '.') && (file->d_name[match.len] != '@'))) {
+                    continue;
+                }
+                if (asprintf(&wn, "%s/%s", wd, file->d_name) == -1) {
+                    LOGMEM(ctx);
+                    closedir(dir);
+                    goto cleanup;
+                }
+                if (!stat(wn, &st) && S_ISREG(st.st_mode) && lys_search_match_file(&match, &wn, strlen(wd))) {
+                    closedir(dir);
+                    goto success;
+                }
+                free(wn);
+            }
+            closedir(dir);
+        }
+    }
+
+success:
+    *localfile = match.match_name;
+    match.match_name = NULL;
+    if (format) {
+        *format = match.match_format;
+    }
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(match.match_name);
+    free(wd);
+    return ret;
 }
 
 API int
@@ -471,6 +1471,10 @@ ly_ctx_set_searchdir(struct ly_ctx *ctx, const char *search_dir)
         new_dir = NULL;
         ctx->models.search_paths[index + 1] = NULL;
 
+        /* the new directory is not indexed */
+        ly_searchdir_index_free(ctx->searchdir_index);
+        ctx->searchdir_index = NULL;
+
 success:
         rc = EXIT_SUCCESS;
     } else {
@@ -506,6 +1510,10 @@ ly_ctx_unset_searchdirs(struct ly_ctx *ctx, int index)
         return;
     }
 
+    /* the index covers all the search dirs */
+    ly_searchdir_index_free(ctx->searchdir_index);
+    ctx->searchdir_index = NULL;
+
     for (i = 0; ctx->models.search_paths[i]; i++) {
         if (index < 0 || index == i) {
             free(ctx->models.search_paths[i]);
@@ -545,7 +1553,10 @@ ly_ctx_destroy(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_n
         }
         free(ctx->models.search_paths);
     }
+    ly_searchdir_index_free(ctx->searchdir_index);
     free(ctx->models.list);
+    /* emptied when the identities were freed */
+    lyht_free(ctx->ident_index);
 
     /* clean the error list */
     ly_err_clean(ctx, 0);
@@ -847,6 +1858,480 @@ ly_ctx_set_priv_dup_clb(struct ly_ctx *ctx, void *(*priv_dup_clb)(const void *pr
 
 #endif
 
+/**
+ * @brief Find a file found in the search dirs among the read-ahead files. Only used after all the threads finished.
+ *
+ * @param[in] prefetch Read-ahead files.
+ * @param[in] name Name of the (sub)module.
+ * @param[in] revision Revision of the (sub)module, NULL for the newest one.
+ * @return Matching file, NULL if it was not requested or not found (then it is searched for in the standard way).
+ */
+static struct ly_prefetch_file *
+ly_ctx_prefetch_find(struct ly_prefetch *prefetch, const char *name, const char *revision)
+{
+    uint32_t u;
+
+    for (u = 0; u < prefetch->count; ++u) {
+        if (prefetch->files[u].filepath && !strcmp(prefetch->files[u].name, name) && (revision ? prefetch->files[u].revision
+                && !strcmp(prefetch->files[u].revision, revision) : !prefetch->files[u].revision)) {
+            return &prefetch->files[u];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Request a file to be read ahead unless it was already requested, the caller must hold the lock
+ * while the threads are running.
+ *
+ * @param[in] prefetch Read-ahead files.
+ * @param[in] name Name of the (sub)module.
+ * @param[in] name_len Length of \p name.
+ * @param[in] revision Revision of the (sub)module, NULL for the newest one.
+ * @param[in] rev_len Length of \p revision.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation error.
+ */
+static int
+ly_ctx_prefetch_add(struct ly_prefetch *prefetch, const char *name, size_t name_len, const char *revision, size_t rev_len)
+{
+    struct ly_prefetch_file *file;
+    uint32_t u;
+
+    for (u = 0; u < prefetch->count; ++u) {
+        file = &prefetch->files[u];
+        if (!strncmp(file->name, name, name_len) && !file->name[name_len] && (revision ? file->revision
+                && !strncmp(file->revision, revision, rev_len) && !file->revision[rev_len] : !file->revision)) {
+            return EXIT_SUCCESS;
+        }
+    }
+
+    if (prefetch->count == prefetch->size) {
+        file = realloc(prefetch->files, (prefetch->size ? prefetch->size * 2 : 16) * sizeof *file);
+        LY_CHECK_ERR_RETURN(!file, LOGMEM(NULL), EXIT_FAILURE);
+        prefetch->files = file;
+        prefetch->size = prefetch->size ? prefetch->size * 2 : 16;
+    }
+
+    file = &prefetch->files[prefetch->count];
+    memset(file, 0, sizeof *file);
+    file->name = strndup(name, name_len);
+    LY_CHECK_ERR_RETURN(!file->name, LOGMEM(NULL), EXIT_FAILURE);
+    if (revision) {
+        file->revision = strndup(revision, rev_len);
+        LY_CHECK_ERR_RETURN(!file->revision, free(file->name); LOGMEM(NULL), EXIT_FAILURE);
+    }
+    ++prefetch->count;
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Get the next token of a YANG text, good enough to find import and include statements.
+ *
+ * @param[in] data Text to read.
+ * @param[out] token Start of the token (without quotes), NULL at the end of the text.
+ * @param[out] len Length of the token.
+ * @return Text following the token.
+ */
+static const char *
+ly_ctx_prefetch_yang_token(const char *data, const char **token, size_t *len)
+{
+    const char *end;
+
+    while (1) {
+        data += strspn(data, " \t\r\n");
+        if ((data[0] == '/') && (data[1] == '/')) {
+            data += strcspn(data, "\n");
+        } else if ((data[0] == '/') && (data[1] == '*')) {
+            end = strstr(data + 2, "*/");
+            data = end ? end + 2 : data + strlen(data);
+        } else {
+            break;
+        }
+    }
+
+    if (!data[0]) {
+        *token = NULL;
+        return data;
+    }
+
+    if ((data[0] == '"') || (data[0] == '\'')) {
+        for (end = data + 1; *end && (*end != data[0]); ++end) {
+            if ((data[0] == '"') && (*end == '\\') && end[1]) {
+                ++end;
+            }
+        }
+        *token = data + 1;
+        *len = end - *token;
+        return *end ? end + 1 : end;
+    }
+
+    if (strchr(";{}", data[0])) {
+        *len = 1;
+    } else {
+        *len = strcspn(data, " \t\r\n;{}\"'");
+    }
+    *token = data;
+    return data + *len;
+}
+
+/**
+ * @brief Request the modules imported and the submodules included by a YANG text.
+ *
+ * @param[in] prefetch Read-ahead files, the caller holds their lock.
+ * @param[in] data YANG text.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation error.
+ */
+static int
+ly_ctx_prefetch_yang_deps(struct ly_prefetch *prefetch, const char *data)
+{
+    const char *token, *name, *rev;
+    size_t len, name_len, rev_len = 0;
+    int stmt_start = 1, depth;
+
+    while ((data = ly_ctx_prefetch_yang_token(data, &token, &len)) && token) {
+        if (!stmt_start || (((len != 6) || strncmp(token, "import", 6)) && ((len != 7) || strncmp(token, "include", 7)))) {
+            stmt_start = (len == 1) && strchr(";{}", token[0]);
+            continue;
+        }
+
+        data = ly_ctx_prefetch_yang_token(data, &name, &name_len);
+        if (!name) {
+            break;
+        }
+
+        /* look for the revision-date substatement */
+        rev = NULL;
+        data = ly_ctx_prefetch_yang_token(data, &token, &len);
+        if (token && (token[0] == '{')) {
+            depth = 1;
+            stmt_start = 1;
+            while (depth && (data = ly_ctx_prefetch_yang_token(data, &token, &len)) && token) {
+                if (stmt_start && (depth == 1) && (len == 13) && !strncmp(token, "revision-date", 13)) {
+                    data = ly_ctx_prefetch_yang_token(data, &rev, &rev_len);
+                    if (!rev) {
+                        break;
+                    }
+                    token = rev;
+                    len = rev_len;
+                } else if (token[0] == '{') {
+                    ++depth;
+                } else if (token[0] == '}') {
+                    --depth;
+                }
+                stmt_start = (len == 1) && strchr(";{}", token[0]);
+            }
+        }
+        stmt_start = 1;
+
+        if (ly_ctx_prefetch_add(prefetch, name, name_len, rev, rev_len)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Get the value of an attribute of a YIN element.
+ *
+ * @param[in] elem Element start.
+ * @param[in] elem_end End of the element start tag.
+ * @param[in] attr Attribute name including the equal sign.
+ * @param[out] len Length of the value.
+ * @return Start of the value, NULL if not found.
+ */
+static const char *
+ly_ctx_prefetch_yin_attr(const char *elem, const char *elem_end, const char *attr, size_t *len)
+{
+    const char *value, *end;
+
+    value = strstr(elem, attr);
+    if (!value || (value >= elem_end) || ((value[strlen(attr)] != '"') && (value[strlen(attr)] != '\''))) {
+        return NULL;
+    }
+    value += strlen(attr);
+    end = strchr(value + 1, value[0]);
+    if (!end || (end > elem_end)) {
+        return NULL;
+    }
+
+    *len = end - (value + 1);
+    return value + 1;
+}
+
+/**
+ * @brief Request the modules imported and the submodules included by a YIN text.
+ *
+ * @param[in] prefetch Read-ahead files, the caller holds their lock.
+ * @param[in] data YIN text.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation error.
+ */
+static int
+ly_ctx_prefetch_yin_deps(struct ly_prefetch *prefetch, const char *data)
+{
+    const char *elem, *elem_end, *name, *rev, *close;
+    size_t name_len, rev_len = 0;
+
+    while ((elem = strchr(data, '<'))) {
+        data = elem + 1;
+        if (strncmp(data, "import", 6) && strncmp(data, "include", 7)) {
+            continue;
+        }
+        close = (data[2] == 'p') ? "</import" : "</include";
+        data += (data[2] == 'p') ? 6 : 7;
+        if (!strchr(" \t\r\n", data[0]) || !(elem_end = strchr(data, '>'))) {
+            continue;
+        }
+
+        name = ly_ctx_prefetch_yin_attr(data, elem_end, "module=", &name_len);
+        if (!name) {
+            continue;
+        }
+
+        /* look for the revision-date substatement */
+        rev = NULL;
+        if (elem_end[-1] != '/') {
+            data = elem_end;
+            close = strstr(data, close);
+            elem = strstr(data, "<revision-date");
+            if (close && elem && (elem < close) && (elem_end = strchr(elem, '>'))) {
+                rev = ly_ctx_prefetch_yin_attr(elem, elem_end, "date=", &rev_len);
+            }
+        }
+
+        if (ly_ctx_prefetch_add(prefetch, name, name_len, rev, rev_len)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Read the whole file into memory terminated by 2 zero bytes as the YANG parser needs.
+ *
+ * @param[in] path File to read.
+ * @return File content, NULL on error.
+ */
+static char *
+ly_ctx_prefetch_read(const char *path)
+{
+    int fd;
+    struct stat st;
+    char *data = NULL;
+    ssize_t r;
+    size_t done = 0;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) || !st.st_size) {
+        goto cleanup;
+    }
+
+    data = malloc(st.st_size + 2);
+    if (!data) {
+        goto cleanup;
+    }
+    while (done < (size_t)st.st_size) {
+        r = read(fd, data + done, st.st_size - done);
+        if (r <= 0) {
+            if ((r < 0) && (errno == EINTR)) {
+                continue;
+            }
+            free(data);
+            data = NULL;
+            goto cleanup;
+        }
+        done += r;
+    }
+    data[done] = data[done + 1] = '\0';
+
+cleanup:
+    close(fd);
+    return data;
+}
+
+/**
+ * @brief Arguments of the read-ahead threads.
+ */
+struct ly_prefetch_arg {
+    struct ly_ctx *ctx;
+    struct ly_prefetch *prefetch;
+};
+
+/**
+ * @brief Read-ahead thread, searches for the requested files, reads them and requests their imports
+ * and includes until there is no more work for any thread.
+ *
+ * @param[in] arg Thread arguments (struct ly_prefetch_arg).
+ * @return NULL
+ */
+static void *
+ly_ctx_prefetch_thread(void *arg)
+{
+    struct ly_ctx *ctx = ((struct ly_prefetch_arg *)arg)->ctx;
+    struct ly_prefetch *prefetch = ((struct ly_prefetch_arg *)arg)->prefetch;
+    const char *name, *revision;
+    char *filepath, *data;
+    LYS_INFORMAT format;
+    uint32_t idx;
+
+    pthread_mutex_lock(&prefetch->lock);
+    while (1) {
+        while ((prefetch->next == prefetch->count) && prefetch->busy) {
+            pthread_cond_wait(&prefetch->cond, &prefetch->lock);
+        }
+        if (prefetch->next == prefetch->count) {
+            /* no more work and nobody to create it */
+            break;
+        }
+
+        /* the strings are never reallocated, only the array */
+        idx = prefetch->next++;
+        name = prefetch->files[idx].name;
+        revision = prefetch->files[idx].revision;
+        ++prefetch->busy;
+        pthread_mutex_unlock(&prefetch->lock);
+
+        /* the context is not modified while the threads are running, modules already in it are not
+         * searched for and neither are their imports */
+        filepath = data = NULL;
+        format = LYS_IN_UNKNOWN;
+        if (!ly_ctx_get_module_by(ctx, name, 0, offsetof(struct lys_module, name), revision, 1, 0)
+                && !ly_ctx_search_localfile(ctx, name, revision, &filepath, &format) && filepath) {
+            data = ly_ctx_prefetch_read(filepath);
+        }
+
+        pthread_mutex_lock(&prefetch->lock);
+        --prefetch->busy;
+        prefetch->files[idx].filepath = filepath;
+        prefetch->files[idx].format = format;
+        prefetch->files[idx].data = data;
+        if (data) {
+            /* a failure here only means that fewer files are read ahead */
+            if (format == LYS_IN_YANG) {
+                ly_ctx_prefetch_yang_deps(prefetch, data);
+            } else {
+                ly_ctx_prefetch_yin_deps(prefetch, data);
+            }
+        }
+        pthread_cond_broadcast(&prefetch->cond);
+    }
+    pthread_cond_broadcast(&prefetch->cond);
+    pthread_mutex_unlock(&prefetch->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Free the read-ahead files of a context.
+ *
+ * @param[in] ctx Context with the read-ahead files.
+ */
+static void
+ly_ctx_prefetch_free(struct ly_ctx *ctx)
+{
+    uint32_t u;
+
+    if (!ctx->prefetch) {
+        return;
+    }
+
+    for (u = 0; u < ctx->prefetch->count; ++u) {
+        free(ctx->prefetch->files[u].name);
+        free(ctx->prefetch->files[u].revision);
+        free(ctx->prefetch->files[u].filepath);
+        free(ctx->prefetch->files[u].data);
+    }
+    free(ctx->prefetch->files);
+    pthread_cond_destroy(&ctx->prefetch->cond);
+    pthread_mutex_destroy(&ctx->prefetch->lock);
+    free(ctx->prefetch);
+    ctx->prefetch = NULL;
+}
+
+/**
+ * @brief Search for the files of modules, their imports and includes in the search dirs and read them
+ * using several threads. The files are then used by ly_ctx_load_localfile() instead of searching for them
+ * again until ly_ctx_prefetch_free() is called. Nothing is done if the search dirs are disabled.
+ *
+ * @param[in] ctx Context to use, it must not be modified while this function runs.
+ * @param[in] names Names of the modules.
+ * @param[in] revisions Revisions of the modules, NULL or empty string for the newest one. Can be NULL.
+ * @param[in] count Number of modules.
+ * @param[in] threads Number of threads to use, 0 for the number of online processors.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+ly_ctx_prefetch(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count, unsigned int threads)
+{
+    struct ly_prefetch *prefetch;
+    struct ly_prefetch_arg arg;
+    pthread_t *tids;
+    const char *rev;
+    unsigned int u, started;
+    long cpus;
+
+    if (ctx->prefetch || (ctx->models.flags & LY_CTX_DISABLE_SEARCHDIRS) || !count) {
+        return EXIT_SUCCESS;
+    }
+
+    if (!threads) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? cpus : 1;
+    }
+    if (threads > LY_PREFETCH_MAX_THREADS) {
+        threads = LY_PREFETCH_MAX_THREADS;
+    }
+
+    /* the threads only read the index */
+    if (ly_ctx_searchdir_index_update(ctx)) {
+        return EXIT_FAILURE;
+    }
+
+    prefetch = calloc(1, sizeof *prefetch);
+    LY_CHECK_ERR_RETURN(!prefetch, LOGMEM(ctx), EXIT_FAILURE);
+    pthread_mutex_init(&prefetch->lock, NULL);
+    pthread_cond_init(&prefetch->cond, NULL);
+    ctx->prefetch = prefetch;
+
+    for (u = 0; u < count; ++u) {
+        if (!names[u]) {
+            continue;
+        }
+        rev = (revisions && revisions[u] && revisions[u][0]) ? revisions[u] : NULL;
+        if (ly_ctx_prefetch_add(prefetch, names[u], strlen(names[u]), rev, rev ? strlen(rev) : 0)) {
+            ly_ctx_prefetch_free(ctx);
+            return EXIT_FAILURE;
+        }
+    }
+
+    tids = malloc(threads * sizeof *tids);
+    LY_CHECK_ERR_RETURN(!tids, LOGMEM(ctx); ly_ctx_prefetch_free(ctx), EXIT_FAILURE);
+
+    arg.ctx = ctx;
+    arg.prefetch = prefetch;
+    for (started = 0; started < threads; ++started) {
+        if (pthread_create(&tids[started], NULL, ly_ctx_prefetch_thread, &arg)) {
+            break;
+        }
+    }
+    if (!started) {
+        /* read the files ourselves */
+        ly_ctx_prefetch_thread(&arg);
+    }
+    for (u = 0; u < started; ++u) {
+        pthread_join(tids[u], NULL);
+    }
+    free(tids);
+
+    return EXIT_SUCCESS;
+}
+
 /* if module is !NULL, then the function searches for submodule */
 static struct lys_module *
 ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char *name, const char *revision,
@@ -857,9 +2342,17 @@ ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char
     char *filepath = NULL, *dot, *rev, *filename;
     LYS_INFORMAT format;
     struct lys_module *result = NULL;
+    struct ly_prefetch_file *prefetched = NULL;
 
-    if (lys_search_localfile(ly_ctx_get_searchdirs(ctx), !(ctx->models.flags & LY_CTX_DISABLE_SEARCHDIR_CWD), name, revision,
-                             &filepath, &format)) {
+    if (ctx->prefetch) {
+        /* the file was already found and read */
+        prefetched = ly_ctx_prefetch_find(ctx->prefetch, name, revision);
+    }
+    if (prefetched) {
+        filepath = strdup(prefetched->filepath);
+        LY_CHECK_ERR_RETURN(!filepath, LOGMEM(ctx), NULL);
+        format = prefetched->format;
+    } else if (ly_ctx_searchdir_index_update(ctx) || ly_ctx_search_localfile(ctx, name, revision, &filepath, &format)) {
         goto cleanup;
     } else if (!filepath) {
         if (!module && !revision) {
@@ -902,20 +2395,28 @@ ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char
     /* add the format back */
     dot[1] = 'y';
 
-    /* open the file */
-    fd = open(filepath, O_RDONLY);
-    if (fd < 0) {
-        LOGERR(ctx, LY_ESYS, "Unable to open data model file \"%s\" (%s).",
-               filepath, strerror(errno));
-        goto cleanup;
-    }
-
-    if (module) {
-        result = (struct lys_module *)lys_sub_parse_fd(module, fd, format, unres);
+    if (prefetched && prefetched->data) {
+        if (module) {
+            result = (struct lys_module *)lys_sub_parse_mem(module, prefetched->data, format, unres);
+        } else {
+            result = (struct lys_module *)lys_parse_mem_(ctx, prefetched->data, format, revision, 1, implement);
+        }
     } else {
-        result = (struct lys_module *)lys_parse_fd_(ctx, fd, format, revision, implement);
+        /* open the file */
+        fd = open(filepath, O_RDONLY);
+        if (fd < 0) {
+            LOGERR(ctx, LY_ESYS, "Unable to open data model file \"%s\" (%s).",
+                   filepath, strerror(errno));
+            goto cleanup;
+        }
+
+        if (module) {
+            result = (struct lys_module *)lys_sub_parse_fd(module, fd, format, unres);
+        } else {
+            result = (struct lys_module *)lys_parse_fd_(ctx, fd, format, revision, implement);
+        }
+        close(fd);
     }
-    close(fd);
 
     if (!result) {
         goto cleanup;
@@ -1047,6 +2548,15 @@ ly_ctx_load_sub_module(struct ly_ctx *ctx, struct lys_module *module, const char
         }
     }
 
+    if (ctx->frozen) {
+        /* no schema can be added, the latest one found is the latest available */
+        if (latest_mod && (!implement || latest_mod->implemented)) {
+            return latest_mod;
+        }
+        ly_ctx_check_frozen(ctx);
+        return NULL;
+    }
+
     /* module is not yet in context, use the user callback or try to find the schema on our own */
     if (ctx->imp_clb && !(ctx->models.flags & LY_CTX_PREFER_SEARCHDIRS)) {
 search_clb:
@@ -1102,6 +2612,51 @@ ly_ctx_load_module(struct ly_ctx *ctx, const char *name, const char *revision)
     return ly_ctx_load_sub_module(ctx, NULL, name, revision && revision[0] ? revision : NULL, 1, NULL);
 }
 
+API int
+ly_ctx_load_modules(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count,
+                    unsigned int threads, const struct lys_module **modules)
+{
+    FUN_IN;
+
+    const struct lys_module *mod;
+    unsigned int u;
+    int ret = EXIT_SUCCESS;
+
+    if (!ctx || (count && !names)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+    for (u = 0; u < count; ++u) {
+        if (!names[u]) {
+            LOGARG;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (ly_ctx_prefetch(ctx, names, revisions, count, threads)) {
+        return EXIT_FAILURE;
+    }
+
+    /* parse and link the modules in order, the imports are loaded before the modules importing them */
+    for (u = 0; u < count; ++u) {
+        mod = ly_ctx_load_sub_module(ctx, NULL, names[u], revisions && revisions[u] && revisions[u][0] ? revisions[u] : NULL,
+                                     1, NULL);
+        if (modules) {
+            modules[u] = mod;
+        }
+        if (!mod) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+    }
+    for (++u; modules && (u < count); ++u) {
+        modules[u] = NULL;
+    }
+
+    ly_ctx_prefetch_free(ctx);
+    return ret;
+}
+
 /*
  * mods - set of removed modules, if NULL all modules are supposed to be removed so any backlink is invalid
  */
@@ -1215,6 +2770,9 @@ lys_set_disabled(const struct lys_module *module)
     }
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
+    if (ly_ctx_check_frozen(ctx)) {
+        return EXIT_FAILURE;
+    }
 
     /* avoid disabling internal modules */
     for (i = 0; i < ctx->internal_module_count; i++) {
@@ -1361,6 +2919,9 @@ lys_set_enabled(const struct lys_module *module)
     }
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
+    if (ly_ctx_check_frozen(ctx)) {
+        return EXIT_FAILURE;
+    }
 
     /* avoid disabling internal modules */
     for (i = 0; i < ctx->internal_module_count; i++) {
@@ -1467,6 +3028,9 @@ ly_ctx_remove_module(const struct lys_module *module,
 
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
+    if (ly_ctx_check_frozen(ctx)) {
+        return EXIT_FAILURE;
+    }
 
     /* avoid removing internal modules ... */
     for (i = 0; i < ctx->internal_module_count; i++) {
@@ -1581,7 +3145,7 @@ ly_ctx_clean(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_nod
 {
     FUN_IN;
 
-    if (!ctx) {
+    if (!ctx || ly_ctx_check_frozen(ctx)) {
         return;
     }
 
@@ -16,6 +16,7 @@
 #define LY_CONTEXT_H_
 
 #include <pthread.h>
+#include <time.h>
 
 #include "libyang.h"
 #include "common.h"
@@ -37,6 +38,75 @@ struct ly_modules_list {
     int flags; /* see @ref contextoptions. */
 };
 
+/**
+ * @brief File in the search dirs that can contain a (sub)module.
+ */
+struct ly_searchdir_file {
+    char *path;
+    size_t dir_len;             /**< length of the directory part of path */
+};
+
+/**
+ * @brief Key of a file in the search dirs index, the file name up to a '.' or '@' (a (sub)module name
+ * the file can contain). A file has a key for each such prefix of its name.
+ */
+struct ly_searchdir_key {
+    const char *name;           /**< points into the file path */
+    size_t len;
+    uint32_t file;              /**< index of the file, files are kept in the order they are searched in */
+};
+
+/**
+ * @brief Directory indexed in the search dirs index.
+ */
+struct ly_searchdir_dir {
+    char *path;
+    int exists;                 /**< whether the directory could be stat'ed, mtime is valid only then */
+    struct timespec mtime;
+};
+
+/**
+ * @brief Index of the files in all the search dirs (recursively), replaces their scanning by lys_search_localfile().
+ */
+struct ly_searchdir_index {
+    char **search_paths;        /**< copy of the search dirs the index was built for, NULL-terminated */
+    struct ly_searchdir_file *files;
+    uint32_t file_count;
+    struct ly_searchdir_key *keys;  /**< sorted by name, files of the same name in the search order */
+    uint32_t key_count;
+    struct ly_searchdir_dir *dirs;
+    uint32_t dir_count;
+};
+
+/**
+ * @brief Maximum number of threads reading schema files ahead.
+ */
+#define LY_PREFETCH_MAX_THREADS 64
+
+/**
+ * @brief Schema file found and read ahead of parsing it, see ly_ctx_load_modules().
+ */
+struct ly_prefetch_file {
+    char *name;                 /**< name of the (sub)module as requested */
+    char *revision;             /**< requested revision, NULL for the newest one */
+    char *filepath;             /**< file found by lys_search_localfile(), NULL if there is none */
+    LYS_INFORMAT format;
+    char *data;                 /**< file content terminated by 2 zero bytes, NULL if it could not be read */
+};
+
+/**
+ * @brief Schema files being read ahead by a pool of threads, the list serves also as their work queue.
+ */
+struct ly_prefetch {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct ly_prefetch_file *files;
+    uint32_t count;             /**< number of requested files */
+    uint32_t size;              /**< allocated size of files */
+    uint32_t next;              /**< index of the next file to search for */
+    uint32_t busy;              /**< number of threads currently processing a file */
+};
+
 struct ly_ctx {
     struct dict_table dict;
     struct ly_modules_list models;
@@ -49,6 +119,19 @@ struct ly_ctx {
 #endif
     pthread_key_t errlist_key;
     uint8_t internal_module_count;
+    struct ly_prefetch *prefetch;   /**< files read ahead while loading a set of modules, NULL otherwise */
+    struct ly_searchdir_index *searchdir_index; /**< index of the search dirs, NULL until needed */
+    uint8_t frozen;                 /**< set by ly_ctx_freeze(), the schemas cannot be modified */
+    struct hash_table *ident_index; /**< all the (transitive) bases of the identities of the modules in the context,
+                                         see resolve_identity_index(), NULL until needed */
 };
 
+/**
+ * @brief Check that the schemas of a context can be modified, that is it was not frozen by ly_ctx_freeze().
+ *
+ * @param[in] ctx Context to check.
+ * @return 0 if the schemas can be modified, non-zero if the context is frozen (an error is logged).
+ */
+int ly_ctx_check_frozen(const struct ly_ctx *ctx);
+
 #endif /* LY_CONTEXT_H_ */
@@ -17,11 +17,16 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <assert.h>
+#include <sys/mman.h>
 
 #include "common.h"
 #include "context.h"
 #include "hash_table.h"
 
+#if defined(LY_ENABLED_HT_GROUPS) && defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
 static int
 lydict_val_eq(void *val1_p, void *val2_p, int UNUSED(mod), void *cb_data)
 {
@@ -55,6 +60,8 @@ lydict_init(struct dict_table *dict)
 
     dict->hash_tab = lyht_new(1024, sizeof(struct dict_rec), lydict_val_eq, NULL, 1);
     LY_CHECK_ERR_RETURN(!dict->hash_tab, LOGINT(NULL), );
+    /* inserting a string must never stall on moving all the others */
+    lyht_set_incremental(dict->hash_tab, 1);
     pthread_mutex_init(&dict->lock, NULL);
 }
 
@@ -63,23 +70,23 @@ lydict_clean(struct dict_table *dict)
 {
     unsigned int i;
     struct dict_rec *dict_rec  = NULL;
-    struct ht_rec *rec = NULL;
+    struct dict_pin *pin;
 
     if (!dict) {
         LOGARG;
         return;
     }
 
+    lyht_finish_resize(dict->hash_tab);
     for (i = 0; i < dict->hash_tab->size; i++) {
-        /* get ith record */
-        rec = (struct ht_rec *)&dict->hash_tab->recs[i * dict->hash_tab->rec_size];
-        if (rec->hits == 1) {
+        /* get ith value */
+        dict_rec = lyht_get_val(dict->hash_tab, i);
+        if (dict_rec) {
             /*
              * this should not happen, all records inserted into
              * dictionary are supposed to be removed using lydict_remove()
              * before calling lydict_clean()
              */
-            dict_rec  = (struct dict_rec *)rec->val;
             LOGWRN(NULL, "String \"%s\" not freed from the dictionary, refcount %d", dict_rec->value, dict_rec->refcount);
             /* if record wasn't removed before free string allocated for that record */
 #ifdef NDEBUG
@@ -88,11 +95,99 @@ lydict_clean(struct dict_table *dict)
         }
     }
 
+    /* values referencing the pinned buffers are supposed to be freed as well */
+    while (dict->pins) {
+        LOGWRN(NULL, "Pinned input buffer not released, refcount %" PRId64, dict->pins->refcount);
+        pin = dict->pins;
+        dict->pins = pin->next;
+        munmap(pin->addr, pin->length);
+        free(pin);
+    }
+
+    /* the frozen strings are not reference counted, they are all freed now */
+    if (dict->frozen_tab) {
+        for (i = 0; i < dict->frozen_tab->size; i++) {
+            dict_rec = lyht_get_val(dict->frozen_tab, i);
+            if (dict_rec) {
+                free(dict_rec->value);
+            }
+        }
+        lyht_free(dict->frozen_tab);
+    }
+
     /* free table and destroy mutex */
     lyht_free(dict->hash_tab);
     pthread_mutex_destroy(&dict->lock);
 }
 
+/**
+ * @brief Searched string of a frozen dictionary, also the cb_data of its table are never set so that
+ * the table is only read.
+ */
+struct dict_frozen_key {
+    const char *value;
+    size_t len;
+};
+
+static int
+lydict_frozen_val_eq(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    const struct dict_frozen_key *key = val1_p;
+    const char *str = ((struct dict_rec *)val2_p)->value;
+
+    return !strncmp(key->value, str, key->len) && !str[key->len];
+}
+
+int
+lydict_freeze(struct dict_table *dict)
+{
+    struct hash_table *hash_tab;
+
+    if (dict->frozen_tab) {
+        /* already frozen */
+        return EXIT_SUCCESS;
+    }
+
+    hash_tab = lyht_new(1024, sizeof(struct dict_rec), lydict_val_eq, NULL, 1);
+    LY_CHECK_ERR_RETURN(!hash_tab, LOGMEM(NULL), EXIT_FAILURE);
+    lyht_set_incremental(hash_tab, 1);
+
+    pthread_mutex_lock(&dict->lock);
+    /* the frozen table must not be modified by searching it */
+    lyht_finish_resize(dict->hash_tab);
+    lyht_set_cb(dict->hash_tab, lydict_frozen_val_eq);
+    dict->frozen_tab = dict->hash_tab;
+    dict->hash_tab = hash_tab;
+    pthread_mutex_unlock(&dict->lock);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Find a string among the frozen strings of a dictionary, without locking it.
+ *
+ * @param[in] dict Dictionary table.
+ * @param[in] value String to find.
+ * @param[in] len Length of \p value.
+ * @param[in] hash Hash of \p value.
+ * @return Frozen string, NULL if there is none such.
+ */
+static char *
+dict_frozen_find(struct dict_table *dict, const char *value, size_t len, uint32_t hash)
+{
+    struct dict_frozen_key key;
+    struct dict_rec *match;
+
+    key.value = value;
+    key.len = len;
+    if (lyht_find(dict->frozen_tab, &key, hash, (void **)&match)) {
+        return NULL;
+    }
+    return match->value;
+}
+
+#ifndef LY_ENABLED_FAST_HASH
+
 /*
  * Bob Jenkin's one-at-a-time hash
  * http://www.burtleburtle.net/bob/hash/doobs.html
@@ -115,14 +210,106 @@ dict_hash(const char *key, size_t len)
     return hash;
 }
 
+#else
+
 /*
- * Usage:
- * - init hash to 0
- * - repeatedly call dict_hash_multi(), provide hash from the last call
- * - call dict_hash_multi() with key_part = NULL to finish the hash
+ * Hash in the style of wyhash (final version 4) by Wang Yi, public domain
+ * https://github.com/wangyi-fudan/wyhash
+ *
+ * Consumes 16 bytes with one 64x64 -> 128 bit multiplication. Reads in the native byte order,
+ * so the values differ between little and big endian architectures.
+ */
+static const uint64_t dict_hash_secret[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+static uint64_t
+dict_hash_mix(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)a * b;
+
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b, hi, lo;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+static uint64_t
+dict_hash_read64(const unsigned char *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+static uint64_t
+dict_hash_read32(const unsigned char *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+/*
+ * Unlike in wyhash, the seed is not mixed at the beginning, it is always either 0 or the
+ * (already mixed) result of the previous call.
+ */
+static uint32_t
+dict_hash_wy(uint32_t hash, const char *key, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t seed, a, b;
+    size_t i;
+
+    seed = hash ^ dict_hash_secret[0];
+    if (len <= 16) {
+        if (len >= 4) {
+            /* overlapping reads from both ends */
+            a = (dict_hash_read32(p) << 32) | dict_hash_read32(p + ((len >> 3) << 2));
+            b = (dict_hash_read32(p + len - 4) << 32) | dict_hash_read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        for (i = len; i > 16; i -= 16, p += 16) {
+            seed = dict_hash_mix(dict_hash_read64(p) ^ dict_hash_secret[1], dict_hash_read64(p + 8) ^ seed);
+        }
+        /* the last 16 bytes, may overlap the already consumed ones */
+        a = dict_hash_read64(p + i - 16);
+        b = dict_hash_read64(p + i - 8);
+    }
+
+    a = dict_hash_mix(a ^ dict_hash_secret[1], b ^ seed) ^ len;
+    a = dict_hash_mix(a ^ dict_hash_secret[2], seed ^ dict_hash_secret[3]);
+    return (uint32_t)(a ^ (a >> 32));
+}
+
+static uint32_t
+dict_hash(const char *key, size_t len)
+{
+    return dict_hash_wy(0, key, len);
+}
+
+#endif
+
+/*
+ * Bob Jenkin's one-at-a-time hash
+ * http://www.burtleburtle.net/bob/hash/doobs.html
  */
 uint32_t
-dict_hash_multi(uint32_t hash, const char *key_part, size_t len)
+dict_hash_stable_multi(uint32_t hash, const char *key_part, size_t len)
 {
     uint32_t i;
 
@@ -141,6 +328,27 @@ dict_hash_multi(uint32_t hash, const char *key_part, size_t len)
     return hash;
 }
 
+/*
+ * Usage:
+ * - init hash to 0
+ * - repeatedly call dict_hash_multi(), provide hash from the last call
+ * - call dict_hash_multi() with key_part = NULL to finish the hash
+ */
+uint32_t
+dict_hash_multi(uint32_t hash, const char *key_part, size_t len)
+{
+#ifdef LY_ENABLED_FAST_HASH
+    if (key_part) {
+        return dict_hash_wy(hash, key_part, len);
+    }
+
+    /* every part is already fully mixed */
+    return hash;
+#else
+    return dict_hash_stable_multi(hash, key_part, len);
+#endif
+}
+
 static int
 lydict_resize_val_eq(void *val1_p, void *val2_p, int mod, void *cb_data)
 {
@@ -170,6 +378,91 @@ lydict_resize_val_eq(void *val1_p, void *val2_p, int mod, void *cb_data)
     return 0;
 }
 
+/* dictionary lock must be held */
+static struct dict_pin *
+dict_pin_find(struct dict_table *dict, const char *addr, struct dict_pin **prev)
+{
+    struct dict_pin *pin;
+
+    for (*prev = NULL, pin = dict->pins; pin; *prev = pin, pin = pin->next) {
+        if ((addr >= pin->addr) && (addr < pin->addr + pin->length)) {
+            return pin;
+        }
+    }
+
+    return NULL;
+}
+
+/* dictionary lock must be held */
+static void
+dict_pin_release(struct dict_table *dict, struct dict_pin *pin, struct dict_pin *prev)
+{
+    if (--pin->refcount) {
+        return;
+    }
+
+    if (prev) {
+        prev->next = pin->next;
+    } else {
+        dict->pins = pin->next;
+    }
+    munmap(pin->addr, pin->length);
+    free(pin);
+}
+
+struct dict_pin *
+lydict_pin(struct ly_ctx *ctx, char *addr, size_t length)
+{
+    struct dict_pin *pin;
+
+    pin = malloc(sizeof *pin);
+    LY_CHECK_ERR_RETURN(!pin, LOGMEM(ctx), NULL);
+    pin->addr = addr;
+    pin->length = length;
+    pin->refcount = 1;
+
+    pthread_mutex_lock(&ctx->dict.lock);
+    pin->next = ctx->dict.pins;
+    ctx->dict.pins = pin;
+    pthread_mutex_unlock(&ctx->dict.lock);
+
+    return pin;
+}
+
+struct dict_pin *
+lydict_pin_find(struct ly_ctx *ctx, const char *addr)
+{
+    struct dict_pin *pin, *prev;
+
+    pthread_mutex_lock(&ctx->dict.lock);
+    pin = dict_pin_find(&ctx->dict, addr, &prev);
+    pthread_mutex_unlock(&ctx->dict.lock);
+
+    return pin;
+}
+
+void
+lydict_pin_ref(struct ly_ctx *ctx, struct dict_pin *pin)
+{
+    pthread_mutex_lock(&ctx->dict.lock);
+    ++pin->refcount;
+    pthread_mutex_unlock(&ctx->dict.lock);
+}
+
+void
+lydict_unpin(struct ly_ctx *ctx, struct dict_pin *pin)
+{
+    struct dict_pin *prev;
+
+    pthread_mutex_lock(&ctx->dict.lock);
+    if (dict_pin_find(&ctx->dict, pin->addr, &prev) == pin) {
+        dict_pin_release(&ctx->dict, pin, prev);
+    } else {
+        LOGINT(ctx);
+    }
+    pthread_mutex_unlock(&ctx->dict.lock);
+}
+
 API void
 lydict_remove(struct ly_ctx *ctx, const char *value)
 {
@@ -179,6 +472,7 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
     int ret;
     uint32_t hash;
     struct dict_rec rec, *match = NULL;
+    struct dict_pin *pin, *prev;
     char *val_p;
 
     if (!value || !ctx) {
@@ -188,11 +482,25 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
     len = strlen(value);
     hash = dict_hash(value, len);
 
+    if (ctx->dict.frozen_tab && (dict_frozen_find(&ctx->dict, value, len, hash) == value)) {
+        /* frozen strings are not reference counted */
+        return;
+    }
+
     /* create record for lyht_find call */
     rec.value = (char *)value;
     rec.refcount = 0;
 
     pthread_mutex_lock(&ctx->dict.lock);
+
+    /* pins are added and released by other threads, so they can be checked only under the lock */
+    pin = dict_pin_find(&ctx->dict, value, &prev);
+    if (pin) {
+        /* not a dictionary string, but a value referencing a pinned buffer */
+        dict_pin_release(&ctx->dict, pin, prev);
+        goto finish;
+    }
+
     /* set len as data for compare callback */
     lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
     /* check if value is already inserted */
@@ -221,13 +529,11 @@ finish:
 }
 
 static char *
-dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
+dict_insert(struct ly_ctx *ctx, char *value, size_t len, uint32_t hash, int zerocopy)
 {
     struct dict_rec *match = NULL, rec;
     int ret = 0;
-    uint32_t hash;
 
-    hash = dict_hash(value, len);
     /* set len as data for compare callback */
     lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
     /* create record for lyht_insert */
@@ -267,6 +573,7 @@ lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
     FUN_IN;
 
     const char *result;
+    uint32_t hash;
 
     if (!value) {
         return NULL;
@@ -275,9 +582,14 @@ lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
     if (!len) {
         len = strlen(value);
     }
+    hash = dict_hash(value, len);
+
+    if (ctx->dict.frozen_tab && (result = dict_frozen_find(&ctx->dict, value, len, hash))) {
+        return result;
+    }
 
     pthread_mutex_lock(&ctx->dict.lock);
-    result = dict_insert(ctx, (char *)value, len, 0);
+    result = dict_insert(ctx, (char *)value, len, hash, 0);
     pthread_mutex_unlock(&ctx->dict.lock);
 
     return result;
@@ -289,24 +601,112 @@ lydict_insert_zc(struct ly_ctx *ctx, char *value)
     FUN_IN;
 
     const char *result;
+    size_t len;
+    uint32_t hash;
 
     if (!value) {
         return NULL;
     }
 
+    len = strlen(value);
+    hash = dict_hash(value, len);
+
+    if (ctx->dict.frozen_tab && (result = dict_frozen_find(&ctx->dict, value, len, hash))) {
+        free(value);
+        return result;
+    }
+
     pthread_mutex_lock(&ctx->dict.lock);
-    result = dict_insert(ctx, value, strlen(value), 1);
+    result = dict_insert(ctx, value, len, hash, 1);
     pthread_mutex_unlock(&ctx->dict.lock);
 
     return result;
 }
 
+values_equal_cb
+lyht_set_cb(struct hash_table *ht, values_equal_cb new_val_equal)
+{
+    values_equal_cb prev;
+
+    prev = ht->val_equal;
+    ht->val_equal = new_val_equal;
+    return prev;
+}
+
+void *
+lyht_set_cb_data(struct hash_table *ht, void *new_cb_data)
+{
+    void *prev;
+
+    prev = ht->cb_data;
+    ht->cb_data = new_cb_data;
+    return prev;
+}
+
+#ifndef NDEBUG
+
+/* prints little-endian numbers, will also work on big-endian just the values will look weird */
+static char *
+lyht_dbgprint_val2str(void *val_p, int filled, uint16_t val_size)
+{
+    char *val;
+    int32_t i, j;
+
+    val = malloc(val_size * 2 + 1);
+    for (i = 0, j = val_size - 1; i < val_size; ++i, --j) {
+        if (filled) {
+            sprintf(val + i * 2, "%02x", *(((uint8_t *)val_p) + j));
+        } else {
+            sprintf(val + i * 2, "  ");
+        }
+    }
+
+    return val;
+}
+
+#endif
+
+static void
+lyht_dbgprint_value(void *val_p, uint32_t hash, uint16_t val_size, const char *operation)
+{
+#ifndef NDEBUG
+    if ((LY_LLDBG > ly_log_level) || !(ly_log_dbg_groups & LY_LDGHASH)) {
+        return;
+    }
+
+    char *val = lyht_dbgprint_val2str(val_p, 1, val_size);
+    LOGDBG(LY_LDGHASH, "%s value %s with hash %u", operation, val, hash);
+    free(val);
+#else
+    (void)val_p;
+    (void)hash;
+    (void)val_size;
+    (void)operation;
+#endif
+}
+
+#ifndef LY_ENABLED_HT_GROUPS
+
+#define LYHT_VAL_SIZE(ht) ((uint16_t)((ht)->rec_size - (sizeof(struct ht_rec) - 1)))
+
 struct ht_rec *
 lyht_get_rec(unsigned char *recs, uint16_t rec_size, uint32_t idx)
 {
     return (struct ht_rec *)&recs[idx * rec_size];
 }
 
+void *
+lyht_get_val(const struct hash_table *ht, uint32_t idx)
+{
+    struct ht_rec *rec;
+
+    rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
+    if (rec->hits > 0) {
+        return &rec->val;
+    }
+    return NULL;
+}
+
 struct hash_table *
 lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_data, int resize)
 {
@@ -329,6 +729,9 @@ lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_d
     ht->val_equal = val_equal;
     ht->cb_data = cb_data;
     ht->resize = (uint16_t)resize;
+    ht->incremental = 0;
+    ht->old = NULL;
+    ht->old_idx = 0;
 
     ht->rec_size = (sizeof(struct ht_rec) - 1) + val_size;
     /* allocate the records correctly */
@@ -338,94 +741,41 @@ lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_d
     return ht;
 }
 
-values_equal_cb
-lyht_set_cb(struct hash_table *ht, values_equal_cb new_val_equal)
+static int
+lyht_alloc_recs(struct hash_table *ht, uint32_t size)
 {
-    values_equal_cb prev;
+    unsigned char *recs;
 
-    prev = ht->val_equal;
-    ht->val_equal = new_val_equal;
-    return prev;
+    recs = calloc(size, ht->rec_size);
+    LY_CHECK_ERR_RETURN(!recs, LOGMEM(NULL), -1);
+
+    ht->size = size;
+    ht->recs = recs;
+    return 0;
 }
 
-void *
-lyht_set_cb_data(struct hash_table *ht, void *new_cb_data)
+static int
+lyht_copy_recs(struct hash_table *ht, const struct hash_table *orig)
 {
-    void *prev;
-
-    prev = ht->cb_data;
-    ht->cb_data = new_cb_data;
-    return prev;
+    LY_CHECK_RETURN(lyht_alloc_recs(ht, orig->size), -1);
+    memcpy(ht->recs, orig->recs, (size_t)orig->size * (size_t)orig->rec_size);
+    return 0;
 }
 
-struct hash_table *
-lyht_dup(const struct hash_table *orig)
+static void
+lyht_free_recs(struct hash_table *ht)
 {
-    struct hash_table *ht;
-
-    if (!orig) {
-        return NULL;
-    }
-
-    ht = lyht_new(orig->size, orig->rec_size - (sizeof(struct ht_rec) - 1), orig->val_equal, orig->cb_data, orig->resize ? 1 : 0);
-    if (!ht) {
-        return NULL;
-    }
-
-    memcpy(ht->recs, orig->recs, (size_t)orig->used * (size_t)orig->rec_size);
-    ht->used = orig->used;
-    return ht;
-}
-
-void
-lyht_free(struct hash_table *ht)
-{
-    if (ht) {
-        free(ht->recs);
-        free(ht);
-    }
+    free(ht->recs);
 }
 
 static int
-lyht_resize(struct hash_table *ht, int enlarge)
+lyht_need_rehash(struct hash_table *UNUSED(ht))
 {
-    struct ht_rec *rec;
-    unsigned char *old_recs;
-    uint32_t i, old_size;
-    int ret;
-
-    old_recs = ht->recs;
-    old_size = ht->size;
-
-    if (enlarge) {
-        /* double the size */
-        ht->size <<= 1;
-    } else {
-        /* half the size */
-        ht->size >>= 1;
-    }
-
-    ht->recs = calloc(ht->size, ht->rec_size);
-    LY_CHECK_ERR_RETURN(!ht->recs, LOGMEM(NULL); ht->recs = old_recs; ht->size = old_size, -1);
-
-    /* reset used, it will increase again */
-    ht->used = 0;
-
-    /* add all the old records into the new records array */
-    for (i = 0; i < old_size; ++i) {
-        rec = lyht_get_rec(old_recs, ht->rec_size, i);
-        if (rec->hits > 0) {
-            ret = lyht_insert(ht, rec->val, rec->hash, NULL);
-            assert(!ret);
-            (void)ret;
-        }
-    }
-
-    /* final touches */
-    free(old_recs);
+    /* deleted records are reused */
     return 0;
 }
 
+
 /* return: 0 - hash found, returned its record,
  *         1 - hash not found, returned the record where it would be inserted */
 static int
@@ -536,8 +886,10 @@ lyht_find_collision(struct hash_table *ht, struct ht_rec **last, struct ht_rec *
     return 1;
 }
 
-int
-lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+/* return: 0 - value found, returned in match_p,
+ *         1 - value not found */
+static int
+lyht_find_rec(struct hash_table *ht, void *val_p, uint32_t hash, int mod, void **match_p)
 {
     struct ht_rec *rec, *crec;
     uint32_t i, c;
@@ -547,7 +899,7 @@ lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
         /* not found */
         return 1;
     }
-    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 0, ht->cb_data)) {
+    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, mod, ht->cb_data)) {
         /* even the value matches */
         if (match_p) {
             *match_p = rec->val;
@@ -564,7 +916,7 @@ lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
         (void)r;
 
         /* compare values */
-        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 0, ht->cb_data)) {
+        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, mod, ht->cb_data)) {
             if (match_p) {
                 *match_p = rec->val;
             }
@@ -576,37 +928,30 @@ lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
     return 1;
 }
 
-int
-lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+/* return: 0 - next value found (the first one with an equal hash if found is set), returned in match_p,
+ *         1 - the previous value was the last one,
+ *         2 - the previous value not found */
+static int
+lyht_find_next_rec(struct hash_table *ht, void *val_p, uint32_t hash, int found, void **match_p)
 {
     struct ht_rec *rec, *crec;
     uint32_t i, c;
-    int r, found = 0;
+    int r;
 
     if (lyht_find_first(ht, hash, &rec)) {
-        /* not found, cannot happen */
-        assert(0);
+        /* no values with this hash */
+        return found ? 1 : 2;
     }
 
-    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-        /* previously returned value */
-        found = 1;
-    }
-
-    if (rec->hits == 1) {
-        /* there are no more similar values */
-        assert(rec->hash == hash);
-        assert(found);
-        return 1;
-    }
-
-    /* go through collisions and find next one after the previous one */
+    /* go through the first record and collisions and find next one after the previous one */
     crec = rec;
     c = rec->hits;
-    for (i = 1; i < c; ++i) {
-        r = lyht_find_collision(ht, &rec, crec);
-        assert(!r);
-        (void)r;
+    for (i = 0; i < c; ++i) {
+        if (i) {
+            r = lyht_find_collision(ht, &rec, crec);
+            assert(!r);
+            (void)r;
+        }
 
         if (rec->hash != hash) {
             /* a normal collision, we are not interested in those */
@@ -621,118 +966,28 @@ lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p
             return 0;
         }
 
-        if (!ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-            /* already returned value, skip */
-            continue;
-        }
-
-        /* this one was returned previously, continue looking */
-        found = 1;
-    }
-
-    /* the last equal value was already returned */
-    assert(found);
-    return 1;
-}
-
-#ifndef NDEBUG
-
-/* prints little-endian numbers, will also work on big-endian just the values will look weird */
-static char *
-lyht_dbgprint_val2str(void *val_p, int32_t hits, uint16_t rec_size)
-{
-    char *val;
-    int32_t i, j, val_size;
-
-    val_size = rec_size - (sizeof(struct ht_rec) - 1);
-
-    val = malloc(val_size * 2 + 1);
-    for (i = 0, j = val_size - 1; i < val_size; ++i, --j) {
-        if (hits > 0) {
-            sprintf(val + i * 2, "%02x", *(((uint8_t *)val_p) + j));
-        } else {
-            sprintf(val + i * 2, "  ");
-        }
-    }
-
-    return val;
-}
-
-#endif
-
-static void
-lyht_dbgprint_ht(struct hash_table *ht, const char *info)
-{
-#ifndef NDEBUG
-    struct ht_rec *rec;
-    uint32_t i, i_len;
-    char *val;
-
-    if ((LY_LLDBG > ly_log_level) || !(ly_log_dbg_groups & LY_LDGHASH)) {
-        return;
-    }
-
-    LOGDBG(LY_LDGHASH, "");
-    LOGDBG(LY_LDGHASH, "hash table %s (used %u, size %u):", info, ht->used, ht->size);
-
-    val = malloc(11);
-    sprintf(val, "%u", ht->size);
-    i_len = strlen(val);
-    free(val);
-
-    for (i = 0; i < ht->size; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        val = lyht_dbgprint_val2str(&rec->val, rec->hits, ht->rec_size);
-        if (rec->hits > 0) {
-            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10u %% %*u  hits  %2d",
-                   (int)i_len, i, val, rec->hash, (int)i_len, rec->hash & (ht->size - 1), rec->hits);
-        } else {
-            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10s %% %*s  hits  %2d",
-                   (int)i_len, i, val, "", (int)i_len, "", rec->hits);
+        if (ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
+            /* this one was returned previously, continue looking */
+            found = 1;
         }
-        free(val);
-    }
-    LOGDBG(LY_LDGHASH, "");
-#else
-    (void)ht;
-    (void)info;
-#endif
-}
-
-static void
-lyht_dbgprint_value(void *val_p, uint32_t hash, uint16_t rec_size, const char *operation)
-{
-#ifndef NDEBUG
-    if ((LY_LLDBG > ly_log_level) || !(ly_log_dbg_groups & LY_LDGHASH)) {
-        return;
     }
 
-    char *val = lyht_dbgprint_val2str(val_p, 1, rec_size);
-    LOGDBG(LY_LDGHASH, "%s value %s with hash %u", operation, val, hash);
-    free(val);
-#else
-    (void)val_p;
-    (void)hash;
-    (void)rec_size;
-    (void)operation;
-#endif
+    return found ? 1 : 2;
 }
 
-int
-lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
-                           values_equal_cb resize_val_equal, void **match_p)
+/* return: 0 - value inserted, returned in match_p,
+ *         1 - equal value found (only if check is set), returned in match_p,
+ *        -1 - error */
+static int
+lyht_insert_rec(struct hash_table *ht, void *val_p, uint32_t hash, int check, void **match_p)
 {
     struct ht_rec *rec, *crec = NULL;
     int32_t i;
-    int r, ret;
-    values_equal_cb old_val_equal;
-
-    lyht_dbgprint_ht(ht, "before");
-    lyht_dbgprint_value(val_p, hash, ht->rec_size, "inserting");
+    int r;
 
     if (!lyht_find_first(ht, hash, &rec)) {
         /* we found matching shortened hash */
-        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
+        if (check && (rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
             /* even the value matches */
             if (match_p) {
                 *match_p = (void *)&rec->val;
@@ -745,9 +1000,10 @@ lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
         for (i = 1; i < crec->hits; ++i) {
             r = lyht_find_collision(ht, &rec, crec);
             assert(!r);
+            (void)r;
 
             /* compare values */
-            if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
+            if (check && (rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
                 if (match_p) {
                     *match_p = (void *)&rec->val;
                 }
@@ -758,13 +1014,14 @@ lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
         /* value not found, get the record where it will be inserted */
         r = lyht_find_collision(ht, &rec, crec);
         assert(r);
+        (void)r;
     }
 
     /* insert it into the returned record */
     assert(rec->hits < 1);
     rec->hash = hash;
     rec->hits = 1;
-    memcpy(&rec->val, val_p, ht->rec_size - (sizeof(struct ht_rec) - 1));
+    memcpy(&rec->val, val_p, LYHT_VAL_SIZE(ht));
     if (match_p) {
         *match_p = (void *)&rec->val;
     }
@@ -777,57 +1034,20 @@ lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
         ++crec->hits;
     }
 
-    /* check size & enlarge if needed */
-    ret = 0;
-    ++ht->used;
-    if (ht->resize) {
-        r = (ht->used * 100) / ht->size;
-        if ((ht->resize == 1) && (r >= LYHT_FIRST_SHRINK_PERCENTAGE)) {
-            /* enable shrinking */
-            ht->resize = 2;
-        }
-        if ((ht->resize == 2) && (r >= LYHT_ENLARGE_PERCENTAGE)) {
-            if (resize_val_equal) {
-                old_val_equal = lyht_set_cb(ht, resize_val_equal);
-            }
-
-            /* enlarge */
-            ret = lyht_resize(ht, 1);
-            /* if hash_table was resized, we need to find new matching value */
-            if (ret == 0 && match_p) {
-                lyht_find(ht, val_p, hash, match_p);
-            }
-
-            if (resize_val_equal) {
-                lyht_set_cb(ht, old_val_equal);
-            }
-        }
-    }
-
-    lyht_dbgprint_ht(ht, "after");
-    return ret;
-}
-
-int
-lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
-{
-    return lyht_insert_with_resize_cb(ht, val_p, hash, NULL, match_p);
+    return 0;
 }
 
-int
-lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb resize_val_equal)
+/* return: 0 - value removed,
+ *         1 - value not found */
+static int
+lyht_remove_rec(struct hash_table *ht, void *val_p, uint32_t hash)
 {
     struct ht_rec *rec, *crec;
     int32_t i;
-    int first_matched = 0, r, ret;
-    values_equal_cb old_val_equal;
-
-    lyht_dbgprint_ht(ht, "before");
-    lyht_dbgprint_value(val_p, hash, ht->rec_size, "removing");
+    int first_matched = 0, r;
 
     if (lyht_find_first(ht, hash, &rec)) {
         /* hash not found */
-        LOGDBG(LY_LDGHASH, "remove failed");
         return 1;
     }
     if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
@@ -840,6 +1060,7 @@ lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, va
     for (i = 1; i < crec->hits; ++i) {
         r = lyht_find_collision(ht, &rec, crec);
         assert(!r);
+        (void)r;
 
         /* compare values */
         if (!first_matched && (rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
@@ -865,6 +1086,716 @@ lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, va
     } else {
         /* value not found even in collisions */
         assert(!first_matched);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* records are migrated by their values, the callbacks may depend on data of the current operation */
+static int
+lyht_val_bytes_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *cb_data)
+{
+    return !memcmp(val1_p, val2_p, *(uint16_t *)cb_data);
+}
+
+/* return: 0 - the record is not filled,
+ *         1 - its value was moved, another one may have been moved into the record,
+ *        -1 - error */
+static int
+lyht_move_rec(struct hash_table *from, uint32_t idx, struct hash_table *to)
+{
+    struct ht_rec *rec;
+    values_equal_cb val_equal;
+    void *cb_data, *val_p;
+    uint16_t val_size;
+    int r;
+
+    rec = lyht_get_rec(from->recs, from->rec_size, idx);
+    if (rec->hits < 1) {
+        return 0;
+    }
+
+    LY_CHECK_RETURN(lyht_insert_rec(to, &rec->val, rec->hash, 0, &val_p), -1);
+
+    /* remove the record from its collisions, values are not compared using the callback */
+    val_size = LYHT_VAL_SIZE(from);
+    val_equal = lyht_set_cb(from, lyht_val_bytes_equal);
+    cb_data = lyht_set_cb_data(from, &val_size);
+    r = lyht_remove_rec(from, val_p, rec->hash);
+    lyht_set_cb(from, val_equal);
+    lyht_set_cb_data(from, cb_data);
+    assert(!r);
+    (void)r;
+
+    return 1;
+}
+
+static void
+lyht_dbgprint_ht(struct hash_table *ht, const char *info)
+{
+#ifndef NDEBUG
+    struct ht_rec *rec;
+    uint32_t i, i_len;
+    char *val;
+
+    if ((LY_LLDBG > ly_log_level) || !(ly_log_dbg_groups & LY_LDGHASH)) {
+        return;
+    }
+
+    LOGDBG(LY_LDGHASH, "");
+    LOGDBG(LY_LDGHASH, "hash table %s (used %u, size %u):", info, ht->used, ht->size);
+
+    val = malloc(11);
+    sprintf(val, "%u", ht->size);
+    i_len = strlen(val);
+    free(val);
+
+    for (i = 0; i < ht->size; ++i) {
+        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
+        val = lyht_dbgprint_val2str(&rec->val, rec->hits > 0, LYHT_VAL_SIZE(ht));
+        if (rec->hits > 0) {
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10u %% %*u  hits  %2d",
+                   (int)i_len, i, val, rec->hash, (int)i_len, rec->hash & (ht->size - 1), rec->hits);
+        } else {
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10s %% %*s  hits  %2d",
+                   (int)i_len, i, val, "", (int)i_len, "", rec->hits);
+        }
+        free(val);
+    }
+    if (ht->old) {
+        lyht_dbgprint_ht(ht->old, "old records");
+    }
+    LOGDBG(LY_LDGHASH, "");
+#else
+    (void)ht;
+    (void)info;
+#endif
+}
+
+#else /* LY_ENABLED_HT_GROUPS */
+
+/* control byte of a never filled record, probing stops at a group with one */
+#define LYHT_CTRL_EMPTY 0x80
+
+/* control byte of a removed record, probing continues past it */
+#define LYHT_CTRL_DELETED 0xfe
+
+/* control byte padding tables smaller than a group, it never matches */
+#define LYHT_CTRL_SENTINEL 0xff
+
+/* control byte of a filled record, the lowest 7 bits of the hash, the rest selects the first probed group */
+#define LYHT_CTRL_H2(hash) ((uint8_t)((hash) & 0x7f))
+#define LYHT_H1(hash) ((hash) >> 7)
+
+#define LYHT_VAL_SIZE(ht) ((ht)->val_size)
+
+static uint32_t
+lyht_groups(uint32_t size)
+{
+    return (size < LYHT_GROUP_SIZE) ? 1 : size / LYHT_GROUP_SIZE;
+}
+
+static unsigned char *
+lyht_val(const struct hash_table *ht, uint32_t idx)
+{
+    return &ht->vals[(size_t)idx * ht->val_size];
+}
+
+/* mask of the records in the group with control byte \p byte (bit i set for the record i) */
+static uint32_t
+lyht_group_match(const uint8_t *group, uint8_t byte)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t i, mask = 0;
+
+    for (i = 0; i < LYHT_GROUP_SIZE; ++i) {
+        mask |= (uint32_t)(group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+/* mask of the records in the group that are empty or deleted */
+static uint32_t
+lyht_group_match_free(const uint8_t *group)
+{
+#ifdef __SSE2__
+    /* as signed bytes, only empty and deleted are less than sentinel (-1) */
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8((char)LYHT_CTRL_SENTINEL), ctrl));
+#else
+    uint32_t i, mask = 0;
+
+    for (i = 0; i < LYHT_GROUP_SIZE; ++i) {
+        mask |= (uint32_t)((group[i] == LYHT_CTRL_EMPTY) || (group[i] == LYHT_CTRL_DELETED)) << i;
+    }
+    return mask;
+#endif
+}
+
+/* allocate empty records, all the arrays share one allocation starting with the control bytes */
+static int
+lyht_alloc_recs(struct hash_table *ht, uint32_t size)
+{
+    size_t ctrl_size;
+    unsigned char *mem;
+
+    ctrl_size = (size_t)lyht_groups(size) * LYHT_GROUP_SIZE;
+    mem = malloc(ctrl_size + (size_t)size * (sizeof *ht->hashes + ht->val_size));
+    LY_CHECK_ERR_RETURN(!mem, LOGMEM(NULL), -1);
+
+    memset(mem, LYHT_CTRL_EMPTY, size);
+    memset(mem + size, LYHT_CTRL_SENTINEL, ctrl_size - size);
+
+    ht->size = size;
+    ht->deleted = 0;
+    ht->ctrl = mem;
+    ht->hashes = (uint32_t *)(mem + ctrl_size);
+    ht->vals = mem + ctrl_size + (size_t)size * sizeof *ht->hashes;
+    return 0;
+}
+
+static int
+lyht_copy_recs(struct hash_table *ht, const struct hash_table *orig)
+{
+    LY_CHECK_RETURN(lyht_alloc_recs(ht, orig->size), -1);
+    memcpy(ht->ctrl, orig->ctrl, (size_t)lyht_groups(orig->size) * LYHT_GROUP_SIZE
+           + (size_t)orig->size * (sizeof *orig->hashes + orig->val_size));
+    ht->deleted = orig->deleted;
+    return 0;
+}
+
+static void
+lyht_free_recs(struct hash_table *ht)
+{
+    free(ht->ctrl);
+}
+
+static int
+lyht_need_rehash(struct hash_table *ht)
+{
+    /* too many deleted records lengthen probing */
+    return ht->deleted && ((((ht->used + ht->deleted) * 100) / ht->size) >= LYHT_ENLARGE_PERCENTAGE);
+}
+
+static void
+lyht_fill_rec(struct hash_table *ht, uint32_t idx, void *val_p, uint32_t hash)
+{
+    if (ht->ctrl[idx] == LYHT_CTRL_DELETED) {
+        --ht->deleted;
+    }
+    ht->ctrl[idx] = LYHT_CTRL_H2(hash);
+    ht->hashes[idx] = hash;
+    memcpy(lyht_val(ht, idx), val_p, ht->val_size);
+}
+
+static void
+lyht_clear_rec(struct hash_table *ht, uint32_t idx)
+{
+    /* no probing ever continued past a group with an empty record, so the record can be empty again */
+    if (lyht_group_match(&ht->ctrl[idx & ~(uint32_t)(LYHT_GROUP_SIZE - 1)], LYHT_CTRL_EMPTY)) {
+        ht->ctrl[idx] = LYHT_CTRL_EMPTY;
+    } else {
+        ht->ctrl[idx] = LYHT_CTRL_DELETED;
+        ++ht->deleted;
+    }
+}
+
+void *
+lyht_get_val(const struct hash_table *ht, uint32_t idx)
+{
+    if (ht->ctrl[idx] & LYHT_CTRL_EMPTY) {
+        /* empty or deleted */
+        return NULL;
+    }
+    return lyht_val(ht, idx);
+}
+
+struct hash_table *
+lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_data, int resize)
+{
+    struct hash_table *ht;
+
+    /* check that 2^x == size (power of 2) */
+    assert(size && !(size & (size - 1)));
+    assert(val_equal && val_size);
+    assert(resize == 0 || resize == 1);
+
+    if (size < LYHT_MIN_SIZE) {
+        size = LYHT_MIN_SIZE;
+    }
+
+    ht = malloc(sizeof *ht);
+    LY_CHECK_ERR_RETURN(!ht, LOGMEM(NULL), NULL);
+
+    ht->used = 0;
+    ht->val_equal = val_equal;
+    ht->cb_data = cb_data;
+    ht->resize = (uint16_t)resize;
+    ht->incremental = 0;
+    ht->val_size = val_size;
+    ht->old = NULL;
+    ht->old_idx = 0;
+
+    /* allocate the records correctly */
+    LY_CHECK_ERR_RETURN(lyht_alloc_recs(ht, size), free(ht), NULL);
+
+    return ht;
+}
+
+/* return: 0 - value found, returned its record index,
+ *         1 - value not found */
+static int
+lyht_find_idx(struct hash_table *ht, void *val_p, uint32_t hash, int mod, uint32_t *idx_p)
+{
+    uint32_t ngroups, g, step, mask, idx;
+    const uint8_t *group;
+
+    ngroups = lyht_groups(ht->size);
+    g = LYHT_H1(hash) & (ngroups - 1);
+    for (step = 1; step <= ngroups; ++step) {
+        group = &ht->ctrl[g * LYHT_GROUP_SIZE];
+        for (mask = lyht_group_match(group, LYHT_CTRL_H2(hash)); mask; mask &= mask - 1) {
+            idx = g * LYHT_GROUP_SIZE + __builtin_ctz(mask);
+            if ((ht->hashes[idx] == hash) && ht->val_equal(val_p, lyht_val(ht, idx), mod, ht->cb_data)) {
+                *idx_p = idx;
+                return 0;
+            }
+        }
+        if (lyht_group_match(group, LYHT_CTRL_EMPTY)) {
+            /* the value would have been stored in this group */
+            break;
+        }
+        g = (g + step) & (ngroups - 1);
+    }
+
+    return 1;
+}
+
+/* return: 0 - value found, returned in match_p,
+ *         1 - value not found */
+static int
+lyht_find_rec(struct hash_table *ht, void *val_p, uint32_t hash, int mod, void **match_p)
+{
+    uint32_t idx;
+
+    if (lyht_find_idx(ht, val_p, hash, mod, &idx)) {
+        return 1;
+    }
+
+    if (match_p) {
+        *match_p = lyht_val(ht, idx);
+    }
+    return 0;
+}
+
+/* return: 0 - next value found (the first one with an equal hash if found is set), returned in match_p,
+ *         1 - the previous value was the last one,
+ *         2 - the previous value not found */
+static int
+lyht_find_next_rec(struct hash_table *ht, void *val_p, uint32_t hash, int found, void **match_p)
+{
+    uint32_t ngroups, g, step, mask, idx;
+    const uint8_t *group;
+
+    /* values with equal hashes are returned in their probing order */
+    ngroups = lyht_groups(ht->size);
+    g = LYHT_H1(hash) & (ngroups - 1);
+    for (step = 1; step <= ngroups; ++step) {
+        group = &ht->ctrl[g * LYHT_GROUP_SIZE];
+        for (mask = lyht_group_match(group, LYHT_CTRL_H2(hash)); mask; mask &= mask - 1) {
+            idx = g * LYHT_GROUP_SIZE + __builtin_ctz(mask);
+            if (ht->hashes[idx] != hash) {
+                /* a normal collision, we are not interested in those */
+                continue;
+            }
+
+            if (found) {
+                /* next value with equal hash, found our value */
+                if (match_p) {
+                    *match_p = lyht_val(ht, idx);
+                }
+                return 0;
+            }
+
+            if (ht->val_equal(val_p, lyht_val(ht, idx), 1, ht->cb_data)) {
+                /* this one was returned previously, continue looking */
+                found = 1;
+            }
+        }
+        if (lyht_group_match(group, LYHT_CTRL_EMPTY)) {
+            break;
+        }
+        g = (g + step) & (ngroups - 1);
+    }
+
+    return found ? 1 : 2;
+}
+
+/* return: 0 - value inserted, returned in match_p,
+ *         1 - equal value found (only if check is set), returned in match_p,
+ *        -1 - error */
+static int
+lyht_insert_rec(struct hash_table *ht, void *val_p, uint32_t hash, int check, void **match_p)
+{
+    uint32_t ngroups, g, step, mask, idx, free_idx;
+    const uint8_t *group;
+
+    /* look for an equal value and remember the first free record on the way */
+    free_idx = ht->size;
+    ngroups = lyht_groups(ht->size);
+    g = LYHT_H1(hash) & (ngroups - 1);
+    for (step = 1; step <= ngroups; ++step) {
+        group = &ht->ctrl[g * LYHT_GROUP_SIZE];
+        for (mask = check ? lyht_group_match(group, LYHT_CTRL_H2(hash)) : 0; mask; mask &= mask - 1) {
+            idx = g * LYHT_GROUP_SIZE + __builtin_ctz(mask);
+            if ((ht->hashes[idx] == hash) && ht->val_equal(val_p, lyht_val(ht, idx), 1, ht->cb_data)) {
+                /* even the value matches */
+                if (match_p) {
+                    *match_p = lyht_val(ht, idx);
+                }
+                return 1;
+            }
+        }
+        if (free_idx == ht->size) {
+            mask = lyht_group_match_free(group);
+            if (mask) {
+                free_idx = g * LYHT_GROUP_SIZE + __builtin_ctz(mask);
+                if (!check) {
+                    break;
+                }
+            }
+        }
+        if (lyht_group_match(group, LYHT_CTRL_EMPTY)) {
+            break;
+        }
+        g = (g + step) & (ngroups - 1);
+    }
+    LY_CHECK_ERR_RETURN(free_idx == ht->size, LOGINT(NULL), -1);
+
+    /* insert it into the free record */
+    lyht_fill_rec(ht, free_idx, val_p, hash);
+    if (match_p) {
+        *match_p = lyht_val(ht, free_idx);
+    }
+    return 0;
+}
+
+/* return: 0 - value removed,
+ *         1 - value not found */
+static int
+lyht_remove_rec(struct hash_table *ht, void *val_p, uint32_t hash)
+{
+    uint32_t idx;
+
+    if (lyht_find_idx(ht, val_p, hash, 1, &idx)) {
+        return 1;
+    }
+
+    lyht_clear_rec(ht, idx);
+    return 0;
+}
+
+/* return: 0 - the record is not filled,
+ *         1 - its value was moved,
+ *        -1 - error */
+static int
+lyht_move_rec(struct hash_table *from, uint32_t idx, struct hash_table *to)
+{
+    if (from->ctrl[idx] & LYHT_CTRL_EMPTY) {
+        return 0;
+    }
+
+    LY_CHECK_RETURN(lyht_insert_rec(to, lyht_val(from, idx), from->hashes[idx], 0, NULL), -1);
+    lyht_clear_rec(from, idx);
+    return 1;
+}
+
+static void
+lyht_dbgprint_ht(struct hash_table *ht, const char *info)
+{
+#ifndef NDEBUG
+    uint32_t i, i_len;
+    char *val;
+
+    if ((LY_LLDBG > ly_log_level) || !(ly_log_dbg_groups & LY_LDGHASH)) {
+        return;
+    }
+
+    LOGDBG(LY_LDGHASH, "");
+    LOGDBG(LY_LDGHASH, "hash table %s (used %u, deleted %u, size %u):", info, ht->used, ht->deleted, ht->size);
+
+    val = malloc(11);
+    sprintf(val, "%u", ht->size);
+    i_len = strlen(val);
+    free(val);
+
+    for (i = 0; i < ht->size; ++i) {
+        val = lyht_dbgprint_val2str(lyht_val(ht, i), !(ht->ctrl[i] & LYHT_CTRL_EMPTY), ht->val_size);
+        if (!(ht->ctrl[i] & LYHT_CTRL_EMPTY)) {
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10u  group %*u  ctrl  %02x",
+                   (int)i_len, i, val, ht->hashes[i], (int)i_len, LYHT_H1(ht->hashes[i]) & (lyht_groups(ht->size) - 1),
+                   ht->ctrl[i]);
+        } else {
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10s  group %*s  ctrl  %02x",
+                   (int)i_len, i, val, "", (int)i_len, "", ht->ctrl[i]);
+        }
+        free(val);
+    }
+    if (ht->old) {
+        lyht_dbgprint_ht(ht->old, "old records");
+    }
+    LOGDBG(LY_LDGHASH, "");
+#else
+    (void)ht;
+    (void)info;
+#endif
+}
+
+#endif /* LY_ENABLED_HT_GROUPS */
+
+void
+lyht_set_incremental(struct hash_table *ht, int incremental)
+{
+    ht->incremental = incremental ? 1 : 0;
+    if (!incremental) {
+        lyht_finish_resize(ht);
+    }
+}
+
+struct hash_table *
+lyht_dup(const struct hash_table *orig)
+{
+    struct hash_table *ht;
+
+    if (!orig) {
+        return NULL;
+    }
+
+    ht = malloc(sizeof *ht);
+    LY_CHECK_ERR_RETURN(!ht, LOGMEM(NULL), NULL);
+
+    *ht = *orig;
+    LY_CHECK_ERR_RETURN(lyht_copy_recs(ht, orig), free(ht), NULL);
+    if (orig->old) {
+        ht->old = lyht_dup(orig->old);
+        LY_CHECK_ERR_RETURN(!ht->old, lyht_free_recs(ht); free(ht), NULL);
+    }
+
+    return ht;
+}
+
+void
+lyht_free(struct hash_table *ht)
+{
+    if (ht) {
+        lyht_free(ht->old);
+        lyht_free_recs(ht);
+        free(ht);
+    }
+}
+
+/* old records of an unfinished resize, they are compared the same way as the current ones */
+static struct hash_table *
+lyht_old(struct hash_table *ht)
+{
+    ht->old->val_equal = ht->val_equal;
+    ht->old->cb_data = ht->cb_data;
+    return ht->old;
+}
+
+/* migrate at most count old records of an unfinished resize, all of them if count is 0 */
+static int
+lyht_migrate(struct hash_table *ht, uint32_t count)
+{
+    struct hash_table *old = ht->old;
+    uint32_t i;
+    int r;
+
+    for (i = 0; old->used && (!count || (i < count)); ++i) {
+        r = lyht_move_rec(old, ht->old_idx, ht);
+        LY_CHECK_RETURN(r == -1, -1);
+        if (r) {
+            /* check the same record again, another value may have been moved into it */
+            --old->used;
+        } else {
+            /* finding values may move them to the records already passed, so go around as long as needed */
+            ht->old_idx = (ht->old_idx + 1) & (old->size - 1);
+        }
+    }
+
+    if (!old->used) {
+        /* resize finished */
+        lyht_free(old);
+        ht->old = NULL;
+    }
+    return 0;
+}
+
+int
+lyht_finish_resize(struct hash_table *ht)
+{
+    if (!ht->old) {
+        return 0;
+    }
+    return lyht_migrate(ht, 0);
+}
+
+/* move all the values into newly allocated records, just start moving them if the resize is incremental */
+static int
+lyht_resize(struct hash_table *ht, uint32_t size)
+{
+    struct hash_table *old;
+
+    /* finish the previous resize, if any */
+    LY_CHECK_RETURN(lyht_finish_resize(ht), -1);
+
+    old = malloc(sizeof *old);
+    LY_CHECK_ERR_RETURN(!old, LOGMEM(NULL), -1);
+
+    /* the current records become the old ones */
+    *old = *ht;
+    LY_CHECK_ERR_RETURN(lyht_alloc_recs(ht, size), free(old), -1);
+    ht->old = old;
+    ht->old_idx = 0;
+
+    if (!ht->incremental) {
+        return lyht_migrate(ht, 0);
+    }
+    return 0;
+}
+
+int
+lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    if (!lyht_find_rec(ht, val_p, hash, 0, match_p)) {
+        return 0;
+    }
+    if (ht->old && !lyht_find_rec(lyht_old(ht), val_p, hash, 0, match_p)) {
+        return 0;
+    }
+
+    /* not found */
+    return 1;
+}
+
+int
+lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    int r;
+
+    /* values in the current records are returned before the old ones */
+    r = lyht_find_next_rec(ht, val_p, hash, 0, match_p);
+    if (ht->old && (r == 1)) {
+        /* continue with the first old value with equal hash */
+        r = lyht_find_next_rec(lyht_old(ht), val_p, hash, 1, match_p);
+    } else if (ht->old && (r == 2)) {
+        r = lyht_find_next_rec(lyht_old(ht), val_p, hash, 0, match_p);
+    }
+
+    /* the previously returned value must have been found */
+    assert(r != 2);
+    return r ? 1 : 0;
+}
+
+int
+lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
+                           values_equal_cb resize_val_equal, void **match_p)
+{
+    uint32_t new_size;
+    int r, ret;
+    values_equal_cb old_val_equal;
+
+    lyht_dbgprint_ht(ht, "before");
+    lyht_dbgprint_value(val_p, hash, LYHT_VAL_SIZE(ht), "inserting");
+
+    if (ht->old) {
+        /* continue with an unfinished resize */
+        LY_CHECK_RETURN(lyht_migrate(ht, LYHT_MIGRATE_STEP), -1);
+    }
+
+    if (ht->old && !lyht_find_rec(lyht_old(ht), val_p, hash, 1, match_p)) {
+        /* the value matches an old one */
+        return 1;
+    }
+    ret = lyht_insert_rec(ht, val_p, hash, 1, match_p);
+    if (ret) {
+        /* the value matches or error */
+        return ret;
+    }
+
+    /* check size & enlarge if needed */
+    ++ht->used;
+    new_size = 0;
+    if (ht->resize) {
+        r = (ht->used * 100) / ht->size;
+        if ((ht->resize == 1) && (r >= LYHT_FIRST_SHRINK_PERCENTAGE)) {
+            /* enable shrinking */
+            ht->resize = 2;
+        }
+        if ((ht->resize == 2) && (r >= LYHT_ENLARGE_PERCENTAGE)) {
+            /* enlarge */
+            new_size = ht->size << 1;
+        }
+    }
+    if (!new_size && lyht_need_rehash(ht)) {
+        /* only rehash */
+        new_size = ht->size;
+    }
+
+    if (new_size) {
+        if (resize_val_equal) {
+            old_val_equal = lyht_set_cb(ht, resize_val_equal);
+        }
+
+        ret = lyht_resize(ht, new_size);
+        /* if hash_table was resized, we need to find new matching value */
+        if (ret == 0 && match_p) {
+            lyht_find(ht, val_p, hash, match_p);
+        }
+
+        if (resize_val_equal) {
+            lyht_set_cb(ht, old_val_equal);
+        }
+    }
+
+    lyht_dbgprint_ht(ht, "after");
+    return ret;
+}
+
+int
+lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    return lyht_insert_with_resize_cb(ht, val_p, hash, NULL, match_p);
+}
+
+int
+lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb resize_val_equal)
+{
+    int r, ret;
+    values_equal_cb old_val_equal;
+
+    lyht_dbgprint_ht(ht, "before");
+    lyht_dbgprint_value(val_p, hash, LYHT_VAL_SIZE(ht), "removing");
+
+    if (ht->old) {
+        /* continue with an unfinished resize */
+        LY_CHECK_RETURN(lyht_migrate(ht, LYHT_MIGRATE_STEP), -1);
+    }
+
+    if (!lyht_remove_rec(ht, val_p, hash)) {
+        /* removed */
+    } else if (ht->old && !lyht_remove_rec(lyht_old(ht), val_p, hash)) {
+        /* removed one of the old values */
+        --ht->old->used;
+    } else {
+        /* value not found */
         LOGDBG(LY_LDGHASH, "remove failed");
         return 1;
     }
@@ -880,7 +1811,7 @@ lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, va
             }
 
             /* shrink */
-            ret = lyht_resize(ht, 0);
+            ret = lyht_resize(ht, ht->size >> 1);
 
             if (resize_val_equal) {
                 lyht_set_cb(ht, old_val_equal);
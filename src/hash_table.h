@@ -32,6 +32,14 @@
  */
 uint32_t dict_hash_multi(uint32_t hash, const char *key_part, size_t len);
 
+/**
+ * @brief Compute hash from (several) string(s) the same way as dict_hash_multi() but always using Jenkin's
+ * one-at-a-time hash, whatever the build options.
+ *
+ * Meant for hashes that leave the process (LYB), so their values must never change.
+ */
+uint32_t dict_hash_stable_multi(uint32_t hash, const char *key_part, size_t len);
+
 /**
  * @brief Callback for checking hash table values equivalence.
  *
@@ -55,6 +63,11 @@ typedef int (*values_equal_cb)(void *val1_p, void *val2_p, int mod, void *cb_dat
 /** never shrink beyond this size */
 #define LYHT_MIN_SIZE 8
 
+/** how many old records are (at most) migrated by every insert or remove during an incremental resize */
+#define LYHT_MIGRATE_STEP 16
+
+#ifndef LY_ENABLED_HT_GROUPS
+
 /**
  * @brief Generic hash table record.
  */
@@ -81,19 +94,69 @@ struct hash_table {
                            * 1 - enlarging is enabled, *
                            * 2 - both shrinking and enlarging is enabled */
     uint16_t rec_size;    /* real size (in bytes) of one record for accessing recs array */
+    uint16_t incremental; /* whether resizing migrates the records gradually */
     unsigned char *recs;  /* pointer to the hash table itself (array of struct ht_rec) */
+    struct hash_table *old; /* records from before an unfinished incremental resize, NULL if there is none */
+    uint32_t old_idx;     /* next old record to migrate */
 };
 
+#else
+
+/** number of records whose control bytes are probed at once */
+#define LYHT_GROUP_SIZE 16
+
+/**
+ * @brief (Very) generic hash table.
+ *
+ * Hash table with open addressing collision resolution and quadratic
+ * probing of groups of #LYHT_GROUP_SIZE records. Every record has a control
+ * byte (empty, deleted, or the lowest 7 bits of the hash of the stored value)
+ * kept apart from the hashes and values so that a whole group is compared at once.
+ * Removal is lazy (removed records are only marked), unless the group still
+ * has an empty record.
+ */
+struct hash_table {
+    uint32_t used;        /* number of values stored in the hash table (filled records) */
+    uint32_t size;        /* always holds 2^x == size (is power of 2), actually number of records allocated */
+    uint32_t deleted;     /* number of records marked as deleted */
+    values_equal_cb val_equal; /* callback for testing value equivalence */
+    void *cb_data;        /* user data callback arbitrary value */
+    uint16_t resize;      /* 0 - resizing is disabled, *
+                           * 1 - enlarging is enabled, *
+                           * 2 - both shrinking and enlarging is enabled */
+    uint16_t val_size;    /* size (in bytes) of one value for accessing vals array */
+    uint16_t incremental; /* whether resizing migrates the records gradually */
+    uint8_t *ctrl;        /* control bytes of the records, padded to a whole group (start of the allocated memory) */
+    uint32_t *hashes;     /* hashes of the values */
+    unsigned char *vals;  /* values */
+    struct hash_table *old; /* records from before an unfinished incremental resize, NULL if there is none */
+    uint32_t old_idx;     /* next old record to migrate */
+};
+
+#endif
+
 struct dict_rec {
     char *value;
     uint32_t refcount;
 } _PACKED;
 
+/**
+ * pinned input buffer referenced by data values instead of dictionary strings
+ */
+struct dict_pin {
+    char *addr;           /* start of the mapped buffer */
+    size_t length;        /* length of the mapping */
+    int64_t refcount;     /* number of values referencing the buffer (+1 while it is being parsed) */
+    struct dict_pin *next;
+};
+
 /**
  * dictionary to store repeating strings
  */
 struct dict_table {
     struct hash_table *hash_tab;
+    struct hash_table *frozen_tab; /* strings of a frozen context, never modified and read without the lock */
+    struct dict_pin *pins; /* pinned input buffers */
     pthread_mutex_t lock;
 };
 
@@ -111,6 +174,59 @@ void lydict_init(struct dict_table *dict);
  */
 void lydict_clean(struct dict_table *dict);
 
+/**
+ * @brief Freeze the current content of the dictionary.
+ *
+ * The stored strings are moved into a table that is never modified again and can be searched without the lock.
+ * They are not reference counted anymore and stay in the dictionary until it is cleaned. Only new strings are
+ * then stored in the standard way.
+ *
+ * @param[in] dict Dictionary table to freeze.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lydict_freeze(struct dict_table *dict);
+
+/**
+ * @brief Pin an mmap()ed input buffer so that values can reference it instead of the dictionary.
+ *
+ * The buffer is owned by the dictionary from now on, it is unmapped once the pin and all the references
+ * to it are released. References are taken by increasing dict_pin::refcount directly, it is safe only
+ * until the referencing values are made visible to other threads, and released by lydict_remove().
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] addr Mapped buffer.
+ * @param[in] length Length of the mapping.
+ * @return Created pin holding one reference, NULL on error.
+ */
+struct dict_pin *lydict_pin(struct ly_ctx *ctx, char *addr, size_t length);
+
+/**
+ * @brief Find the pin of a buffer.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] addr Address inside the buffer.
+ * @return Found pin, NULL if \p addr is not inside any pinned buffer.
+ */
+struct dict_pin *lydict_pin_find(struct ly_ctx *ctx, const char *addr);
+
+/**
+ * @brief Add a reference of a value to a pin. The pin may be shared by several parsing threads.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] pin Pin to reference.
+ */
+void lydict_pin_ref(struct ly_ctx *ctx, struct dict_pin *pin);
+
+/**
+ * @brief Release one reference of a pin, unmap the buffer if it was the last one.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] pin Pin to release.
+ */
+void lydict_unpin(struct ly_ctx *ctx, struct dict_pin *pin);
+
+#ifndef LY_ENABLED_HT_GROUPS
+
 /**
  * @brief Get a specific record from a hash table.
  *
@@ -121,6 +237,18 @@ void lydict_clean(struct dict_table *dict);
  */
 struct ht_rec *lyht_get_rec(unsigned char *recs, uint16_t rec_size, uint32_t idx);
 
+#endif
+
+/**
+ * @brief Get the value stored in a specific record of a hash table.
+ *
+ * @param[in] ht Hash table.
+ * @param[in] idx Index of the record, less than hash_table::size.
+ * @return Value stored in the record on index \p idx, NULL if the record is not filled.
+ * Values of an unfinished incremental resize are not stored in the records, see lyht_finish_resize().
+ */
+void *lyht_get_val(const struct hash_table *ht, uint32_t idx);
+
 /**
  * @brief Create new hash table.
  *
@@ -151,6 +279,26 @@ values_equal_cb lyht_set_cb(struct hash_table *ht, values_equal_cb new_val_equal
  */
 void *lyht_set_cb_data(struct hash_table *ht, void *new_cb_data);
 
+/**
+ * @brief Set whether the hash table is resized incrementally.
+ *
+ * Normally, all the values are moved into the resized records at once. Incremental resize keeps
+ * the old records and every following insert or remove moves only up to #LYHT_MIGRATE_STEP of them,
+ * until then the values are searched for in both.
+ *
+ * @param[in] ht Hash table to modify.
+ * @param[in] incremental Whether to resize incrementally, if not, any unfinished resize is finished.
+ */
+void lyht_set_incremental(struct hash_table *ht, int incremental);
+
+/**
+ * @brief Finish an unfinished incremental resize of a hash table, if any.
+ *
+ * @param[in] ht Hash table to modify.
+ * @return 0 on success, -1 on error.
+ */
+int lyht_finish_resize(struct hash_table *ht);
+
 /**
  * @brief Make a duplicate of an existing hash table.
  *
@@ -74,9 +74,113 @@ API void
     return ly_log_clb;
 }
 
+/**
+ * @brief Learn whether a message would be neither stored nor printed so that it does not need to be
+ * constructed at all.
+ *
+ * @param[in] level Message level.
+ * @return 1 if the message would be discarded, 0 otherwise.
+ */
+static int
+log_is_ignored(LY_LOG_LEVEL level)
+{
+    if ((log_opt == ILO_ERR2WRN) && (level == LY_LLERR)) {
+        /* error will be changed to warning */
+        level = LY_LLWRN;
+    }
+
+    return (log_opt == ILO_IGNORE) || (level > ly_log_level);
+}
+
+THREAD_LOCAL int ly_err_lazy_count;
+
+/**
+ * @brief Get the last error item of this thread without generating any postponed paths.
+ */
+static struct ly_err_item *
+log_last_eitem(const struct ly_ctx *ctx)
+{
+    struct ly_err_item *first;
+
+    if (!ctx) {
+        return NULL;
+    }
+
+    first = pthread_getspecific(ctx->errlist_key);
+    return first ? first->prev : NULL;
+}
+
+/* !! spends path !! */
+static void
+log_eitem_set_path(struct ly_err_item *eitem, char *path, enum LY_VLOG_ELEM path_type, const void *path_elem)
+{
+    struct ly_err_item_int *ieitem = (struct ly_err_item_int *)eitem;
+
+    free(eitem->path);
+    if (ieitem->path_type != LY_VLOG_NONE) {
+        --ly_err_lazy_count;
+    }
+
+    eitem->path = path;
+    ieitem->path_type = path_type;
+    ieitem->path_elem = path_elem;
+    if (path_type != LY_VLOG_NONE) {
+        ++ly_err_lazy_count;
+    }
+}
+
+/**
+ * @brief Generate the postponed path of an error item, if any.
+ */
+static void
+log_eitem_build_path(struct ly_err_item *eitem)
+{
+    struct ly_err_item_int *ieitem = (struct ly_err_item_int *)eitem;
+    char *path = NULL;
+
+    if (ieitem->path_type == LY_VLOG_NONE) {
+        return;
+    }
+
+    ly_vlog_build_path(ieitem->path_type, ieitem->path_elem, &path, 0, 0);
+    log_eitem_set_path(eitem, path, LY_VLOG_NONE, NULL);
+}
+
+void
+ly_err_build_lazy_paths(const struct ly_ctx *ctx)
+{
+    struct ly_err_item *eitem;
+
+    if (!ctx) {
+        return;
+    }
+
+    for (eitem = pthread_getspecific(ctx->errlist_key); eitem && ly_err_lazy_count; eitem = eitem->next) {
+        log_eitem_build_path(eitem);
+    }
+}
+
+/**
+ * @brief Get a copy of the path of the last error item to be used for a new message.
+ */
+static char *
+log_prev_path(const struct ly_ctx *ctx)
+{
+    struct ly_err_item *last;
+
+    last = log_last_eitem(ctx);
+    if (!last) {
+        return NULL;
+    }
+
+    log_eitem_build_path(last);
+    return last->path ? strdup(last->path) : NULL;
+}
+
 /* !! spends all string parameters !! */
 static int
-log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *msg, char *path, char *apptag)
+log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *msg, char *path,
+          enum LY_VLOG_ELEM path_type, const void *path_elem, char *apptag)
 {
     struct ly_err_item *eitem, *last;
 
@@ -86,7 +190,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     if (!eitem) {
         /* if we are only to fill in path, there must have been an error stored */
         assert(msg);
-        eitem = malloc(sizeof *eitem);
+        eitem = calloc(1, sizeof(struct ly_err_item_int));
         if (!eitem) {
             goto mem_fail;
         }
@@ -96,15 +200,14 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
         pthread_setspecific(ctx->errlist_key, eitem);
     } else if (!msg) {
         /* only filling the path */
-        assert(path);
+        assert(path || path_type);
 
         /* find last error */
         eitem = eitem->prev;
         do {
             if (eitem->level == LY_LLERR) {
                 /* fill the path */
-                free(eitem->path);
-                eitem->path = path;
+                log_eitem_set_path(eitem, path, path_type, path_elem);
                 return 0;
             }
             eitem = eitem->prev;
@@ -114,12 +217,11 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     } else if ((log_opt != ILO_STORE) && ((ly_log_opts & LY_LOSTORE_LAST) == LY_LOSTORE_LAST)) {
         /* overwrite last message */
         free(eitem->msg);
-        free(eitem->path);
         free(eitem->apptag);
     } else {
         /* store new message */
         last = eitem->prev;
-        eitem->prev = malloc(sizeof *eitem);
+        eitem->prev = calloc(1, sizeof(struct ly_err_item_int));
         if (!eitem->prev) {
             goto mem_fail;
         }
@@ -134,7 +236,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     eitem->no = no;
     eitem->vecode = vecode;
     eitem->msg = msg;
-    eitem->path = path;
+    log_eitem_set_path(eitem, path, path_type, path_elem);
     eitem->apptag = apptag;
     return 0;
 
@@ -146,41 +248,83 @@ mem_fail:
     return -1;
 }
 
-/* !! spends path !! */
+/**
+ * @brief Check whether the path of an element may be generated only later. It is possible only for elements
+ * that are freed by the functions generating all the postponed paths first (lyd_free(), lys_node_free(),
+ * lyxml_free_withsiblings(), ...), not for the zeroed dummy nodes used for example to parse values.
+ */
+static int
+log_path_can_defer(enum LY_VLOG_ELEM path_type, const void *path_elem)
+{
+    switch (path_type) {
+    case LY_VLOG_XML:
+        return 1;
+    case LY_VLOG_LYS:
+        /* a dummy schema node does not belong to any module */
+        return ((const struct lys_node *)path_elem)->module ? 1 : 0;
+    case LY_VLOG_LYD:
+        /* a dummy data node is not a part of any tree, where every node has a previous sibling (at least itself) */
+        return ((const struct lyd_node *)path_elem)->prev ? 1 : 0;
+    default:
+        return 0;
+    }
+}
+
+/* !! spends path !!
+ * The path is either already generated in \p path or it is generated from \p path_type and \p path_elem, but only
+ * if it is really needed (the message is printed or stored permanently). */
 static void
 log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *path,
-            const char *format, va_list args)
+            enum LY_VLOG_ELEM path_type, const void *path_elem, const char *format, va_list args)
 {
     char *msg = NULL;
-    int free_strs;
+    struct ly_err_item *last;
+    int store, print, free_strs;
 
-    if ((log_opt == ILO_ERR2WRN) && (level == LY_LLERR)) {
-        /* change error to warning */
-        level = LY_LLWRN;
-    }
+    assert(!path || (path_type == LY_VLOG_NONE));
 
-    if ((log_opt == ILO_IGNORE) || (level > ly_log_level)) {
+    if (log_is_ignored(level)) {
         /* do not print or store the message */
         free(path);
         return;
     }
 
+    if ((log_opt == ILO_ERR2WRN) && (level == LY_LLERR)) {
+        /* change error to warning */
+        level = LY_LLWRN;
+    }
+
     /* set global errno on normal logging, but do not erase */
     if ((log_opt != ILO_STORE) && no) {
         ly_errno = no;
     }
 
+    /* store the error/warning (if we need to store errors internally, it does not matter what are the user log options) */
+    store = (level < LY_LLVRB) && ctx && ((ly_log_opts & LY_LOSTORE) || (log_opt == ILO_STORE));
+    /* if we are only storing errors internally, never print the message (yet) */
+    print = (ly_log_opts & LY_LOLOG) && (log_opt != ILO_STORE);
+    if (!store && !print) {
+        free(path);
+        return;
+    }
+
     if ((no == LY_EVALID) && (vecode == LYVE_SUCCESS)) {
         /* assume we are inheriting the error, so inherit vecode as well */
-        vecode = ly_vecode(ctx);
+        last = log_last_eitem(ctx);
+        vecode = last ? last->vecode : LYVE_SUCCESS;
     }
 
-    /* store the error/warning (if we need to store errors internally, it does not matter what are the user log options) */
-    if ((level < LY_LLVRB) && ctx && ((ly_log_opts & LY_LOSTORE) || (log_opt == ILO_STORE))) {
+    if ((path_type != LY_VLOG_NONE) && ((log_opt != ILO_STORE) || !log_path_can_defer(path_type, path_elem))) {
+        /* the message may be needed after the element is changed or freed, generate the path right away */
+        ly_vlog_build_path(path_type, path_elem, &path, 0, 0);
+        path_type = LY_VLOG_NONE;
+    }
+
+    if (store) {
         if (!format) {
-            assert(path);
+            assert(path || path_type);
             /* postponed print of path related to the previous error, do not rewrite stored original message */
-            if (log_store(ctx, level, no, vecode, NULL, path, NULL)) {
+            if (log_store(ctx, level, no, vecode, NULL, path, path_type, path_elem, NULL)) {
                 return;
             }
             msg = "Path is related to the previous error message.";
@@ -190,22 +334,23 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
                 free(path);
                 return;
             }
-            if (log_store(ctx, level, no, vecode, msg, path, NULL)) {
+            if (log_store(ctx, level, no, vecode, msg, path, path_type, path_elem, NULL)) {
                 return;
             }
         }
         free_strs = 0;
     } else {
-        if (vasprintf(&msg, format, args) == -1) {
+        if (!format) {
+            msg = "Path is related to the previous error message.";
+        } else if (vasprintf(&msg, format, args) == -1) {
             LOGMEM(ctx);
             free(path);
             return;
         }
-        free_strs = 1;
+        free_strs = format ? 1 : 0;
     }
 
-    /* if we are only storing errors internally, never print the message (yet) */
-    if ((ly_log_opts & LY_LOLOG) && (log_opt != ILO_STORE)) {
+    if (print) {
         if (ly_log_clb) {
             ly_log_clb(level, msg, path);
         } else {
@@ -216,8 +361,10 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
         }
     }
 
-    if (free_strs) {
+    if (!store) {
         free(path);
+    }
+    if (free_strs) {
         free(msg);
     }
 }
@@ -228,7 +375,7 @@ ly_log(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, const char *form
     va_list ap;
 
     va_start(ap, format);
-    log_vprintf(ctx, level, no, 0, NULL, format, ap);
+    log_vprintf(ctx, level, no, 0, NULL, LY_VLOG_NONE, NULL, format, ap);
     va_end(ap);
 }
 
@@ -278,7 +425,7 @@ ly_log_dbg(int group, const char *format, ...)
     }
 
     va_start(ap, format);
-    log_vprintf(NULL, LY_LLDBG, 0, 0, NULL, dbg_format, ap);
+    log_vprintf(NULL, LY_LLDBG, 0, 0, NULL, LY_VLOG_NONE, NULL, dbg_format, ap);
     va_end(ap);
     free(dbg_format);
 }
@@ -307,7 +454,7 @@ lyext_log(const struct ly_ctx *ctx, LY_LOG_LEVEL level, const char *plugin, cons
     }
 
     va_start(ap, format);
-    log_vprintf(ctx, level, (level == LY_LLERR ? LY_EPLUGIN : 0), 0, NULL, plugin_msg, ap);
+    log_vprintf(ctx, level, (level == LY_LLERR ? LY_EPLUGIN : 0), 0, NULL, LY_VLOG_NONE, NULL, plugin_msg, ap);
     va_end(ap);
 
     free(plugin_msg);
@@ -331,24 +478,23 @@ lyext_vlog(const struct ly_ctx *ctx, LY_VECODE vecode, const char *plugin, const
     va_list ap;
     int ret;
 
-    if (path_flag && (etype != LY_VLOG_NONE)) {
-        if (etype == LY_VLOG_PREV) {
-            /* use previous path */
-            const struct ly_err_item *first = ly_err_first(ctx);
-            if (first && first->prev->path) {
-                path = strdup(first->prev->path);
-            }
-        } else {
-            /* print path */
-            if (!elem) {
-                /* top-level */
-                path = strdup("/");
-            } else {
-                ly_vlog_build_path(etype, elem, &path, 0, 0);
-            }
-        }
+    if (log_is_ignored(LY_LLERR)) {
+        /* do not waste time building the message */
+        return;
     }
 
+    if (!path_flag) {
+        etype = LY_VLOG_NONE;
+    } else if (etype == LY_VLOG_PREV) {
+        /* use previous path */
+        path = log_prev_path(ctx);
+        etype = LY_VLOG_NONE;
+    } else if ((etype != LY_VLOG_NONE) && !elem) {
+        /* top-level */
+        path = strdup("/");
+        etype = LY_VLOG_NONE;
+    } /* else the path is generated only if needed */
+
     if (plugin)
         ret = asprintf(&plugin_msg, "%s (reported by plugin %s, %s())", format, plugin, function);
     else
@@ -362,7 +508,7 @@ lyext_vlog(const struct ly_ctx *ctx, LY_VECODE vecode, const char *plugin, const
 
     va_start(ap, format);
     /* path is spent and should not be freed! */
-    log_vprintf(ctx, LY_LLERR, LY_EVALID, vecode, path, plugin_msg, ap);
+    log_vprintf(ctx, LY_LLERR, LY_EVALID, vecode, path, etype, elem, plugin_msg, ap);
     va_end(ap);
 
     free(plugin_msg);
@@ -851,43 +997,37 @@ ly_vlog(const struct ly_ctx *ctx, LY_ECODE ecode, enum LY_VLOG_ELEM elem_type, c
     va_list ap;
     const char *fmt;
     char* path = NULL;
-    const struct ly_err_item *first;
 
-    if ((ecode == LYE_PATH) && !path_flag) {
+    if (((ecode == LYE_PATH) && !path_flag) || log_is_ignored(LY_LLERR)) {
+        /* nothing would be printed or stored, so do not waste time building the path */
         return;
     }
 
-    if (path_flag && (elem_type != LY_VLOG_NONE)) {
-        if (elem_type == LY_VLOG_PREV) {
-            /* use previous path */
-            first = ly_err_first(ctx);
-            if (first && first->prev->path) {
-                path = strdup(first->prev->path);
-            }
-        } else {
-            /* print path */
-            if (!elem) {
-                /* top-level */
-                path = strdup("/");
-            } else {
-                ly_vlog_build_path(elem_type, elem, &path, 0, 0);
-            }
-        }
-    }
+    if (!path_flag) {
+        elem_type = LY_VLOG_NONE;
+    } else if (elem_type == LY_VLOG_PREV) {
+        /* use previous path */
+        path = log_prev_path(ctx);
+        elem_type = LY_VLOG_NONE;
+    } else if ((elem_type != LY_VLOG_NONE) && !elem) {
+        /* top-level */
+        path = strdup("/");
+        elem_type = LY_VLOG_NONE;
+    } /* else the path is generated only if needed */
 
     va_start(ap, elem);
     /* path is spent and should not be freed! */
     switch (ecode) {
     case LYE_SPEC:
         fmt = va_arg(ap, char *);
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, fmt, ap);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, elem_type, elem, fmt, ap);
         break;
     case LYE_PATH:
-        assert(path);
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, NULL, ap);
+        assert(path || elem_type);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, elem_type, elem, NULL, ap);
         break;
     default:
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, ecode2vecode[ecode], path, ly_errs[ecode], ap);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, ecode2vecode[ecode], path, elem_type, elem, ly_errs[ecode], ap);
         break;
     }
     va_end(ap);
@@ -898,16 +1038,16 @@ ly_vlog_str(const struct ly_ctx *ctx, enum LY_VLOG_ELEM elem_type, const char *s
 {
     va_list ap;
     char *path = NULL, *fmt, *ptr;
-    const struct ly_err_item *first;
 
     assert((elem_type == LY_VLOG_NONE) || (elem_type == LY_VLOG_PREV));
 
+    if (log_is_ignored(LY_LLERR)) {
+        return;
+    }
+
     if (elem_type == LY_VLOG_PREV) {
         /* use previous path */
-        first = ly_err_first(ctx);
-        if (first && first->prev->path) {
-            path = strdup(first->prev->path);
-        }
+        path = log_prev_path(ctx);
     }
 
     if (strchr(str, '%')) {
@@ -924,7 +1064,7 @@ ly_vlog_str(const struct ly_ctx *ctx, enum LY_VLOG_ELEM elem_type, const char *s
 
     va_start(ap, str);
     /* path is spent and should not be freed! */
-    log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, fmt, ap);
+    log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, LY_VLOG_NONE, NULL, fmt, ap);
     va_end(ap);
 
     free(fmt);
@@ -1030,10 +1170,7 @@ ly_ilo_change(struct ly_ctx *ctx, enum int_log_opts new_ilo, enum int_log_opts *
     if (new_ilo == ILO_STORE) {
         /* only in this case the errors are only temporarily stored */
         assert(ctx && prev_last_eitem);
-        *prev_last_eitem = (struct ly_err_item *)ly_err_first(ctx);
-        if (*prev_last_eitem) {
-            *prev_last_eitem = (*prev_last_eitem)->prev;
-        }
+        *prev_last_eitem = log_last_eitem(ctx);
     }
 
     if (log_opt != ILO_IGNORE) {
@@ -1056,6 +1193,10 @@ ly_ilo_restore(struct ly_ctx *ctx, enum int_log_opts prev_ilo, struct ly_err_ite
 
     log_opt = prev_ilo;
     if (keep_and_print) {
+        if ((log_opt != ILO_STORE) && (log_opt != ILO_IGNORE) && ly_err_lazy_count) {
+            /* the errors are leaving the scope where their elements are guaranteed to exist */
+            ly_err_build_lazy_paths(ctx);
+        }
         err_print(ctx, prev_last_eitem);
     }
     err_clean(ctx, prev_last_eitem, keep_and_print);
@@ -1067,9 +1208,8 @@ ly_err_last_set_apptag(const struct ly_ctx *ctx, const char *apptag)
     struct ly_err_item *i;
 
     if (log_opt != ILO_IGNORE) {
-        i = ly_err_first(ctx);
+        i = log_last_eitem(ctx);
         if (i) {
-            i = i->prev;
             i->apptag = strdup(apptag);
         }
     }
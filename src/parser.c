@@ -27,6 +27,9 @@
 #include <unistd.h>
 #include <pcre.h>
 #include <time.h>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
 
 #include "common.h"
 #include "context.h"
@@ -239,6 +242,12 @@ lyp_data_check_options(struct ly_ctx *ctx, int options, const char *func)
         }
     }
 
+    if ((options & LYD_OPT_FILTER) && (x != LYD_OPT_GET) && (x != LYD_OPT_GETCONFIG)) {
+        LOGERR(ctx, LY_EINVAL, "%s: Invalid options 0x%x (LYD_OPT_FILTER can be used only with LYD_OPT_GET or LYD_OPT_GETCONFIG)",
+               func, options);
+        return 1;
+    }
+
     /* "is power of 2" algorithm, with 0 exception */
     if (x && !(x && !(x & (x - 1)))) {
         LOGERR(ctx, LY_EINVAL, "%s: Invalid options 0x%x (multiple data type flags set).", func, options);
@@ -1199,6 +1208,57 @@ ident_val_add_module_prefix(const char *value, const struct lyxml_elem *xml, str
     return lydict_insert_zc(ctx, str);
 }
 
+/**
+ * @brief Cheap lexical pre-check of a value for a union member type. Only the types with a simple
+ * lexical space are checked, the value may still turn out invalid for the others.
+ *
+ * @param[in] type Union member type.
+ * @param[in] value Value to check.
+ * @return 0 if the value can never be valid for the type (parsing it can be skipped), 1 otherwise.
+ */
+static int
+lyp_union_type_may_match(struct lys_type *type, const char *value)
+{
+    unsigned int i;
+
+    if (!value) {
+        /* let the full parser decide */
+        return 1;
+    }
+
+    switch (type->base) {
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        /* strtoll()/strtoull() skip leading whitespaces */
+        while (isspace(value[0])) {
+            ++value;
+        }
+        /* fallthrough */
+    case LY_TYPE_DEC64:
+        return isdigit(value[0]) || (value[0] == '-') || (value[0] == '+');
+    case LY_TYPE_BOOL:
+        return !strcmp(value, "true") || !strcmp(value, "false");
+    case LY_TYPE_EMPTY:
+        return !value[0];
+    case LY_TYPE_ENUM:
+        for (; !type->info.enums.count; type = &type->der->type);
+        for (i = 0; i < type->info.enums.count; ++i) {
+            if (!strcmp(value, type->info.enums.enm[i].name)) {
+                return 1;
+            }
+        }
+        return 0;
+    default:
+        return 1;
+    }
+}
+
 /*
  * xml  - optional for converting instance-identifier and identityref into JSON format
  * leaf - mandatory to know the context (necessary e.g. for prefixes in idenitytref values)
@@ -1254,7 +1314,10 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     /* fully clear the value */
     if (store) {
-        if (leaf) {
+        if (!(*val_flags & LY_VALUE_USER)) {
+            /* the string is needed only to free a user type value */
+            old_val_str = NULL;
+        } else if (leaf) {
             old_val_str = lydict_insert(ctx, leaf->value_str, 0);
         } else {
             old_val_str = lydict_insert(ctx, attr->value_str, 0);
@@ -1947,6 +2010,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
         while ((t = lyp_get_next_union_type(type, t, &found))) {
             found = 0;
+            if (!lyp_union_type_may_match(t, *value_)) {
+                /* do not even try to parse (and store) the value */
+                continue;
+            }
+
             ret = lyp_parse_value(t, value_, xml, leaf, attr, NULL, store, dflt);
             if (ret) {
                 /* we have the result */
@@ -3700,6 +3768,12 @@ lyp_ctx_add_module(struct lys_module *module)
     module->ctx->models.list[module->ctx->models.used++] = module;
     module->ctx->models.module_set_id++;
 
+    /* the module is complete, summarize its subtrees (and the ones it augments or deviates), order its nodes,
+     * and index the bases of its identities */
+    lys_summary_module(module);
+    lys_order_module(module);
+    resolve_identity_index(module);
+
     return 0;
 }
 
@@ -3836,6 +3910,105 @@ copyutf8(struct ly_ctx *ctx, char *dst, const char *src)
     }
 }
 
+/*
+ * The SSE2 scanners read the input in aligned 16-byte blocks. Such a block never crosses a page boundary, so reading
+ * past the terminating NUL byte within the block is safe, but address sanitizers would still report it.
+ */
+#if defined(__SSE2__) && defined(__GNUC__)
+#   define LY_SCAN_SIMD
+#   define LY_SCAN_ATTR __attribute__((no_sanitize_address))
+#else
+#   define LY_SCAN_ATTR
+#endif
+
+static inline int
+lyp_text_plain_char(unsigned char c, const char *stop, int ws)
+{
+    if ((c < 0x20) || (c > 0x7f)) {
+        return ws && ((c == 0x09) || (c == 0x0a) || (c == 0x0d));
+    }
+    return !strchr(stop, c);
+}
+
+LY_SCAN_ATTR size_t
+lyp_text_span(const char *text, const char *stop, int ws)
+{
+    const char *p = text;
+
+#ifdef LY_SCAN_SIMD
+    __m128i chunk, plain, stops, s1, s2, s3, s4, ctrl;
+    int bits;
+
+    /* get to an aligned block */
+    for (; (uintptr_t)p & 0xf; ++p) {
+        if (!lyp_text_plain_char(*p, stop, ws)) {
+            return p - text;
+        }
+    }
+
+    assert(strlen(stop) <= 4);
+    s1 = _mm_set1_epi8(stop[0]);
+    s2 = _mm_set1_epi8(stop[0] ? stop[1] : 0);
+    s3 = _mm_set1_epi8(stop[0] && stop[1] ? stop[2] : 0);
+    s4 = _mm_set1_epi8(stop[0] && stop[1] && stop[2] ? stop[3] : 0);
+    ctrl = _mm_set1_epi8(0x1f);
+    for (; ; p += 16) {
+        chunk = _mm_load_si128((const __m128i *)p);
+
+        /* signed comparison, non-ASCII bytes are negative */
+        plain = _mm_cmpgt_epi8(chunk, ctrl);
+        if (ws) {
+            plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x09)));
+            plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0a)));
+            plain = _mm_or_si128(plain, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0d)));
+        }
+        stops = _mm_or_si128(_mm_cmpeq_epi8(chunk, s1), _mm_cmpeq_epi8(chunk, s2));
+        stops = _mm_or_si128(stops, _mm_or_si128(_mm_cmpeq_epi8(chunk, s3), _mm_cmpeq_epi8(chunk, s4)));
+
+        bits = _mm_movemask_epi8(_mm_andnot_si128(stops, plain));
+        if (bits != 0xffff) {
+            return (p - text) + __builtin_ctz(~bits);
+        }
+    }
+#else
+    for (; lyp_text_plain_char(*p, stop, ws); ++p);
+    return p - text;
+#endif
+}
+
+LY_SCAN_ATTR size_t
+lyp_ws_span(const char *text)
+{
+    const char *p = text;
+
+#ifdef LY_SCAN_SIMD
+    __m128i chunk, ws;
+    int bits;
+
+    /* whitespace runs are usually short */
+    for (; ((uintptr_t)p & 0xf) || ((p - text) < 16); ++p) {
+        if ((*p != 0x20) && (*p != 0x09) && (*p != 0x0a) && (*p != 0x0d)) {
+            return p - text;
+        }
+    }
+
+    for (; ; p += 16) {
+        chunk = _mm_load_si128((const __m128i *)p);
+        ws = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x20)), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x09)));
+        ws = _mm_or_si128(ws, _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0a)),
+                                           _mm_cmpeq_epi8(chunk, _mm_set1_epi8(0x0d))));
+
+        bits = _mm_movemask_epi8(ws);
+        if (bits != 0xffff) {
+            return (p - text) + __builtin_ctz(~bits);
+        }
+    }
+#else
+    for (; (*p == 0x20) || (*p == 0x09) || (*p == 0x0a) || (*p == 0x0d); ++p);
+    return p - text;
+#endif
+}
+
 const struct lys_module *
 lyp_get_module(const struct lys_module *module, const char *prefix, int pref_len, const char *name, int name_len, int in_data)
 {
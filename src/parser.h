@@ -43,6 +43,12 @@ struct lys_submodule *yin_read_submodule(struct lys_module *module, const char *
  */
 struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options);
 
+/**
+ * @brief Parse XML data tree (#LYD_OPT_DATA and the like) splitting the top-level elements among several threads.
+ * Falls back to lyxml_parse_mem() and lyd_parse_xml() if the data cannot be split.
+ */
+struct lyd_node *lyd_parse_xml_parallel(struct ly_ctx *ctx, const char *data, int options, const struct ly_set *filter);
+
 /**@} xmldata */
 
 /**
@@ -50,7 +56,13 @@ struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options
  * @{
  */
 struct lyd_node *lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *rpc_act,
-                                const struct lyd_node *data_tree, const char *yang_data_name);
+                                const struct lyd_node *data_tree, const char *yang_data_name, const struct ly_set *filter);
+
+/**
+ * @brief Parse JSON data tree (#LYD_OPT_DATA and the like) splitting the top-level members among several threads.
+ * Falls back to lyd_parse_json() if the data cannot be split.
+ */
+struct lyd_node *lyd_parse_json_parallel(struct ly_ctx *ctx, const char *data, int options, const struct ly_set *filter);
 
 /**@} jsondata */
 
@@ -59,7 +71,7 @@ struct lyd_node *lyd_parse_json(struct ly_ctx *ctx, const char *data, int option
  * @{
  */
 struct lyd_node *lyd_parse_lyb(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *data_tree,
-                               const char *yang_data_name, int *parsed);
+                               const char *yang_data_name, const struct ly_set *filter, int *parsed);
 
 /**@} lybdata */
 
@@ -213,6 +225,26 @@ int lyp_munmap(void *addr, size_t length);
 unsigned int pututf8(struct ly_ctx *ctx, char *dst, int32_t value);
 unsigned int copyutf8(struct ly_ctx *ctx, char *dst, const char *src);
 
+/**
+ * @brief Get the length of the initial run of plain characters of a text. Plain characters are printable ASCII
+ * characters (and XML whitespaces if \p ws is set) except \p stop characters. Such runs need no further
+ * processing (validation, unescaping) by the parsers and can be copied at once.
+ *
+ * @param[in] text NUL-terminated text to scan.
+ * @param[in] stop Additional characters to stop at, at most 4.
+ * @param[in] ws Whether whitespaces (tab, line feed, carriage return) are plain characters.
+ * @return Number of plain characters at the beginning of \p text.
+ */
+size_t lyp_text_span(const char *text, const char *stop, int ws);
+
+/**
+ * @brief Get the length of the initial run of whitespaces (space, tab, line feed, carriage return) of a text.
+ *
+ * @param[in] text NUL-terminated text to scan.
+ * @return Number of whitespaces at the beginning of \p text.
+ */
+size_t lyp_ws_span(const char *text);
+
 /**
  * @brief Find a module. First, imports from \p module with matching \p prefix, \p name, or both are checked,
  * \p module itself is also compared, and lastly a callback is used if allowed.
@@ -264,6 +296,15 @@ struct lyext_plugin *ext_get_plugin(const char *name, const char *module, const
  */
 int lytype_store(const struct lys_module *mod, const char *type_name, const char **value_str, lyd_val *value);
 
+/**
+ * @brief Learn whether a type is a user type defined by a plugin.
+ *
+ * @param[in] mod Module of the type.
+ * @param[in] type_name Type (typedef) name.
+ * @return 1 if a plugin stores values of the type, 0 otherwise.
+ */
+int lytype_exists(const struct lys_module *mod, const char *type_name);
+
 /**
  * @brief Free a user type stored value.
  *
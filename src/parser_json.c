@@ -16,6 +16,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <limits.h>
+#include <stdarg.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,14 +47,8 @@ lyjson_isspace(int c)
 static unsigned int
 skip_ws(const char *data)
 {
-    unsigned int len = 0;
-
     /* skip leading whitespaces */
-    while (data[len] && lyjson_isspace(data[len])) {
-        len++;
-    }
-
-    return len;
+    return lyp_ws_span(data);
 }
 
 static char *
@@ -66,6 +61,16 @@ lyjson_parse_text(struct ly_ctx *ctx, const char *data, unsigned int *len)
     int o, size = 0;
     unsigned int r, i;
     int32_t value;
+    size_t span;
+
+    /* most strings are not escaped, use them directly */
+    span = lyp_text_span(data, "\"\\", 0);
+    if (data[span] == '"') {
+        *len = span;
+        result = strndup(data, span);
+        LY_CHECK_ERR_RETURN(!result, LOGMEM(ctx), NULL);
+        return result;
+    }
 
     for (*len = o = 0; data[*len] && data[*len] != '"'; o++) {
         if (o > BUFSIZE - 4) {
@@ -155,6 +160,14 @@ lyjson_parse_text(struct ly_ctx *ctx, const char *data, unsigned int *len)
             /* control characters must be escaped */
             LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "control character (unescaped)");
             goto error;
+        } else if ((span = lyp_text_span(&data[*len], "\"\\", 0))) {
+            /* copy a run of plain characters at once */
+            if (span > (size_t)(BUFSIZE - o)) {
+                span = BUFSIZE - o;
+            }
+            memcpy(&buf[o], &data[*len], span);
+            o += span - 1; /* o is ++ in for loop */
+            (*len) += span;
         } else {
             /* unescaped character */
             r = copyutf8(ctx, &buf[o], &data[*len]);
@@ -451,6 +464,19 @@ repeat:
     if (data[len] == '"') {
         /* string representations */
         ++len;
+        if (unres->pin && (leaf->value_type == LY_TYPE_STRING)
+                && (!stype->der || !stype->der->module || !lytype_exists(stype->der->module, stype->der->name))) {
+            /* the value is never changed by lyp_parse_value(), reference it directly in the pinned buffer
+             * terminated instead of the quotation-mark, if not escaped */
+            r = lyp_text_span(&data[len], "\"\\", 0);
+            if (data[len + r] == '"') {
+                ((char *)data)[len + r] = '\0';
+                leaf->value_str = &data[len];
+                lydict_pin_ref(ctx, unres->pin);
+                len += r + 1;
+                goto parse;
+            }
+        }
         str = lyjson_parse_text(ctx, &data[len], &r);
         if (!str) {
             LOGPATH(ctx, LY_VLOG_LYD, leaf);
@@ -509,6 +535,7 @@ inval:
         return 0;
     }
 
+parse:
     /* the value is here converted to a JSON format if needed in case of LY_TYPE_IDENT and LY_TYPE_INST or to a
      * canonical form of the value */
     if (!lyp_parse_value(&((struct lys_node_leaf *)leaf->schema)->type, &leaf->value_str, NULL, leaf, NULL, NULL, 1, 0)) {
@@ -785,17 +812,27 @@ static int
 json_skip_unknown(struct ly_ctx *ctx, struct lyd_node *parent, const char *data, unsigned int *len)
 {
     int qstr = 0;
+    int esc = 0;
     int objects = 0;
     int arrays = 0;
 
     while (data[*len]) {
+        if (qstr) {
+            /* skip the character after a backslash, an escaped backslash must not escape the closing quotation mark */
+            if (esc) {
+                esc = 0;
+            } else if (data[*len] == '\\') {
+                esc = 1;
+            } else if (data[*len] == '\"') {
+                qstr = 0;
+            }
+            (*len)++;
+            continue;
+        }
+
         switch (data[*len]) {
         case '\"':
-            if (qstr) {
-                if (data[(*len) - 1] != '\\')  {
-                    qstr = 0;
-                }
-            } else if (data[(*len) - 1] != '\\') {
+            if (data[(*len) - 1] != '\\') {
                 qstr = 1;
             } else {
                 LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent, "JSON data (missing quotation mark for a string data) ");
@@ -803,27 +840,19 @@ json_skip_unknown(struct ly_ctx *ctx, struct lyd_node *parent, const char *data,
             }
             break;
         case '[':
-            if (!qstr) {
-                arrays++;
-            }
+            arrays++;
             break;
         case '{':
-            if (!qstr) {
-                objects++;
-            }
+            objects++;
             break;
         case ']':
-            if (!qstr) {
-                arrays--;
-            }
+            arrays--;
             break;
         case '}':
-            if (!qstr) {
-                objects--;
-            }
+            objects--;
             break;
         case ',':
-            if (!qstr && !objects && !arrays) {
+            if (!objects && !arrays) {
                 /* do not eat the comma character */
                 return 0;
             }
@@ -849,55 +878,55 @@ json_skip_unknown(struct ly_ctx *ctx, struct lyd_node *parent, const char *data,
     return 0;
 }
 
+/**
+ * @brief Parse the name of a JSON member up to the beginning of its value.
+ * @param[in] ctx libyang context.
+ * @param[in] parent Data parent of the member for logging.
+ * @param[in] data Input data pointing to the member's opening quotation mark.
+ * @param[out] str Allocated member name, the caller is supposed to free it.
+ * @param[out] prefix Prefix of the member name pointing into \p str, NULL if there is none.
+ * @param[out] name Member name without the prefix and the attribute mark pointing into \p str.
+ * @return Number of bytes up to the member value, 0 on error.
+ */
 static unsigned int
-json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent, struct lyd_node **parent,
-                struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs, int options,
-                struct unres_data *unres, struct lyd_node **act_notif, const char *yang_data_name)
+json_parse_name(struct ly_ctx *ctx, struct lyd_node *parent, const char *data, char **str, char **prefix, char **name)
 {
-    unsigned int len = 0;
-    unsigned int r;
-    unsigned int flag_leaflist = 0;
-    int i;
-    uint8_t pos;
-    char *name, *prefix = NULL, *str = NULL;
-    const struct lys_module *module = NULL;
-    struct lys_node *schema = NULL;
-    const struct lys_node *sparent = NULL;
-    struct lyd_node *result = NULL, *new, *list, *diter = NULL;
-    struct lyd_attr *attr;
-    struct attr_cont *attrs_aux;
+    unsigned int len = 0, r;
+
+    *str = NULL;
+    *prefix = NULL;
 
     /* each YANG data node representation starts with string (node identifier) */
     if (data[len] != '"') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent),
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent,
                "JSON data (missing quotation-mark at the beginning of string)");
         return 0;
     }
     len++;
 
-    str = lyjson_parse_text(ctx, &data[len], &r);
-    if (!str) {
-        goto error;
+    *str = lyjson_parse_text(ctx, &data[len], &r);
+    if (!*str) {
+        return 0;
     }
 
     if (!r) {
         goto error;
     } else if (data[len + r] != '"') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent),
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent,
                "JSON data (missing quotation-mark at the end of string)");
         goto error;
     }
-    if ((name = strchr(str, ':'))) {
-        *name = '\0';
-        name++;
-        prefix = str;
-        if (prefix[0] == '@') {
-            prefix++;
+    if ((*name = strchr(*str, ':'))) {
+        **name = '\0';
+        (*name)++;
+        *prefix = *str;
+        if ((*prefix)[0] == '@') {
+            (*prefix)++;
         }
     } else {
-        name = str;
-        if (name[0] == '@') {
-            name++;
+        *name = *str;
+        if ((*name)[0] == '@') {
+            (*name)++;
         }
     }
 
@@ -905,46 +934,40 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
     len += r + 1;
     len += skip_ws(&data[len]);
     if (data[len] != ':') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent), "JSON data (missing name-separator)");
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent, "JSON data (missing name-separator)");
         goto error;
     }
     len++;
     len += skip_ws(&data[len]);
 
-    if (str[0] == '@' && !str[1]) {
-        /* process attribute of the parent object (container or list) */
-        if (!(*parent)) {
-            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "attribute with no corresponding element to belongs to");
-            goto error;
-        }
-
-        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], options);
-        if (!r) {
-            LOGPATH(ctx, LY_VLOG_LYD, *parent);
-            goto error;
-        }
-        len += r;
-
-        if ((*parent)->attr) {
-            lyd_free_attr(ctx, NULL, attr, 1);
-        } else {
-            (*parent)->attr = attr;
-            for (; attr; attr = attr->next) {
-                attr->parent = *parent;
-            }
-        }
+    return len;
 
-        /* check edit-config attribute correctness */
-        if ((options & LYD_OPT_EDIT) && lyp_check_edit_attr(ctx, (*parent)->attr, *parent, NULL)) {
-            goto error;
-        }
+error:
+    free(*str);
+    *str = NULL;
+    return 0;
+}
 
-        free(str);
-        return len;
-    }
+/**
+ * @brief Find the schema node of a JSON member.
+ * @param[in] ctx libyang context.
+ * @param[in] parent Data parent of the member, NULL for a top-level member.
+ * @param[in] schema_parent Schema parent to search in instead of the \p parent's schema.
+ * @param[in] prefix Member name prefix (module name), may be NULL.
+ * @param[in] name Member name.
+ * @param[in] options Parser options.
+ * @param[in] yang_data_name Name of the yang-data template for top-level members.
+ * @return Found schema node, NULL if not found.
+ */
+static struct lys_node *
+json_find_schema(struct ly_ctx *ctx, struct lyd_node *parent, const struct lys_node *schema_parent, const char *prefix,
+                 const char *name, int options, const char *yang_data_name)
+{
+    const struct lys_module *module;
+    const struct lys_node *sparent;
+    struct lys_node *schema = NULL;
 
-    /* find schema node */
-    if (!(*parent)) {
+    if (!parent) {
         /* starting in root */
         /* get the proper schema */
         module = ly_ctx_get_module(ctx, prefix, NULL, 0);
@@ -990,8 +1013,8 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
         }
 
         /* go through RPC's input/output following the options' data type */
-        if ((*parent)->schema->nodetype == LYS_RPC || (*parent)->schema->nodetype == LYS_ACTION) {
-            while ((schema = (struct lys_node *)lys_getnext(schema, (*parent)->schema, NULL, LYS_GETNEXT_WITHINOUT))) {
+        if (parent->schema->nodetype == LYS_RPC || parent->schema->nodetype == LYS_ACTION) {
+            while ((schema = (struct lys_node *)lys_getnext(schema, parent->schema, NULL, LYS_GETNEXT_WITHINOUT))) {
                 if ((options & LYD_OPT_RPC) && (schema->nodetype == LYS_INPUT)) {
                     break;
                 } else if ((options & LYD_OPT_RPCREPLY) && (schema->nodetype == LYS_OUTPUT)) {
@@ -1011,73 +1034,37 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
                 }
             }
         } else {
-            while ((schema = (struct lys_node *)lys_getnext(schema, (*parent)->schema, NULL, 0))) {
+            while ((schema = (struct lys_node *)lys_getnext(schema, parent->schema, NULL, 0))) {
                 if (!strcmp(schema->name, name)
                         && ((prefix && !strcmp(lys_node_module(schema)->name, prefix))
-                        || (!prefix && (lys_node_module(schema) == lyd_node_module(*parent))))) {
+                        || (!prefix && (lys_node_module(schema) == lyd_node_module(parent))))) {
                     break;
                 }
             }
         }
     }
 
-    module = lys_node_module(schema);
-    if (!module || !module->implemented || module->disabled) {
-        if (options & LYD_OPT_STRICT) {
-            LOGVAL(ctx, LYE_INELEM, (*parent ? LY_VLOG_LYD : LY_VLOG_NONE), (*parent), name);
-            goto error;
-        } else {
-            if (json_skip_unknown(ctx, *parent, data, &len)) {
-                goto error;
-            }
-            free(str);
-            return len;
-        }
-    }
-
-    if (str[0] == '@') {
-        /* attribute for some sibling node */
-        if (data[len] == '[') {
-            flag_leaflist = 1;
-            len++;
-            len += skip_ws(&data[len]);
-        }
-
-attr_repeat:
-        r = json_parse_attr((struct lys_module *)module, &attr, &data[len], options);
-        if (!r) {
-            LOGPATH(ctx, LY_VLOG_LYD, (*parent));
-            goto error;
-        }
-        len += r;
-
-        if (attr) {
-            attrs_aux = malloc(sizeof *attrs_aux);
-            LY_CHECK_ERR_GOTO(!attrs_aux, LOGMEM(ctx), error);
-            attrs_aux->attr = attr;
-            attrs_aux->index = flag_leaflist;
-            attrs_aux->schema = schema;
-            attrs_aux->next = *attrs;
-            *attrs = attrs_aux;
-        }
 
-        if (flag_leaflist) {
-            if (data[len] == ',') {
-                len++;
-                len += skip_ws(&data[len]);
-                flag_leaflist++;
-                goto attr_repeat;
-            } else if (data[len] != ']') {
-                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent), "JSON data (missing end-array)");
-                goto error;
-            }
-            len++;
-            len += skip_ws(&data[len]);
-        }
+    return schema;
+}
 
-        free(str);
-        return len;
-    }
+/**
+ * @brief Create a data node for a JSON member and link it as the last child of \p parent
+ * (or at its proper position in case of a list key).
+ * @param[in] ctx libyang context.
+ * @param[in] schema Schema node of the new data node.
+ * @param[in] parent Data parent, NULL for a top-level node.
+ * @param[in,out] first_sibling First sibling of the new node, updated when the new node becomes the first one.
+ * @param[in] prev Current last sibling, NULL if there are no siblings.
+ * @return Created node, NULL on error.
+ */
+static struct lyd_node *
+json_new_node(struct ly_ctx *ctx, struct lys_node *schema, struct lyd_node *parent, struct lyd_node **first_sibling,
+              struct lyd_node *prev)
+{
+    struct lyd_node *result, *diter = NULL;
+    uint8_t pos;
+    int i;
 
     switch (schema->nodetype) {
     case LYS_CONTAINER:
@@ -1097,26 +1084,25 @@ attr_repeat:
         break;
     default:
         LOGINT(ctx);
-        goto error;
+        return NULL;
     }
-    LY_CHECK_ERR_GOTO(!result, LOGMEM(ctx), error);
+    LY_CHECK_ERR_RETURN(!result, LOGMEM(ctx), NULL);
 
     result->prev = result;
     result->schema = schema;
-    result->parent = *parent;
-    diter = NULL;
+    result->parent = parent;
     if (schema->nodetype == LYS_LEAF && lys_is_key((struct lys_node_leaf *)schema, &pos)) {
         /* it is key and we need to insert it into a correct place (we must have parent then, a key cannot be top-level) */
-        assert(*parent);
-        for (i = 0, diter = (*parent)->child;
+        assert(parent);
+        for (i = 0, diter = parent->child;
                 diter && i < pos && diter->schema->nodetype == LYS_LEAF && lys_is_key((struct lys_node_leaf *)diter->schema, NULL);
                 i++, diter = diter->next);
         if (diter) {
             /* out of order insertion - insert list's key to the correct position, before the diter */
-            if ((*parent)->child == diter) {
-                (*parent)->child = result;
+            if (parent->child == diter) {
+                parent->child = result;
                 /* update first_sibling */
-                first_sibling = result;
+                *first_sibling = result;
             }
             if (diter->prev->next) {
                 diter->prev->next = result;
@@ -1128,18 +1114,18 @@ attr_repeat:
     }
     if (!diter) {
         /* simplified (faster) insert as the last node */
-        if (*parent && !(*parent)->child) {
-            (*parent)->child = result;
+        if (parent && !parent->child) {
+            parent->child = result;
         }
         if (prev) {
             result->prev = prev;
             prev->next = result;
 
             /* fix the "last" pointer */
-            first_sibling->prev = result;
+            (*first_sibling)->prev = result;
         } else {
             result->prev = result;
-            first_sibling = result;
+            *first_sibling = result;
         }
     }
     result->validity = ly_new_node_validity(result->schema);
@@ -1147,81 +1133,233 @@ attr_repeat:
         result->when_status = LYD_WHEN;
     }
 
-    /* type specific processing */
-    switch (schema->nodetype) {
-    case LYS_LEAF:
-    case LYS_LEAFLIST:
-        /* type detection and assigning the value */
-        r = json_get_value((struct lyd_node_leaf_list *)result, &first_sibling, &data[len], options, unres);
-        if (!r) {
-            goto error;
-        }
-        /* only for leaf-list */
-        while (result->next && (result->next->schema == result->schema)) {
-            result = result->next;
-        }
+    return result;
+}
 
-        len += r;
-        len += skip_ws(&data[len]);
-        break;
-    case LYS_ANYDATA:
-    case LYS_ANYXML:
-        r = json_get_anydata((struct lyd_node_anydata *)result, &data[len]);
-        if (!r) {
-            goto error;
+/**
+ * @brief Check that an inner node (container, RPC, action, notification) may appear in the data
+ * and insert it into its parent's hash table.
+ * @param[in] result Created inner node.
+ * @param[in] options Parser options.
+ * @param[in,out] act_notif Action/notification node found so far.
+ * @return 0 on success, -1 on error.
+ */
+static int
+json_open_inner(struct lyd_node *result, int options, struct lyd_node **act_notif)
+{
+    struct ly_ctx *ctx = result->schema->module->ctx;
+    struct lys_node *schema = result->schema;
+
+    if (schema->nodetype & (LYS_RPC | LYS_ACTION)) {
+        if (!(options & LYD_OPT_RPC) || *act_notif) {
+            LOGVAL(ctx, LYE_INELEM, LY_VLOG_LYD, result, schema->name);
+            LOGVAL(ctx, LYE_SPEC, LY_VLOG_PREV, NULL, "Unexpected %s node \"%s\".",
+                   (schema->nodetype == LYS_RPC ? "rpc" : "action"), schema->name);
+            return -1;
+        }
+        *act_notif = result;
+    } else if (schema->nodetype == LYS_NOTIF) {
+        if (!(options & LYD_OPT_NOTIF) || *act_notif) {
+            LOGVAL(ctx, LYE_INELEM, LY_VLOG_LYD, result, schema->name);
+            LOGVAL(ctx, LYE_SPEC, LY_VLOG_PREV, NULL, "Unexpected notification node \"%s\".", schema->name);
+            return -1;
         }
+        *act_notif = result;
+    }
 
 #ifdef LY_ENABLED_CACHE
-        /* calculate the hash and insert it into parent */
-        lyd_hash(result);
-        lyd_insert_hash(result);
+    /* calculate the hash and insert it into parent */
+    lyd_hash(result);
+    lyd_insert_hash(result);
 #endif
 
+    return 0;
+}
+
+static unsigned int
+json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent, struct lyd_node **parent,
+                struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs, int options,
+                struct unres_data *unres, struct lyd_node **act_notif, const char *yang_data_name)
+{
+    unsigned int len = 0;
+    unsigned int r;
+    unsigned int flag_leaflist = 0;
+    int i;
+    char *name, *prefix = NULL, *str = NULL;
+    const struct lys_module *module = NULL;
+    struct lys_node *schema = NULL;
+    struct lyd_node *result = NULL, *new, *list, *diter = NULL;
+    struct lyd_attr *attr;
+    struct attr_cont *attrs_aux;
+
+    len = json_parse_name(ctx, *parent, data, &str, &prefix, &name);
+    if (!len) {
+        goto error;
+    }
+
+    if (str[0] == '@' && !str[1]) {
+        /* process attribute of the parent object (container or list) */
+        if (!(*parent)) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "attribute with no corresponding element to belongs to");
+            goto error;
+        }
+
+        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], options);
+        if (!r) {
+            LOGPATH(ctx, LY_VLOG_LYD, *parent);
+            goto error;
+        }
         len += r;
-        len += skip_ws(&data[len]);
-        break;
-    case LYS_CONTAINER:
-    case LYS_RPC:
-    case LYS_ACTION:
-    case LYS_NOTIF:
-        if (schema->nodetype & (LYS_RPC | LYS_ACTION)) {
-            if (!(options & LYD_OPT_RPC) || *act_notif) {
-                LOGVAL(ctx, LYE_INELEM, LY_VLOG_LYD, result, schema->name);
-                LOGVAL(ctx, LYE_SPEC, LY_VLOG_PREV, NULL, "Unexpected %s node \"%s\".",
-                       (schema->nodetype == LYS_RPC ? "rpc" : "action"), schema->name);
-                goto error;
-            }
-            *act_notif = result;
-        } else if (schema->nodetype == LYS_NOTIF) {
-            if (!(options & LYD_OPT_NOTIF) || *act_notif) {
-                LOGVAL(ctx, LYE_INELEM, LY_VLOG_LYD, result, schema->name);
-                LOGVAL(ctx, LYE_SPEC, LY_VLOG_PREV, NULL, "Unexpected notification node \"%s\".", schema->name);
-                goto error;
+
+        if ((*parent)->attr) {
+            lyd_free_attr(ctx, NULL, attr, 1);
+        } else {
+            (*parent)->attr = attr;
+            for (; attr; attr = attr->next) {
+                attr->parent = *parent;
             }
-            *act_notif = result;
         }
 
-#ifdef LY_ENABLED_CACHE
-        /* calculate the hash and insert it into parent */
-        lyd_hash(result);
-        lyd_insert_hash(result);
-#endif
-
-        if (data[len] != '{') {
-            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, result, "JSON data (missing begin-object)");
+        /* check edit-config attribute correctness */
+        if ((options & LYD_OPT_EDIT) && lyp_check_edit_attr(ctx, (*parent)->attr, *parent, NULL)) {
             goto error;
         }
-        len++;
-        len += skip_ws(&data[len]);
-
-        if (data[len] != '}') {
-            /* non-empty container */
-            len--;
-            diter = NULL;
-            attrs_aux = NULL;
-            do {
-                len++;
-                len += skip_ws(&data[len]);
+
+        free(str);
+        return len;
+    }
+
+    /* find schema node */
+    schema = json_find_schema(ctx, *parent, schema_parent, prefix, name, options, yang_data_name);
+
+    module = lys_node_module(schema);
+    if (!module || !module->implemented || module->disabled) {
+        if (options & LYD_OPT_STRICT) {
+            LOGVAL(ctx, LYE_INELEM, (*parent ? LY_VLOG_LYD : LY_VLOG_NONE), (*parent), name);
+            goto error;
+        } else {
+            if (json_skip_unknown(ctx, *parent, data, &len)) {
+                goto error;
+            }
+            free(str);
+            return len;
+        }
+    }
+
+    if (unres->filter && lyd_filter_skip(unres->filter, schema)) {
+        /* not selected, skip the node (or its attributes) */
+        if (json_skip_unknown(ctx, *parent, data, &len)) {
+            goto error;
+        }
+        free(str);
+        return len;
+    }
+
+    if (str[0] == '@') {
+        /* attribute for some sibling node */
+        if (data[len] == '[') {
+            flag_leaflist = 1;
+            len++;
+            len += skip_ws(&data[len]);
+        }
+
+attr_repeat:
+        r = json_parse_attr((struct lys_module *)module, &attr, &data[len], options);
+        if (!r) {
+            LOGPATH(ctx, LY_VLOG_LYD, (*parent));
+            goto error;
+        }
+        len += r;
+
+        if (attr) {
+            attrs_aux = malloc(sizeof *attrs_aux);
+            LY_CHECK_ERR_GOTO(!attrs_aux, LOGMEM(ctx), error);
+            attrs_aux->attr = attr;
+            attrs_aux->index = flag_leaflist;
+            attrs_aux->schema = schema;
+            attrs_aux->next = *attrs;
+            *attrs = attrs_aux;
+        }
+
+        if (flag_leaflist) {
+            if (data[len] == ',') {
+                len++;
+                len += skip_ws(&data[len]);
+                flag_leaflist++;
+                goto attr_repeat;
+            } else if (data[len] != ']') {
+                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent), "JSON data (missing end-array)");
+                goto error;
+            }
+            len++;
+            len += skip_ws(&data[len]);
+        }
+
+        free(str);
+        return len;
+    }
+
+    result = json_new_node(ctx, schema, *parent, &first_sibling, prev);
+    if (!result) {
+        goto error;
+    }
+
+    /* type specific processing */
+    switch (schema->nodetype) {
+    case LYS_LEAF:
+    case LYS_LEAFLIST:
+        /* type detection and assigning the value */
+        r = json_get_value((struct lyd_node_leaf_list *)result, &first_sibling, &data[len], options, unres);
+        if (!r) {
+            goto error;
+        }
+        /* only for leaf-list */
+        while (result->next && (result->next->schema == result->schema)) {
+            result = result->next;
+        }
+
+        len += r;
+        len += skip_ws(&data[len]);
+        break;
+    case LYS_ANYDATA:
+    case LYS_ANYXML:
+        r = json_get_anydata((struct lyd_node_anydata *)result, &data[len]);
+        if (!r) {
+            goto error;
+        }
+
+#ifdef LY_ENABLED_CACHE
+        /* calculate the hash and insert it into parent */
+        lyd_hash(result);
+        lyd_insert_hash(result);
+#endif
+
+        len += r;
+        len += skip_ws(&data[len]);
+        break;
+    case LYS_CONTAINER:
+    case LYS_RPC:
+    case LYS_ACTION:
+    case LYS_NOTIF:
+        if (json_open_inner(result, options, act_notif)) {
+            goto error;
+        }
+
+        if (data[len] != '{') {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, result, "JSON data (missing begin-object)");
+            goto error;
+        }
+        len++;
+        len += skip_ws(&data[len]);
+
+        if (data[len] != '}') {
+            /* non-empty container */
+            len--;
+            diter = NULL;
+            attrs_aux = NULL;
+            do {
+                len++;
+                len += skip_ws(&data[len]);
 
                 r = json_parse_data(ctx, &data[len], NULL, &result, result->child, diter, &attrs_aux, options, unres, act_notif, yang_data_name);
                 if (!r) {
@@ -1390,9 +1528,130 @@ error:
     return 0;
 }
 
+/**
+ * @brief Create the RPC/action reply part that is not present in the parsed data.
+ * @param[in] ctx libyang context.
+ * @param[in] rpc_act RPC or action request the reply belongs to.
+ * @param[out] reply_top Top-level node of the created reply tree.
+ * @param[out] reply_parent RPC or action node to which the reply data belong.
+ * @return 0 on success, -1 on error.
+ */
+static int
+json_reply_parent(struct ly_ctx *ctx, const struct lyd_node *rpc_act, struct lyd_node **reply_top,
+                  struct lyd_node **reply_parent)
+{
+    struct lyd_node *iter;
+
+    if (rpc_act->schema->nodetype == LYS_RPC) {
+        /* RPC request */
+        *reply_top = *reply_parent = _lyd_new(NULL, rpc_act->schema, 0);
+    } else {
+        /* action request */
+        *reply_top = lyd_dup(rpc_act, 1);
+        LY_TREE_DFS_BEGIN(*reply_top, iter, *reply_parent) {
+            if ((*reply_parent)->schema->nodetype == LYS_ACTION) {
+                break;
+            }
+            LY_TREE_DFS_END(*reply_top, iter, *reply_parent);
+        }
+        if (!*reply_parent) {
+            LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
+            return -1;
+        }
+        lyd_free_withsiblings((*reply_parent)->child);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Finish parsing of the whole JSON document - store top-level attributes, add default nodes and perform
+ * the checks requiring all the top-level nodes.
+ * @param[in] ctx libyang context.
+ * @param[in,out] result First top-level node of the parsed data, replaced by \p reply_top if set.
+ * @param[in] reply_top Top-level node of the RPC/action reply tree, if any.
+ * @param[in] reply_parent RPC/action node of the reply tree, if any.
+ * @param[in] rpc_act RPC/action request for an RPC reply.
+ * @param[in] data_tree Additional data tree for resolving references.
+ * @param[in] act_notif Parsed action/notification node, if any.
+ * @param[in] attrs Top-level attributes to be stored, always consumed.
+ * @param[in] unres Unresolved data items.
+ * @param[in] options Parser options.
+ * @return 0 on success, -1 on error.
+ */
+static int
+json_parse_end(struct ly_ctx *ctx, struct lyd_node **result, struct lyd_node *reply_top, struct lyd_node *reply_parent,
+               const struct lyd_node *rpc_act, const struct lyd_node *data_tree, struct lyd_node *act_notif,
+               struct attr_cont *attrs, struct unres_data *unres, int options)
+{
+    struct lyd_node *iter;
+
+    /* store attributes */
+    if (store_attrs(ctx, attrs, *result, options)) {
+        return -1;
+    }
+
+    if (reply_top) {
+        *result = reply_top;
+    }
+
+    if (!*result && (options & LYD_OPT_STRICT)) {
+        LOGERR(ctx, LY_EVALID, "Model for the data to be linked with not found.");
+        return -1;
+    }
+
+    /* order the elements by hand as it is not required of the JSON input */
+    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY))) {
+        if (lyd_schema_sort(*result, 1)) {
+            return -1;
+        }
+    }
+
+    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
+        /* action reply */
+        act_notif = reply_parent;
+    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
+        LOGVAL(ctx, LYE_MISSELEM, LY_VLOG_LYD, *result, (options & LYD_OPT_RPC ? "action" : "notification"), (*result)->schema->name);
+        return -1;
+    }
+
+    /* add missing ietf-yang-library if requested */
+    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+        if (lyd_merge(*result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
+            LOGERR(ctx, LY_EINT, "Adding ietf-yang-library data failed.");
+            return -1;
+        }
+    }
+
+    /* check for uniquness of top-level lists/leaflists because
+     * only the inner instances were tested in lyv_data_content() */
+    LY_TREE_FOR(*result, iter) {
+        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_DUP)) {
+            continue;
+        }
+
+        if (lyv_data_dup(iter, *result)) {
+            return -1;
+        }
+    }
+
+    /* add/validate default values, unres */
+    if (lyd_defaults_add_unres(result, options, ctx, NULL, 0, data_tree, act_notif, unres, 1)) {
+        return -1;
+    }
+
+    /* check for missing top level mandatory nodes */
+    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
+            && lyd_check_mandatory_tree((act_notif ? act_notif : *result), ctx, NULL, 0, options)) {
+        return -1;
+    }
+
+    return 0;
+}
+
 struct lyd_node *
 lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *rpc_act,
-               const struct lyd_node *data_tree, const char *yang_data_name)
+               const struct lyd_node *data_tree, const char *yang_data_name, const struct ly_set *filter)
 {
     struct lyd_node *result = NULL, *next, *iter, *reply_parent = NULL, *reply_top = NULL, *act_notif = NULL;
     struct unres_data *unres = NULL;
@@ -1427,27 +1686,16 @@ lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct l
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_RETURN(!unres, LOGMEM(ctx), NULL);
+    if (options & LYD_OPT_PIN_INPUT) {
+        unres->pin = lydict_pin_find(ctx, data);
+    }
+    unres->filter = filter;
 
     /* create RPC/action reply part that is not in the parsed data */
     if (rpc_act) {
         assert(options & LYD_OPT_RPCREPLY);
-        if (rpc_act->schema->nodetype == LYS_RPC) {
-            /* RPC request */
-            reply_top = reply_parent = _lyd_new(NULL, rpc_act->schema, 0);
-        } else {
-            /* action request */
-            reply_top = lyd_dup(rpc_act, 1);
-            LY_TREE_DFS_BEGIN(reply_top, iter, reply_parent) {
-                if (reply_parent->schema->nodetype == LYS_ACTION) {
-                    break;
-                }
-                LY_TREE_DFS_END(reply_top, iter, reply_parent);
-            }
-            if (!reply_parent) {
-                LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
-                goto error;
-            }
-            lyd_free_withsiblings(reply_parent->child);
+        if (json_reply_parent(ctx, rpc_act, &reply_top, &reply_parent)) {
+            goto error;
         }
     }
 
@@ -1524,63 +1772,7 @@ lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct l
         len += skip_ws(&data[len]);
     }
 
-    /* store attributes */
-    if (store_attrs(ctx, attrs, result, options)) {
-        goto error;
-    }
-
-    if (reply_top) {
-        result = reply_top;
-    }
-
-    if (!result && (options & LYD_OPT_STRICT)) {
-        LOGERR(ctx, LY_EVALID, "Model for the data to be linked with not found.");
-        goto error;
-    }
-
-    /* order the elements by hand as it is not required of the JSON input */
-    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY))) {
-        if (lyd_schema_sort(result, 1)) {
-            goto error;
-        }
-    }
-
-    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
-        /* action reply */
-        act_notif = reply_parent;
-    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
-        LOGVAL(ctx, LYE_MISSELEM, LY_VLOG_LYD, result, (options & LYD_OPT_RPC ? "action" : "notification"), result->schema->name);
-        goto error;
-    }
-
-    /* add missing ietf-yang-library if requested */
-    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
-        if (lyd_merge(result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
-            LOGERR(ctx, LY_EINT, "Adding ietf-yang-library data failed.");
-            goto error;
-        }
-    }
-
-    /* check for uniquness of top-level lists/leaflists because
-     * only the inner instances were tested in lyv_data_content() */
-    LY_TREE_FOR(result, iter) {
-        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_DUP)) {
-            continue;
-        }
-
-        if (lyv_data_dup(iter, result)) {
-            goto error;
-        }
-    }
-
-    /* add/validate default values, unres */
-    if (lyd_defaults_add_unres(&result, options, ctx, NULL, 0, data_tree, act_notif, unres, 1)) {
-        goto error;
-    }
-
-    /* check for missing top level mandatory nodes */
-    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
-            && lyd_check_mandatory_tree((act_notif ? act_notif : result), ctx, NULL, 0, options)) {
+    if (json_parse_end(ctx, &result, reply_top, reply_parent, rpc_act, data_tree, act_notif, attrs, unres, options)) {
         goto error;
     }
 
@@ -1601,3 +1793,995 @@ error:
 
     return NULL;
 }
+
+/**
+ * @brief Find the end of a JSON value (or a string) without parsing it.
+ * @param[in] data Input data pointing to the beginning of the value.
+ * @return Length of the value, 0 if the value is not terminated.
+ */
+static unsigned int
+json_value_span(const char *data)
+{
+    unsigned int len;
+    int depth = 0;
+
+    for (len = 0; data[len]; ++len) {
+        switch (data[len]) {
+        case '"':
+            for (++len; data[len] && (data[len] != '"'); len += ((data[len] == '\\') && data[len + 1]) ? 2 : 1);
+            if (!data[len]) {
+                return 0;
+            } else if (!depth) {
+                return len + 1;
+            }
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (!depth) {
+                /* end of a literal */
+                return len;
+            } else if (!--depth) {
+                return len + 1;
+            }
+            break;
+        case ',':
+            if (!depth) {
+                return len;
+            }
+            break;
+        default:
+            if (!depth && lyjson_isspace(data[len])) {
+                return len;
+            }
+            break;
+        }
+    }
+
+    return depth ? 0 : len;
+}
+
+/* top-level members of a JSON document parsed by a single thread */
+struct json_part {
+    unsigned int start;         /* offset of the first member */
+    unsigned int end;           /* offset of the value-separator or end-object following the last member */
+    struct lyd_node *first;     /* parsed top-level nodes */
+    struct attr_cont *attrs;    /* attributes of the top-level nodes */
+    struct unres_data unres;
+    LY_ERR err;
+    struct ly_err_item *eitems; /* errors of the parsing thread */
+};
+
+struct json_parallel {
+    struct ly_ctx *ctx;
+    const char *data;
+    int options;
+    enum int_log_opts log_opt;
+    struct dict_pin *pin;
+    const struct ly_set *filter;
+    struct json_part *parts;
+};
+
+static void
+json_parse_part(void *arg, unsigned int idx)
+{
+    struct json_parallel *par = arg;
+    struct json_part *part = &par->parts[idx];
+    struct ly_ctx *ctx = par->ctx;
+    struct lyd_node *next, *iter, *last = NULL, *act_notif = NULL;
+    struct ly_err_item *eitem;
+    unsigned int len = part->start, r;
+
+    log_opt = par->log_opt;
+    eitem = ly_err_first(ctx);
+    eitem = eitem ? eitem->prev : NULL;
+    ly_errno = LY_SUCCESS;
+    part->unres.pin = par->pin;
+    part->unres.filter = par->filter;
+
+    while (1) {
+        next = NULL;
+        r = json_parse_data(ctx, &par->data[len], NULL, &next, part->first, last, &part->attrs, par->options,
+                            &part->unres, &act_notif, NULL);
+        if (!r) {
+            goto error;
+        }
+        len += r;
+
+        if (!part->first) {
+            for (iter = next; iter && iter->prev->next; iter = iter->prev);
+            part->first = iter;
+        }
+        last = part->first ? part->first->prev : NULL;
+
+        if (len >= part->end) {
+            break;
+        } else if (par->data[len] != ',') {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top-level end-object)");
+            goto error;
+        }
+        ++len;
+        len += skip_ws(&par->data[len]);
+    }
+
+    part->err = ly_errno;
+    part->eitems = ly_err_detach(ctx, eitem);
+    return;
+
+error:
+    part->err = ly_errno ? ly_errno : LY_EVALID;
+    part->eitems = ly_err_detach(ctx, eitem);
+}
+
+struct lyd_node *
+lyd_parse_json_parallel(struct ly_ctx *ctx, const char *data, int options, const struct ly_set *filter)
+{
+    struct json_parallel par;
+    struct json_part *part = NULL;
+    struct lyd_node *result = NULL, *iter;
+    struct attr_cont *attrs = NULL, **attrs_last = &attrs, *attrs_aux;
+    struct unres_data unres;
+    unsigned int len, r, total, count = 0, i;
+    LY_ERR err = LY_SUCCESS;
+
+    if (lyp_data_check_options(ctx, options, __func__)) {
+        return NULL;
+    }
+
+    memset(&par, 0, sizeof par);
+    memset(&unres, 0, sizeof unres);
+
+    if (ctx->data_clb) {
+        /* the callback may change the context */
+        goto sequential;
+    }
+
+    /* expect top-level { with some members */
+    len = skip_ws(data);
+    if (data[len] != '{') {
+        goto sequential;
+    }
+    ++len;
+    len += skip_ws(&data[len]);
+    if ((data[len] != '"') || !strncmp(&data[len], "\"yang:action\"", 13)) {
+        goto sequential;
+    }
+
+    /* find the top-level members and split them into parts of a similar size */
+    total = strlen(&data[len]);
+    while (1) {
+        i = len;
+        if (data[len] != '"') {
+            goto sequential;
+        }
+        if (!(r = json_value_span(&data[len]))) {
+            goto sequential;
+        }
+        len += r;
+        len += skip_ws(&data[len]);
+        if (data[len] != ':') {
+            goto sequential;
+        }
+        ++len;
+        len += skip_ws(&data[len]);
+        if (!(r = json_value_span(&data[len]))) {
+            goto sequential;
+        }
+        len += r;
+        len += skip_ws(&data[len]);
+
+        if (!count || (part->end - part->start >= total / LY_PARALLEL_PARTS)) {
+            part = realloc(par.parts, (count + 1) * sizeof *par.parts);
+            LY_CHECK_ERR_GOTO(!part, LOGMEM(ctx), error);
+            par.parts = part;
+            part = &par.parts[count++];
+            memset(part, 0, sizeof *part);
+            part->start = i;
+        }
+        part->end = len;
+
+        if (data[len] == '}') {
+            break;
+        } else if (data[len] != ',') {
+            goto sequential;
+        }
+        ++len;
+        len += skip_ws(&data[len]);
+    }
+    if (count < 2) {
+        goto sequential;
+    }
+
+    par.ctx = ctx;
+    par.data = data;
+    par.options = options;
+    par.log_opt = log_opt;
+    par.filter = filter;
+    if (options & LYD_OPT_PIN_INPUT) {
+        par.pin = lydict_pin_find(ctx, data);
+    }
+    ly_parallel(count, json_parse_part, &par);
+
+    /* join the parts in the document order */
+    for (i = 0; i < count; ++i) {
+        part = &par.parts[i];
+        if (err) {
+            /* the sequential parser would have stopped on the first error */
+            ly_err_free(part->eitems);
+            continue;
+        }
+        ly_err_attach(ctx, part->eitems);
+        if (part->err) {
+            err = part->err;
+            continue;
+        }
+
+        if (lyd_parse_append(&result, part->first, options)) {
+            err = ly_errno ? ly_errno : LY_EVALID;
+        }
+        part->first = NULL;
+        *attrs_last = part->attrs;
+        for (; *attrs_last; attrs_last = &(*attrs_last)->next);
+        part->attrs = NULL;
+        if (unres_data_merge(&unres, &part->unres)) {
+            err = LY_EMEM;
+        }
+    }
+    if (err) {
+        goto error;
+    }
+
+    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+        LY_TREE_FOR(result, iter) {
+            if (iter->schema->module == ctx->models.list[ctx->internal_module_count - 1]) {
+                /* ietf-yang-library data present, so ignore the option to add them */
+                options &= ~LYD_OPT_DATA_ADD_YANGLIB;
+                break;
+            }
+        }
+    }
+
+    unres.pin = par.pin;
+    r = json_parse_end(ctx, &result, NULL, NULL, NULL, NULL, NULL, attrs, &unres, options);
+    attrs = NULL;
+    if (r) {
+        goto error;
+    }
+
+    free(unres.node);
+    free(unres.type);
+    free(par.parts);
+    return result;
+
+error:
+    lyd_free_withsiblings(result);
+    while (attrs) {
+        attrs_aux = attrs;
+        attrs = attrs->next;
+        lyd_free_attr(ctx, NULL, attrs_aux->attr, 1);
+        free(attrs_aux);
+    }
+    for (i = 0; i < count; ++i) {
+        lyd_free_withsiblings(par.parts[i].first);
+        while (par.parts[i].attrs) {
+            attrs_aux = par.parts[i].attrs;
+            par.parts[i].attrs = attrs_aux->next;
+            lyd_free_attr(ctx, NULL, attrs_aux->attr, 1);
+            free(attrs_aux);
+        }
+        free(par.parts[i].unres.node);
+        free(par.parts[i].unres.type);
+    }
+    free(unres.node);
+    free(unres.type);
+    free(par.parts);
+    if (err) {
+        ly_errno = err;
+    }
+    return NULL;
+
+sequential:
+    free(par.parts);
+    return lyd_parse_json(ctx, data, options, NULL, NULL, NULL, filter);
+}
+
+/* states of the incremental JSON data parser */
+enum json_stream_state {
+    JSON_STREAM_BEGIN,          /* expecting the top-level begin-object */
+    JSON_STREAM_MEMBER_FIRST,   /* expecting the first member or end-object */
+    JSON_STREAM_MEMBER,         /* expecting a member */
+    JSON_STREAM_VALUE,          /* buffering the value of a member */
+    JSON_STREAM_NEXT,           /* expecting value-separator or end-object */
+    JSON_STREAM_INSTANCE,       /* expecting begin-object of a list instance */
+    JSON_STREAM_INSTANCE_NEXT,  /* expecting value-separator or end-array of a list */
+    JSON_STREAM_END,            /* top-level end-object was parsed */
+    JSON_STREAM_ERROR           /* parsing failed */
+};
+
+/* object or list array currently open in the incremental JSON data parser */
+struct json_stream_frame {
+    struct lyd_node *node;      /* data node of the object (NULL for top-level), the last instance of a list array */
+    struct lys_node *list;      /* list schema node of a list array, NULL for an object */
+    struct lyd_node *first;     /* first child of the object */
+    struct lyd_node *last;      /* last child of the object */
+    struct attr_cont *attrs;    /* attributes of the object's children */
+};
+
+struct lyd_json_stream {
+    struct ly_ctx *ctx;
+    int options;
+    const struct lyd_node *rpc_act;
+    const struct lyd_node *data_tree;
+    const char *yang_data_name; /* in dictionary */
+    struct lyd_node *reply_top;
+    struct lyd_node *act_notif;
+    struct unres_data *unres;
+    enum json_stream_state state;
+    int empty;                  /* no top-level member parsed */
+
+    char *buf;                  /* input data not processed yet, always NUL-terminated */
+    size_t used;
+    size_t size;
+    size_t pos;                 /* current position in buf */
+    size_t scan;                /* scanned part of the buffered member value (starting at pos) */
+    int depth;                  /* nesting of the buffered member value */
+    int instr;                  /* scanning inside a string */
+    int esc;                    /* scanning an escaped character */
+
+    struct json_stream_frame *frames;
+    unsigned int count;
+    unsigned int fsize;
+};
+
+static int
+json_stream_push(struct lyd_json_stream *stream, struct lyd_node *node, struct lys_node *list)
+{
+    struct json_stream_frame *frames;
+
+    if (stream->count == stream->fsize) {
+        frames = realloc(stream->frames, (stream->fsize ? stream->fsize * 2 : 8) * sizeof *frames);
+        LY_CHECK_ERR_RETURN(!frames, LOGMEM(stream->ctx), -1);
+        stream->frames = frames;
+        stream->fsize = stream->fsize ? stream->fsize * 2 : 8;
+    }
+
+    memset(&stream->frames[stream->count], 0, sizeof *stream->frames);
+    stream->frames[stream->count].node = node;
+    stream->frames[stream->count].list = list;
+    if (node && node->child) {
+        stream->frames[stream->count].first = node->child;
+        stream->frames[stream->count].last = node->child->prev;
+    }
+    ++stream->count;
+
+    return 0;
+}
+
+/**
+ * @brief Find the end of the buffered member value, continue where the previous call stopped.
+ * @param[in] stream Incremental parser.
+ * @return Position after the value, 0 if the value is not complete yet.
+ */
+static size_t
+json_stream_scan(struct lyd_json_stream *stream)
+{
+    char c;
+
+    for (; stream->scan < stream->used; ++stream->scan) {
+        c = stream->buf[stream->scan];
+        if (stream->instr) {
+            if (stream->esc) {
+                stream->esc = 0;
+            } else if (c == '\\') {
+                stream->esc = 1;
+            } else if (c == '"') {
+                stream->instr = 0;
+                if (!stream->depth) {
+                    return stream->scan + 1;
+                }
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            stream->instr = 1;
+            break;
+        case '{':
+        case '[':
+            ++stream->depth;
+            break;
+        case '}':
+        case ']':
+            if (!stream->depth) {
+                /* end of a literal */
+                return stream->scan;
+            }
+            if (!--stream->depth) {
+                return stream->scan + 1;
+            }
+            break;
+        case ',':
+            if (!stream->depth) {
+                return stream->scan;
+            }
+            break;
+        default:
+            if (!stream->depth && lyjson_isspace(c)) {
+                return stream->scan;
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Validate a complete node in the context of its siblings.
+ * @param[in] stream Incremental parser.
+ * @param[in] node Complete node.
+ * @param[in] f Frame of the node's parent object.
+ * @return 0 on success, -1 on error.
+ */
+static int
+json_stream_validate(struct lyd_json_stream *stream, struct lyd_node *node, struct json_stream_frame *f)
+{
+    /* various validation checks (LYD_OPT_TRUSTED is used just so that the order of elements is not checked) */
+    if (lyv_data_context(node, stream->options | LYD_OPT_TRUSTED, stream->unres) ||
+            lyv_data_content(node, stream->options, stream->unres) ||
+            lyv_multicases(node, NULL, (node != f->first) ? &f->first : NULL, 0, NULL)) {
+        return -1;
+    }
+
+    if (f->node) {
+        f->first = f->node->child;
+    }
+    f->last = f->first ? f->first->prev : NULL;
+
+    return 0;
+}
+
+/**
+ * @brief Parse the buffered member once its value is complete.
+ * @param[in] stream Incremental parser.
+ * @return 1 on success, 0 if more data are needed, -1 on error.
+ */
+static int
+json_stream_value(struct lyd_json_stream *stream)
+{
+    struct json_stream_frame *f = &stream->frames[stream->count - 1];
+    struct lyd_node *parent = f->node, *iter;
+    size_t end;
+    unsigned int r;
+    char c;
+
+    end = json_stream_scan(stream);
+    if (!end) {
+        return 0;
+    }
+
+    /* parse just the member, the following data are not complete */
+    c = stream->buf[end];
+    stream->buf[end] = '\0';
+    r = json_parse_data(stream->ctx, &stream->buf[stream->pos], NULL, &parent, f->first, f->last, &f->attrs,
+                        stream->options, stream->unres, &stream->act_notif, stream->yang_data_name);
+    stream->buf[end] = c;
+    if (!r) {
+        return -1;
+    }
+
+    if (f->node) {
+        f->first = f->node->child;
+    } else if (!f->first) {
+        for (iter = parent; iter && iter->prev->next; iter = iter->prev);
+        f->first = iter;
+    }
+    f->last = f->first ? f->first->prev : NULL;
+
+    stream->pos = end;
+    stream->state = JSON_STREAM_NEXT;
+    return 1;
+}
+
+/**
+ * @brief Process a member of the current object. Containers, RPCs, actions, notifications, and lists are opened
+ * so that their content is parsed as it comes, the other members are buffered until their value is complete.
+ * @param[in] stream Incremental parser.
+ * @return 1 on success, 0 if more data are needed, -1 on error.
+ */
+static int
+json_stream_member(struct lyd_json_stream *stream)
+{
+    struct ly_ctx *ctx = stream->ctx;
+    struct json_stream_frame *f = &stream->frames[stream->count - 1];
+    const char *data = &stream->buf[stream->pos];
+    size_t avail = stream->used - stream->pos, len;
+    unsigned int r;
+    char *str, *prefix, *name;
+    const struct lys_module *module;
+    struct lys_node *schema = NULL;
+    struct lyd_node *node;
+
+    if (data[0] != '"') {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, f->node, "JSON data (missing quotation-mark at the beginning of string)");
+        return -1;
+    }
+
+    /* wait for the whole name, the name-separator, and the beginning of the value */
+    for (len = 1; (len < avail) && (data[len] != '"'); len += (data[len] == '\\') ? 2 : 1);
+    if (len >= avail) {
+        return 0;
+    }
+    ++len;
+    len += skip_ws(&data[len]);
+    if (len == avail) {
+        return 0;
+    }
+    if (data[len] == ':') {
+        ++len;
+        len += skip_ws(&data[len]);
+        if (len == avail) {
+            return 0;
+        }
+    }
+
+    r = json_parse_name(ctx, f->node, data, &str, &prefix, &name);
+    if (!r) {
+        return -1;
+    }
+    if ((stream->count == 1) && !f->node && !strcmp(str, "yang:action")) {
+        LOGVAL(ctx, LYE_SPEC, LY_VLOG_NONE, NULL, "The \"yang:action\" envelope is not supported by the incremental parser.");
+        free(str);
+        return -1;
+    }
+    if ((str[0] != '@') && ((data[r] == '{') || (data[r] == '['))) {
+        schema = json_find_schema(ctx, f->node, NULL, prefix, name, stream->options, stream->yang_data_name);
+        module = lys_node_module(schema);
+        if (!module || !module->implemented || module->disabled
+                || (stream->unres->filter && lyd_filter_skip(stream->unres->filter, schema))) {
+            /* skipped as a whole value */
+            schema = NULL;
+        }
+    }
+    free(str);
+
+    if (schema && (schema->nodetype & (LYS_CONTAINER | LYS_NOTIF | LYS_RPC | LYS_ACTION)) && (data[r] == '{')) {
+        node = json_new_node(ctx, schema, f->node, &f->first, f->last);
+        if (!node) {
+            return -1;
+        }
+        f->last = node;
+        if (json_open_inner(node, stream->options, &stream->act_notif) || json_stream_push(stream, node, NULL)) {
+            return -1;
+        }
+        stream->state = JSON_STREAM_MEMBER_FIRST;
+    } else if (schema && (schema->nodetype == LYS_LIST) && (data[r] == '[')) {
+        if (json_stream_push(stream, NULL, schema)) {
+            return -1;
+        }
+        stream->state = JSON_STREAM_INSTANCE;
+    } else {
+        /* buffer the member until its value is complete */
+        stream->scan = stream->pos + r;
+        stream->depth = 0;
+        stream->instr = 0;
+        stream->esc = 0;
+        stream->state = JSON_STREAM_VALUE;
+        return 1;
+    }
+
+    stream->pos += r + 1;
+    return 1;
+}
+
+/**
+ * @brief Create a new list instance in the current list array.
+ * @param[in] stream Incremental parser.
+ * @return 1 on success, -1 on error.
+ */
+static int
+json_stream_instance(struct lyd_json_stream *stream)
+{
+    struct json_stream_frame *a = &stream->frames[stream->count - 1], *f = a - 1;
+    struct lyd_node *node;
+
+    node = json_new_node(stream->ctx, a->list, f->node, &f->first, f->last);
+    if (!node) {
+        return -1;
+    }
+    f->last = node;
+    a->node = node;
+    if (json_stream_push(stream, node, NULL)) {
+        return -1;
+    }
+
+    stream->state = JSON_STREAM_MEMBER;
+    return 1;
+}
+
+/**
+ * @brief Close the current object.
+ * @param[in] stream Incremental parser.
+ * @return 1 on success, -1 on error.
+ */
+static int
+json_stream_close(struct lyd_json_stream *stream)
+{
+    struct json_stream_frame *f = &stream->frames[stream->count - 1];
+    struct lyd_node *node = f->node;
+    struct attr_cont *attrs;
+
+    if (stream->count == 1) {
+        /* top-level attributes are stored when finishing */
+        stream->state = JSON_STREAM_END;
+        return 1;
+    }
+
+#ifdef LY_ENABLED_CACHE
+    /* calculate the hash and insert it into parent */
+    if ((node->schema->nodetype == LYS_LIST) && !((struct lys_node_list *)node->schema)->keys_size) {
+        lyd_hash(node);
+        lyd_insert_hash(node);
+    }
+#endif
+
+    /* store attributes */
+    attrs = f->attrs;
+    f->attrs = NULL;
+    if (store_attrs(stream->ctx, attrs, node->child, stream->options)) {
+        return -1;
+    }
+
+    /* if we have empty non-presence container, mark it as default */
+    if (node->schema->nodetype == LYS_CONTAINER && !node->child &&
+            !node->attr && !((struct lys_node_container *)node->schema)->presence) {
+        node->dflt = 1;
+    }
+
+    --stream->count;
+    if (node->schema->nodetype == LYS_LIST) {
+        stream->state = JSON_STREAM_INSTANCE_NEXT;
+        return json_stream_validate(stream, node, f - 2) ? -1 : 1;
+    }
+    stream->state = JSON_STREAM_NEXT;
+    return json_stream_validate(stream, node, f - 1) ? -1 : 1;
+}
+
+/**
+ * @brief Make a single step in parsing the buffered data.
+ * @param[in] stream Incremental parser.
+ * @return 1 on success, 0 if more data are needed, -1 on error.
+ */
+static int
+json_stream_step(struct lyd_json_stream *stream)
+{
+    struct ly_ctx *ctx = stream->ctx;
+    struct json_stream_frame *f = &stream->frames[stream->count - 1];
+    char c;
+
+    if (stream->state == JSON_STREAM_VALUE) {
+        return json_stream_value(stream);
+    }
+
+    stream->pos += skip_ws(&stream->buf[stream->pos]);
+    if (stream->pos == stream->used) {
+        return 0;
+    }
+    c = stream->buf[stream->pos];
+
+    switch (stream->state) {
+    case JSON_STREAM_BEGIN:
+        if (c != '{') {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top level begin-object)");
+            return -1;
+        }
+        ++stream->pos;
+        stream->state = JSON_STREAM_MEMBER_FIRST;
+        return 1;
+    case JSON_STREAM_MEMBER_FIRST:
+        if (c == '}') {
+            ++stream->pos;
+            return json_stream_close(stream);
+        }
+        /* fallthrough */
+    case JSON_STREAM_MEMBER:
+        if (stream->count == 1) {
+            stream->empty = 0;
+        }
+        return json_stream_member(stream);
+    case JSON_STREAM_NEXT:
+        if (c == ',') {
+            ++stream->pos;
+            stream->state = JSON_STREAM_MEMBER;
+            return 1;
+        } else if (c == '}') {
+            ++stream->pos;
+            return json_stream_close(stream);
+        }
+
+        if (stream->count == 1) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top-level end-object)");
+        } else if (f->node->schema->nodetype == LYS_LIST) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, f->node, "JSON data (missing list instance's end-object)");
+        } else {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, f->node, "JSON data (missing end-object)");
+        }
+        return -1;
+    case JSON_STREAM_INSTANCE:
+        if (c != '{') {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, f[-1].node, "JSON data (missing list instance's begin-object)");
+            return -1;
+        }
+        ++stream->pos;
+        return json_stream_instance(stream);
+    case JSON_STREAM_INSTANCE_NEXT:
+        if (c == ',') {
+            ++stream->pos;
+            stream->state = JSON_STREAM_INSTANCE;
+            return 1;
+        } else if (c != ']') {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, f->node, "JSON data (missing end-array)");
+            return -1;
+        }
+        ++stream->pos;
+
+        /* postpone checking of unique when there will be all list instances */
+        f->node->validity |= LYD_VAL_DUP;
+        --stream->count;
+        stream->state = JSON_STREAM_NEXT;
+        return 1;
+    case JSON_STREAM_END:
+        /* data following the top-level object are ignored */
+        stream->pos = stream->used;
+        return 0;
+    default:
+        LOGINT(ctx);
+        return -1;
+    }
+}
+
+static struct lyd_json_stream *
+json_stream_new(struct ly_ctx *ctx, int options, const struct lyd_node *rpc_act, const struct lyd_node *data_tree,
+                const char *yang_data_name)
+{
+    struct lyd_json_stream *stream;
+    struct lyd_node *reply_parent = NULL;
+
+    stream = calloc(1, sizeof *stream);
+    LY_CHECK_ERR_RETURN(!stream, LOGMEM(ctx), NULL);
+    stream->ctx = ctx;
+    /* there is no input buffer the values could reference */
+    stream->options = options & ~LYD_OPT_PIN_INPUT;
+    stream->rpc_act = rpc_act;
+    stream->data_tree = data_tree;
+    stream->yang_data_name = lydict_insert(ctx, yang_data_name, 0);
+    stream->state = JSON_STREAM_BEGIN;
+    stream->empty = 1;
+
+    stream->unres = calloc(1, sizeof *stream->unres);
+    stream->size = 1024;
+    stream->buf = malloc(stream->size);
+    LY_CHECK_ERR_GOTO(!stream->unres || !stream->buf, LOGMEM(ctx), error);
+    stream->buf[0] = '\0';
+
+    /* create RPC/action reply part that is not in the parsed data */
+    if (rpc_act && json_reply_parent(ctx, rpc_act, &stream->reply_top, &reply_parent)) {
+        goto error;
+    }
+
+    /* top-level object */
+    if (json_stream_push(stream, reply_parent, NULL)) {
+        goto error;
+    }
+
+    return stream;
+
+error:
+    lyd_json_stream_free(stream);
+    return NULL;
+}
+
+API struct lyd_json_stream *
+lyd_json_stream_new(struct ly_ctx *ctx, int options, ...)
+{
+    FUN_IN;
+
+    va_list ap;
+    const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
+    const char *yang_data_name = NULL;
+    const struct ly_set *filter = NULL;
+    struct lyd_json_stream *stream;
+    int r;
+
+    if (!ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    va_start(ap, options);
+    r = lyd_parse_data_args(ctx, options, ap, &rpc_act, &data_tree, &yang_data_name, &filter);
+    va_end(ap);
+    if (r) {
+        return NULL;
+    }
+
+    stream = json_stream_new(ctx, options, rpc_act, data_tree, yang_data_name);
+    if (stream) {
+        stream->unres->filter = filter;
+    }
+    return stream;
+}
+
+API int
+lyd_json_stream_feed(struct lyd_json_stream *stream, const char *chunk, size_t len)
+{
+    FUN_IN;
+
+    char *buf;
+    size_t size;
+    int ret;
+
+    if (!stream || (!chunk && len)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (stream->state == JSON_STREAM_ERROR) {
+        LOGERR(stream->ctx, LY_EINVAL, "%s: the parser has already failed.", __func__);
+        return EXIT_FAILURE;
+    }
+
+    /* drop the processed data */
+    if (stream->pos) {
+        stream->used -= stream->pos;
+        memmove(stream->buf, &stream->buf[stream->pos], stream->used);
+        if (stream->state == JSON_STREAM_VALUE) {
+            stream->scan -= stream->pos;
+        }
+        stream->pos = 0;
+    }
+
+    /* append the chunk */
+    if (stream->used + len >= stream->size) {
+        size = stream->size * 2 > stream->used + len ? stream->size * 2 : stream->used + len + 1;
+        buf = realloc(stream->buf, size);
+        LY_CHECK_ERR_GOTO(!buf, LOGMEM(stream->ctx), error);
+        stream->buf = buf;
+        stream->size = size;
+    }
+    memcpy(&stream->buf[stream->used], chunk, len);
+    stream->used += len;
+    stream->buf[stream->used] = '\0';
+
+    /* any error means failure the same way as for lyd_parse_mem() */
+    ly_errno = LY_SUCCESS;
+    while ((ret = json_stream_step(stream)) > 0);
+    if (ret || ly_errno) {
+        goto error;
+    }
+
+    return EXIT_SUCCESS;
+
+error:
+    stream->state = JSON_STREAM_ERROR;
+    return EXIT_FAILURE;
+}
+
+static struct lyd_node *
+json_stream_finish(struct lyd_json_stream *stream)
+{
+    struct ly_ctx *ctx = stream->ctx;
+    struct json_stream_frame *f = &stream->frames[0];
+    struct lyd_node *result = NULL, *reply_top;
+    struct attr_cont *attrs;
+    int options = stream->options;
+
+    if (stream->state == JSON_STREAM_ERROR) {
+        LOGERR(ctx, LY_EINVAL, "%s: the parser has already failed.", __func__);
+        return NULL;
+    } else if (stream->state != JSON_STREAM_END) {
+        LOGVAL(ctx, LYE_EOF, LY_VLOG_NONE, NULL);
+        stream->state = JSON_STREAM_ERROR;
+        return NULL;
+    }
+
+    if (stream->empty) {
+        if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+            result = ly_ctx_info(ctx);
+        }
+        lyd_validate(&result, options, ctx);
+        return result;
+    }
+
+    /* the tree is passed to the caller */
+    result = f->first;
+    reply_top = stream->reply_top;
+    f->first = NULL;
+    stream->reply_top = NULL;
+    attrs = f->attrs;
+    f->attrs = NULL;
+
+    if (!reply_top && result && (options & LYD_OPT_DATA_ADD_YANGLIB)
+            && result->schema->module == ctx->models.list[ctx->internal_module_count - 1]) {
+        /* ietf-yang-library data present, so ignore the option to add them */
+        options &= ~LYD_OPT_DATA_ADD_YANGLIB;
+    }
+
+    if (json_parse_end(ctx, &result, reply_top, f->node, stream->rpc_act, stream->data_tree, stream->act_notif,
+                       attrs, stream->unres, options)) {
+        lyd_free_withsiblings(result);
+        if (reply_top && result != reply_top) {
+            lyd_free_withsiblings(reply_top);
+        }
+        stream->state = JSON_STREAM_ERROR;
+        return NULL;
+    }
+
+    return result;
+}
+
+API struct lyd_node *
+lyd_json_stream_finish(struct lyd_json_stream *stream)
+{
+    FUN_IN;
+
+    struct ly_ctx *ctx;
+    struct lyd_node *result;
+    int options;
+
+    if (!stream) {
+        LOGARG;
+        return NULL;
+    }
+    ctx = stream->ctx;
+    options = stream->options;
+
+    /* we must free all the errors, otherwise we are unable to properly check returned ly_errno :-/ */
+    ly_errno = LY_SUCCESS;
+    result = json_stream_finish(stream);
+    lyd_json_stream_free(stream);
+
+    return lyd_parse_data_end(ctx, result, LYD_JSON, options);
+}
+
+API void
+lyd_json_stream_free(struct lyd_json_stream *stream)
+{
+    FUN_IN;
+
+    struct attr_cont *attrs;
+    unsigned int i;
+
+    if (!stream) {
+        return;
+    }
+
+    for (i = 0; i < stream->count; ++i) {
+        while (stream->frames[i].attrs) {
+            attrs = stream->frames[i].attrs;
+            stream->frames[i].attrs = attrs->next;
+
+            lyd_free_attr(stream->ctx, NULL, attrs->attr, 1);
+            free(attrs);
+        }
+    }
+    if (stream->reply_top) {
+        lyd_free_withsiblings(stream->reply_top);
+    } else if (stream->count) {
+        lyd_free_withsiblings(stream->frames[0].first);
+    }
+
+    if (stream->unres) {
+        free(stream->unres->node);
+        free(stream->unres->type);
+        free(stream->unres);
+    }
+    lydict_remove(stream->ctx, stream->yang_data_name);
+    free(stream->frames);
+    free(stream->buf);
+    free(stream);
+}
@@ -1035,8 +1035,8 @@ lyb_parse_subtree(const char *data, struct lyd_node *parent, struct lyd_node **f
     ret += r;
     LYB_HAVE_READ_GOTO(r, data, error);
 
-    if (!mod || !snode) {
-        /* unknown data subtree, skip it whole */
+    if (!mod || !snode || (unres->filter && lyd_filter_skip(unres->filter, snode))) {
+        /* unknown or not selected data subtree, skip it whole */
         ret += (r = lyb_skip_subtree(data, lybs));
         LYB_HAVE_READ_GOTO(r, data, error);
         goto stop_subtree;
@@ -1207,7 +1207,7 @@ lyb_parse_header(const char *data, struct lyb_state *lybs)
 
 struct lyd_node *
 lyd_parse_lyb(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *data_tree,
-              const char *yang_data_name, int *parsed)
+              const char *yang_data_name, const struct ly_set *filter, int *parsed)
 {
     int r = 0, ret = 0;
     struct lyd_node *node = NULL, *next, *act_notif = NULL;
@@ -1231,6 +1231,7 @@ lyd_parse_lyb(struct ly_ctx *ctx, const char *data, int options, const struct ly
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_GOTO(!unres, LOGMEM(ctx), finish);
+    unres->filter = filter;
 
     /* read magic number */
     ret += (r = lyb_parse_magic_number(data, &lybs));
@@ -220,6 +220,11 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
         }
     }
 
+    if (unres->filter && lyd_filter_skip(unres->filter, schema)) {
+        /* not selected */
+        return 0;
+    }
+
     /* create the element structure */
     switch (schema->nodetype) {
     case LYS_CONTAINER:
@@ -278,20 +283,27 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             } else {
                 LOGWRN(ctx, "Invalid position of the key \"%s\" in a list \"%s\".", schema->name, parent->schema->name)
             }
-            if (parent->child == diter) {
+        }
+    } else if (prev && (ctx->models.flags & LY_CTX_SCHEMA_ORDER)) {
+        /* keep the schema order of the siblings */
+        diter = lyd_schema_order_next(prev, schema);
+    }
+    if (diter) {
+        /* out of order insertion - insert the node before the diter */
+        if (diter == first_sibling) {
+            if (parent) {
                 parent->child = *result;
-                /* update first_sibling */
-                first_sibling = *result;
-            }
-            if (diter->prev->next) {
-                diter->prev->next = *result;
             }
-            (*result)->prev = diter->prev;
-            diter->prev = *result;
-            (*result)->next = diter;
+            /* update first_sibling */
+            first_sibling = *result;
         }
-    }
-    if (!diter) {
+        if (diter->prev->next) {
+            diter->prev->next = *result;
+        }
+        (*result)->prev = diter->prev;
+        diter->prev = *result;
+        (*result)->next = diter;
+    } else {
         /* simplified (faster) insert as the last node */
         if (parent && !parent->child) {
             parent->child = *result;
@@ -561,6 +573,67 @@ error:
     return -1;
 }
 
+/**
+ * @brief Finish parsing of the whole XML document - add default nodes and perform the checks requiring all
+ * the top-level nodes.
+ * @param[in] ctx libyang context.
+ * @param[in,out] result First top-level node of the parsed data.
+ * @param[in] rpc_act RPC/action request for an RPC reply.
+ * @param[in] reply_parent RPC/action node of the reply tree, if any.
+ * @param[in] data_tree Additional data tree for resolving references.
+ * @param[in] act_notif Parsed action/notification node, if any.
+ * @param[in] unres Unresolved data items.
+ * @param[in] options Parser options.
+ * @return 0 on success, -1 on error.
+ */
+static int
+xml_parse_end(struct ly_ctx *ctx, struct lyd_node **result, const struct lyd_node *rpc_act, struct lyd_node *reply_parent,
+              const struct lyd_node *data_tree, struct lyd_node *act_notif, struct unres_data *unres, int options)
+{
+    struct lyd_node *iter;
+
+    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
+        /* action reply */
+        act_notif = reply_parent;
+    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
+        LOGVAL(ctx, LYE_INELEM, (*result ? LY_VLOG_LYD : LY_VLOG_NONE), *result, (options & LYD_OPT_RPC ? "action" : "notification"));
+        return -1;
+    }
+
+    /* add missing ietf-yang-library if requested */
+    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+        if (!*result) {
+            *result = ly_ctx_info(ctx);
+        } else if (lyd_merge(*result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
+            LOGERR(ctx, LY_EINT, "Adding ietf-yang-library data failed.");
+            return -1;
+        }
+    }
+
+    /* check for uniqueness of top-level lists/leaflists because
+     * only the inner instances were tested in lyv_data_content() */
+    LY_TREE_FOR(*result, iter) {
+        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_DUP)) {
+            continue;
+        }
+
+        if (lyv_data_dup(iter, *result)) {
+            return -1;
+        }
+    }
+
+    /* add default values, resolve unres and check for mandatory nodes in final tree */
+    if (lyd_defaults_add_unres(result, options, ctx, NULL, 0, data_tree, act_notif, unres, 1)) {
+        return -1;
+    }
+    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
+            && lyd_check_mandatory_tree((act_notif ? act_notif : *result), ctx, NULL, 0, options)) {
+        return -1;
+    }
+
+    return 0;
+}
+
 API struct lyd_node *
 lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
 {
@@ -657,6 +730,13 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
     if (options & LYD_OPT_DATA_TEMPLATE) {
         yang_data_name = va_arg(ap, const char *);
     }
+    if (options & LYD_OPT_FILTER) {
+        unres->filter = va_arg(ap, const struct ly_set *);
+        if (!unres->filter) {
+            LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct ly_set *filter).", __func__);
+            goto error;
+        }
+    }
 
     if ((*root) && !(options & LYD_OPT_NOSIBLINGS)) {
         /* locate the first root to process */
@@ -696,13 +776,17 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
             *root = xmlaux;
         }
         if (iter) {
-            last = iter;
+            if (!iter->next) {
+                /* not inserted in the middle to keep the schema order */
+                last = iter;
+            }
             if ((options & LYD_OPT_DATA_ADD_YANGLIB) && iter->schema->module == ctx->models.list[ctx->internal_module_count - 1]) {
                 /* ietf-yang-library data present, so ignore the option to add them */
                 options &= ~LYD_OPT_DATA_ADD_YANGLIB;
             }
         }
-        if (!result) {
+        if (!result || (iter && (iter->next == result))) {
+            /* the first node or a node inserted before it to keep the schema order */
             result = iter;
         }
 
@@ -716,62 +800,318 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
         result = reply_top;
     }
 
-    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
-        /* action reply */
-        act_notif = reply_parent;
-    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
-        LOGVAL(ctx, LYE_INELEM, (result ? LY_VLOG_LYD : LY_VLOG_NONE), result, (options & LYD_OPT_RPC ? "action" : "notification"));
+    if (xml_parse_end(ctx, &result, rpc_act, reply_parent, data_tree, act_notif, unres, options)) {
         goto error;
     }
 
-    /* add missing ietf-yang-library if requested */
-    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
-        if (!result) {
-            result = ly_ctx_info(ctx);
-        } else if (lyd_merge(result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
-            LOGERR(ctx, LY_EINT, "Adding ietf-yang-library data failed.");
-            goto error;
+    if (xmlfree) {
+        lyxml_free(ctx, xmlfree);
+    }
+    free(unres->node);
+    free(unres->type);
+    free(unres);
+    va_end(ap);
+    return result;
+
+error:
+    lyd_free_withsiblings(result);
+    if (xmlfree) {
+        lyxml_free(ctx, xmlfree);
+    }
+    free(unres->node);
+    free(unres->type);
+    free(unres);
+    va_end(ap);
+    return NULL;
+}
+
+/**
+ * @brief Skip XML whitespaces, comments and processing instructions between the top-level elements.
+ * @param[in] data Input data.
+ * @return Number of the skipped bytes.
+ */
+static unsigned int
+xml_skip_misc(const char *data)
+{
+    const char *c = data, *e;
+
+    while (1) {
+        if (is_xmlws(*c)) {
+            ++c;
+        } else if (!strncmp(c, "<!--", 4) && (e = strstr(c + 4, "-->"))) {
+            c = e + 3;
+        } else if (!strncmp(c, "<?", 2) && (e = strstr(c + 2, "?>"))) {
+            c = e + 2;
+        } else {
+            return c - data;
         }
     }
+}
 
-    /* check for uniqueness of top-level lists/leaflists because
-     * only the inner instances were tested in lyv_data_content() */
-    LY_TREE_FOR(result, iter) {
-        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_DUP)) {
-            continue;
+/**
+ * @brief Find the end of an XML element without parsing it.
+ * @param[in] data Input data pointing to the element's start-tag.
+ * @return Length of the element, 0 if it is not terminated or it contains an unsupported construct.
+ */
+static unsigned int
+xml_elem_span(const char *data)
+{
+    const char *c = data, *e;
+    char quot;
+    int depth = 0;
+
+    while ((c = strchr(c, '<'))) {
+        if (!strncmp(c, "<!--", 4)) {
+            e = strstr(c + 4, "-->");
+            c = e ? e + 3 : NULL;
+        } else if (!strncmp(c, "<![CDATA[", 9)) {
+            e = strstr(c + 9, "]]>");
+            c = e ? e + 3 : NULL;
+        } else if (!strncmp(c, "<?", 2)) {
+            e = strstr(c + 2, "?>");
+            c = e ? e + 2 : NULL;
+        } else if (c[1] == '!') {
+            /* DOCTYPE */
+            return 0;
+        } else if (c[1] == '/') {
+            c = strchr(c, '>');
+            if (c && !--depth) {
+                return c + 1 - data;
+            }
+        } else {
+            /* start-tag, skip the attribute values which may contain '>' */
+            for (++c; *c && (*c != '>'); ++c) {
+                if ((*c == '"') || (*c == '\'')) {
+                    quot = *c;
+                    c = strchr(c + 1, quot);
+                    if (!c) {
+                        return 0;
+                    }
+                }
+            }
+            if (!*c) {
+                return 0;
+            } else if (c[-1] != '/') {
+                ++depth;
+            } else if (!depth) {
+                /* empty top-level element */
+                return c + 1 - data;
+            }
+        }
+
+        if (!c) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+/* top-level elements of an XML document parsed by a single thread */
+struct xml_part {
+    unsigned int start;         /* offset of the first element */
+    unsigned int end;           /* offset following the last element */
+    struct lyd_node *first;     /* parsed top-level nodes */
+    struct unres_data unres;
+    LY_ERR err;
+    struct ly_err_item *eitems; /* errors of the parsing thread */
+};
+
+struct xml_parallel {
+    struct ly_ctx *ctx;
+    const char *data;
+    int options;
+    enum int_log_opts log_opt;
+    const struct ly_set *filter;
+    struct xml_part *parts;
+};
+
+static void
+xml_parse_part(void *arg, unsigned int idx)
+{
+    struct xml_parallel *par = arg;
+    struct xml_part *part = &par->parts[idx];
+    struct ly_ctx *ctx = par->ctx;
+    struct lyxml_elem *xml;
+    struct lyd_node *iter, *last = NULL, *act_notif = NULL;
+    struct ly_err_item *eitem;
+    unsigned int len = part->start, r;
+
+    log_opt = par->log_opt;
+    eitem = ly_err_first(ctx);
+    eitem = eitem ? eitem->prev : NULL;
+    ly_errno = LY_SUCCESS;
+    part->unres.filter = par->filter;
+
+    while (len < part->end) {
+        xml = lyxml_parse_elem(ctx, &par->data[len], &r, NULL, LYXML_PARSE_MULTIROOT);
+        if (!xml) {
+            goto error;
         }
+        len += r;
+        len += xml_skip_misc(&par->data[len]);
 
-        if (lyv_data_dup(iter, result)) {
+        iter = NULL;
+        r = xml_parse_data(ctx, xml, NULL, part->first, last, par->options, &part->unres, &iter, &act_notif, NULL);
+        lyxml_free(ctx, xml);
+        if (r) {
             goto error;
         }
+        if (iter) {
+            if (!iter->next) {
+                /* not inserted in the middle to keep the schema order */
+                last = iter;
+            }
+            if (!part->first || (iter->next == part->first)) {
+                part->first = iter;
+            }
+        }
     }
 
-    /* add default values, resolve unres and check for mandatory nodes in final tree */
-    if (lyd_defaults_add_unres(&result, options, ctx, NULL, 0, data_tree, act_notif, unres, 1)) {
+    part->err = ly_errno;
+    part->eitems = ly_err_detach(ctx, eitem);
+    return;
+
+error:
+    part->err = ly_errno ? ly_errno : LY_EVALID;
+    part->eitems = ly_err_detach(ctx, eitem);
+}
+
+struct lyd_node *
+lyd_parse_xml_parallel(struct ly_ctx *ctx, const char *data, int options, const struct ly_set *filter)
+{
+    struct xml_parallel par;
+    struct xml_part *part = NULL;
+    struct lyxml_elem *xml;
+    struct lyd_node *result = NULL, *iter;
+    struct unres_data unres;
+    unsigned int len, r, total, count = 0, i;
+    LY_ERR err = LY_SUCCESS;
+
+    if (lyp_data_check_options(ctx, options, __func__)) {
+        return NULL;
+    }
+
+    memset(&par, 0, sizeof par);
+    memset(&unres, 0, sizeof unres);
+
+    if (ctx->data_clb) {
+        /* the callback may change the context */
+        goto sequential;
+    }
+
+    /* find the top-level elements and split them into parts of a similar size */
+    len = xml_skip_misc(data);
+    total = strlen(&data[len]);
+    while (data[len]) {
+        if (!(r = xml_elem_span(&data[len]))) {
+            goto sequential;
+        }
+
+        if (!count || (part->end - part->start >= total / LY_PARALLEL_PARTS)) {
+            part = realloc(par.parts, (count + 1) * sizeof *par.parts);
+            LY_CHECK_ERR_GOTO(!part, LOGMEM(ctx), error);
+            par.parts = part;
+            part = &par.parts[count++];
+            memset(part, 0, sizeof *part);
+            part->start = len;
+        }
+        len += r;
+        len += xml_skip_misc(&data[len]);
+        part->end = len;
+
+        if (data[len] && (data[len] != '<')) {
+            goto sequential;
+        }
+    }
+    if (count < 2) {
+        goto sequential;
+    }
+
+    par.ctx = ctx;
+    par.data = data;
+    par.options = options;
+    par.log_opt = log_opt;
+    par.filter = filter;
+    ly_parallel(count, xml_parse_part, &par);
+
+    /* join the parts in the document order */
+    for (i = 0; i < count; ++i) {
+        part = &par.parts[i];
+        if (err) {
+            /* the sequential parser would have stopped on the first error */
+            ly_err_free(part->eitems);
+            continue;
+        }
+        ly_err_attach(ctx, part->eitems);
+        if (part->err) {
+            err = part->err;
+            continue;
+        }
+
+        if (lyd_parse_append(&result, part->first, options)) {
+            err = ly_errno ? ly_errno : LY_EVALID;
+        }
+        part->first = NULL;
+        if (unres_data_merge(&unres, &part->unres)) {
+            err = LY_EMEM;
+        }
+    }
+    if (err) {
         goto error;
     }
-    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
-            && lyd_check_mandatory_tree((act_notif ? act_notif : result), ctx, NULL, 0, options)) {
+
+    if (result && (ctx->models.flags & LY_CTX_SCHEMA_ORDER) && lyd_schema_sort(result, 0)) {
+        /* every part is ordered, but they may be interleaved */
         goto error;
     }
+    result = lyd_first_sibling(result);
 
-    if (xmlfree) {
-        lyxml_free(ctx, xmlfree);
+    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+        LY_TREE_FOR(result, iter) {
+            if (iter->schema->module == ctx->models.list[ctx->internal_module_count - 1]) {
+                /* ietf-yang-library data present, so ignore the option to add them */
+                options &= ~LYD_OPT_DATA_ADD_YANGLIB;
+                break;
+            }
+        }
     }
-    free(unres->node);
-    free(unres->type);
-    free(unres);
-    va_end(ap);
+
+    if (xml_parse_end(ctx, &result, NULL, NULL, NULL, NULL, &unres, options)) {
+        goto error;
+    }
+
+    free(unres.node);
+    free(unres.type);
+    free(par.parts);
     return result;
 
 error:
     lyd_free_withsiblings(result);
-    if (xmlfree) {
-        lyxml_free(ctx, xmlfree);
+    for (i = 0; i < count; ++i) {
+        lyd_free_withsiblings(par.parts[i].first);
+        free(par.parts[i].unres.node);
+        free(par.parts[i].unres.type);
+    }
+    free(unres.node);
+    free(unres.type);
+    free(par.parts);
+    if (err) {
+        ly_errno = err;
     }
-    free(unres->node);
-    free(unres->type);
-    free(unres);
-    va_end(ap);
     return NULL;
+
+sequential:
+    free(par.parts);
+    xml = lyxml_parse_mem(ctx, data, LYXML_PARSE_MULTIROOT);
+    if (ly_errno) {
+        return NULL;
+    }
+    if (filter) {
+        result = lyd_parse_xml(ctx, &xml, options, filter);
+    } else {
+        result = lyd_parse_xml(ctx, &xml, options);
+    }
+    lyxml_free_withsiblings(ctx, xml);
+    return result;
 }
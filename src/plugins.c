@@ -630,6 +630,12 @@ lytype_store(const struct lys_module *mod, const char *type_name, const char **v
     return 1;
 }
 
+int
+lytype_exists(const struct lys_module *mod, const char *type_name)
+{
+    return lytype_find(mod->name, mod->rev_size ? mod->rev[0].date : NULL, type_name) ? 1 : 0;
+}
+
 void
 lytype_free(const struct lys_type *type, lyd_val value, const char *value_str)
 {
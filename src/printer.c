@@ -22,6 +22,9 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <unistd.h>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
 
 #include "common.h"
 #include "tree_schema.h"
@@ -196,6 +199,81 @@ ly_write(struct lyout *out, const char *buf, size_t count)
     return 0;
 }
 
+/**
+ * @brief Learn whether a character must be escaped.
+ *
+ * @param[in] c Character to check.
+ * @param[in] type Escaping type.
+ * @return non-zero if \p c must be escaped, 0 otherwise.
+ */
+static inline int
+ly_escape_char(unsigned char c, LY_ESC_TYPE type)
+{
+    switch (type) {
+    case LY_ESC_JSON:
+        return (c < 0x20) || (c == '"') || (c == '\\');
+    case LY_ESC_XML_ATTR:
+        if (c == '"') {
+            return 1;
+        }
+        /* falls through */
+    case LY_ESC_XML_ELEM:
+        return (c == '&') || (c == '<') || (c == '>');
+    }
+
+    return 0;
+}
+
+size_t
+ly_escape_span(const char *text, size_t len, LY_ESC_TYPE type)
+{
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i chunk, match, c1, c2, c3, c4, ctrl;
+    int bits;
+
+    /* compare 16 characters at once */
+    if (type == LY_ESC_JSON) {
+        c1 = _mm_set1_epi8('"');
+        c2 = _mm_set1_epi8('\\');
+        ctrl = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= len; i += 16) {
+            chunk = _mm_loadu_si128((const __m128i *)&text[i]);
+            match = _mm_or_si128(_mm_cmpeq_epi8(chunk, c1), _mm_cmpeq_epi8(chunk, c2));
+            /* unsigned c <= 0x1F */
+            match = _mm_or_si128(match, _mm_cmpeq_epi8(_mm_max_epu8(chunk, ctrl), ctrl));
+            bits = _mm_movemask_epi8(match);
+            if (bits) {
+                return i + __builtin_ctz(bits);
+            }
+        }
+    } else {
+        c1 = _mm_set1_epi8('&');
+        c2 = _mm_set1_epi8('<');
+        c3 = _mm_set1_epi8('>');
+        c4 = _mm_set1_epi8((type == LY_ESC_XML_ATTR) ? '"' : '&');
+        for (; i + 16 <= len; i += 16) {
+            chunk = _mm_loadu_si128((const __m128i *)&text[i]);
+            match = _mm_or_si128(_mm_cmpeq_epi8(chunk, c1), _mm_cmpeq_epi8(chunk, c2));
+            match = _mm_or_si128(match, _mm_or_si128(_mm_cmpeq_epi8(chunk, c3), _mm_cmpeq_epi8(chunk, c4)));
+            bits = _mm_movemask_epi8(match);
+            if (bits) {
+                return i + __builtin_ctz(bits);
+            }
+        }
+    }
+#endif
+
+    for (; i < len; ++i) {
+        if (ly_escape_char(text[i], type)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 int
 ly_write_skip(struct lyout *out, size_t count, size_t *position)
 {
@@ -701,9 +779,60 @@ lys_print_target(struct lyout *out, const struct lys_module *module, const char
     return EXIT_SUCCESS;
 }
 
+int
+lyd_print_has_lazy(const struct lyd_node *root, int options)
+{
+    const struct lyd_node *top, *next, *elem;
+
+    LY_TREE_FOR(root, top) {
+        LY_TREE_DFS_BEGIN(top, next, elem) {
+            if (elem->lazy_dflt) {
+                return 1;
+            }
+            LY_TREE_DFS_END(top, next, elem);
+        }
+        if (!(options & LYP_WITHSIBLINGS)) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
 static int
 lyd_print_(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, int options)
 {
+    const struct lyd_node *iter;
+    struct lyd_node *dup = NULL, *sibling;
+    int ret;
+
+    if ((format != LYD_LYB) && (options & (LYP_WD_ALL | LYP_WD_ALL_TAG | LYP_WD_IMPL_TAG))
+            && lyd_print_has_lazy(root, options)) {
+        /* the deferred default nodes are printed, instantiate them in a copy of the printed data */
+        LY_TREE_FOR(root, iter) {
+            sibling = lyd_dup(iter, LYD_DUP_OPT_RECURSIVE);
+            if (!sibling || (dup && lyd_insert_after(dup->prev, sibling))) {
+                lyd_free(sibling);
+                lyd_free_withsiblings(dup);
+                return EXIT_FAILURE;
+            }
+            if (!dup) {
+                dup = sibling;
+            }
+            if (!(options & LYP_WITHSIBLINGS)) {
+                break;
+            }
+        }
+        if (lyd_wd_materialize(dup)) {
+            lyd_free_withsiblings(dup);
+            return EXIT_FAILURE;
+        }
+
+        ret = lyd_print_(out, dup, format, options);
+        lyd_free_withsiblings(dup);
+        return ret;
+    }
+
     switch (format) {
     case LYD_XML:
         return xml_print_data(out, root, options);
@@ -76,6 +76,27 @@ int ly_write(struct lyout *out, const char *buf, size_t count);
 int ly_write_skip(struct lyout *out, size_t count, size_t *position);
 int ly_write_skipped(struct lyout *out, size_t position, const char *buf, size_t count);
 
+/**
+ * @brief Character escaping types of the data printers.
+ */
+typedef enum {
+    LY_ESC_XML_ELEM,   /**< XML element content - '&', '<', and '>' */
+    LY_ESC_XML_ATTR,   /**< XML attribute value - '&', '<', '>', and '"' */
+    LY_ESC_JSON        /**< JSON string - '"', '\\', and control characters */
+} LY_ESC_TYPE;
+
+/**
+ * @brief Get the length of the initial part of a text that can be printed without escaping.
+ *
+ * Uses SSE2 instructions if available so that the printers can write long runs of plain text at once.
+ *
+ * @param[in] text Text to scan.
+ * @param[in] len Length of \p text.
+ * @param[in] type Escaping type.
+ * @return Index of the first character to escape, \p len if there is none.
+ */
+size_t ly_escape_span(const char *text, size_t len, LY_ESC_TYPE type);
+
 /* prefix_kind: 0 - print import prefixes for foreign features, 1 - print module names, 2 - print prefixes (tree printer), 3 - print module names including revisions (JSONS printer) */
 int ly_print_iffeature(struct lyout *out, const struct lys_module *module, struct lys_iffeature *expr, int prefix_kind);
 
@@ -90,6 +111,13 @@ int xml_print_data(struct lyout *out, const struct lyd_node *root, int options);
 int xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options);
 int lyb_print_data(struct lyout *out, const struct lyd_node *root, int options);
 
+int json_print_string(struct lyout *out, const char *text);
+
+/**
+ * @brief Learn whether the printed data include implicit default leaves not instantiated yet (#LYD_OPT_LAZY_DFLT).
+ */
+int lyd_print_has_lazy(const struct lyd_node *root, int options);
+
 int lys_print_target(struct lyout *out, const struct lys_module *module, const char *target_schema_path,
                      void (*clb_print_typedef)(struct lyout*, const struct lys_tpdf*, int*),
                      void (*clb_print_identity)(struct lyout*, const struct lys_ident*, int*),
@@ -33,31 +33,41 @@ static int json_print_nodes(struct lyout *out, int level, const struct lyd_node
 int
 json_print_string(struct lyout *out, const char *text)
 {
-    unsigned int i, n;
+    size_t i, len, span;
+    unsigned int n;
 
     if (!text) {
         return 0;
     }
 
+    len = strlen(text);
     ly_write(out, "\"", 1);
-    for (i = n = 0; text[i]; i++) {
-        const unsigned char ascii = text[i];
-        if (ascii < 0x20) {
-            /* control character */
-            n += ly_print(out, "\\u%.4X", ascii);
-        } else {
-            switch (ascii) {
-            case '"':
-                n += ly_print(out, "\\\"");
-                break;
-            case '\\':
-                n += ly_print(out, "\\\\");
+    for (i = n = 0; i < len; i++) {
+        /* print all the characters that do not need escaping at once */
+        span = ly_escape_span(&text[i], len - i, LY_ESC_JSON);
+        if (span) {
+            ly_write(out, &text[i], span);
+            n += span;
+            i += span;
+            if (i == len) {
                 break;
-            default:
-                ly_write(out, &text[i], 1);
-                n++;
             }
         }
+
+        switch (text[i]) {
+        case '"':
+            ly_write(out, "\\\"", 2);
+            n += 2;
+            break;
+        case '\\':
+            ly_write(out, "\\\\", 2);
+            n += 2;
+            break;
+        default:
+            /* control character */
+            n += ly_print(out, "\\u%.4X", (unsigned char)text[i]);
+            break;
+        }
     }
     ly_write(out, "\"", 1);
 
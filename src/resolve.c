@@ -5793,28 +5793,182 @@ resolve_base_ident(const struct lys_module *module, struct lys_ident *ident, con
     return rc;
 }
 
-/*
- * 1 - true (der is derived from base)
- * 0 - false (der is not derived from base)
+/**
+ * @brief Record of the context identity index (ly_ctx::ident_index).
  */
+struct resolve_ident_bases {
+    const struct lys_ident *ident;   /**< identity with a base */
+    struct hash_table *bases;        /**< all its (transitive) base identities */
+};
+
+static int
+resolve_identity_equal_cb(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return *(struct lys_ident **)val1_p == *(struct lys_ident **)val2_p;
+}
+
 static int
-search_base_identity(struct lys_ident *der, struct lys_ident *base)
+resolve_ident_bases_equal_cb(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct resolve_ident_bases *)val1_p)->ident == ((struct resolve_ident_bases *)val2_p)->ident;
+}
+
+static uint32_t
+resolve_identity_hash(const struct lys_ident *ident)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&ident, sizeof ident);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Add a base identity with all its bases into the base set of an identity.
+ *
+ * @param[in] bases Base set of the identity.
+ * @param[in] base Base identity to add.
+ * @return 0 on success, -1 on error.
+ */
+static int
+resolve_identity_index_add(struct hash_table *bases, struct lys_ident *base)
+{
+    uint8_t i;
+    int r;
+
+    r = lyht_insert(bases, &base, resolve_identity_hash(base), NULL);
+    if (r == 1) {
+        /* already added with all its bases (diamond) */
+        return 0;
+    } else if (r) {
+        return -1;
+    }
+
+    for (i = 0; i < base->base_size; ++i) {
+        if (resolve_identity_index_add(bases, base->base[i])) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void
+resolve_identity_index(struct lys_module *module)
+{
+    struct ly_ctx *ctx = module->ctx;
+    struct lys_module *mod;
+    struct resolve_ident_bases rec;
+    uint32_t i, hash;
+    uint8_t u, v;
+
+    if (!ctx->ident_index) {
+        ctx->ident_index = lyht_new(8, sizeof rec, resolve_ident_bases_equal_cb, NULL, 1);
+        LY_CHECK_ERR_RETURN(!ctx->ident_index, LOGMEM(ctx), );
+    }
+
+    for (v = 0; v <= module->inc_size; ++v) {
+        mod = v ? (struct lys_module *)module->inc[v - 1].submodule : module;
+        if (!mod) {
+            continue;
+        }
+        for (i = 0; i < mod->ident_size; ++i) {
+            rec.ident = &mod->ident[i];
+            hash = resolve_identity_hash(rec.ident);
+            if (!rec.ident->base_size || !lyht_find(ctx->ident_index, &rec, hash, NULL)) {
+                continue;
+            }
+
+            rec.bases = lyht_new(8, sizeof(struct lys_ident *), resolve_identity_equal_cb, NULL, 1);
+            LY_CHECK_ERR_RETURN(!rec.bases, LOGMEM(ctx), );
+            for (u = 0; u < rec.ident->base_size; ++u) {
+                if (resolve_identity_index_add(rec.bases, rec.ident->base[u])) {
+                    break;
+                }
+            }
+            if ((u < rec.ident->base_size) || lyht_insert(ctx->ident_index, &rec, hash, NULL)) {
+                /* the bases will be searched instead */
+                LOGMEM(ctx);
+                lyht_free(rec.bases);
+                return;
+            }
+        }
+    }
+}
+
+void
+resolve_identity_index_remove(struct ly_ctx *ctx, const struct lys_ident *ident)
+{
+    struct resolve_ident_bases rec, *match;
+    uint32_t hash;
+
+    if (!ident->base_size || !ctx->ident_index) {
+        return;
+    }
+
+    rec.ident = ident;
+    hash = resolve_identity_hash(ident);
+    if (!lyht_find(ctx->ident_index, &rec, hash, (void **)&match)) {
+        lyht_free(match->bases);
+        lyht_remove(ctx->ident_index, &rec, hash);
+    }
+}
+
+int
+resolve_identity_derived(const struct lys_ident *der, const struct lys_ident *base)
 {
+    struct hash_table *ident_index;
+    struct resolve_ident_bases rec, *match;
     int i;
 
     if (der == base) {
         return 1;
-    } else {
-        for(i = 0; i < der->base_size; i++) {
-            if (search_base_identity(der->base[i], base) == 1) {
-                return 1;
-            }
+    }
+
+    ident_index = der->module->ctx->ident_index;
+    rec.ident = der;
+    if (der->base_size && ident_index
+            && !lyht_find(ident_index, &rec, resolve_identity_hash(der), (void **)&match)) {
+        return lyht_find(match->bases, &base, resolve_identity_hash(base), NULL) ? 0 : 1;
+    }
+
+    /* the module of the identity is still being parsed, search the bases */
+    for (i = 0; i < der->base_size; i++) {
+        if (resolve_identity_derived(der->base[i], base)) {
+            return 1;
         }
     }
 
     return 0;
 }
 
+struct lys_ident *
+resolve_identity_find(const struct lys_module *module, const char *name, int nam_len)
+{
+    uint32_t i, j;
+    struct lys_module *sub;
+
+    if (!nam_len) {
+        nam_len = strlen(name);
+    }
+
+    for (i = 0; i < module->ident_size; i++) {
+        if (!strncmp(name, module->ident[i].name, nam_len) && !module->ident[i].name[nam_len]) {
+            return &module->ident[i];
+        }
+    }
+
+    /* go through includes */
+    for (j = 0; j < module->inc_size && module->inc[j].submodule; j++) {
+        sub = (struct lys_module *)module->inc[j].submodule;
+        for (i = 0; i < sub->ident_size; i++) {
+            if (!strncmp(name, sub->ident[i].name, nam_len) && !sub->ident[i].name[nam_len]) {
+                return &sub->ident[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Resolve JSON data format identityref. Logs directly.
  *
@@ -5832,7 +5986,7 @@ resolve_identref(struct lys_type *type, const char *ident_name, struct lyd_node
     char *str;
     int mod_name_len, nam_len, rc;
     int need_implemented = 0;
-    unsigned int i, j, found;
+    unsigned int i, found;
     struct lys_ident *der, *cur;
     struct lys_module *imod = NULL, *m, *tmod;
     struct ly_ctx *ctx;
@@ -5937,33 +6091,16 @@ resolve_identref(struct lys_type *type, const char *ident_name, struct lyd_node
          * THEN, we may need to make the module with the identity implemented, but only if it really
          * contains the identity */
         if (!imod->implemented) {
-            cur = NULL;
             /* get the identity in the module */
-            for (i = 0; i < imod->ident_size; i++) {
-                if (!strcmp(name, imod->ident[i].name)) {
-                    cur = &imod->ident[i];
-                    break;
-                }
-            }
+            cur = resolve_identity_find(imod, name, nam_len);
             if (!cur) {
-                /* go through includes */
-                for (j = 0; j < imod->inc_size; j++) {
-                    for (i = 0; i < imod->inc[j].submodule->ident_size; i++) {
-                        if (!strcmp(name, imod->inc[j].submodule->ident[i].name)) {
-                            cur = &imod->inc[j].submodule->ident[i];
-                            break;
-                        }
-                    }
-                }
-                if (!cur) {
-                    goto fail;
-                }
+                goto fail;
             }
 
             /* check that identity is derived from one of the type's base */
             while (type->der) {
                 for (i = 0; i < type->info.ident.count; i++) {
-                    if (search_base_identity(cur, type->info.ident.ref[i])) {
+                    if (resolve_identity_derived(cur, type->info.ident.ref[i])) {
                         /* cur's base matches the type's base */
                         need_implemented = 1;
                         goto match;
@@ -5977,26 +6114,21 @@ resolve_identref(struct lys_type *type, const char *ident_name, struct lyd_node
         }
     }
 
-    /* go through all the derived types of all the bases */
+    /* find the identity once and check its derivation from all the bases by their pointers, only implemented
+     * identities (the ones with backlinks in the bases) are allowed */
+    der = imod->implemented && !imod->disabled ? resolve_identity_find(imod, name, nam_len) : NULL;
     found = 0;
     for (i = 0; i < type->info.ident.count; ++i) {
         cur = type->info.ident.ref[i];
-        if (cur->der) {
-            /* there are some derived identities */
-            for (j = 0; j < cur->der->number; j++) {
-                der = (struct lys_ident *)cur->der->set.g[j]; /* shortcut */
-                if (!strcmp(der->name, name) && lys_main_module(der->module) == imod) {
-                    /* we have a match on this base */
-                    ++found;
-                    break;
-                }
-            }
-        } else {
+        if (!cur->der) {
             LOGWRN(ctx, "Identity \"%s\" has no derived identities, identityref with this base can never be instatiated.",
                    cur->name);
+        } else if (der && (der != cur) && resolve_identity_derived(der, cur)) {
+            /* we have a match on this base */
+            ++found;
         }
     }
-    if (found == type->info.ident.count) {
+    if (der && (found == type->info.ident.count)) {
         /* match found for all bases */
         cur = der;
         goto match;
@@ -7986,7 +8118,7 @@ resolve_leafref(struct lyd_node_leaf_list *leaf, const char *path, int req_inst,
 
             /* not that the value is already in canonical form since the parsers does the conversion,
              * so we can simply compare just the values */
-            if (ly_strequal(leaf->value_str, ((struct lyd_node_leaf_list *)xp_set.val.nodes[i].node)->value_str, 1)) {
+            if (ly_strequal(leaf->value_str, ((struct lyd_node_leaf_list *)xp_set.val.nodes[i].node)->value_str, 0)) {
                 /* we have the match */
                 *ret = xp_set.val.nodes[i].node;
                 break;
@@ -8307,6 +8439,30 @@ unres_data_add(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM
     return 0;
 }
 
+int
+unres_data_merge(struct unres_data *unres, struct unres_data *from)
+{
+    if (!from->count) {
+        return 0;
+    }
+
+    unres->node = ly_realloc(unres->node, (unres->count + from->count) * sizeof *unres->node);
+    LY_CHECK_ERR_RETURN(!unres->node, LOGMEM(NULL), -1);
+    memcpy(&unres->node[unres->count], from->node, from->count * sizeof *unres->node);
+    unres->type = ly_realloc(unres->type, (unres->count + from->count) * sizeof *unres->type);
+    LY_CHECK_ERR_RETURN(!unres->type, LOGMEM(NULL), -1);
+    memcpy(&unres->type[unres->count], from->type, from->count * sizeof *unres->type);
+    unres->count += from->count;
+
+    free(from->node);
+    from->node = NULL;
+    free(from->type);
+    from->type = NULL;
+    from->count = 0;
+
+    return 0;
+}
+
 static void
 resolve_unres_data_autodel_diff(struct unres_data *unres, uint32_t unres_i)
 {
@@ -98,6 +98,9 @@ struct unres_data {
     struct lyd_difflist *diff;
     unsigned int diff_size;
     unsigned int diff_idx;
+
+    struct dict_pin *pin;   /* pinned input buffer the parsed values can reference (#LYD_OPT_PIN_INPUT) */
+    const struct ly_set *filter; /* schema nodes of the subtrees to parse (#LYD_OPT_FILTER) */
 };
 
 /**
@@ -168,6 +171,43 @@ int inherit_config_flag(struct lys_node *node, int flags, int clear);
 
 void resolve_identity_backlink_update(struct lys_ident *der, struct lys_ident *base);
 
+/**
+ * @brief Add all the identities of a module and its submodules with their (transitive) base identities into
+ *        the context identity index (ly_ctx::ident_index), so that their derivation can be checked in constant
+ *        time. The module must be complete.
+ *
+ * @param[in] module Main module just added into its context.
+ */
+void resolve_identity_index(struct lys_module *module);
+
+/**
+ * @brief Remove an identity being freed from the context identity index (ly_ctx::ident_index).
+ *
+ * @param[in] ctx Context of the identity.
+ * @param[in] ident Identity to remove.
+ */
+void resolve_identity_index_remove(struct ly_ctx *ctx, const struct lys_ident *ident);
+
+/**
+ * @brief Check whether an identity is derived from another one (or is the same identity). The check
+ *        uses the base index of \p der or, while its module is being parsed, follows the resolved base pointers.
+ *
+ * @param[in] der Identity to check.
+ * @param[in] base Supposed (transitive) base identity of \p der.
+ * @return 1 if \p der is \p base or is derived from it, 0 otherwise.
+ */
+int resolve_identity_derived(const struct lys_ident *der, const struct lys_ident *base);
+
+/**
+ * @brief Find an identity defined in a module or any of its submodules. Does not log.
+ *
+ * @param[in] module Main module to search in.
+ * @param[in] name Identity name.
+ * @param[in] nam_len Length of \p name, 0 if \p name is NULL-terminated.
+ * @return Found identity, NULL if there is none.
+ */
+struct lys_ident *resolve_identity_find(const struct lys_module *module, const char *name, int nam_len);
+
 struct lyd_node *resolve_data_descendant_schema_nodeid(const char *nodeid, struct lyd_node *start);
 
 int resolve_schema_nodeid(const char *nodeid, const struct lys_node *start, const struct lys_module *cur_module,
@@ -253,6 +293,15 @@ int resolve_unres_data_item(struct lyd_node *dnode, enum UNRES_ITEM type, int ig
 
 int unres_data_addonly(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
 int unres_data_add(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
+
+/**
+ * @brief Move all the items of \p from to the end of \p unres.
+ *
+ * @param[in] unres Unres structure to add to.
+ * @param[in] from Unres structure to take the items from, it is emptied.
+ * @return 0 on success, -1 on error.
+ */
+int unres_data_merge(struct unres_data *unres, struct unres_data *from);
 void unres_data_del(struct unres_data *unres, uint32_t i);
 
 int resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node **root, int options);
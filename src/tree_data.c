@@ -114,16 +114,13 @@ lyd_list_has_keys(struct lyd_node *list)
 }
 
 static int
-lyd_leaf_val_equal(struct lyd_node *node1, struct lyd_node *node2, int diff_ctx)
+lyd_leaf_val_equal(struct lyd_node *node1, struct lyd_node *node2)
 {
     assert(node1->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST));
     assert(node1->schema->nodetype == node2->schema->nodetype);
 
-    if (diff_ctx) {
-        return ly_strequal(((struct lyd_node_leaf_list *)node1)->value_str, ((struct lyd_node_leaf_list *)node2)->value_str, 0);
-    } else {
-        return ly_strequal(((struct lyd_node_leaf_list *)node1)->value_str, ((struct lyd_node_leaf_list *)node2)->value_str, 1);
-    }
+    /* values in the same context may not be dictionary strings either (#LYD_OPT_PIN_INPUT) */
+    return ly_strequal(((struct lyd_node_leaf_list *)node1)->value_str, ((struct lyd_node_leaf_list *)node2)->value_str, 0);
 }
 
 /*
@@ -143,7 +140,7 @@ lyd_list_equal(struct lyd_node *node1, struct lyd_node *node2, int with_defaults
 
     switch (node2->schema->nodetype) {
     case LYS_LEAFLIST:
-        if (lyd_leaf_val_equal(node1, node2, diff_ctx) && (!with_defaults || (node1->dflt == node2->dflt))) {
+        if (lyd_leaf_val_equal(node1, node2) && (!with_defaults || (node1->dflt == node2->dflt))) {
             return 1;
         }
         break;
@@ -170,7 +167,7 @@ lyd_list_equal(struct lyd_node *node1, struct lyd_node *node2, int with_defaults
                     }
                 }
                 if (!elem1 || !elem2 || ((elem1_sch ? elem1_sch : elem1->schema) != elem2->schema)
-                        || !lyd_leaf_val_equal(elem1, elem2, diff_ctx)) {
+                        || !lyd_leaf_val_equal(elem1, elem2)) {
                     break;
                 }
                 elem1 = elem1->next;
@@ -220,7 +217,7 @@ lyd_list_equal(struct lyd_node *node1, struct lyd_node *node2, int with_defaults
                     }
                     /* we will compare all the children of this list instance, not just keys */
                 } else if (elem2->schema->nodetype & (LYS_LEAFLIST | LYS_LEAF)) {
-                    if (!lyd_leaf_val_equal(elem1, elem2, diff_ctx) && (!with_defaults || (elem1->dflt == elem2->dflt))) {
+                    if (!lyd_leaf_val_equal(elem1, elem2) && (!with_defaults || (elem1->dflt == elem2->dflt))) {
                         break;
                     }
                 } else if (elem2->schema->nodetype & LYS_ANYDATA) {
@@ -435,6 +432,8 @@ _lyd_insert_hash(struct lyd_node *node, int keyless_list_check)
                 if (i == LY_CACHE_HT_MIN_CHILDREN) {
                     /* create hash table, insert all the children */
                     node->parent->ht = lyht_new(1, sizeof(struct lyd_node *), lyd_hash_table_val_equal, NULL, 1);
+                    /* children of huge lists must not stall on resizing */
+                    lyht_set_incremental(node->parent->ht, 1);
                     LY_TREE_FOR(node->parent->child, iter) {
                         if ((iter->schema->nodetype == LYS_LIST) && !lyd_list_has_keys(iter)) {
                             /* skip lists without keys */
@@ -594,6 +593,26 @@ lyd_is_when_false(struct lyd_node *root, struct lyd_node *last_parent, struct ly
     return 0;
 }
 
+/**
+ * @brief Learn whether a data tree walk can skip a schema subtree because the subtree summary
+ * (see #LYS_DFLT_DESC and #LYS_MAND_DESC) proves there is nothing to do in it.
+ *
+ * @param[in] schema Schema node to examine.
+ * @param[in] summary Summary flag the walk is interested in.
+ * @param[in] options @ref parseroptions of the walk.
+ * @return 1 if the subtree can be skipped, 0 otherwise.
+ */
+static int
+lyd_schema_skip(const struct lys_node *schema, uint16_t summary, int options)
+{
+    if (options & LYD_OPT_DATA_TEMPLATE) {
+        /* yang-data templates are not summarized */
+        return 0;
+    }
+
+    return !(lys_subtree_flags(schema) & summary);
+}
+
 /**
  * @param[in] root Root node to be able search the data tree in case of no instance
  * @return
@@ -708,7 +727,7 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
 
     assert(schema);
 
-    if (lys_is_disabled(schema, 0)) {
+    if (lyd_schema_skip(schema, LYS_MAND_DESC, options) || lys_is_disabled(schema, 0)) {
         return EXIT_SUCCESS;
     }
 
@@ -927,13 +946,109 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct
     return EXIT_SUCCESS;
 }
 
+struct lyd_node *
+lyd_parse_data_end(struct ly_ctx *ctx, struct lyd_node *result, LYD_FORMAT format, int options)
+{
+    if (ly_errno) {
+        lyd_free_withsiblings(result);
+        return NULL;
+    }
+
+    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
+        /* rpc and rpc-reply must be sorted */
+        lyd_free_withsiblings(result);
+        return NULL;
+    }
+
+    if (result && (format != LYD_XML) && (ctx->models.flags & LY_CTX_SCHEMA_ORDER)
+            && !(options & LYD_OPT_DATA_TEMPLATE)) {
+        /* the XML parser inserts the nodes in the schema order, the other ones are just checked (the data are
+         * mostly ordered) */
+        if (lyd_schema_sort(result, 1)) {
+            lyd_free_withsiblings(result);
+            return NULL;
+        }
+        result = lyd_first_sibling(result);
+    }
+
+    return result;
+}
+
+int
+lyd_filter_skip(const struct ly_set *filter, const struct lys_node *schema)
+{
+    const struct lys_node *siter;
+    unsigned int i;
+
+    for (i = 0; i < filter->number; ++i) {
+        /* in a selected subtree */
+        for (siter = schema; siter && (siter != filter->set.s[i]); siter = lys_parent(siter));
+        if (siter) {
+            return 0;
+        }
+
+        /* on the path to a selected subtree */
+        for (siter = lys_parent(filter->set.s[i]); siter && (siter != schema); siter = lys_parent(siter));
+        if (siter) {
+            return 0;
+        }
+    }
+
+    if ((schema->nodetype == LYS_LEAF) && lys_is_key((struct lys_node_leaf *)schema, NULL)) {
+        /* key of a parsed list instance */
+        return 0;
+    }
+
+    return 1;
+}
+
+int
+lyd_parse_append(struct lyd_node **result, struct lyd_node *first, int options)
+{
+    struct lyd_node *iter, *diter, *plast;
+    struct lys_node *sparent;
+
+    if (!first) {
+        return EXIT_SUCCESS;
+    } else if (!*result) {
+        *result = first;
+        return EXIT_SUCCESS;
+    }
+
+    /* connect the siblings */
+    plast = first->prev;
+    (*result)->prev->next = first;
+    first->prev = (*result)->prev;
+    (*result)->prev = plast;
+
+    /* the instances were checked only against the nodes parsed together with them */
+    for (iter = first; iter; iter = iter->next) {
+        if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
+                && (iter->schema->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_ANYDATA))) {
+            for (diter = *result; diter != first; diter = diter->next) {
+                if (diter->schema == iter->schema) {
+                    LOGVAL(iter->schema->module->ctx, LYE_TOOMANY, LY_VLOG_LYD, iter, iter->schema->name, "data tree");
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        for (sparent = lys_parent(iter->schema); sparent && (sparent->nodetype == LYS_USES); sparent = lys_parent(sparent));
+        if (sparent && (sparent->nodetype & (LYS_CHOICE | LYS_CASE)) && lyv_multicases(iter, NULL, result, 0, NULL)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static struct lyd_node *
 lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data, LYD_FORMAT format, int options,
-           const struct lyd_node *data_tree, const char *yang_data_name)
+           const struct lyd_node *data_tree, const char *yang_data_name, const struct ly_set *filter)
 {
     struct lyxml_elem *xml;
     struct lyd_node *result = NULL;
-    int xmlopt = LYXML_PARSE_MULTIROOT;
+    int xmlopt = LYXML_PARSE_MULTIROOT, parallel = 0;
 
     if (!ctx || !data) {
         LOGARG;
@@ -944,10 +1059,26 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
         xmlopt = 0;
     }
 
+    if (options & LYD_OPT_PARALLEL) {
+        switch (options & LYD_OPT_TYPEMASK) {
+        case LYD_OPT_DATA:
+        case LYD_OPT_CONFIG:
+        case LYD_OPT_GET:
+        case LYD_OPT_GETCONFIG:
+            parallel = !(options & LYD_OPT_NOSIBLINGS);
+            break;
+        }
+        options &= ~LYD_OPT_PARALLEL;
+    }
+
     /* we must free all the errors, otherwise we are unable to properly check returned ly_errno :-/ */
     ly_errno = LY_SUCCESS;
     switch (format) {
     case LYD_XML:
+        if (parallel) {
+            result = lyd_parse_xml_parallel(ctx, data, options, filter);
+            break;
+        }
         xml = lyxml_parse_mem(ctx, data, xmlopt);
         if (ly_errno) {
             break;
@@ -958,85 +1089,101 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
             result = lyd_parse_xml(ctx, &xml, options, data_tree);
         } else if (options & LYD_OPT_DATA_TEMPLATE) {
             result = lyd_parse_xml(ctx, &xml, options, yang_data_name);
+        } else if (options & LYD_OPT_FILTER) {
+            result = lyd_parse_xml(ctx, &xml, options, filter);
         } else {
             result = lyd_parse_xml(ctx, &xml, options);
         }
         lyxml_free_withsiblings(ctx, xml);
         break;
     case LYD_JSON:
-        result = lyd_parse_json(ctx, data, options, rpc_act, data_tree, yang_data_name);
+        if (parallel) {
+            result = lyd_parse_json_parallel(ctx, data, options, filter);
+        } else {
+            result = lyd_parse_json(ctx, data, options, rpc_act, data_tree, yang_data_name, filter);
+        }
         break;
     case LYD_LYB:
-        result = lyd_parse_lyb(ctx, data, options, data_tree, yang_data_name, NULL);
+        result = lyd_parse_lyb(ctx, data, options, data_tree, yang_data_name, filter, NULL);
         break;
     default:
         /* error */
         break;
     }
 
-    if (ly_errno) {
-        lyd_free_withsiblings(result);
-        return NULL;
-    }
-
-    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
-        /* rpc and rpc-reply must be sorted */
-        lyd_free_withsiblings(result);
-        return NULL;
-    }
-
-    return result;
+    return lyd_parse_data_end(ctx, result, format, options);
 }
 
-static struct lyd_node *
-lyd_parse_data_(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int options, va_list ap)
+int
+lyd_parse_data_args(struct ly_ctx *ctx, int options, va_list ap, const struct lyd_node **rpc_act,
+                    const struct lyd_node **data_tree, const char **yang_data_name, const struct ly_set **filter)
 {
-    const struct lyd_node *rpc_act = NULL, *data_tree = NULL, *iter;
-    const char *yang_data_name = NULL;
+    const struct lyd_node *iter;
 
     if (lyp_data_check_options(ctx, options, __func__)) {
-        return NULL;
+        return EXIT_FAILURE;
     }
 
     if (options & LYD_OPT_RPCREPLY) {
-        rpc_act = va_arg(ap, const struct lyd_node *);
-        if (!rpc_act || rpc_act->parent || !(rpc_act->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
+        *rpc_act = va_arg(ap, const struct lyd_node *);
+        if (!*rpc_act || (*rpc_act)->parent || !((*rpc_act)->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
             LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
-            return NULL;
+            return EXIT_FAILURE;
         }
     }
     if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY)) {
-        data_tree = va_arg(ap, const struct lyd_node *);
-        if (data_tree) {
+        *data_tree = va_arg(ap, const struct lyd_node *);
+        if (*data_tree) {
             if (options & LYD_OPT_NOEXTDEPS) {
                 LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree and LYD_OPT_NOEXTDEPS set).",
                        __func__);
-                return NULL;
+                return EXIT_FAILURE;
             }
 
-            LY_TREE_FOR(data_tree, iter) {
+            LY_TREE_FOR(*data_tree, iter) {
                 if (iter->parent) {
                     /* a sibling is not top-level */
                     LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *data_tree).", __func__);
-                    return NULL;
+                    return EXIT_FAILURE;
                 }
             }
 
             /* move it to the beginning */
-            for (; data_tree->prev->next; data_tree = data_tree->prev);
+            for (; (*data_tree)->prev->next; *data_tree = (*data_tree)->prev);
 
             /* LYD_OPT_NOSIBLINGS cannot be set in this case */
             if (options & LYD_OPT_NOSIBLINGS) {
                 LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree with LYD_OPT_NOSIBLINGS).", __func__);
-                return NULL;
+                return EXIT_FAILURE;
             }
         }
     }
     if (options & LYD_OPT_DATA_TEMPLATE) {
-        yang_data_name = va_arg(ap, const char *);
+        *yang_data_name = va_arg(ap, const char *);
+    }
+    if (options & LYD_OPT_FILTER) {
+        *filter = va_arg(ap, const struct ly_set *);
+        if (!*filter) {
+            LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct ly_set *filter).", __func__);
+            return EXIT_FAILURE;
+        }
     }
 
-    return lyd_parse_(ctx, rpc_act, data, format, options, data_tree, yang_data_name);
+    return EXIT_SUCCESS;
+}
+
+static struct lyd_node *
+lyd_parse_data_(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int options, va_list ap)
+{
+    const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
+    const char *yang_data_name = NULL;
+    const struct ly_set *filter = NULL;
+
+    if (lyd_parse_data_args(ctx, options, ap, &rpc_act, &data_tree, &yang_data_name, &filter)) {
+        return NULL;
+    }
+
+    return lyd_parse_(ctx, rpc_act, data, format, options, data_tree, yang_data_name, filter);
 }
 
 API struct lyd_node *
@@ -1047,6 +1194,9 @@ lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int optio
     va_list ap;
     struct lyd_node *result;
 
+    /* the buffer is owned by the caller */
+    options &= ~LYD_OPT_PIN_INPUT;
+
     va_start(ap, options);
     result = lyd_parse_data_(ctx, data, format, options, ap);
     va_end(ap);
@@ -1058,6 +1208,7 @@ static struct lyd_node *
 lyd_parse_fd_(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, va_list ap)
 {
     struct lyd_node *ret;
+    struct dict_pin *pin = NULL;
     size_t length;
     char *data;
 
@@ -1073,9 +1224,24 @@ lyd_parse_fd_(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, va_lis
         return NULL;
     }
 
+    if ((options & LYD_OPT_PIN_INPUT) && (format == LYD_JSON)) {
+        /* the parsed values may reference the input, the dictionary takes it over */
+        pin = lydict_pin(ctx, data, length);
+        if (!pin) {
+            lyp_munmap(data, length);
+            return NULL;
+        }
+    } else {
+        options &= ~LYD_OPT_PIN_INPUT;
+    }
+
     ret = lyd_parse_data_(ctx, data, format, options, ap);
 
-    lyp_munmap(data, length);
+    if (pin) {
+        lydict_unpin(ctx, pin);
+    } else {
+        lyp_munmap(data, length);
+    }
 
     return ret;
 }
@@ -1835,6 +2001,65 @@ lyd_new_path_update(struct lyd_node *node, void *value, LYD_ANYDATA_VALUETYPE va
     return NULL;
 }
 
+/**
+ * @brief Find the schema node of a data path step.
+ *
+ * @param[in] sparent Schema parent of the step, NULL for top-level nodes.
+ * @param[in] module Module to search in for top-level nodes.
+ * @param[in] prev_mod Module of the previous step used when \p mod_name is not set.
+ * @param[in] mod_name Module name of the step, NULL if not specified.
+ * @param[in] mod_name_len Length of \p mod_name.
+ * @param[in] name Schema node name of the step.
+ * @param[in] nam_len Length of \p name.
+ * @param[in] options Data path options, only #LYD_PATH_OPT_OUTPUT is used.
+ * @return Found schema node, NULL if there is none.
+ */
+static const struct lys_node *
+lyd_new_path_find_schema(const struct lys_node *sparent, const struct lys_module *module, const struct lys_module *prev_mod,
+                         const char *mod_name, int mod_name_len, const char *name, int nam_len, int options)
+{
+    const struct lys_node *schild = NULL, *tmp;
+    const char *node_mod_name;
+
+    while ((schild = lys_getnext(schild, sparent, module, 0))) {
+        if (schild->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST
+                                | LYS_ANYDATA | LYS_NOTIF | LYS_RPC | LYS_ACTION)) {
+            /* module comparison */
+            if (mod_name) {
+                node_mod_name = lys_node_module(schild)->name;
+                if (strncmp(node_mod_name, mod_name, mod_name_len) || node_mod_name[mod_name_len]) {
+                    continue;
+                }
+            } else if (lys_node_module(schild) != prev_mod) {
+                continue;
+            }
+
+            /* name check */
+            if (strncmp(schild->name, name, nam_len) || schild->name[nam_len]) {
+                continue;
+            }
+
+            /* RPC/action in/out check */
+            for (tmp = lys_parent(schild); tmp && (tmp->nodetype == LYS_USES); tmp = lys_parent(tmp));
+            if (tmp) {
+                if (options & LYD_PATH_OPT_OUTPUT) {
+                    if (tmp->nodetype == LYS_INPUT) {
+                        continue;
+                    }
+                } else {
+                    if (tmp->nodetype == LYS_OUTPUT) {
+                        continue;
+                    }
+                }
+            }
+
+            break;
+        }
+    }
+
+    return schild;
+}
+
 API struct lyd_node *
 lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *path, void *value,
              LYD_ANYDATA_VALUETYPE value_type, int options)
@@ -1842,9 +2067,9 @@ lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *p
     FUN_IN;
 
     char *str;
-    const char *mod_name, *name, *val_name, *val, *node_mod_name, *id, *backup_mod_name = NULL, *yang_data_name = NULL;
+    const char *mod_name, *name, *val_name, *val, *id, *backup_mod_name = NULL, *yang_data_name = NULL;
     struct lyd_node *ret = NULL, *node, *parent = NULL;
-    const struct lys_node *schild, *sparent, *tmp;
+    const struct lys_node *schild, *sparent;
     const struct lys_node_list *slist;
     const struct lys_module *module, *prev_mod;
     int r, i, parsed = 0, mod_name_len, nam_len, val_name_len, val_len;
@@ -1990,43 +2215,7 @@ lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *p
     /* create nodes in a loop */
     while (1) {
         /* find the schema node */
-        schild = NULL;
-        while ((schild = lys_getnext(schild, sparent, module, 0))) {
-            if (schild->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST
-                                    | LYS_ANYDATA | LYS_NOTIF | LYS_RPC | LYS_ACTION)) {
-                /* module comparison */
-                if (mod_name) {
-                    node_mod_name = lys_node_module(schild)->name;
-                    if (strncmp(node_mod_name, mod_name, mod_name_len) || node_mod_name[mod_name_len]) {
-                        continue;
-                    }
-                } else if (lys_node_module(schild) != prev_mod) {
-                    continue;
-                }
-
-                /* name check */
-                if (strncmp(schild->name, name, nam_len) || schild->name[nam_len]) {
-                    continue;
-                }
-
-                /* RPC/action in/out check */
-                for (tmp = lys_parent(schild); tmp && (tmp->nodetype == LYS_USES); tmp = lys_parent(tmp));
-                if (tmp) {
-                    if (options & LYD_PATH_OPT_OUTPUT) {
-                        if (tmp->nodetype == LYS_INPUT) {
-                            continue;
-                        }
-                    } else {
-                        if (tmp->nodetype == LYS_OUTPUT) {
-                            continue;
-                        }
-                    }
-                }
-
-                break;
-            }
-        }
-
+        schild = lyd_new_path_find_schema(sparent, module, prev_mod, mod_name, mod_name_len, name, nam_len, options);
         if (!schild) {
             str = strndup(path, (name + nam_len) - path);
             LOGVAL(ctx, LYE_PATH_INNODE, LY_VLOG_STR, str);
@@ -2162,38 +2351,430 @@ lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *p
             return ret;
         }
 
-        /* prepare for another iteration */
-        parent = node;
-        sparent = schild;
-        prev_mod = lys_node_module(schild);
+        /* prepare for another iteration */
+        parent = node;
+        sparent = schild;
+        prev_mod = lys_node_module(schild);
+
+        /* parse another node */
+        if ((r = parse_schema_nodeid(id, &mod_name, &mod_name_len, &name, &nam_len, &is_relative, &has_predicate, NULL, 0)) < 1) {
+            LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[-r], &id[-r]);
+            lyd_free(ret);
+            return NULL;
+        }
+        id += r;
+
+        /* if a key of a list was supposed to be created, it is created as a part of the list instance creation */
+        if ((schild->nodetype == LYS_LIST) && !mod_name) {
+            slist = (const struct lys_node_list *)schild;
+            for (i = 0; i < slist->keys_size; ++i) {
+                if (!strncmp(slist->keys[i]->name, name, nam_len) && !slist->keys[i]->name[nam_len]) {
+                    /* the path continues? there cannot be anything after a key (leaf) */
+                    if (id[0]) {
+                        LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[0], id);
+                        lyd_free(ret);
+                        return NULL;
+                    }
+                    return ret;
+                }
+            }
+        }
+    }
+
+    LOGINT(ctx);
+    return NULL;
+}
+
+API struct lyd_path *
+lyd_path_compile(const struct ly_ctx *ctx, const char *path, int options)
+{
+    FUN_IN;
+
+    struct lyd_path *cpath;
+    const struct lys_node *sparent = NULL, *schild, **snodes;
+    const struct lys_module *module = NULL;
+    const char *id, *mod_name, *name;
+    char *str;
+    int r, mod_name_len, nam_len, is_relative = -1, has_predicate;
+
+    if (!ctx || !path || (path[0] != '/')) {
+        LOGARG;
+        return NULL;
+    }
+
+    cpath = calloc(1, sizeof *cpath);
+    LY_CHECK_ERR_RETURN(!cpath, LOGMEM(ctx), NULL);
+    cpath->ctx = ctx;
+    cpath->options = options & LYD_PATH_OPT_OUTPUT;
+
+    for (id = path; id[0]; id += r) {
+        if ((r = parse_schema_nodeid(id, &mod_name, &mod_name_len, &name, &nam_len, &is_relative, &has_predicate, NULL, 0)) < 1) {
+            LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[-r], &id[-r]);
+            goto error;
+        }
+        if (has_predicate) {
+            /* key and leaf-list values are provided when the path is used */
+            LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[r], &id[r]);
+            goto error;
+        }
+
+        if (!sparent && !module) {
+            /* the first node */
+            if (!mod_name) {
+                str = strndup(path, (name + nam_len) - path);
+                LOGVAL(ctx, LYE_PATH_MISSMOD, LY_VLOG_STR, str);
+                free(str);
+                goto error;
+            }
+            module = ly_ctx_nget_module(ctx, mod_name, mod_name_len, NULL, 1);
+            if (!module) {
+                str = strndup(path, (mod_name + mod_name_len) - path);
+                LOGVAL(ctx, LYE_PATH_INMOD, LY_VLOG_STR, str);
+                free(str);
+                goto error;
+            }
+            mod_name = NULL;
+        } else if (sparent->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
+            /* the previous node cannot have any children */
+            LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[0], id);
+            goto error;
+        }
+
+        schild = lyd_new_path_find_schema(sparent, module, sparent ? lys_node_module(sparent) : module, mod_name,
+                                          mod_name_len, name, nam_len, options);
+        if (!schild) {
+            str = strndup(path, (name + nam_len) - path);
+            LOGVAL(ctx, LYE_PATH_INNODE, LY_VLOG_STR, str);
+            free(str);
+            goto error;
+        }
+
+        if (sparent && (sparent->nodetype == LYS_LIST) && (schild->nodetype == LYS_LEAF)
+                && lys_is_key((struct lys_node_leaf *)schild, NULL)) {
+            /* keys are always created with their list */
+            str = strndup(path, (name + nam_len) - path);
+            LOGVAL(ctx, LYE_SPEC, LY_VLOG_STR, str, "List key \"%s\" cannot be the target of a compiled path.", schild->name);
+            free(str);
+            goto error;
+        }
+        if (sparent && (sparent->nodetype == LYS_LIST) && !((struct lys_node_list *)sparent)->keys_size) {
+            /* key-less list instances cannot be identified */
+            str = strndup(path, (name + nam_len) - path);
+            LOGVAL(ctx, LYE_SPEC, LY_VLOG_STR, str, "Key-less list \"%s\" can only be the last node of a compiled path.",
+                   sparent->name);
+            free(str);
+            goto error;
+        }
+
+        snodes = realloc(cpath->snodes, (cpath->count + 1) * sizeof *cpath->snodes);
+        LY_CHECK_ERR_GOTO(!snodes, LOGMEM(ctx), error);
+        cpath->snodes = snodes;
+        cpath->snodes[cpath->count++] = schild;
+        if (schild->nodetype == LYS_LIST) {
+            cpath->keys_count += ((struct lys_node_list *)schild)->keys_size;
+        }
+
+        sparent = schild;
+    }
+
+    return cpath;
+
+error:
+    lyd_path_free(cpath);
+    return NULL;
+}
+
+API void
+lyd_path_free(struct lyd_path *path)
+{
+    FUN_IN;
+
+    if (!path) {
+        return;
+    }
+
+    free(path->snodes);
+    free(path);
+}
+
+/**
+ * @brief Create a list instance with all its keys, not connected to any parent.
+ *
+ * @param[in] slist List schema node.
+ * @param[in] keys Values of all the list keys in the schema order.
+ * @param[in] dflt Whether the created list is a default node.
+ * @return Created list instance, NULL on error.
+ */
+static struct lyd_node *
+lyd_path_create_list(const struct lys_node_list *slist, const char **keys, int dflt)
+{
+    struct lyd_node *list, *key;
+    uint8_t i;
+
+    list = _lyd_new(NULL, (struct lys_node *)slist, dflt);
+    LY_CHECK_RETURN(!list, NULL);
+
+    for (i = 0; i < slist->keys_size; ++i) {
+        if (!keys[i]) {
+            LOGERR(slist->module->ctx, LY_EINVAL, "Invalid arguments - missing value of the key \"%s\" of \"%s\".",
+                   slist->keys[i]->name, slist->name);
+            lyd_free(list);
+            return NULL;
+        }
+
+        key = lyd_create_leaf((struct lys_node *)slist->keys[i], keys[i], 0, 0);
+        if (!key || lyd_insert(list, key)) {
+            lyd_free(key);
+            lyd_free(list);
+            return NULL;
+        }
+    }
+
+    return list;
+}
+
+/**
+ * @brief Create a node to look for an instance of a compiled path step.
+ *
+ * Containers, leaves, and anydata are matched only by their schema node so \p tmp is used for them
+ * and nothing is allocated. Lists and leaf-lists are created with their keys or value.
+ *
+ * @param[in] snode Schema node of the path step.
+ * @param[in] keys Key values of the list, if \p snode is a list.
+ * @param[in] value Value of the leaf-list, if \p snode is a leaf-list.
+ * @param[in] dflt Whether the created list or leaf-list is a default node.
+ * @param[in] tmp Memory for the node of other schema nodes.
+ * @param[out] target Node to search for.
+ * @return Created node that must be freed or linked into a tree, NULL if \p tmp was used or on error.
+ */
+struct lyd_node *
+lyd_path_target(const struct lys_node *snode, const char **keys, const char *value, int dflt,
+                struct lyd_node_leaf_list *tmp, struct lyd_node **target)
+{
+    struct lyd_node *node = NULL;
+
+    switch (snode->nodetype) {
+    case LYS_LIST:
+        node = lyd_path_create_list((struct lys_node_list *)snode, keys, dflt);
+        break;
+    case LYS_LEAFLIST:
+        node = lyd_create_leaf(snode, value, dflt, 0);
+        break;
+    default:
+        /* used attributes: schema, hash */
+        memset(tmp, 0, sizeof *tmp);
+        tmp->schema = (struct lys_node *)snode;
+        tmp->prev = (struct lyd_node *)tmp;
+#ifdef LY_ENABLED_CACHE
+        lyd_hash((struct lyd_node *)tmp);
+#endif
+        *target = (struct lyd_node *)tmp;
+        return NULL;
+    }
+
+    *target = node;
+    return node;
+}
+
+API struct lyd_node *
+lyd_new_path_compiled(struct lyd_node *data_tree, const struct lyd_path *path, const char **keys, void *value,
+                      LYD_ANYDATA_VALUETYPE value_type, int options)
+{
+    FUN_IN;
+
+    struct lyd_node *ret = NULL, *node = NULL, *parent = NULL, *target, *match = NULL, *last;
+    struct lyd_node_leaf_list tmp;
+    const struct lys_node *snode, *sparent;
+    const struct ly_ctx *ctx;
+    uint32_t i;
+    int dflt;
+
+    if (!path || (path->keys_count && !keys) || (data_tree && (lyd_node_module(data_tree)->ctx != path->ctx))) {
+        LOGARG;
+        return NULL;
+    }
+    ctx = path->ctx;
+    options = (options & ~LYD_PATH_OPT_OUTPUT) | path->options;
+    dflt = (options & LYD_PATH_OPT_DFLT) ? 1 : 0;
+
+    for (i = 0; i < path->count; ++i) {
+        snode = path->snodes[i];
+        node = NULL;
+
+        if (!ret) {
+            /* nothing created yet, the instance may exist */
+            node = lyd_path_target(snode, keys, value_type > LYD_ANYDATA_STRING ? NULL : value, dflt, &tmp, &target);
+            if ((snode->nodetype & (LYS_LIST | LYS_LEAFLIST)) && !node) {
+                goto error;
+            }
+
+            match = NULL;
+            if (((snode->nodetype == LYS_LIST) && !((struct lys_node_list *)snode)->keys_size)
+                    || ((snode->nodetype == LYS_LEAFLIST) && (snode->flags & LYS_CONFIG_R))) {
+                /* there can be several instances, always create a new one */
+            } else if (lyd_find_sibling(parent ? parent->child : data_tree, target, &match)) {
+                goto error;
+            }
+
+            if (match) {
+                lyd_free(node);
+                node = NULL;
+
+                if (i < path->count - 1) {
+                    if (snode->nodetype == LYS_LIST) {
+                        keys += ((struct lys_node_list *)snode)->keys_size;
+                    }
+                    parent = match;
+                    continue;
+                }
+
+                /* the node exists, are we supposed to update it or is it default? */
+                if (!(options & LYD_PATH_OPT_UPDATE) && (!match->dflt || (options & LYD_PATH_OPT_DFLT))) {
+                    LOGVAL(ctx, LYE_PATH_EXISTS, LY_VLOG_LYD, match);
+                    return NULL;
+                }
+
+                /* no change, the default node already exists */
+                if (match->dflt && (options & LYD_PATH_OPT_DFLT)) {
+                    return NULL;
+                }
+
+                return lyd_new_path_update(match, value, value_type, options & LYD_PATH_OPT_DFLT);
+            }
+        } else if (snode->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
+            /* the parent was just created, so was this node */
+            node = lyd_path_target(snode, keys, value_type > LYD_ANYDATA_STRING ? NULL : value, dflt, &tmp, &target);
+            LY_CHECK_GOTO(!node, error);
+        }
+
+        /* create the node */
+        switch (snode->nodetype) {
+        case LYS_CONTAINER:
+        case LYS_LIST:
+        case LYS_NOTIF:
+        case LYS_RPC:
+        case LYS_ACTION:
+            if (options & LYD_PATH_OPT_NOPARENT) {
+                /* these were supposed to exist */
+                LOGVAL(ctx, LYE_PATH_MISSPAR, LY_VLOG_LYS, snode);
+                goto error;
+            }
+            if (snode->nodetype == LYS_LIST) {
+                keys += ((struct lys_node_list *)snode)->keys_size;
+            } else {
+                node = _lyd_new(NULL, snode, dflt);
+            }
+            break;
+        case LYS_LEAF:
+            node = _lyd_new_leaf(parent, snode, value_type > LYD_ANYDATA_STRING ? NULL : value, dflt,
+                                 options & LYD_PATH_OPT_EDIT);
+            break;
+        case LYS_LEAFLIST:
+            /* already created */
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            if (value_type <= LYD_ANYDATA_STRING && !value) {
+                value_type = LYD_ANYDATA_CONSTSTRING;
+                value = "";
+            }
+            node = lyd_create_anydata(parent, snode, value, value_type);
+            break;
+        default:
+            LOGINT(ctx);
+            break;
+        }
+        LY_CHECK_GOTO(!node, error);
+
+        /* connect it, leaves and anydata are already connected */
+        if (!(snode->nodetype & (LYS_LEAF | LYS_ANYDATA)) || !parent) {
+            if (parent) {
+                if (lyd_insert(parent, node)) {
+                    goto error;
+                }
+            } else if (data_tree) {
+                for (last = data_tree; last->next; last = last->next);
+                if (lyd_insert_after(last, node)) {
+                    goto error;
+                }
+            }
+        }
+
+        if (!ret) {
+            /* sort if needed, but only when inserted somewhere */
+            sparent = snode;
+            do {
+                sparent = lys_parent(sparent);
+            } while (sparent && (sparent->nodetype != ((options & LYD_PATH_OPT_OUTPUT) ? LYS_OUTPUT : LYS_INPUT)));
+            if (sparent && lyd_schema_sort(node, 0)) {
+                lyd_free(node);
+                return NULL;
+            }
+
+            /* set first created node */
+            ret = node;
+        }
+        parent = node;
+    }
+
+    if (options & LYD_PATH_OPT_NOPARENTRET) {
+        /* last created node */
+        return node;
+    }
+    return ret;
+
+error:
+    if (node && (node != ret) && !node->parent && (node->prev == node)) {
+        /* not connected */
+        lyd_free(node);
+    }
+    lyd_free(ret);
+    return NULL;
+}
+
+API int
+lyd_find_path_compiled(const struct lyd_node *data_tree, const struct lyd_path *path, const char **keys,
+                       const char *value, struct lyd_node **match)
+{
+    FUN_IN;
+
+    struct lyd_node *node, *target;
+    struct lyd_node_leaf_list tmp;
+    const struct lys_node *snode;
+    uint32_t i;
+    int r;
+
+    if (!path || (path->keys_count && !keys) || !match) {
+        LOGARG;
+        return -1;
+    }
+    snode = path->snodes[path->count - 1];
+    if ((snode->nodetype == LYS_LEAFLIST) && !value) {
+        LOGERR(path->ctx, LY_EINVAL, "Invalid arguments - no value for a leaf-list (%s()).", __func__);
+        return -1;
+    }
+
+    *match = (struct lyd_node *)data_tree;
+    for (i = 0; *match && (i < path->count); ++i) {
+        snode = path->snodes[i];
 
-        /* parse another node */
-        if ((r = parse_schema_nodeid(id, &mod_name, &mod_name_len, &name, &nam_len, &is_relative, &has_predicate, NULL, 0)) < 1) {
-            LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[-r], &id[-r]);
-            lyd_free(ret);
-            return NULL;
+        node = lyd_path_target(snode, keys, value, 0, &tmp, &target);
+        if ((snode->nodetype & (LYS_LIST | LYS_LEAFLIST)) && !node) {
+            return -1;
+        }
+        if (snode->nodetype == LYS_LIST) {
+            keys += ((struct lys_node_list *)snode)->keys_size;
         }
-        id += r;
 
-        /* if a key of a list was supposed to be created, it is created as a part of the list instance creation */
-        if ((schild->nodetype == LYS_LIST) && !mod_name) {
-            slist = (const struct lys_node_list *)schild;
-            for (i = 0; i < slist->keys_size; ++i) {
-                if (!strncmp(slist->keys[i]->name, name, nam_len) && !slist->keys[i]->name[nam_len]) {
-                    /* the path continues? there cannot be anything after a key (leaf) */
-                    if (id[0]) {
-                        LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[0], id);
-                        lyd_free(ret);
-                        return NULL;
-                    }
-                    return ret;
-                }
-            }
+        r = lyd_find_sibling(i ? (*match)->child : data_tree, target, match);
+        lyd_free(node);
+        if (r) {
+            *match = NULL;
+            return -1;
         }
     }
 
-    LOGINT(ctx);
-    return NULL;
+    return 0;
 }
 
 API unsigned int
@@ -2459,6 +3040,10 @@ lyd_merge_node_update(struct lyd_node *target, struct lyd_node *source, int opti
                 lyd_free_value(trg_leaf->value, trg_leaf->value_type, trg_leaf->value_flags,
                                &((struct lys_node_leaf *)trg_leaf->schema)->type, trg_leaf->value_str, NULL, NULL, NULL);
                 trg_leaf->value = src_leaf->value;
+                if ((trg_leaf->value_type == LY_TYPE_STRING) || (trg_leaf->value_type == LY_TYPE_BINARY)) {
+                    /* value_str pointer is shared in these cases, source value may not be a dictionary string */
+                    trg_leaf->value.string = trg_leaf->value_str;
+                }
                 /* so that it is not freed */
                 src_leaf->value.uint64 = 0;
             }
@@ -3379,7 +3964,7 @@ lyd_diff_match(struct lyd_node *first, struct lyd_node *second, struct lyd_diffl
         break;
     case LYS_LEAF:
         /* check for leaf's modification */
-        if (!lyd_leaf_val_equal(first, second, 0) || ((options & LYD_DIFFOPT_WITHDEFAULTS) && (first->dflt != second->dflt))) {
+        if (!lyd_leaf_val_equal(first, second) || ((options & LYD_DIFFOPT_WITHDEFAULTS) && (first->dflt != second->dflt))) {
             if (lyd_difflist_add(diff, size, (*i)++, LYD_DIFF_CHANGED, first, second)) {
                return -1;
             }
@@ -3550,6 +4135,41 @@ lyd_diff_init_difflist(struct ly_ctx *ctx, unsigned int *size)
     return result;
 }
 
+/**
+ * @brief Instantiate all the implicit default nodes not created yet (#LYD_OPT_LAZY_DFLT) of a tree to diff.
+ *
+ * @param[in] tree Tree passed to lyd_diff().
+ * @param[in] options lyd_diff() options.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+lyd_diff_wd_materialize(struct lyd_node *tree, int options)
+{
+    struct lyd_node *next, *elem;
+
+    if (options & LYD_DIFFOPT_NOSIBLINGS) {
+        LY_TREE_DFS_BEGIN(tree, next, elem) {
+            if (elem->lazy_dflt && lyd_wd_materialize_node(elem, NULL)) {
+                return EXIT_FAILURE;
+            }
+            LY_TREE_DFS_END(tree, next, elem);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /* all the siblings are compared */
+    if (tree->parent) {
+        if (tree->parent->lazy_dflt && lyd_wd_materialize_node(tree->parent, NULL)) {
+            return EXIT_FAILURE;
+        }
+        tree = tree->parent->child;
+    } else {
+        for (; tree->prev->next; tree = tree->prev);
+    }
+
+    return lyd_wd_materialize(tree);
+}
+
 API struct lyd_difflist *
 lyd_diff(struct lyd_node *first, struct lyd_node *second, int options)
 {
@@ -3608,6 +4228,12 @@ lyd_diff(struct lyd_node *first, struct lyd_node *second, int options)
 
     ctx = first->schema->module->ctx;
 
+    if ((options & LYD_DIFFOPT_WITHDEFAULTS)
+            && (lyd_diff_wd_materialize(first, options) || lyd_diff_wd_materialize(second, options))) {
+        /* the implicit default nodes of both trees are compared */
+        return NULL;
+    }
+
     if (options & LYD_DIFFOPT_NOSIBLINGS) {
         /* both trees must start at the same (schema) node */
         if (first->schema != second->schema) {
@@ -4456,6 +5082,20 @@ lyd_insert_common(struct lyd_node *parent, struct lyd_node **sibling, struct lyd
                     ins->prev = start->prev;
                     start->prev = ins;
                 }
+            } else if ((ins->schema->module->ctx->models.flags & LY_CTX_SCHEMA_ORDER)
+                    && (iter = lyd_schema_order_next(start->prev, ins->schema))) {
+                /* keep the schema order, add before the iter */
+                if (iter == start) {
+                    start = ins;
+                    if (parent) {
+                        parent->child = ins;
+                    }
+                } else {
+                    iter->prev->next = ins;
+                }
+                ins->prev = iter->prev;
+                iter->prev = ins;
+                ins->next = iter;
             } else {
                 /* add as the last child of the parent */
                 start->prev->next = ins;
@@ -4520,8 +5160,308 @@ lyd_insert_sibling(struct lyd_node **sibling, struct lyd_node *node)
         return EXIT_FAILURE;
     }
 
-    return lyd_insert_common((*sibling) ? (*sibling)->parent : NULL, sibling, node, 1);
+    return lyd_insert_common((*sibling) ? (*sibling)->parent : NULL, sibling, node, 1);
+
+}
+
+API struct lyd_builder *
+lyd_builder_new(struct lyd_node *parent)
+{
+    FUN_IN;
+
+    struct lyd_builder *builder;
+
+    if (parent && (parent->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+        LOGARG;
+        return NULL;
+    }
+
+    builder = calloc(1, sizeof *builder);
+    LY_CHECK_ERR_RETURN(!builder, LOGMEM(parent ? lyd_node_module(parent)->ctx : NULL), NULL);
+    builder->parent = parent;
+
+    return builder;
+}
+
+/**
+ * @brief Append a new node as the last child of a parent without any further processing.
+ *
+ * @param[in] builder Builder with the node.
+ * @param[in] parent Parent to append to, NULL for top-level nodes.
+ * @param[in] node Node to append.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_builder_append(struct lyd_builder *builder, struct lyd_node *parent, struct lyd_node *node)
+{
+    struct lyd_node *first, *last;
+    struct lys_node_list *slist;
+    uint8_t pos;
+
+    first = parent ? parent->child : builder->first;
+
+    if (parent && (parent->schema->nodetype == LYS_LIST) && ((struct lys_node_list *)parent->schema)->keys_size) {
+        slist = (struct lys_node_list *)parent->schema;
+        last = first ? first->prev : NULL;
+
+        /* keys must be added first, in their order, and only to new list instances */
+        if ((node->schema->nodetype == LYS_LEAF) && lys_is_key((struct lys_node_leaf *)node->schema, &pos)) {
+            if ((parent == builder->parent) || (pos && (!last || (last->schema != (struct lys_node *)slist->keys[pos - 1])))
+                    || (!pos && last)) {
+                LOGERR(slist->module->ctx, LY_EINVAL, "Invalid arguments - key \"%s\" out of order (%s()).",
+                       node->schema->name, __func__);
+                return -1;
+            }
+        } else if ((parent != builder->parent) && !lyd_list_has_keys(parent)) {
+            LOGERR(slist->module->ctx, LY_EINVAL, "Invalid arguments - list \"%s\" without keys (%s()).",
+                   slist->name, __func__);
+            return -1;
+        }
+    }
+
+    node->parent = parent;
+    if (!first) {
+        if (parent) {
+            parent->child = node;
+        } else {
+            builder->first = node;
+        }
+    } else {
+        first->prev->next = node;
+        node->prev = first->prev;
+        first->prev = node;
+    }
+
+    if ((parent == builder->parent) && !builder->first) {
+        builder->first = node;
+    }
+    return 0;
+}
+
+API struct lyd_node *
+lyd_builder_add(struct lyd_builder *builder, struct lyd_node *parent, const struct lys_module *module, const char *name)
+{
+    FUN_IN;
+
+    const struct lys_node *snode = NULL, *siblings;
+    struct lyd_node *node;
+
+    if (!builder || !name) {
+        LOGARG;
+        return NULL;
+    }
+    if (!parent) {
+        parent = builder->parent;
+    }
+    if (!parent && !module) {
+        LOGARG;
+        return NULL;
+    }
+
+    siblings = lyd_new_find_schema(parent, module, 0);
+    if (!siblings) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lys_getnext_data(module, lys_parent(siblings), name, strlen(name), LYS_CONTAINER | LYS_LIST | LYS_NOTIF
+                         | LYS_RPC | LYS_ACTION, 0, &snode) || !snode) {
+        LOGERR(siblings->module->ctx, LY_EINVAL, "Failed to find \"%s\" as a sibling to \"%s:%s\".",
+               name, lys_node_module(siblings)->name, siblings->name);
+        return NULL;
+    }
+
+    node = _lyd_new(NULL, snode, 0);
+    if (!node || lyd_builder_append(builder, parent, node)) {
+        lyd_free(node);
+        return NULL;
+    }
+
+    return node;
+}
+
+API struct lyd_node *
+lyd_builder_add_leaf(struct lyd_builder *builder, struct lyd_node *parent, const struct lys_module *module,
+                     const char *name, const char *val_str)
+{
+    FUN_IN;
+
+    const struct lys_node *snode = NULL, *siblings;
+    struct lyd_node *node;
+
+    if (!builder || !name) {
+        LOGARG;
+        return NULL;
+    }
+    if (!parent) {
+        parent = builder->parent;
+    }
+    if (!parent && !module) {
+        LOGARG;
+        return NULL;
+    }
+
+    siblings = lyd_new_find_schema(parent, module, 0);
+    if (!siblings) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lys_getnext_data(module, lys_parent(siblings), name, strlen(name), LYS_LEAFLIST | LYS_LEAF, 0, &snode) || !snode) {
+        LOGERR(siblings->module->ctx, LY_EINVAL, "Failed to find \"%s\" as a sibling to \"%s:%s\".",
+               name, lys_node_module(siblings)->name, siblings->name);
+        return NULL;
+    }
+
+    node = lyd_create_leaf(snode, val_str, 0, 0);
+    if (!node || lyd_builder_append(builder, parent, node)) {
+        lyd_free(node);
+        return NULL;
+    }
+
+    return node;
+}
+
+#ifdef LY_ENABLED_CACHE
+
+/**
+ * @brief Create the hash table of a parent for all its children at once, sized for their count.
+ *
+ * @param[in] parent Parent with all its children already hashed.
+ */
+static void
+lyd_builder_hash_children(struct lyd_node *parent)
+{
+    struct lyd_node *iter;
+    uint32_t count = 0, size;
+
+    if (parent->ht) {
+        lyht_free(parent->ht);
+        parent->ht = NULL;
+    }
+
+    LY_TREE_FOR(parent->child, iter) {
+        if ((iter->schema->nodetype != LYS_LIST) || lyd_list_has_keys(iter)) {
+            ++count;
+        }
+    }
+    if (count < LY_CACHE_HT_MIN_CHILDREN) {
+        return;
+    }
+
+    /* the smallest power of 2 that will not need to be enlarged */
+    for (size = LYHT_MIN_SIZE; (count * 100) / size >= LYHT_ENLARGE_PERCENTAGE; size <<= 1);
+
+    parent->ht = lyht_new(size, sizeof(struct lyd_node *), lyd_hash_table_val_equal, NULL, 1);
+    lyht_set_incremental(parent->ht, 1);
+    LY_TREE_FOR(parent->child, iter) {
+        if ((iter->schema->nodetype == LYS_LIST) && !lyd_list_has_keys(iter)) {
+            /* skip lists without keys */
+            continue;
+        }
+
+        if (lyht_insert(parent->ht, &iter, iter->hash, NULL)) {
+            assert(0);
+        }
+    }
+}
+
+#endif
+
+/**
+ * @brief Finish a subtree created by a builder. Children are processed before their parent
+ * so that the parent hashes can be computed from them.
+ *
+ * @param[in] node Subtree root.
+ * @param[in] list Closest list ancestor of \p node, NULL if there is none.
+ */
+static void
+lyd_builder_finish_r(struct lyd_node *node, struct lyd_node *list)
+{
+    struct lyd_node *child;
+
+    switch (node->schema->nodetype) {
+    case LYS_LEAF:
+        if (list && (node->schema->flags & LYS_UNIQUE)) {
+            list->validity |= LYD_VAL_UNIQUE;
+        }
+        return;
+    case LYS_LEAFLIST:
+    case LYS_ANYXML:
+    case LYS_ANYDATA:
+        return;
+    default:
+        break;
+    }
+
+    LY_TREE_FOR(node->child, child) {
+        lyd_builder_finish_r(child, (node->schema->nodetype == LYS_LIST) ? node : list);
+    }
+
+#ifdef LY_ENABLED_CACHE
+    if (node->schema->nodetype == LYS_LIST) {
+        /* all the keys (or children of a key-less list) are present now */
+        lyd_hash(node);
+    }
+    lyd_builder_hash_children(node);
+#endif
+}
+
+API struct lyd_node *
+lyd_builder_finish(struct lyd_builder *builder)
+{
+    FUN_IN;
+
+    struct lyd_node *ret, *parent, *iter, *next, *ins;
+
+    if (!builder) {
+        LOGARG;
+        return NULL;
+    }
+
+    ret = builder->first;
+    parent = builder->parent;
+    free(builder);
+
+    if (!ret) {
+        return NULL;
+    }
+
+    if (parent) {
+        /* the new nodes replace any existing default nodes, as lyd_insert() does */
+        for (iter = parent->child; iter != ret; iter = next) {
+            next = iter->next;
+            if (!iter->dflt) {
+                continue;
+            }
+            for (ins = ret; ins && (ins->schema != iter->schema); ins = ins->next);
+            if (ins) {
+                lyd_free(iter);
+            }
+        }
+    }
+
+    LY_TREE_FOR(ret, iter) {
+        lyd_builder_finish_r(iter, NULL);
+    }
+
+    if (parent) {
+#ifdef LY_ENABLED_CACHE
+        lyd_builder_hash_children(parent);
+        lyd_keyless_list_hash_change(parent);
+#endif
+
+        /* remove the dflt flag from parents */
+        for (iter = parent; iter && iter->dflt; iter = iter->parent) {
+            iter->dflt = 0;
+        }
+    }
+
+    LY_TREE_FOR(ret, iter) {
+        lyd_insert_setinvalid(iter);
+    }
 
+    return ret;
 }
 
 int
@@ -4778,27 +5718,78 @@ lys_module_node_pos_r(struct lys_node *first_sibling, struct lys_node *target, u
     return 1;
 }
 
+/**
+ * @brief Compare the modules of two schema nodes in the context order.
+ *
+ * @return Negative, 0, or positive as in qsort() callbacks.
+ */
 static int
-lyd_node_pos_cmp(const void *item1, const void *item2)
+lyd_module_order_cmp(const struct lys_node *schema1, const struct lys_node *schema2)
 {
+    struct lys_module *mod1, *mod2;
     uint32_t mpos1, mpos2;
+
+    mod1 = lys_node_module(schema1);
+    mod2 = lys_node_module(schema2);
+    if (mod1 == mod2) {
+        return 0;
+    }
+
+    mpos1 = mod1->order ? mod1->order : lys_module_pos(mod1);
+    mpos2 = mod2->order ? mod2->order : lys_module_pos(mod2);
+    /* if lys_module_pos failed, there is nothing we can do anyway,
+     * at least internal error will be printed */
+
+    return (mpos1 > mpos2) ? 1 : -1;
+}
+
+int
+lyd_schema_order_cmp(const struct lys_node *schema1, const struct lys_node *schema2)
+{
+    int ret;
+
+    if ((ret = lyd_module_order_cmp(schema1, schema2))) {
+        return ret;
+    }
+
+    if (schema1->order > schema2->order) {
+        return 1;
+    } else if (schema1->order < schema2->order) {
+        return -1;
+    }
+    return 0;
+}
+
+struct lyd_node *
+lyd_schema_order_next(struct lyd_node *last, const struct lys_node *schema)
+{
+    struct lyd_node *next = NULL;
+
+    if (!schema->order) {
+        /* no ordinal (nodes of extension instances), keep the insertion order */
+        return NULL;
+    }
+
+    /* in the common case the node belongs after the last sibling */
+    for (; last && (lyd_schema_order_cmp(last->schema, schema) > 0); last = last->prev->next ? last->prev : NULL) {
+        next = last;
+    }
+
+    return next;
+}
+
+static int
+lyd_node_pos_cmp(const void *item1, const void *item2)
+{
+    int ret;
     struct lyd_node_pos *np1, *np2;
 
     np1 = (struct lyd_node_pos *)item1;
     np2 = (struct lyd_node_pos *)item2;
 
     /* different modules? */
-    if (lys_node_module(np1->node->schema) != lys_node_module(np2->node->schema)) {
-        mpos1 = lys_module_pos(lys_node_module(np1->node->schema));
-        mpos2 = lys_module_pos(lys_node_module(np2->node->schema));
-        /* if lys_module_pos failed, there is nothing we can do anyway,
-         * at least internal error will be printed */
-
-        if (mpos1 > mpos2) {
-            return 1;
-        } else {
-            return -1;
-        }
+    if ((ret = lyd_module_order_cmp(np1->node->schema, np2->node->schema))) {
+        return ret;
     }
 
     if (np1->pos > np2->pos) {
@@ -4815,6 +5806,7 @@ lyd_schema_sort(struct lyd_node *sibling, int recursive)
     FUN_IN;
 
     uint32_t len, i;
+    int ordinals = 1;
     struct lyd_node *node;
     struct lys_node *first_ssibling = NULL;
     struct lyd_node_pos *array;
@@ -4824,23 +5816,34 @@ lyd_schema_sort(struct lyd_node *sibling, int recursive)
         return -1;
     }
 
-    /* something actually to sort */
-    if (sibling->prev != sibling) {
-
-        /* find the beginning */
-        sibling = lyd_first_sibling(sibling);
+    /* find the beginning */
+    sibling = lyd_first_sibling(sibling);
 
-        /* count siblings */
-        len = 0;
-        for (node = sibling; node; node = node->next) {
-            ++len;
+    /* count siblings and check whether they are not already in the schema order */
+    len = 0;
+    for (node = sibling; node; node = node->next) {
+        ++len;
+        if (!node->schema->order) {
+            /* no ordinal (nodes of extension instances) */
+            ordinals = 0;
+        } else if (ordinals && (len > 1) && (lyd_schema_order_cmp(node->prev->schema, node->schema) > 0)) {
+            ordinals = -1;
         }
+    }
 
+    /* something actually to sort */
+    if ((len > 1) && (ordinals < 1)) {
         array = malloc(len * sizeof *array);
         LY_CHECK_ERR_RETURN(!array, LOGMEM(sibling->schema->module->ctx), -1);
 
         /* fill arrays with positions and corresponding nodes */
         for (i = 0, node = sibling; i < len; ++i, node = node->next) {
+            array[i].node = node;
+            if (ordinals) {
+                /* precomputed position */
+                array[i].pos = node->schema->order;
+                continue;
+            }
             array[i].pos = 0;
 
             /* we need to repeat this for every module */
@@ -4866,8 +5869,6 @@ lyd_schema_sort(struct lyd_node *sibling, int recursive)
                 free(array);
                 return -1;
             }
-
-            array[i].node = node;
         }
 
         /* sort the arrays */
@@ -5344,6 +6345,11 @@ lyd_unlink_internal(struct lyd_node *node, int permanent)
         return EXIT_FAILURE;
     }
 
+    if (ly_err_lazy_count) {
+        /* the node is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(node->schema->module->ctx);
+    }
+
     /* unlink from siblings */
     if (node->prev->next) {
         node->prev->next = node->next;
@@ -5414,6 +6420,8 @@ _lyd_dup_node_common(struct lyd_node *new_node, const struct lyd_node *orig, str
     new_node->parent = NULL;
     new_node->validity = ly_new_node_validity(new_node->schema);
     new_node->dflt = orig->dflt;
+    /* deferred default leaves belong to the copied children */
+    new_node->lazy_dflt = (options & LYD_DUP_OPT_RECURSIVE) ? orig->lazy_dflt : 0;
     if (options & LYD_DUP_OPT_WITH_WHEN) {
         new_node->when_status = orig->when_status;
     } else {
@@ -5922,6 +6930,159 @@ lyd_dup_withsiblings(const struct lyd_node *node, int options)
     return lyd_dup_withsiblings_to_ctx(node, options, lyd_node_module(node)->ctx);
 }
 
+API struct lyd_snapshot *
+lyd_snapshot_new(const struct lyd_node *tree)
+{
+    FUN_IN;
+
+    struct lyd_snapshot *snapshot;
+
+    if (tree && tree->parent) {
+        LOGARG;
+        return NULL;
+    }
+
+    snapshot = calloc(1, sizeof *snapshot);
+    LY_CHECK_ERR_RETURN(!snapshot, LOGMEM(tree ? lyd_node_module(tree)->ctx : NULL), NULL);
+
+    if (tree) {
+        snapshot->tree = lyd_dup_withsiblings(tree, LYD_DUP_OPT_RECURSIVE | LYD_DUP_OPT_WITH_WHEN);
+        if (!snapshot->tree || lyd_wd_materialize(snapshot->tree)) {
+            lyd_free_withsiblings(snapshot->tree);
+            free(snapshot);
+            return NULL;
+        }
+    }
+    snapshot->refcount = 1;
+    pthread_mutex_init(&snapshot->lock, NULL);
+
+    return snapshot;
+}
+
+API const struct lyd_node *
+lyd_snapshot_tree(const struct lyd_snapshot *snapshot)
+{
+    FUN_IN;
+
+    if (!snapshot) {
+        LOGARG;
+        return NULL;
+    }
+
+    return snapshot->tree;
+}
+
+API struct lyd_snapshot *
+lyd_snapshot_ref(struct lyd_snapshot *snapshot)
+{
+    FUN_IN;
+
+    if (!snapshot) {
+        LOGARG;
+        return NULL;
+    }
+
+    pthread_mutex_lock(&snapshot->lock);
+    ++snapshot->refcount;
+    pthread_mutex_unlock(&snapshot->lock);
+
+    return snapshot;
+}
+
+API void
+lyd_snapshot_free(struct lyd_snapshot *snapshot)
+{
+    FUN_IN;
+
+    uint32_t refcount;
+
+    if (!snapshot) {
+        return;
+    }
+
+    pthread_mutex_lock(&snapshot->lock);
+    refcount = --snapshot->refcount;
+    pthread_mutex_unlock(&snapshot->lock);
+    if (refcount) {
+        return;
+    }
+
+    lyd_free_withsiblings(snapshot->tree);
+    pthread_mutex_destroy(&snapshot->lock);
+    free(snapshot);
+}
+
+API struct lyd_snapshot_head *
+lyd_snapshot_head_new(void)
+{
+    FUN_IN;
+
+    struct lyd_snapshot_head *head;
+
+    head = calloc(1, sizeof *head);
+    LY_CHECK_ERR_RETURN(!head, LOGMEM(NULL), NULL);
+    pthread_mutex_init(&head->lock, NULL);
+
+    return head;
+}
+
+API void
+lyd_snapshot_publish(struct lyd_snapshot_head *head, struct lyd_snapshot *snapshot)
+{
+    FUN_IN;
+
+    struct lyd_snapshot *prev;
+
+    if (!head) {
+        LOGARG;
+        return;
+    }
+
+    pthread_mutex_lock(&head->lock);
+    prev = head->current;
+    head->current = snapshot;
+    pthread_mutex_unlock(&head->lock);
+
+    /* the snapshot may still be used by some readers, otherwise it is freed now */
+    lyd_snapshot_free(prev);
+}
+
+API struct lyd_snapshot *
+lyd_snapshot_get(struct lyd_snapshot_head *head)
+{
+    FUN_IN;
+
+    struct lyd_snapshot *snapshot = NULL;
+
+    if (!head) {
+        LOGARG;
+        return NULL;
+    }
+
+    /* the reference must be taken before the snapshot can be replaced and released */
+    pthread_mutex_lock(&head->lock);
+    if (head->current) {
+        snapshot = lyd_snapshot_ref(head->current);
+    }
+    pthread_mutex_unlock(&head->lock);
+
+    return snapshot;
+}
+
+API void
+lyd_snapshot_head_free(struct lyd_snapshot_head *head)
+{
+    FUN_IN;
+
+    if (!head) {
+        return;
+    }
+
+    lyd_snapshot_free(head->current);
+    pthread_mutex_destroy(&head->lock);
+    free(head);
+}
+
 API void
 lyd_free_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr, int recursive)
 {
@@ -6120,6 +7281,11 @@ _lyd_free_node(struct lyd_node *node)
         return;
     }
 
+    if (ly_err_lazy_count) {
+        /* the node is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(node->schema->module->ctx);
+    }
+
     switch (node->schema->nodetype) {
     case LYS_CONTAINER:
     case LYS_LIST:
@@ -6607,6 +7773,12 @@ lyd_find_sibling(const struct lyd_node *siblings, const struct lyd_node *target,
         return 0;
     }
 
+    if (siblings->parent && siblings->parent->lazy_dflt && (target->schema->nodetype == LYS_LEAF)
+            && lyd_wd_materialize_node(siblings->parent, target->schema->name)) {
+        /* the leaf may be an implicit default not instantiated yet (#LYD_OPT_LAZY_DFLT) */
+        return -1;
+    }
+
     /* find first sibling */
     if (siblings->parent) {
         siblings = siblings->parent->child;
@@ -7199,7 +8371,7 @@ lyd_wd_default(struct lyd_node_leaf_list *node)
         }
 
         /* compare the default value with the value of the leaf */
-        if (!ly_strequal(dflt, node->value_str, 1)) {
+        if (!ly_strequal(dflt, node->value_str, 0)) {
             return 0;
         }
     } else if (node->schema->module->version >= LYS_VERSION_1_1) { /* LYS_LEAFLIST */
@@ -7245,13 +8417,13 @@ lyd_wd_default(struct lyd_node_leaf_list *node)
 
             if (llist->flags & LYS_USERORDERED) {
                 /* we have strict order */
-                if (!ly_strequal(dflts[c], ((struct lyd_node_leaf_list *)iter)->value_str, 1)) {
+                if (!ly_strequal(dflts[c], ((struct lyd_node_leaf_list *)iter)->value_str, 0)) {
                     return 0;
                 }
             } else {
                 /* node's value is supposed to match with one of the default values */
                 for (i = 0; i < dflts_size; i++) {
-                    if (ly_strequal(dflts[i], ((struct lyd_node_leaf_list *)iter)->value_str, 1)) {
+                    if (ly_strequal(dflts[i], ((struct lyd_node_leaf_list *)iter)->value_str, 0)) {
                         break;
                     }
                 }
@@ -7342,16 +8514,18 @@ lyd_free_val_diff(struct lyd_difflist *diff)
     lyd_free_diff(diff);
 }
 
-static int
-lyd_wd_add_leaf(struct lyd_node **tree, struct lyd_node *last_parent, struct lys_node_leaf *leaf, struct unres_data *unres,
-                int check_when_must)
+/**
+ * @brief Get the default value of a leaf, either its own or the one inherited from its type.
+ *
+ * @param[in] leaf Schema leaf.
+ * @return Default value, NULL if the leaf has none.
+ */
+static const char *
+lyd_wd_leaf_dflt(const struct lys_node_leaf *leaf)
 {
-    struct lyd_node *dummy = NULL, *current;
     struct lys_tpdf *tpdf;
     const char *dflt = NULL;
-    int ret;
 
-    /* get know if there is a default value */
     if (leaf->dflt) {
         /* leaf has a default value */
         dflt = leaf->dflt;
@@ -7361,6 +8535,152 @@ lyd_wd_add_leaf(struct lyd_node **tree, struct lyd_node *last_parent, struct lys
             dflt = tpdf->dflt;
         }
     }
+
+    return dflt;
+}
+
+/**
+ * @brief Learn whether an implicit default leaf can be left uninstantiated (#LYD_OPT_LAZY_DFLT). It must not need
+ * any validation, so it can be created from the schema at any time with the same result.
+ *
+ * @param[in] schema Schema node to check.
+ * @return 1 if the leaf can be deferred, 0 otherwise.
+ */
+static int
+lyd_wd_lazy_leaf(const struct lys_node *schema)
+{
+    const struct lys_node_leaf *leaf = (const struct lys_node_leaf *)schema;
+    const struct lys_node *parent;
+
+    if ((schema->nodetype != LYS_LEAF) || (schema->flags & (LYS_CONFIG_R | LYS_UNIQUE)) || leaf->must_size
+            || (leaf->type.base == LY_TYPE_LEAFREF) || (leaf->type.base == LY_TYPE_INST)
+            || (leaf->type.base == LY_TYPE_UNION)) {
+        return 0;
+    }
+
+    /* only direct children of a container or a list, default cases of choices are always instantiated */
+    for (parent = lys_parent(schema); parent && (parent->nodetype == LYS_USES); parent = lys_parent(parent));
+    if (!parent || !(parent->nodetype & (LYS_CONTAINER | LYS_LIST))) {
+        return 0;
+    }
+
+    return resolve_applies_when(schema, 0, NULL) ? 0 : 1;
+}
+
+/**
+ * @brief Instantiate the deferred default leaves from a schema node children (uses are processed recursively).
+ *
+ * @param[in] parent Data node to add the leaves into.
+ * @param[in] schema Schema node whose children to process.
+ * @param[in] name Dictionary name of the only leaf to instantiate, NULL for all of them.
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int
+lyd_wd_materialize_children(struct lyd_node *parent, const struct lys_node *schema, const char *name)
+{
+    const struct lys_node *siter;
+    struct lyd_node *iter, *leaf;
+    const char *dflt;
+#ifdef LY_ENABLED_CACHE
+    struct lyd_node target, *target_p = &target;
+#endif
+
+    LY_TREE_FOR(schema->child, siter) {
+        if (siter->nodetype == LYS_USES) {
+            if (lyd_wd_materialize_children(parent, siter, name)) {
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        if ((name && (siter->name != name)) || !lyd_wd_lazy_leaf(siter)
+                || !(dflt = lyd_wd_leaf_dflt((struct lys_node_leaf *)siter))
+                || lys_is_disabled(siter, 2)) {
+            continue;
+        }
+
+        /* explicit value or an already instantiated default */
+#ifdef LY_ENABLED_CACHE
+        if (parent->ht) {
+            /* a leaf hash depends only on its schema node */
+            memset(&target, 0, sizeof target);
+            target.schema = (struct lys_node *)siter;
+            lyd_hash(&target);
+            if (!lyht_find(parent->ht, &target_p, target.hash, NULL)) {
+                continue;
+            }
+        } else
+#endif
+        {
+            LY_TREE_FOR(parent->child, iter) {
+                if (iter->schema == siter) {
+                    break;
+                }
+            }
+            if (iter) {
+                continue;
+            }
+        }
+
+        leaf = lyd_create_leaf(siter, dflt, 1, 1);
+        if (!leaf) {
+            return EXIT_FAILURE;
+        }
+        /* the value comes from the schema, nothing to validate */
+        leaf->validity = LYD_VAL_OK;
+        if (lyd_insert_common(parent, NULL, leaf, 0)) {
+            lyd_free(leaf);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int
+lyd_wd_materialize_node(struct lyd_node *node, const char *name)
+{
+    assert(node->lazy_dflt);
+
+    if (lyd_wd_materialize_children(node, node->schema, name)) {
+        return EXIT_FAILURE;
+    }
+    if (!name) {
+        /* the rest may still be needed */
+        node->lazy_dflt = 0;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API int
+lyd_wd_materialize(struct lyd_node *root)
+{
+    FUN_IN;
+
+    struct lyd_node *top, *next, *elem;
+
+    LY_TREE_FOR(root, top) {
+        LY_TREE_DFS_BEGIN(top, next, elem) {
+            if (elem->lazy_dflt && lyd_wd_materialize_node(elem, NULL)) {
+                return EXIT_FAILURE;
+            }
+            LY_TREE_DFS_END(top, next, elem);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int
+lyd_wd_add_leaf(struct lyd_node **tree, struct lyd_node *last_parent, struct lys_node_leaf *leaf, struct unres_data *unres,
+                int check_when_must)
+{
+    struct lyd_node *dummy = NULL, *current;
+    const char *dflt;
+    int ret;
+
+    /* get know if there is a default value */
+    dflt = lyd_wd_leaf_dflt(leaf);
     if (!dflt) {
         /* no default value */
         return EXIT_SUCCESS;
@@ -7745,6 +9065,11 @@ lyd_wd_add_subtree(struct lyd_node **root, struct lyd_node *last_parent, struct
             goto error;
         }
         LY_TREE_FOR(schema->child, siter) {
+            if ((!subroot || !subroot->dflt) && lyd_schema_skip(siter, LYS_DFLT_DESC, options)) {
+                /* nothing to add and no default flags to fix */
+                continue;
+            }
+
             if (siter->nodetype & (LYS_CHOICE | LYS_USES)) {
                 /* go into without searching for data instance */
                 if (lyd_wd_add_subtree(root, last_parent, subroot, siter, toplevel, options, unres)) {
@@ -7820,7 +9145,12 @@ lyd_wd_add_subtree(struct lyd_node **root, struct lyd_node *last_parent, struct
             }
         }
         if (schema->nodetype == LYS_LEAF) {
-            if (lyd_wd_add_leaf(root, last_parent, (struct lys_node_leaf*)schema, unres, check_when_must)) {
+            if ((options & LYD_OPT_LAZY_DFLT) && last_parent && lyd_wd_lazy_leaf(schema)) {
+                /* do not instantiate it, it will be resolved from the schema when needed */
+                if (lyd_wd_leaf_dflt((struct lys_node_leaf *)schema)) {
+                    last_parent->lazy_dflt = 1;
+                }
+            } else if (lyd_wd_add_leaf(root, last_parent, (struct lys_node_leaf*)schema, unres, check_when_must)) {
                 return EXIT_FAILURE;
             }
         } else { /* LYS_LEAFLIST */
@@ -7920,7 +9250,7 @@ lyd_wd_add(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module *
             for (i = 0; i < mod_count; ++i) {
                 LY_TREE_FOR(modules[i]->data, siter) {
                     if (!(siter->nodetype & (LYS_CONTAINER | LYS_CHOICE | LYS_LEAF | LYS_LEAFLIST | LYS_LIST | LYS_ANYDATA |
-                                             LYS_USES))) {
+                                             LYS_USES)) || lyd_schema_skip(siter, LYS_DFLT_DESC, options)) {
                         continue;
                     }
                     if (lyd_wd_add_subtree(root, NULL, NULL, siter, 1, options, unres)) {
@@ -7936,7 +9266,7 @@ lyd_wd_add(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module *
                 }
                 LY_TREE_FOR(ctx->models.list[i]->data, siter) {
                     if (!(siter->nodetype & (LYS_CONTAINER | LYS_CHOICE | LYS_LEAF | LYS_LEAFLIST | LYS_LIST | LYS_ANYDATA |
-                                             LYS_USES))) {
+                                             LYS_USES)) || lyd_schema_skip(siter, LYS_DFLT_DESC, options)) {
                         continue;
                     }
                     if (lyd_wd_add_subtree(root, NULL, NULL, siter, 1, options, unres)) {
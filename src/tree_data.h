@@ -179,6 +179,8 @@ struct lyd_node {
     uint8_t dflt:1;                  /**< flag for implicit default node */
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
+    uint8_t lazy_dflt:1;             /**< flag for a node with implicit default leaf children not instantiated yet,
+                                          see #LYD_OPT_LAZY_DFLT */
 
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
@@ -221,6 +223,8 @@ struct lyd_node_leaf_list {
     uint8_t dflt:1;                  /**< flag for implicit default node */
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
+    uint8_t lazy_dflt:1;             /**< flag for a node with implicit default leaf children not instantiated yet,
+                                          see #LYD_OPT_LAZY_DFLT */
 
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
@@ -282,6 +286,8 @@ struct lyd_node_anydata {
     uint8_t dflt:1;                  /**< flag for implicit default node */
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
+    uint8_t lazy_dflt:1;             /**< flag for a node with implicit default leaf children not instantiated yet,
+                                          see #LYD_OPT_LAZY_DFLT */
 
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
@@ -408,7 +414,8 @@ void lyd_free_diff(struct lyd_difflist *diff);
  *            be marked as #LYD_DIFF_CREATED.
  * @param[in] second The second (sub)tree to compare. Without #LYD_OPT_NOSIBLINGS option, all siblings are
  *            taken into comparison. If NULL, all the \p first nodes will be marked as #LYD_DIFF_DELETED.
- * @param[in] options The @ref diffoptions are accepted.
+ * @param[in] options The @ref diffoptions are accepted. With #LYD_DIFFOPT_WITHDEFAULTS, the implicit default nodes
+ *            not instantiated yet (#LYD_OPT_LAZY_DFLT) are created in both trees before comparing them.
  * @return NULL on error, the list of differences on success. In case the trees are the same, the first item in the
  *         lyd_difflist::type array is #LYD_DIFF_END. The returned structure is supposed to be freed by lyd_free_diff().
  */
@@ -537,6 +544,37 @@ char *lyd_path(const struct lyd_node *node);
 #define LYD_OPT_VAL_DIFF 0x40000 /**< Flag only for validation, store all the data node changes performed by the validation
                                       in a diff structure. */
 #define LYD_OPT_LYB_MOD_UPDATE 0x80000 /**< Allow to parse data using an updated revision of a module, relevant only for LYB format. */
+#define LYD_OPT_LAZY_DFLT 0x100000 /**< Do not instantiate implicit default leaves that can be resolved from the schema
+                                        at any time (no when, must, unique, or leafref/instance-identifier/union type,
+                                        configuration leaf directly in a container or a list). Their parent is only
+                                        marked (lyd_node::lazy_dflt) and the leaves are created when they are first
+                                        accessed by an XPath expression or a lyd_find_sibling*() function, when
+                                        printed with #LYP_WD_ALL, #LYP_WD_ALL_TAG, or #LYP_WD_IMPL_TAG, compared
+                                        by lyd_diff() with #LYD_DIFFOPT_WITHDEFAULTS, or by lyd_wd_materialize().
+                                        Searching such a tree modifies it, so it cannot be searched from several
+                                        threads at once before lyd_wd_materialize(). */
+#define LYD_OPT_PIN_INPUT 0x200000 /**< Keep the mapped input of lyd_parse_fd() or lyd_parse_path() and let plain (ASCII,
+                                        not escaped) values of string leaves and leaf-lists reference it directly instead
+                                        of copying them into the dictionary. The input is owned by the context and
+                                        unmapped when all such values are freed, a changed or duplicated value is
+                                        stored in the dictionary as usual. Applicable only to the #LYD_JSON format,
+                                        ignored otherwise. */
+#define LYD_OPT_PARALLEL 0x400000 /**< Pre-scan the input for the top-level element (#LYD_XML) or member (#LYD_JSON)
+                                       boundaries and parse the top-level subtrees on several threads (one per online
+                                       CPU). The subtrees are joined in the input order and the checks requiring the
+                                       whole tree (top-level duplicates, defaults, unres, mandatory nodes) are done
+                                       afterwards, so the result is the same as without the option. Errors may be
+                                       logged from the parsing threads. Applicable only to #LYD_OPT_DATA, #LYD_OPT_CONFIG,
+                                       #LYD_OPT_GET, and #LYD_OPT_GETCONFIG without #LYD_OPT_NOSIBLINGS, ignored otherwise.
+                                       Data parsed with a data callback set (ly_ctx_set_module_data_clb()) are
+                                       always parsed sequentially. */
+#define LYD_OPT_FILTER 0x800000 /**< Parse only the subtrees selected by a set of schema nodes (variable argument
+                                     const struct ::ly_set *filter), for example the result of ly_ctx_find_path().
+                                     A data node is created only if its schema node is one of the selected nodes, their
+                                     descendant or their ancestor (or a key of such a list). Other subtrees are skipped
+                                     without creating any nodes or values (apart from the generic XML tree of #LYD_XML
+                                     input). Applicable only to #LYD_OPT_GET and #LYD_OPT_GETCONFIG, whose validation
+                                     tolerates the missing nodes. */
 #define LYD_OPT_DATA_TEMPLATE 0x1000000 /**< Data represents YANG data template. */
 
 /**@} parseroptions */
@@ -573,6 +611,8 @@ char *lyd_path(const struct lyd_node *node);
  *                  - const struct ::lyd_node *data_tree - additional **validated** top-level siblings of a data tree that
  *                    will be used when checking any references ("when", "must" conditions, leafrefs, ...)
  *                    that require some nodes outside their subtree.
+ *                - #LYD_OPT_FILTER (after the arguments above):
+ *                  - const struct ::ly_set *filter - schema nodes selecting the subtrees to parse.
  * @return Pointer to the built data tree or NULL in case of empty \p data. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -613,6 +653,8 @@ struct lyd_node *lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT
  *                  - const struct ::lyd_node *data_tree - additional **validated** top-level siblings of a data tree that
  *                    will be used when checking any references ("when", "must" conditions, leafrefs, ...)
  *                    that require some nodes outside their subtree.
+ *                - #LYD_OPT_FILTER (after the arguments above):
+ *                  - const struct ::ly_set *filter - schema nodes selecting the subtrees to parse.
  * @return Pointer to the built data tree or NULL in case of empty file. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -651,12 +693,66 @@ struct lyd_node *lyd_parse_fd(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int
  *                  - const struct ::lyd_node *data_tree - additional **validated** top-level siblings of a data tree that
  *                    will be used when checking any references ("when", "must" conditions, leafrefs, ...)
  *                    that require some nodes outside their subtree.
+ *                - #LYD_OPT_FILTER (after the arguments above):
+ *                  - const struct ::ly_set *filter - schema nodes selecting the subtrees to parse.
  * @return Pointer to the built data tree or NULL in case of empty file. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
  */
 struct lyd_node *lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT format, int options, ...);
 
+/**
+ * @brief Incremental JSON data parser, see lyd_json_stream_new().
+ */
+struct lyd_json_stream;
+
+/**
+ * @brief Create an incremental (push) parser of JSON data.
+ *
+ * The data are passed to the parser in arbitrary chunks by lyd_json_stream_feed() and the data tree is being
+ * built as the chunks arrive, so the whole input never needs to be kept in memory. Containers and list instances
+ * are parsed as their content comes, only a single leaf, leaf-list, anydata, or attribute member is buffered until
+ * its value is complete. The result is the same as of lyd_parse_mem() with the #LYD_JSON format, except that the
+ * "yang:action" envelope is not supported.
+ *
+ * @param[in] ctx Context to connect with the data tree being built here.
+ * @param[in] options Parser options, see @ref parseroptions. #LYD_OPT_PIN_INPUT is ignored.
+ * @param[in] ... Variable arguments depend on \p options, the same as for lyd_parse_mem(). The filter of
+ *                #LYD_OPT_FILTER must exist until the parser is freed, a skipped subtree is buffered as a single value.
+ * @return Created parser, NULL on error. It is freed by lyd_json_stream_finish() or lyd_json_stream_free().
+ */
+struct lyd_json_stream *lyd_json_stream_new(struct ly_ctx *ctx, int options, ...);
+
+/**
+ * @brief Pass the next chunk of JSON data to the incremental parser.
+ *
+ * Everything that can be parsed from the data received so far is added to the data tree. When the function fails,
+ * the parser can only be freed.
+ *
+ * @param[in] stream Incremental parser.
+ * @param[in] chunk Next chunk of the data, not NULL-terminated.
+ * @param[in] len Length of \p chunk.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyd_json_stream_feed(struct lyd_json_stream *stream, const char *chunk, size_t len);
+
+/**
+ * @brief Finish the incremental parsing, validate the parsed data tree, and free the parser.
+ *
+ * @param[in] stream Incremental parser, freed by the function.
+ * @return Pointer to the built data tree or NULL in case of empty data. To free the returned structure,
+ *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error
+ *         (including incomplete data), #ly_errno contains appropriate error code (see #LY_ERR).
+ */
+struct lyd_node *lyd_json_stream_finish(struct lyd_json_stream *stream);
+
+/**
+ * @brief Free the incremental parser including the partially built data tree.
+ *
+ * @param[in] stream Incremental parser to free.
+ */
+void lyd_json_stream_free(struct lyd_json_stream *stream);
+
 /**
  * @brief Parse (and validate) XML tree.
  *
@@ -699,6 +795,8 @@ struct lyd_node *lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT
  *                  - const struct ::lyd_node *data_tree - additional **validated** top-level siblings of a data tree that
  *                    will be used when checking any references ("when", "must" conditions, leafrefs, ...)
  *                    that require some nodes outside their subtree.
+ *                - #LYD_OPT_FILTER (after the arguments above):
+ *                  - const struct ::ly_set *filter - schema nodes selecting the subtrees to parse.
  * @return Pointer to the built data tree or NULL in case of empty \p root. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -893,6 +991,73 @@ struct lyd_node *lyd_new_yangdata(const struct lys_module *module, const char *n
 struct lyd_node *lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *path, void *value,
                               LYD_ANYDATA_VALUETYPE value_type, int options);
 
+/**
+ * @brief Compiled data path, opaque for the users. It is created by lyd_path_compile() and used
+ * with lyd_new_path_compiled() and lyd_find_path_compiled() to avoid repeated parsing of the same path
+ * and resolving its schema nodes.
+ */
+struct lyd_path;
+
+/**
+ * @brief Compile a simple data path template into a reusable object.
+ *
+ * The path has the format of lyd_new_path() absolute paths, but without any predicates. Key values of all
+ * the lists in the path and a leaf-list value are instead provided whenever the compiled path is used. Key-less
+ * lists are allowed only as the last node and list keys cannot be the last node (they are created with the list).
+ *
+ * The compiled path is valid as long as the schema nodes in the context are, so it must not be used after
+ * the modules are removed from or disabled in the context.
+ *
+ * @param[in] ctx Context with the schemas of the path.
+ * @param[in] path Absolute simple data path (see @ref howtoxpath) without predicates.
+ * @param[in] options Only #LYD_PATH_OPT_OUTPUT is used, to resolve the path in RPC/action output instead of input.
+ * @return Compiled path, NULL on error.
+ */
+struct lyd_path *lyd_path_compile(const struct ly_ctx *ctx, const char *path, int options);
+
+/**
+ * @brief Free a compiled data path.
+ *
+ * @param[in] path Compiled path to free.
+ */
+void lyd_path_free(struct lyd_path *path);
+
+/**
+ * @brief Create a new data node based on a compiled data path. The behavior is the same as of lyd_new_path(),
+ * but no path parsing or schema searching is performed.
+ *
+ * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
+ *
+ * @param[in] data_tree Existing data tree to add to/modify (including siblings), can be NULL.
+ * @param[in] path Compiled path from lyd_path_compile().
+ * @param[in] keys Values of the keys of all the lists in \p path, in the order of the lists and their keys.
+ * Can be NULL if there are no keys.
+ * @param[in] value Value of the new leaf/leaf-list (const char*) or anydata/anyxml, as for lyd_new_path().
+ * @param[in] value_type Type of the provided \p value parameter in case of creating anydata or anyxml node.
+ * @param[in] options Bitmask of options flags, see @ref pathoptions. #LYD_PATH_OPT_OUTPUT is taken from the
+ * compilation.
+ * @return First created (or updated with #LYD_PATH_OPT_UPDATE) node,
+ * NULL if #LYD_PATH_OPT_UPDATE was used and the full path exists or the leaf original value matches \p value,
+ * NULL and ly_errno is set on error.
+ */
+struct lyd_node *lyd_new_path_compiled(struct lyd_node *data_tree, const struct lyd_path *path, const char **keys,
+                                       void *value, LYD_ANYDATA_VALUETYPE value_type, int options);
+
+/**
+ * @brief Search in the given data for the instance of a compiled data path. If cache is enabled, every
+ * non-top-level node on the path is found in a constant time.
+ *
+ * @param[in] data_tree Data tree to search in (including siblings).
+ * @param[in] path Compiled path from lyd_path_compile(). It cannot end with a key-less list or a state leaf-list.
+ * @param[in] keys Values of the keys of all the lists in \p path, in the order of the lists and their keys.
+ * Can be NULL if there are no keys.
+ * @param[in] value Value of the searched leaf-list instance, if \p path targets a leaf-list, ignored otherwise.
+ * @param[out] match Found data node, NULL if not found.
+ * @return 0 on success (even on not found), -1 on error.
+ */
+int lyd_find_path_compiled(const struct lyd_node *data_tree, const struct lyd_path *path, const char **keys,
+                           const char *value, struct lyd_node **match);
+
 /**
  * @brief Learn the relative instance position of a list or leaf-list within other instances of the
  * same schema node.
@@ -966,6 +1131,255 @@ struct lyd_node *lyd_dup_withsiblings(const struct lyd_node *node, int options);
  */
 struct lyd_node *lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx);
 
+/**
+ * @brief Data tree snapshot, opaque for the users. It is created by lyd_snapshot_new() and released by
+ * lyd_snapshot_free().
+ *
+ * A snapshot is an immutable copy of a whole data tree shared by any number of readers. Every holder of a reference
+ * can use the snapshot tree with XPath (lyd_find_path(), lyd_find_sibling*()), printers, lyd_dup*(), or simply
+ * traverse it, concurrently with other threads and without any locking, but it must never modify it.
+ */
+struct lyd_snapshot;
+
+/**
+ * @brief Data tree snapshot publication point, opaque for the users. It is created by lyd_snapshot_head_new()
+ * and freed by lyd_snapshot_head_free().
+ *
+ * A writer publishes a new snapshot of its data tree after every change by lyd_snapshot_publish() and readers
+ * acquire the current one by lyd_snapshot_get(). Older snapshots are freed once their last reader releases them.
+ */
+struct lyd_snapshot_head;
+
+/**
+ * @brief Create a snapshot of a data tree. The tree is copied once, any later changes of \p tree do not affect
+ * the snapshot. Implicit default leaves not instantiated yet (see #LYD_OPT_LAZY_DFLT) are created in the copy
+ * so that no reader ever modifies it.
+ *
+ * Structural sharing of unchanged subtrees between snapshots is not possible because every data node is linked to
+ * its parent and siblings, so each snapshot holds a complete copy.
+ *
+ * @param[in] tree Any top-level node of the data tree, all its siblings are included. NULL for an empty snapshot.
+ * @return New snapshot with a single reference, NULL on error.
+ */
+struct lyd_snapshot *lyd_snapshot_new(const struct lyd_node *tree);
+
+/**
+ * @brief Get the data tree of a snapshot.
+ *
+ * @param[in] snapshot Snapshot to use.
+ * @return First top-level node of the read-only data tree, NULL if empty.
+ */
+const struct lyd_node *lyd_snapshot_tree(const struct lyd_snapshot *snapshot);
+
+/**
+ * @brief Get another reference to a snapshot. Every reference must be released by lyd_snapshot_free().
+ *
+ * @param[in] snapshot Snapshot to reference.
+ * @return \p snapshot.
+ */
+struct lyd_snapshot *lyd_snapshot_ref(struct lyd_snapshot *snapshot);
+
+/**
+ * @brief Release a reference to a snapshot. The snapshot and its data tree are freed with the last reference.
+ *
+ * @param[in] snapshot Snapshot to release, may be NULL.
+ */
+void lyd_snapshot_free(struct lyd_snapshot *snapshot);
+
+/**
+ * @brief Create a snapshot publication point with no snapshot.
+ *
+ * @return New publication point, NULL on error.
+ */
+struct lyd_snapshot_head *lyd_snapshot_head_new(void);
+
+/**
+ * @brief Publish a snapshot, replacing the current one. Readers that already got the previous snapshot keep
+ * using it until they release it.
+ *
+ * @param[in] head Publication point to use.
+ * @param[in] snapshot Snapshot to publish, its reference is taken over by \p head. NULL to publish no snapshot.
+ */
+void lyd_snapshot_publish(struct lyd_snapshot_head *head, struct lyd_snapshot *snapshot);
+
+/**
+ * @brief Get a new reference to the currently published snapshot. It does not wait for any writer.
+ *
+ * @param[in] head Publication point to use.
+ * @return Current snapshot to be released by lyd_snapshot_free(), NULL if none was published.
+ */
+struct lyd_snapshot *lyd_snapshot_get(struct lyd_snapshot_head *head);
+
+/**
+ * @brief Free a snapshot publication point and release its current snapshot.
+ *
+ * @param[in] head Publication point to free, may be NULL.
+ */
+void lyd_snapshot_head_free(struct lyd_snapshot_head *head);
+
+/**
+ * @brief Flat data tree, opaque for the users. It is opened by lyd_flat_open() on an image written by
+ * lyd_flat_write_mem() or lyd_flat_write_fd() and closed by lyd_flat_close().
+ *
+ * An image is a read-only data tree in a single relocatable block of memory where all the nodes refer to each other
+ * by offsets and to their schema nodes by paths. It can be placed into a shared memory segment or a file, mapped at
+ * any address by any number of processes, and used directly in any context with the same implemented modules, with
+ * no parsing, allocation, or validation of data nodes. Its nodes are traversed by lyd_flat_first(), lyd_flat_next(),
+ * lyd_flat_child(), and lyd_flat_parent(), looked up by lyd_flat_find_path_compiled(), and the whole tree can be
+ * printed by lyd_flat_print_mem() or lyd_flat_print_fd().
+ *
+ * Anydata and anyxml nodes and attributes are not supported.
+ */
+struct lyd_flat;
+
+/**
+ * @brief Node of a flat data tree image, opaque for the users.
+ */
+struct lyd_flat_node;
+
+/**
+ * @brief Write a data tree into a new flat data tree image in memory.
+ *
+ * @param[out] image Written image to be freed by the caller, aligned to be opened directly.
+ * @param[out] size Size of \p image.
+ * @param[in] root First top-level node of the data tree, all its following siblings are written. NULL for
+ * an empty tree.
+ * @param[in] options [printer flags](@ref printerflags), only the with-defaults flags and #LYP_KEEPEMPTYCONT
+ * selecting the written nodes are used. The with-defaults tags are not written.
+ * @return 0 on success, 1 on failure.
+ */
+int lyd_flat_write_mem(void **image, size_t *size, const struct lyd_node *root, int options);
+
+/**
+ * @brief Write a data tree as a flat data tree image into a file descriptor, e.g. of a shared memory object.
+ *
+ * @param[in] fd File descriptor to write into.
+ * @param[in] root First top-level node of the data tree, all its following siblings are written. NULL for
+ * an empty tree.
+ * @param[in] options [printer flags](@ref printerflags), see lyd_flat_write_mem().
+ * @return 0 on success, 1 on failure.
+ */
+int lyd_flat_write_fd(int fd, const struct lyd_node *root, int options);
+
+/**
+ * @brief Open a flat data tree image. The header, modules, and schema nodes of the image are checked, the nodes
+ * themselves are trusted.
+ *
+ * @param[in] ctx Context with all the modules of the image implemented in the same revisions.
+ * @param[in] image Image, must be aligned to 4 bytes and stay unchanged until closed.
+ * @param[in] size Size of \p image.
+ * @return Opened flat data tree, NULL on error.
+ */
+struct lyd_flat *lyd_flat_open(struct ly_ctx *ctx, const void *image, size_t size);
+
+/**
+ * @brief Close a flat data tree, the image itself is left untouched.
+ *
+ * @param[in] flat Flat data tree to close, may be NULL.
+ */
+void lyd_flat_close(struct lyd_flat *flat);
+
+/**
+ * @brief Get the first top-level node of a flat data tree.
+ *
+ * @param[in] flat Flat data tree.
+ * @return First top-level node, NULL if the tree is empty.
+ */
+const struct lyd_flat_node *lyd_flat_first(const struct lyd_flat *flat);
+
+/**
+ * @brief Get the next sibling of a flat data tree node.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return Next sibling, NULL if \p node is the last one.
+ */
+const struct lyd_flat_node *lyd_flat_next(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Get the first child of a flat data tree node.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return First child, NULL if there are none.
+ */
+const struct lyd_flat_node *lyd_flat_child(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Get the parent of a flat data tree node.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return Parent, NULL for a top-level node.
+ */
+const struct lyd_flat_node *lyd_flat_parent(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Get the schema node of a flat data tree node in the context of the flat data tree.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return Schema node.
+ */
+const struct lys_node *lyd_flat_schema(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Get the canonical value of a flat data tree leaf or leaf-list, as in lyd_node_leaf_list::value_str.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return Value, NULL if \p node is not a leaf or a leaf-list.
+ */
+const char *lyd_flat_value(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Learn whether a flat data tree node is a default node.
+ *
+ * @param[in] flat Flat data tree.
+ * @param[in] node Node of \p flat.
+ * @return 1 for a default node, 0 otherwise.
+ */
+int lyd_flat_dflt(const struct lyd_flat *flat, const struct lyd_flat_node *node);
+
+/**
+ * @brief Search in a flat data tree for the instance of a compiled data path, see lyd_find_path_compiled().
+ * Siblings with a hash index in the image are searched in a constant time.
+ *
+ * @param[in] flat Flat data tree to search in.
+ * @param[in] path Compiled path from lyd_path_compile() in the context of \p flat. It cannot end with a key-less
+ * list or a state leaf-list.
+ * @param[in] keys Values of the keys of all the lists in \p path, in the order of the lists and their keys.
+ * Can be NULL if there are no keys.
+ * @param[in] value Value of the searched leaf-list instance, if \p path targets a leaf-list, ignored otherwise.
+ * @param[out] match Found node, NULL if not found.
+ * @return 0 on success (even on not found), -1 on error.
+ */
+int lyd_flat_find_path_compiled(const struct lyd_flat *flat, const struct lyd_path *path, const char **keys,
+                                const char *value, const struct lyd_flat_node **match);
+
+/**
+ * @brief Print a whole flat data tree, the same as lyd_print_mem() with #LYP_WITHSIBLINGS prints the data tree
+ * it was written from.
+ *
+ * @param[out] strp Pointer to store the resulting dump.
+ * @param[in] flat Flat data tree to print.
+ * @param[in] format Data output format, only #LYD_XML and #LYD_JSON are supported.
+ * @param[in] options [printer flags](@ref printerflags), only #LYP_FORMAT is used.
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_flat_print_mem(char **strp, const struct lyd_flat *flat, LYD_FORMAT format, int options);
+
+/**
+ * @brief Print a whole flat data tree, see lyd_flat_print_mem().
+ *
+ * @param[in] fd File descriptor where to print the data.
+ * @param[in] flat Flat data tree to print.
+ * @param[in] format Data output format, only #LYD_XML and #LYD_JSON are supported.
+ * @param[in] options [printer flags](@ref printerflags), only #LYP_FORMAT is used.
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_flat_print_fd(int fd, const struct lyd_flat *flat, LYD_FORMAT format, int options);
+
 /**
  * @brief Merge a (sub)tree into a data tree.
  *
@@ -1078,6 +1492,66 @@ int lyd_insert(struct lyd_node *parent, struct lyd_node *node);
  */
 int lyd_insert_sibling(struct lyd_node **sibling, struct lyd_node *node);
 
+/**
+ * @brief Data subtree builder, opaque for the users. It is created by lyd_builder_new() and always
+ * finished by lyd_builder_finish().
+ */
+struct lyd_builder;
+
+/**
+ * @brief Start building new data nodes in a batch.
+ *
+ * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
+ *
+ * Nodes created by the builder are only appended as the last children of their parents. Maintaining of the children
+ * hash tables, the key-less list hashes, and the validation flags is postponed until lyd_builder_finish(), which
+ * processes all the created subtrees in one pass. Meanwhile, the data tree must not be accessed or modified
+ * other than by the builder functions. Compared to lyd_insert(), the caller is responsible for the schema
+ * order of RPC/action nodes and for not creating multiple instances of the same node.
+ *
+ * @param[in] parent Existing data node to add the new children to. NULL to build new top-level nodes.
+ * @return New builder, NULL on error.
+ */
+struct lyd_builder *lyd_builder_new(struct lyd_node *parent);
+
+/**
+ * @brief Create a new container, list, RPC/action, or notification node using a builder.
+ *
+ * @param[in] builder Builder to use.
+ * @param[in] parent Parent of the new node, either the builder parent or a node created by the builder.
+ * NULL for the builder parent.
+ * @param[in] module Module with the node being created, can be NULL if the parent is known.
+ * @param[in] name Schema node name of the new data node.
+ * @return New node, NULL on error.
+ */
+struct lyd_node *lyd_builder_add(struct lyd_builder *builder, struct lyd_node *parent, const struct lys_module *module,
+                                 const char *name);
+
+/**
+ * @brief Create a new leaf or leaf-list node using a builder. List keys must be created right after the list,
+ * in their schema order, before any other child.
+ *
+ * @param[in] builder Builder to use.
+ * @param[in] parent Parent of the new node, either the builder parent or a node created by the builder.
+ * NULL for the builder parent.
+ * @param[in] module Module with the node being created, can be NULL if the parent is known.
+ * @param[in] name Schema node name of the new data node.
+ * @param[in] val_str String form of the value of the node being created.
+ * @return New node, NULL on error.
+ */
+struct lyd_node *lyd_builder_add_leaf(struct lyd_builder *builder, struct lyd_node *parent, const struct lys_module *module,
+                                      const char *name, const char *val_str);
+
+/**
+ * @brief Finish building and free the builder. The hash tables of all the affected parents are created at once
+ * for their final number of children and the nodes are invalidated as by lyd_insert(). Default nodes of the builder
+ * parent are replaced by the new nodes of the same schema.
+ *
+ * @param[in] builder Builder to finish.
+ * @return First node created as a child of the builder parent (or as a top-level node), NULL if there is none.
+ */
+struct lyd_node *lyd_builder_finish(struct lyd_builder *builder);
+
 /**
  * @brief Insert the \p node element after the \p sibling element. If \p node and \p siblings are already
  * siblings (just moving \p node position).
@@ -1136,6 +1610,10 @@ int lyd_schema_sort(struct lyd_node *sibling, int recursive);
  *
  * Learn more about the path format on page @ref howtoxpath.
  *
+ * Implicit default leaves deferred by #LYD_OPT_LAZY_DFLT are instantiated when the expression accesses them, so
+ * the tree is modified even though it is passed as const. To search such a tree from several threads at once,
+ * call lyd_wd_materialize() on it first.
+ *
  * @param[in] ctx_node Path context node.
  * @param[in] path Data path expression filtering the matching nodes.
  * @return Set of found data nodes. If no nodes are matching \p path or the result
@@ -1159,6 +1637,10 @@ struct ly_set *lyd_find_instance(const struct lyd_node *data, const struct lys_n
  * @brief Search in the given siblings for the target instance. If cache is enabled and the siblings
  * are NOT top-level nodes, this function finds the node in a constant time!
  *
+ * An implicit default leaf deferred by #LYD_OPT_LAZY_DFLT is instantiated when it is searched for, so the
+ * siblings are modified even though they are passed as const (see lyd_find_path()). Only the leaves of
+ * a parent with some children can be found this way, \p siblings cannot be NULL.
+ *
  * @param[in] siblings Siblings to search in including preceding and succeeding nodes.
  * @param[in] target Target node to find. Lists must have all the keys.
  * Invalid argument - key-less list or state (config false) leaf-list, use ::lyd_find_sibling_set instead.
@@ -1171,6 +1653,8 @@ int lyd_find_sibling(const struct lyd_node *siblings, const struct lyd_node *tar
  * @brief Search in the given siblings for all target instances. If cache is enabled and the siblings
  * are NOT top-level nodes, this function finds the node(s) in a constant time!
  *
+ * Deferred implicit default leaves are instantiated as by lyd_find_sibling().
+ *
  * @param[in] siblings Siblings to search in including preceding and succeeding nodes.
  * @param[in] target Target node to find. Lists must have all the keys. Key-less lists are compared based on
  * all its descendants (both direct and indirect).
@@ -1184,6 +1668,8 @@ int lyd_find_sibling_set(const struct lyd_node *siblings, const struct lyd_node
  * @brief Search in the given siblings for the schema instance. If cache is enabled and the siblings
  * are NOT top-level nodes, this function finds the node in a constant time!
  *
+ * Deferred implicit default leaves are instantiated as by lyd_find_sibling().
+ *
  * @param[in] siblings Siblings to search in including preceding and succeeding nodes.
  * @param[in] schema Schema node of the data node to find.
  * Invalid argument - key-less list or state (config false) leaf-list, use ::lyd_find_sibling_set instead.
@@ -1323,6 +1809,17 @@ int lyd_value_type(struct lys_node *node, const char *value, struct lys_type **t
  */
 int lyd_wd_default(struct lyd_node_leaf_list *node);
 
+/**
+ * @brief Instantiate all the implicit default leaves deferred by #LYD_OPT_LAZY_DFLT.
+ *
+ * Needed only before traversing the children directly or accessing the tree from several threads at once,
+ * XPath evaluation, lyd_find_sibling*() functions, and printing do it on their own.
+ *
+ * @param[in] root Data tree (with all the siblings) to process.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyd_wd_materialize(struct lyd_node *root);
+
 /**
  * @brief Learn if a node is supposed to be printed based on the options.
  *
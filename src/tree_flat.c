@@ -0,0 +1,1294 @@
+/**
+ * @file tree_flat.c
+ * @brief Position-independent read-only images of data trees
+ *
+ * Copyright (c) 2018 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "libyang.h"
+#include "common.h"
+#include "context.h"
+#include "hash_table.h"
+#include "printer.h"
+#include "tree_internal.h"
+#include "xml_internal.h"
+
+/* node of an image at an offset, NULL for offset 0 */
+#define FLAT_NODE(image, off) ((off) ? (struct lyd_flat_node *)((char *)(image) + (off)) : NULL)
+
+/* string of an image at an offset */
+#define FLAT_STR(image, off) ((const char *)(image) + (off))
+
+/* schema node of an image node */
+#define FLAT_SNODE(flat, node) ((flat)->snodes[(node)->schema])
+
+/**
+ * @brief Flat data tree image being written.
+ */
+struct lyd_flat_wr {
+    struct ly_ctx *ctx;
+    char *buf;                      /**< the image */
+    uint32_t len;                   /**< used bytes of the image */
+    uint32_t size;                  /**< allocated bytes of the image */
+    int options;                    /**< printer flags selecting the nodes */
+    struct hash_table *snode_ht;    /**< indices of the written schema nodes */
+    struct hash_table *str_ht;      /**< offsets of the written strings */
+    const struct lys_node **snodes; /**< written schema nodes in the order of their indices */
+    uint32_t snode_count;
+};
+
+/**
+ * @brief Record of the hash tables of struct lyd_flat_wr.
+ */
+struct lyd_flat_wr_rec {
+    const void *ptr;                /**< schema node or string */
+    uint32_t val;                   /**< index or offset */
+};
+
+static int
+lyd_flat_wr_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct lyd_flat_wr_rec *)val1_p)->ptr == ((struct lyd_flat_wr_rec *)val2_p)->ptr;
+}
+
+static uint32_t
+lyd_flat_ptr_hash(const void *ptr)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&ptr, sizeof ptr);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Hash of a node stored in its image record. Unlike lyd_node::hash, it does not depend on the build options.
+ *
+ * @param[in] node Node to hash, the keys of a list must be its first children.
+ * @return Node hash.
+ */
+static uint32_t
+lyd_flat_node_hash(const struct lyd_node *node)
+{
+    const struct lyd_node *key;
+    const char *mod_name;
+    uint32_t hash;
+    uint8_t i;
+
+    mod_name = lyd_node_module(node)->name;
+    hash = dict_hash_stable_multi(0, mod_name, strlen(mod_name));
+    hash = dict_hash_stable_multi(hash, node->schema->name, strlen(node->schema->name));
+    if (node->schema->nodetype == LYS_LEAFLIST) {
+        mod_name = ((struct lyd_node_leaf_list *)node)->value_str;
+        hash = dict_hash_stable_multi(hash, mod_name, strlen(mod_name));
+    } else if (node->schema->nodetype == LYS_LIST) {
+        for (i = 0, key = node->child; key && (i < ((struct lys_node_list *)node->schema)->keys_size); ++i, key = key->next) {
+            mod_name = ((struct lyd_node_leaf_list *)key)->value_str;
+            hash = dict_hash_stable_multi(hash, mod_name, strlen(mod_name));
+        }
+    }
+
+    return dict_hash_stable_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Allocate zeroed space in the image.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] len Number of bytes.
+ * @param[in] align Required alignment of the space.
+ * @return Offset of the space, 0 on error.
+ */
+static uint32_t
+lyd_flat_wr_alloc(struct lyd_flat_wr *wr, size_t len, uint32_t align)
+{
+    uint32_t off, size;
+    char *buf;
+
+    off = (wr->len + align - 1) & ~(align - 1);
+    if ((off < wr->len) || (len > UINT32_MAX - off)) {
+        LOGERR(wr->ctx, LY_EINVAL, "Flat data tree image exceeds %" PRIu32 " bytes.", UINT32_MAX);
+        return 0;
+    }
+
+    if (off + len > wr->size) {
+        for (size = wr->size ? wr->size : 1024; size < off + len; size = (size > UINT32_MAX / 2) ? UINT32_MAX : size * 2);
+        buf = realloc(wr->buf, size);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM(wr->ctx), 0);
+        wr->buf = buf;
+        wr->size = size;
+    }
+
+    memset(wr->buf + wr->len, 0, off + len - wr->len);
+    wr->len = off + len;
+    return off;
+}
+
+/**
+ * @brief Write a string into the image.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] str String to write.
+ * @param[in] reuse Whether \p str stays valid until the image is written so that its offset can be reused.
+ * @return Offset of the string, 0 on error.
+ */
+static uint32_t
+lyd_flat_wr_str(struct lyd_flat_wr *wr, const char *str, int reuse)
+{
+    struct lyd_flat_wr_rec rec, *match;
+    uint32_t hash = 0, off;
+    size_t len;
+
+    if (reuse) {
+        rec.ptr = str;
+        hash = lyd_flat_ptr_hash(str);
+        if (!lyht_find(wr->str_ht, &rec, hash, (void **)&match)) {
+            return match->val;
+        }
+    }
+
+    len = strlen(str) + 1;
+    off = lyd_flat_wr_alloc(wr, len, 1);
+    if (!off) {
+        return 0;
+    }
+    memcpy(wr->buf + off, str, len);
+
+    if (reuse) {
+        rec.val = off;
+        LY_CHECK_ERR_RETURN(lyht_insert(wr->str_ht, &rec, hash, NULL), LOGINT(wr->ctx), 0);
+    }
+    return off;
+}
+
+/**
+ * @brief Get the image index of a schema node, add it if not there yet.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] snode Schema node.
+ * @param[out] idx Index of \p snode.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_flat_wr_snode(struct lyd_flat_wr *wr, const struct lys_node *snode, uint32_t *idx)
+{
+    struct lyd_flat_wr_rec rec, *match;
+    const struct lys_node **snodes;
+    uint32_t hash;
+
+    rec.ptr = snode;
+    hash = lyd_flat_ptr_hash(snode);
+    if (!lyht_find(wr->snode_ht, &rec, hash, (void **)&match)) {
+        *idx = match->val;
+        return 0;
+    }
+
+    snodes = realloc(wr->snodes, (wr->snode_count + 1) * sizeof *snodes);
+    LY_CHECK_ERR_RETURN(!snodes, LOGMEM(wr->ctx), -1);
+    wr->snodes = snodes;
+    wr->snodes[wr->snode_count] = snode;
+
+    rec.val = wr->snode_count++;
+    LY_CHECK_ERR_RETURN(lyht_insert(wr->snode_ht, &rec, hash, NULL), LOGINT(wr->ctx), -1);
+    *idx = rec.val;
+    return 0;
+}
+
+/**
+ * @brief Write the value of a leaf or a leaf-list into its image record. The printed form is decided
+ * the same way as by the XML and JSON printers.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] off Offset of the record.
+ * @param[in] leaf Leaf or leaf-list.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_flat_wr_value(struct lyd_flat_wr *wr, uint32_t off, const struct lyd_node_leaf_list *leaf)
+{
+    const struct lyd_node_leaf_list *iter;
+    const struct lys_type *type;
+    const struct lys_tpdf *tpdf;
+    const char **prefs = NULL, **nss = NULL, *xml_expr, *value, *p;
+    enum int_log_opts prev_ilo;
+    LY_DATA_TYPE datatype;
+    uint32_t ns_count = 0, i, val, xml_value = 0, xml_ns = 0;
+    uint8_t value_fmt;
+    int xml = 0, ret = -1;
+    char *ns_str = NULL;
+    size_t len;
+
+    value = leaf->value_str ? leaf->value_str : "";
+    datatype = leaf->value_type;
+
+resolve:
+    switch (datatype) {
+    case LY_TYPE_STRING:
+        value_fmt = LYD_FLAT_VAL_STR;
+        ly_ilo_change(NULL, ILO_IGNORE, &prev_ilo, NULL);
+        type = lyd_leaf_type(leaf);
+        ly_ilo_restore(NULL, prev_ilo, NULL, 0);
+        if (type) {
+            for (tpdf = type->der;
+                tpdf->module && (strcmp(tpdf->name, "xpath1.0") || strcmp(tpdf->module->name, "ietf-yang-types"));
+                tpdf = tpdf->type.der);
+            /* special handling of ietf-yang-types xpath1.0, printed with namespaces in XML */
+            xml = tpdf->module ? 1 : 0;
+        }
+        break;
+    case LY_TYPE_BINARY:
+    case LY_TYPE_BITS:
+    case LY_TYPE_ENUM:
+    case LY_TYPE_UNION:
+    case LY_TYPE_DEC64:
+    case LY_TYPE_INT64:
+    case LY_TYPE_UINT64:
+        value_fmt = LYD_FLAT_VAL_STR;
+        break;
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_BOOL:
+        value_fmt = LYD_FLAT_VAL_NUM;
+        break;
+    case LY_TYPE_IDENT:
+        value_fmt = LYD_FLAT_VAL_IDENT;
+        p = strchr(value, ':');
+        if (p) {
+            len = p - value;
+            /* an identity of another module needs its namespace in XML */
+            xml = (strncmp(value, leaf->schema->module->name, len) || leaf->schema->module->name[len]) ? 1 : 0;
+        }
+        break;
+    case LY_TYPE_INST:
+        value_fmt = LYD_FLAT_VAL_STR;
+        xml = 1;
+        break;
+    case LY_TYPE_LEAFREF:
+        iter = (struct lyd_node_leaf_list *)leaf->value.leafref;
+        while (iter && (iter->value_type == LY_TYPE_LEAFREF)) {
+            iter = (struct lyd_node_leaf_list *)iter->value.leafref;
+        }
+        if (!iter) {
+            /* unresolved and invalid, but we can learn the correct type anyway */
+            type = lyd_leaf_type(leaf);
+            if (!type) {
+                return -1;
+            }
+            datatype = type->base;
+        } else {
+            datatype = iter->value_type;
+        }
+        goto resolve;
+    case LY_TYPE_EMPTY:
+    case LY_TYPE_UNKNOWN:
+        value_fmt = LYD_FLAT_VAL_EMPTY;
+        break;
+    default:
+        LOGINT(wr->ctx);
+        return -1;
+    }
+
+    val = lyd_flat_wr_str(wr, value, 1);
+    if (!val) {
+        return -1;
+    }
+
+    if (xml && value[0]) {
+        xml_expr = transform_json2xml(leaf->schema->module, value, 1, &prefs, &nss, &ns_count);
+        if (!xml_expr) {
+            return -1;
+        }
+
+        /* namespace declarations printed with the value */
+        for (i = 0, len = 0; i < ns_count; ++i) {
+            len += strlen(prefs[i]) + strlen(nss[i]) + 11;
+        }
+        if (ns_count) {
+            ns_str = malloc(len + 1);
+            LY_CHECK_ERR_GOTO(!ns_str, LOGMEM(wr->ctx), cleanup);
+            for (i = 0, len = 0; i < ns_count; ++i) {
+                len += sprintf(ns_str + len, " xmlns:%s=\"%s\"", prefs[i], nss[i]);
+            }
+            xml_ns = lyd_flat_wr_str(wr, ns_str, 0);
+            if (!xml_ns) {
+                goto cleanup;
+            }
+        }
+
+        xml_value = lyd_flat_wr_str(wr, xml_expr, 0);
+        if (!xml_value) {
+            goto cleanup;
+        }
+        ret = 0;
+
+cleanup:
+        lydict_remove(wr->ctx, xml_expr);
+        free(prefs);
+        free(nss);
+        free(ns_str);
+        if (ret) {
+            return ret;
+        }
+    }
+
+    FLAT_NODE(wr->buf, off)->value = val;
+    FLAT_NODE(wr->buf, off)->xml_value = xml_value;
+    FLAT_NODE(wr->buf, off)->xml_ns = xml_ns;
+    FLAT_NODE(wr->buf, off)->value_fmt = value_fmt;
+    return 0;
+}
+
+/**
+ * @brief Write the hash index of siblings into the image.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] first Offset of the first sibling.
+ * @param[in] count Number of the siblings.
+ * @return Offset of the index, 0 on error.
+ */
+static uint32_t
+lyd_flat_wr_index(struct lyd_flat_wr *wr, uint32_t first, uint32_t count)
+{
+    struct lyd_flat_node *node;
+    uint32_t off, size, *slots, i;
+
+    /* keep the index at most half full */
+    for (size = LYD_FLAT_INDEX_MIN; size < 2 * count; size <<= 1);
+
+    off = lyd_flat_wr_alloc(wr, (size + 1) * sizeof *slots, sizeof *slots);
+    if (!off) {
+        return 0;
+    }
+    slots = (uint32_t *)(wr->buf + off);
+    slots[0] = size;
+    ++slots;
+
+    for (node = FLAT_NODE(wr->buf, first); node; node = FLAT_NODE(wr->buf, node->next)) {
+        for (i = node->hash & (size - 1); slots[i]; i = (i + 1) & (size - 1));
+        slots[i] = (char *)node - wr->buf;
+    }
+
+    return off;
+}
+
+/**
+ * @brief Write data siblings and their descendants into the image.
+ *
+ * @param[in] wr Image being written.
+ * @param[in] first First sibling.
+ * @param[in] parent Offset of the parent record, 0 for top-level siblings.
+ * @param[out] first_off Offset of the first written sibling, 0 if none.
+ * @param[out] index_off Offset of the sibling index, 0 if none.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_flat_wr_siblings(struct lyd_flat_wr *wr, const struct lyd_node *first, uint32_t parent, uint32_t *first_off,
+                     uint32_t *index_off)
+{
+    const struct lyd_node *node;
+    struct lyd_flat_node *rec;
+    uint32_t off, prev = 0, idx, child, index, count = 0;
+
+    *first_off = 0;
+    *index_off = 0;
+
+    LY_TREE_FOR(first, node) {
+        if (!lyd_node_should_print(node, wr->options)) {
+            continue;
+        }
+        if (node->schema->nodetype & LYS_ANYDATA) {
+            LOGERR(wr->ctx, LY_EINVAL, "Anydata and anyxml nodes cannot be written into a flat data tree (\"%s\").",
+                   node->schema->name);
+            return -1;
+        }
+
+        off = lyd_flat_wr_alloc(wr, sizeof *rec, LYD_FLAT_ALIGN);
+        if (!off || lyd_flat_wr_snode(wr, node->schema, &idx)) {
+            return -1;
+        }
+        rec = FLAT_NODE(wr->buf, off);
+        rec->schema = idx;
+        rec->hash = lyd_flat_node_hash(node);
+        rec->parent = parent;
+        rec->flags = (node->dflt ? LYD_FLAT_DFLT : 0) | (node->child ? LYD_FLAT_CHILDREN : 0);
+        if (prev) {
+            FLAT_NODE(wr->buf, prev)->next = off;
+            rec->prev = prev;
+        } else {
+            *first_off = off;
+        }
+        prev = off;
+        ++count;
+
+        if (node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
+            if (lyd_flat_wr_value(wr, off, (struct lyd_node_leaf_list *)node)) {
+                return -1;
+            }
+        } else if (node->child) {
+            if (lyd_flat_wr_siblings(wr, node->child, off, &child, &index)) {
+                return -1;
+            }
+            FLAT_NODE(wr->buf, off)->child = child;
+            FLAT_NODE(wr->buf, off)->index = index;
+        }
+    }
+
+    if (*first_off) {
+        /* the first sibling points to the last one, as in the data tree */
+        FLAT_NODE(wr->buf, *first_off)->prev = prev;
+    }
+    if (count >= LYD_FLAT_INDEX_MIN) {
+        *index_off = lyd_flat_wr_index(wr, *first_off, count);
+        if (!*index_off) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Write the module and schema node tables into the image.
+ *
+ * @param[in] wr Image being written.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_flat_wr_tables(struct lyd_flat_wr *wr)
+{
+    const struct lys_module **mods = NULL, *mod;
+    struct lyd_flat_hdr *hdr;
+    struct lyd_flat_mod *fmod;
+    struct lyd_flat_snode *fsnode;
+    uint32_t i, j, mod_count = 0, off, str;
+    char *path;
+    int ret = -1;
+
+    /* modules of all the schema nodes */
+    for (i = 0; i < wr->snode_count; ++i) {
+        mod = lys_node_module(wr->snodes[i]);
+        for (j = 0; (j < mod_count) && (mods[j] != mod); ++j);
+        if (j == mod_count) {
+            mods = ly_realloc(mods, (mod_count + 1) * sizeof *mods);
+            LY_CHECK_ERR_RETURN(!mods, LOGMEM(wr->ctx), -1);
+            mods[mod_count++] = mod;
+        }
+    }
+
+    off = lyd_flat_wr_alloc(wr, mod_count * sizeof *fmod, LYD_FLAT_ALIGN);
+    if (!off) {
+        goto cleanup;
+    }
+    hdr = (struct lyd_flat_hdr *)wr->buf;
+    hdr->mods = off;
+    hdr->mod_count = mod_count;
+    for (i = 0; i < mod_count; ++i) {
+        str = lyd_flat_wr_str(wr, mods[i]->name, 1);
+        if (!str) {
+            goto cleanup;
+        }
+        fmod = (struct lyd_flat_mod *)(wr->buf + off) + i;
+        fmod->name = str;
+        if (mods[i]->rev_size) {
+            str = lyd_flat_wr_str(wr, mods[i]->rev[0].date, 0);
+            if (!str) {
+                goto cleanup;
+            }
+            fmod = (struct lyd_flat_mod *)(wr->buf + off) + i;
+            fmod->revision = str;
+        }
+    }
+
+    off = lyd_flat_wr_alloc(wr, wr->snode_count * sizeof *fsnode, LYD_FLAT_ALIGN);
+    if (!off) {
+        goto cleanup;
+    }
+    hdr = (struct lyd_flat_hdr *)wr->buf;
+    hdr->snodes = off;
+    hdr->snode_count = wr->snode_count;
+    for (i = 0; i < wr->snode_count; ++i) {
+        /* schema paths are resolvable in any context with the same modules */
+        path = lys_path(wr->snodes[i], 0);
+        LY_CHECK_ERR_GOTO(!path, LOGMEM(wr->ctx), cleanup);
+        str = lyd_flat_wr_str(wr, path, 0);
+        free(path);
+        if (!str) {
+            goto cleanup;
+        }
+        fsnode = (struct lyd_flat_snode *)(wr->buf + off) + i;
+        fsnode->path = str;
+    }
+    ret = 0;
+
+cleanup:
+    free(mods);
+    return ret;
+}
+
+/**
+ * @brief Write a flat data tree image into memory.
+ *
+ * @param[in] root Top-level node of the data tree.
+ * @param[in] options Printer flags selecting the nodes.
+ * @param[out] image Written image.
+ * @param[out] size Size of \p image.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyd_flat_write(const struct lyd_node *root, int options, char **image, uint32_t *size)
+{
+    struct lyd_flat_wr wr;
+    struct lyd_flat_hdr *hdr;
+    struct lyd_node *dup = NULL;
+    uint32_t first, index;
+    int ret = -1;
+
+    memset(&wr, 0, sizeof wr);
+    wr.ctx = root ? lyd_node_module(root)->ctx : NULL;
+    wr.options = options;
+
+    if ((options & (LYP_WD_ALL | LYP_WD_ALL_TAG | LYP_WD_IMPL_TAG)) && lyd_print_has_lazy(root, LYP_WITHSIBLINGS)) {
+        /* the deferred default nodes are written, instantiate them in a copy */
+        dup = lyd_dup_withsiblings(root, LYD_DUP_OPT_RECURSIVE | LYD_DUP_OPT_WITH_WHEN);
+        if (!dup || lyd_wd_materialize(dup)) {
+            goto cleanup;
+        }
+        root = dup;
+    }
+
+    wr.snode_ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_flat_wr_rec), lyd_flat_wr_rec_equal, NULL, 1);
+    wr.str_ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_flat_wr_rec), lyd_flat_wr_rec_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!wr.snode_ht || !wr.str_ht, LOGMEM(wr.ctx), cleanup);
+
+    if (!lyd_flat_wr_alloc(&wr, sizeof *hdr, LYD_FLAT_ALIGN) && !wr.buf) {
+        goto cleanup;
+    }
+    if (lyd_flat_wr_siblings(&wr, root, 0, &first, &index) || lyd_flat_wr_tables(&wr)) {
+        goto cleanup;
+    }
+
+    hdr = (struct lyd_flat_hdr *)wr.buf;
+    memcpy(hdr->magic, LYD_FLAT_MAGIC, sizeof hdr->magic);
+    hdr->version = LYD_FLAT_VERSION;
+    hdr->byte_order = LYD_FLAT_BYTE_ORDER;
+    hdr->size = wr.len;
+    hdr->first = first;
+    hdr->index = index;
+    hdr->flags = root ? LYD_FLAT_CHILDREN : 0;
+
+    *image = wr.buf;
+    *size = wr.len;
+    wr.buf = NULL;
+    ret = 0;
+
+cleanup:
+    lyht_free(wr.snode_ht);
+    lyht_free(wr.str_ht);
+    free(wr.snodes);
+    free(wr.buf);
+    lyd_free_withsiblings(dup);
+    return ret;
+}
+
+API int
+lyd_flat_write_mem(void **image, size_t *size, const struct lyd_node *root, int options)
+{
+    FUN_IN;
+
+    char *buf;
+    uint32_t len;
+
+    if (!image || !size || (root && root->parent)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (lyd_flat_write(root, options, &buf, &len)) {
+        return EXIT_FAILURE;
+    }
+
+    *image = buf;
+    *size = len;
+    return EXIT_SUCCESS;
+}
+
+API int
+lyd_flat_write_fd(int fd, const struct lyd_node *root, int options)
+{
+    FUN_IN;
+
+    char *buf;
+    uint32_t len, written;
+    ssize_t r;
+
+    if ((fd < 0) || (root && root->parent)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (lyd_flat_write(root, options, &buf, &len)) {
+        return EXIT_FAILURE;
+    }
+
+    for (written = 0; written < len; written += r) {
+        r = write(fd, buf + written, len - written);
+        if (r < 0) {
+            if (errno == EINTR) {
+                r = 0;
+                continue;
+            }
+            LOGERR(root ? lyd_node_module(root)->ctx : NULL, LY_ESYS, "Writing a flat data tree failed (%s).", strerror(errno));
+            free(buf);
+            return EXIT_FAILURE;
+        }
+    }
+
+    free(buf);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Get a string of an image with bounds checking.
+ *
+ * @param[in] image Image.
+ * @param[in] size Size of \p image.
+ * @param[in] off Offset of the string.
+ * @return String, NULL if it is not within the image.
+ */
+static const char *
+lyd_flat_str_check(const char *image, uint32_t size, uint32_t off)
+{
+    if (!off || (off >= size) || !memchr(image + off, '\0', size - off)) {
+        return NULL;
+    }
+    return image + off;
+}
+
+API struct lyd_flat *
+lyd_flat_open(struct ly_ctx *ctx, const void *image, size_t size)
+{
+    FUN_IN;
+
+    const struct lyd_flat_hdr *hdr = image;
+    const struct lyd_flat_mod *fmod;
+    const struct lyd_flat_snode *fsnode;
+    const char *name, *rev, *path;
+    struct lyd_flat *flat = NULL;
+    struct ly_set *set;
+    uint32_t i;
+
+    if (!ctx || !image || ((uintptr_t)image % LYD_FLAT_ALIGN)) {
+        LOGARG;
+        return NULL;
+    }
+
+    if ((size < sizeof *hdr) || memcmp(hdr->magic, LYD_FLAT_MAGIC, sizeof hdr->magic)
+            || (hdr->byte_order != LYD_FLAT_BYTE_ORDER) || (hdr->size > size)
+            || (hdr->mods % LYD_FLAT_ALIGN) || (hdr->snodes % LYD_FLAT_ALIGN)
+            || ((uint64_t)hdr->mods + (uint64_t)hdr->mod_count * sizeof *fmod > hdr->size)
+            || ((uint64_t)hdr->snodes + (uint64_t)hdr->snode_count * sizeof *fsnode > hdr->size)) {
+        LOGERR(ctx, LY_EINVAL, "Invalid flat data tree image.");
+        return NULL;
+    }
+    if (hdr->version != LYD_FLAT_VERSION) {
+        LOGERR(ctx, LY_EINVAL, "Unsupported flat data tree image version %u.", hdr->version);
+        return NULL;
+    }
+
+    /* the context must have the same modules */
+    for (i = 0; i < hdr->mod_count; ++i) {
+        fmod = (const struct lyd_flat_mod *)((const char *)image + hdr->mods) + i;
+        name = lyd_flat_str_check(image, hdr->size, fmod->name);
+        rev = fmod->revision ? lyd_flat_str_check(image, hdr->size, fmod->revision) : NULL;
+        if (!name || (fmod->revision && !rev)) {
+            LOGERR(ctx, LY_EINVAL, "Invalid flat data tree image.");
+            return NULL;
+        }
+        if (!ly_ctx_get_module(ctx, name, rev, 1)) {
+            LOGERR(ctx, LY_EINVAL, "Module \"%s%s%s\" of the flat data tree not implemented in the context.", name,
+                   rev ? "@" : "", rev ? rev : "");
+            return NULL;
+        }
+    }
+
+    flat = calloc(1, sizeof *flat);
+    LY_CHECK_ERR_RETURN(!flat, LOGMEM(ctx), NULL);
+    flat->ctx = ctx;
+    flat->image = image;
+    flat->snode_count = hdr->snode_count;
+    flat->snodes = malloc((hdr->snode_count ? hdr->snode_count : 1) * sizeof *flat->snodes);
+    LY_CHECK_ERR_GOTO(!flat->snodes, LOGMEM(ctx), error);
+
+    /* resolve the schema nodes in this context */
+    for (i = 0; i < hdr->snode_count; ++i) {
+        fsnode = (const struct lyd_flat_snode *)((const char *)image + hdr->snodes) + i;
+        path = lyd_flat_str_check(image, hdr->size, fsnode->path);
+        if (!path) {
+            LOGERR(ctx, LY_EINVAL, "Invalid flat data tree image.");
+            goto error;
+        }
+        set = ly_ctx_find_path(ctx, path);
+        if (!set || (set->number != 1)) {
+            ly_set_free(set);
+            LOGERR(ctx, LY_EINVAL, "Schema node \"%s\" of the flat data tree not found in the context.", path);
+            goto error;
+        }
+        flat->snodes[i] = set->set.s[0];
+        ly_set_free(set);
+    }
+
+    return flat;
+
+error:
+    lyd_flat_close(flat);
+    return NULL;
+}
+
+API void
+lyd_flat_close(struct lyd_flat *flat)
+{
+    FUN_IN;
+
+    if (!flat) {
+        return;
+    }
+
+    free(flat->snodes);
+    free(flat);
+}
+
+API const struct lyd_flat_node *
+lyd_flat_first(const struct lyd_flat *flat)
+{
+    FUN_IN;
+
+    if (!flat) {
+        LOGARG;
+        return NULL;
+    }
+
+    return FLAT_NODE(flat->image, ((struct lyd_flat_hdr *)flat->image)->first);
+}
+
+API const struct lyd_flat_node *
+lyd_flat_next(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return NULL;
+    }
+
+    return FLAT_NODE(flat->image, node->next);
+}
+
+API const struct lyd_flat_node *
+lyd_flat_child(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return NULL;
+    }
+
+    return FLAT_NODE(flat->image, node->child);
+}
+
+API const struct lyd_flat_node *
+lyd_flat_parent(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return NULL;
+    }
+
+    return FLAT_NODE(flat->image, node->parent);
+}
+
+API const struct lys_node *
+lyd_flat_schema(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return NULL;
+    }
+
+    return FLAT_SNODE(flat, node);
+}
+
+API const char *
+lyd_flat_value(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return NULL;
+    }
+
+    return node->value ? FLAT_STR(flat->image, node->value) : NULL;
+}
+
+API int
+lyd_flat_dflt(const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    FUN_IN;
+
+    if (!flat || !node) {
+        LOGARG;
+        return 0;
+    }
+
+    return (node->flags & LYD_FLAT_DFLT) ? 1 : 0;
+}
+
+/**
+ * @brief Check whether an image node is an instance of a data node.
+ *
+ * @param[in] flat Opened image.
+ * @param[in] node Image node.
+ * @param[in] target Data node with its keys or value.
+ * @param[in] hash Image hash of \p target.
+ * @return Non-zero if equal, 0 otherwise.
+ */
+static int
+lyd_flat_node_equal(const struct lyd_flat *flat, const struct lyd_flat_node *node, const struct lyd_node *target,
+                    uint32_t hash)
+{
+    const struct lyd_flat_node *key;
+    const struct lyd_node *tkey;
+    uint8_t i;
+
+    if ((node->hash != hash) || (FLAT_SNODE(flat, node) != target->schema)) {
+        return 0;
+    }
+
+    if (target->schema->nodetype == LYS_LEAFLIST) {
+        return !strcmp(FLAT_STR(flat->image, node->value), ((struct lyd_node_leaf_list *)target)->value_str);
+    } else if (target->schema->nodetype == LYS_LIST) {
+        for (i = 0, key = FLAT_NODE(flat->image, node->child), tkey = target->child;
+                i < ((struct lys_node_list *)target->schema)->keys_size;
+                ++i, key = FLAT_NODE(flat->image, key->next), tkey = tkey->next) {
+            if (!key || strcmp(FLAT_STR(flat->image, key->value), ((struct lyd_node_leaf_list *)tkey)->value_str)) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Find an instance of a data node among image siblings.
+ *
+ * @param[in] flat Opened image.
+ * @param[in] parent Parent of the siblings, NULL for top-level siblings.
+ * @param[in] target Data node with its keys or value.
+ * @return Found image node, NULL if there is none.
+ */
+static const struct lyd_flat_node *
+lyd_flat_find_child(const struct lyd_flat *flat, const struct lyd_flat_node *parent, const struct lyd_node *target)
+{
+    const struct lyd_flat_hdr *hdr = (struct lyd_flat_hdr *)flat->image;
+    const struct lyd_flat_node *node;
+    const uint32_t *slots;
+    uint32_t hash, size, i;
+
+    hash = lyd_flat_node_hash(target);
+
+    i = parent ? parent->index : hdr->index;
+    if (i) {
+        slots = (const uint32_t *)(flat->image + i);
+        size = slots[0];
+        ++slots;
+        for (i = hash & (size - 1); slots[i]; i = (i + 1) & (size - 1)) {
+            node = FLAT_NODE(flat->image, slots[i]);
+            if (lyd_flat_node_equal(flat, node, target, hash)) {
+                return node;
+            }
+        }
+        return NULL;
+    }
+
+    for (node = FLAT_NODE(flat->image, parent ? parent->child : hdr->first); node;
+            node = FLAT_NODE(flat->image, node->next)) {
+        if (lyd_flat_node_equal(flat, node, target, hash)) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+API int
+lyd_flat_find_path_compiled(const struct lyd_flat *flat, const struct lyd_path *path, const char **keys,
+                            const char *value, const struct lyd_flat_node **match)
+{
+    FUN_IN;
+
+    struct lyd_node *node, *target;
+    struct lyd_node_leaf_list tmp;
+    const struct lys_node *snode;
+    uint32_t i;
+
+    if (!flat || !path || (path->ctx != flat->ctx) || (path->keys_count && !keys) || !match) {
+        LOGARG;
+        return -1;
+    }
+    snode = path->snodes[path->count - 1];
+    if ((snode->nodetype == LYS_LEAFLIST) && !value) {
+        LOGERR(path->ctx, LY_EINVAL, "Invalid arguments - no value for a leaf-list (%s()).", __func__);
+        return -1;
+    }
+
+    *match = NULL;
+    for (i = 0; i < path->count; ++i) {
+        snode = path->snodes[i];
+
+        /* the node with canonical keys or value to look for */
+        node = lyd_path_target(snode, keys, value, 0, &tmp, &target);
+        if ((snode->nodetype & (LYS_LIST | LYS_LEAFLIST)) && !node) {
+            return -1;
+        }
+        if (snode->nodetype == LYS_LIST) {
+            keys += ((struct lys_node_list *)snode)->keys_size;
+        }
+
+        *match = lyd_flat_find_child(flat, *match, target);
+        lyd_free(node);
+        if (!*match) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/* XML printer, mirrors printer_xml.c */
+
+#define INDENT ""
+#define LEVEL (level ? level*2-2 : 0)
+
+static void
+lyd_flat_xml_node(struct lyout *out, const struct lyd_flat *flat, int level, const struct lyd_flat_node *node)
+{
+    const struct lys_node *snode = FLAT_SNODE(flat, node);
+    const struct lyd_flat_node *parent = FLAT_NODE(flat->image, node->parent), *child;
+    const char *value;
+
+    if (!parent || (lys_node_module(snode) != lys_node_module(FLAT_SNODE(flat, parent)))) {
+        ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, snode->name, lys_node_module(snode)->ns);
+    } else {
+        ly_print(out, "%*s<%s", LEVEL, INDENT, snode->name);
+    }
+
+    if (snode->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
+        value = FLAT_STR(flat->image, node->value);
+        if (node->xml_value) {
+            if (node->xml_ns) {
+                ly_print(out, "%s", FLAT_STR(flat->image, node->xml_ns));
+            }
+            value = FLAT_STR(flat->image, node->xml_value);
+        } else if ((node->value_fmt == LYD_FLAT_VAL_IDENT) && strchr(value, ':')) {
+            /* identity of the node module */
+            value = strchr(value, ':') + 1;
+        }
+
+        if ((node->value_fmt == LYD_FLAT_VAL_EMPTY) || !value[0]) {
+            ly_print(out, "/>");
+        } else {
+            ly_print(out, ">");
+            lyxml_dump_text(out, value, LYXML_DATA_ELEM);
+            ly_print(out, "</%s>", snode->name);
+        }
+        if (level) {
+            ly_print(out, "\n");
+        }
+        return;
+    }
+
+    if (!(node->flags & LYD_FLAT_CHILDREN)) {
+        ly_print(out, "/>%s", level ? "\n" : "");
+        return;
+    }
+    ly_print(out, ">%s", level ? "\n" : "");
+
+    for (child = FLAT_NODE(flat->image, node->child); child; child = FLAT_NODE(flat->image, child->next)) {
+        lyd_flat_xml_node(out, flat, level ? level + 1 : 0, child);
+    }
+
+    ly_print(out, "%*s</%s>%s", LEVEL, INDENT, snode->name, level ? "\n" : "");
+}
+
+static void
+lyd_flat_xml_print(struct lyout *out, const struct lyd_flat *flat, int options)
+{
+    const struct lyd_flat_node *node;
+    int level = (options & LYP_FORMAT) ? 1 : 0;
+
+    node = FLAT_NODE(flat->image, ((struct lyd_flat_hdr *)flat->image)->first);
+    if (!node && ((out->type == LYOUT_MEMORY) || (out->type == LYOUT_CALLBACK))) {
+        ly_print(out, "");
+    }
+    for (; node; node = FLAT_NODE(flat->image, node->next)) {
+        lyd_flat_xml_node(out, flat, level, node);
+    }
+}
+
+#undef LEVEL
+
+/* JSON printer, mirrors printer_json.c */
+
+#define LEVEL (level*2)
+
+static void lyd_flat_json_nodes(struct lyout *out, const struct lyd_flat *flat, int level,
+                                const struct lyd_flat_node *first, int any);
+
+static void
+lyd_flat_json_name(struct lyout *out, const struct lyd_flat *flat, int level, const struct lyd_flat_node *node)
+{
+    const struct lys_node *snode = FLAT_SNODE(flat, node);
+    const struct lyd_flat_node *parent = FLAT_NODE(flat->image, node->parent);
+
+    if (!parent || (lys_node_module(snode) != lys_node_module(FLAT_SNODE(flat, parent)))) {
+        ly_print(out, "%*s\"%s:%s\":", LEVEL, INDENT, lys_node_module(snode)->name, snode->name);
+    } else {
+        ly_print(out, "%*s\"%s\":", LEVEL, INDENT, snode->name);
+    }
+}
+
+static void
+lyd_flat_json_value(struct lyout *out, const struct lyd_flat *flat, const struct lyd_flat_node *node)
+{
+    const char *value = FLAT_STR(flat->image, node->value), *p, *mod_name;
+
+    switch (node->value_fmt) {
+    case LYD_FLAT_VAL_STR:
+        json_print_string(out, value);
+        break;
+    case LYD_FLAT_VAL_NUM:
+        ly_print(out, "%s", value[0] ? value : "null");
+        break;
+    case LYD_FLAT_VAL_IDENT:
+        p = strchr(value, ':');
+        mod_name = FLAT_SNODE(flat, node)->module->name;
+        if (p && !strncmp(value, mod_name, p - value) && !mod_name[p - value]) {
+            /* do not print the prefix, it is the default prefix for this node */
+            json_print_string(out, p + 1);
+        } else {
+            json_print_string(out, value);
+        }
+        break;
+    default:
+        ly_print(out, "[null]");
+        break;
+    }
+}
+
+static void
+lyd_flat_json_list(struct lyout *out, const struct lyd_flat *flat, int level, const struct lyd_flat_node *node)
+{
+    const struct lyd_flat_node *list = node;
+    int is_list = (FLAT_SNODE(flat, node)->nodetype == LYS_LIST);
+
+    lyd_flat_json_name(out, flat, level, node);
+    if (is_list && !(node->flags & LYD_FLAT_CHILDREN)) {
+        /* empty, e.g. in case of filter */
+        ly_print(out, "%snull", (level ? " " : ""));
+        return;
+    }
+    ly_print(out, "%s[%s", (level ? " " : ""), (level ? "\n" : ""));
+
+    if (!is_list && level) {
+        ++level;
+    }
+
+    while (list) {
+        if (is_list) {
+            if (level) {
+                ++level;
+            }
+            ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
+            if (level) {
+                ++level;
+            }
+            lyd_flat_json_nodes(out, flat, level, FLAT_NODE(flat->image, list->child), list->flags & LYD_FLAT_CHILDREN);
+            if (level) {
+                --level;
+            }
+            ly_print(out, "%*s}", LEVEL, INDENT);
+            if (level) {
+                --level;
+            }
+        } else {
+            ly_print(out, "%*s", LEVEL, INDENT);
+            lyd_flat_json_value(out, flat, list);
+        }
+
+        for (list = FLAT_NODE(flat->image, list->next); list && (list->schema != node->schema);
+                list = FLAT_NODE(flat->image, list->next));
+        if (list) {
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+    }
+
+    if (!is_list && level) {
+        --level;
+    }
+
+    ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+}
+
+static void
+lyd_flat_json_nodes(struct lyout *out, const struct lyd_flat *flat, int level, const struct lyd_flat_node *first,
+                    int any)
+{
+    const struct lyd_flat_node *node, *iter;
+    int comma_flag = 0;
+
+    for (node = first; node; node = FLAT_NODE(flat->image, node->next)) {
+        switch (FLAT_SNODE(flat, node)->nodetype) {
+        case LYS_LEAF:
+            if (comma_flag) {
+                ly_print(out, ",%s", (level ? "\n" : ""));
+            }
+            lyd_flat_json_name(out, flat, level, node);
+            ly_print(out, "%s", (level ? " " : ""));
+            lyd_flat_json_value(out, flat, node);
+            break;
+        case LYS_LEAFLIST:
+        case LYS_LIST:
+            /* is it already printed? (the first node is not) */
+            for (iter = FLAT_NODE(flat->image, node->prev); iter->next && (node != first);
+                    iter = FLAT_NODE(flat->image, iter->prev)) {
+                if (iter->schema == node->schema) {
+                    break;
+                }
+            }
+            if (!iter->next || (node == first)) {
+                if (comma_flag) {
+                    ly_print(out, ",%s", (level ? "\n" : ""));
+                }
+                lyd_flat_json_list(out, flat, level, node);
+            }
+            break;
+        default:
+            if (comma_flag) {
+                ly_print(out, ",%s", (level ? "\n" : ""));
+            }
+            lyd_flat_json_name(out, flat, level, node);
+            ly_print(out, "%s{%s", (level ? " " : ""), (level ? "\n" : ""));
+            lyd_flat_json_nodes(out, flat, level ? level + 1 : 0, FLAT_NODE(flat->image, node->child),
+                                node->flags & LYD_FLAT_CHILDREN);
+            ly_print(out, "%*s}", LEVEL, INDENT);
+            break;
+        }
+        comma_flag = 1;
+    }
+
+    if (any && level) {
+        ly_print(out, "\n");
+    }
+}
+
+static void
+lyd_flat_json_print(struct lyout *out, const struct lyd_flat *flat, int options)
+{
+    const struct lyd_flat_hdr *hdr;
+    int level = (options & LYP_FORMAT) ? 1 : 0;
+
+    ly_print(out, "{%s", (level ? "\n" : ""));
+    hdr = (struct lyd_flat_hdr *)flat->image;
+    lyd_flat_json_nodes(out, flat, level, FLAT_NODE(flat->image, hdr->first), hdr->flags & LYD_FLAT_CHILDREN);
+    ly_print(out, "}%s", (level ? "\n" : ""));
+}
+
+#undef LEVEL
+#undef INDENT
+
+static int
+lyd_flat_print_(struct lyout *out, const struct lyd_flat *flat, LYD_FORMAT format, int options)
+{
+    LY_PRINT_SET;
+
+    switch (format) {
+    case LYD_XML:
+        lyd_flat_xml_print(out, flat, options);
+        break;
+    case LYD_JSON:
+        lyd_flat_json_print(out, flat, options);
+        break;
+    default:
+        LOGERR(flat->ctx, LY_EINVAL, "Unsupported output format of a flat data tree.");
+        return EXIT_FAILURE;
+    }
+    ly_print_flush(out);
+
+    LY_PRINT_RET(flat->ctx);
+}
+
+API int
+lyd_flat_print_mem(char **strp, const struct lyd_flat *flat, LYD_FORMAT format, int options)
+{
+    FUN_IN;
+
+    struct lyout out;
+    int r;
+
+    if (!strp || !flat) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&out, 0, sizeof out);
+    out.type = LYOUT_MEMORY;
+
+    r = lyd_flat_print_(&out, flat, format, options);
+
+    *strp = out.method.mem.buf;
+    free(out.buffered);
+    return r;
+}
+
+API int
+lyd_flat_print_fd(int fd, const struct lyd_flat *flat, LYD_FORMAT format, int options)
+{
+    FUN_IN;
+
+    struct lyout out;
+    int r;
+
+    if ((fd < 0) || !flat) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&out, 0, sizeof out);
+    out.type = LYOUT_FD;
+    out.method.fd = fd;
+
+    r = lyd_flat_print_(&out, flat, format, options);
+
+    free(out.buffered);
+    return r;
+}
@@ -16,7 +16,9 @@
 #ifndef LY_TREE_INTERNAL_H_
 #define LY_TREE_INTERNAL_H_
 
+#include <stdarg.h>
 #include <stdint.h>
+#include <pthread.h>
 
 #include "libyang.h"
 #include "tree_schema.h"
@@ -64,6 +66,144 @@ struct lyd_node_pos {
     uint32_t pos;
 };
 
+/**
+ * @brief Compiled data path, see lyd_path_compile().
+ */
+struct lyd_path {
+    const struct ly_ctx *ctx;
+    const struct lys_node **snodes; /**< resolved schema nodes of all the path steps */
+    uint32_t count;                 /**< number of path steps */
+    uint32_t keys_count;            /**< number of key values of all the lists in the path */
+    int options;                    /**< data path options used for the compilation */
+};
+
+/**
+ * @brief Data subtree builder, see lyd_builder_new().
+ */
+struct lyd_builder {
+    struct lyd_node *parent;        /**< parent of the built subtrees, NULL for top-level ones */
+    struct lyd_node *first;         /**< first built child of the parent */
+};
+
+/**
+ * @brief Data tree snapshot, see lyd_snapshot_new().
+ */
+struct lyd_snapshot {
+    struct lyd_node *tree;          /**< read-only copy of the data tree */
+    uint32_t refcount;              /**< number of references */
+    pthread_mutex_t lock;           /**< protects the reference count */
+};
+
+/**
+ * @brief Data tree snapshot publication point, see lyd_snapshot_head_new().
+ */
+struct lyd_snapshot_head {
+    struct lyd_snapshot *current;   /**< published snapshot, its reference is held */
+    pthread_mutex_t lock;           /**< protects the current snapshot */
+};
+
+/**
+ * @brief Magic bytes of flat data tree images.
+ */
+#define LYD_FLAT_MAGIC "LYDF"
+
+/**
+ * @brief Version of the flat data tree image layout, incremented on every incompatible change.
+ */
+#define LYD_FLAT_VERSION 1
+
+/**
+ * @brief Byte order mark of flat data tree images, read back as a different value on a host of another byte order.
+ */
+#define LYD_FLAT_BYTE_ORDER 0x0102
+
+/**
+ * @brief Alignment of all the records of flat data tree images.
+ */
+#define LYD_FLAT_ALIGN 4
+
+/**
+ * @brief Minimal number of siblings in a flat data tree image to get a hash index, also its minimal size.
+ */
+#define LYD_FLAT_INDEX_MIN 8
+
+/**
+ * @brief Header of a flat data tree image, see lyd_flat_write_mem(). All the offsets are relative to the
+ * beginning of the image and 0 means none.
+ */
+struct lyd_flat_hdr {
+    char magic[4];                  /**< #LYD_FLAT_MAGIC */
+    uint16_t version;               /**< #LYD_FLAT_VERSION */
+    uint16_t byte_order;            /**< #LYD_FLAT_BYTE_ORDER */
+    uint32_t size;                  /**< size of the whole image */
+    uint32_t mods;                  /**< offset of the module table (struct lyd_flat_mod) */
+    uint32_t mod_count;             /**< number of modules */
+    uint32_t snodes;                /**< offset of the schema node table (struct lyd_flat_snode) */
+    uint32_t snode_count;           /**< number of schema nodes */
+    uint32_t first;                 /**< offset of the first top-level node */
+    uint32_t index;                 /**< offset of the hash index of the top-level nodes */
+    uint32_t flags;                 /**< LYD_FLAT_CHILDREN if the data tree was not empty */
+};
+
+/**
+ * @brief Module used by a flat data tree image.
+ */
+struct lyd_flat_mod {
+    uint32_t name;                  /**< offset of the module name */
+    uint32_t revision;              /**< offset of the module revision, 0 if there is none */
+};
+
+/**
+ * @brief Schema node used by a flat data tree image.
+ */
+struct lyd_flat_snode {
+    uint32_t path;                  /**< offset of the schema path (lys_path()), resolved in the reading context */
+};
+
+/**
+ * @brief Value formats of flat data tree nodes, decide how they are printed.
+ */
+#define LYD_FLAT_VAL_STR 0          /**< string */
+#define LYD_FLAT_VAL_NUM 1          /**< number or boolean, not quoted in JSON */
+#define LYD_FLAT_VAL_IDENT 2        /**< identity, printed without the prefix of the node module */
+#define LYD_FLAT_VAL_EMPTY 3        /**< empty type, no value */
+
+/**
+ * @brief Flags of flat data tree nodes.
+ */
+#define LYD_FLAT_DFLT 0x01          /**< default node */
+#define LYD_FLAT_CHILDREN 0x02      /**< the node had children in the data tree, even if none were written */
+
+/**
+ * @brief Node of a flat data tree image. The siblings are linked as in struct lyd_node - prev of the first
+ * sibling is the last one and next of the last sibling is 0.
+ */
+struct lyd_flat_node {
+    uint32_t schema;                /**< index of the schema node */
+    uint32_t hash;                  /**< hash of the module name, node name, and keys or value */
+    uint32_t parent;                /**< offset of the parent */
+    uint32_t next;                  /**< offset of the next sibling */
+    uint32_t prev;                  /**< offset of the previous sibling */
+    uint32_t child;                 /**< offset of the first child */
+    uint32_t index;                 /**< offset of the hash index of the children, 0 for only a few of them */
+    uint32_t value;                 /**< offset of the canonical value of a leaf or a leaf-list */
+    uint32_t xml_value;             /**< offset of the value with XML prefixes, if it differs */
+    uint32_t xml_ns;                /**< offset of the XML namespace declarations of xml_value */
+    uint8_t value_fmt;              /**< value format (LYD_FLAT_VAL_*) */
+    uint8_t flags;                  /**< node flags (LYD_FLAT_DFLT, LYD_FLAT_CHILDREN) */
+    uint16_t padding;
+};
+
+/**
+ * @brief Opened flat data tree image, see lyd_flat_open().
+ */
+struct lyd_flat {
+    struct ly_ctx *ctx;
+    const char *image;              /**< the image, not owned */
+    const struct lys_node **snodes; /**< schema nodes resolved in the context */
+    uint32_t snode_count;
+};
+
 /**
  * @brief Internal structure for LYB parser/printer.
  */
@@ -193,6 +333,28 @@ struct lys_submodule *lys_sub_parse_mem(struct lys_module *module, const char *d
  */
 struct lys_submodule *lys_sub_parse_fd(struct lys_module *module, int fd, LYS_INFORMAT format, struct unres_schema *unres);
 
+/**
+ * @brief State of searching for the file of a (sub)module, see lys_search_localfile().
+ */
+struct lys_search_match {
+    const char *name;           /**< name of the (sub)module */
+    size_t len;                 /**< length of name */
+    const char *revision;       /**< revision of the (sub)module, NULL for the newest one */
+    char *match_name;           /**< path of the best matching file found so far */
+    size_t match_len;           /**< length of match_name up to the end of the (sub)module name */
+    LYS_INFORMAT match_format;  /**< format of the best matching file */
+};
+
+/**
+ * @brief Check a file found when searching for the file of a (sub)module, in the way lys_search_localfile() does.
+ *
+ * @param[in,out] match Searching state, updated if the file matches better than the previous files.
+ * @param[in,out] path Path of a regular file, it is taken over (and set to NULL) if it is the best match.
+ * @param[in] dir_len Length of the directory part of \p path.
+ * @return 1 if the file is the exact revision and the searching can stop, 0 otherwise.
+ */
+int lys_search_match_file(struct lys_search_match *match, char **path, size_t dir_len);
+
 /**
  * @brief Free the submodule structure
  *
@@ -222,6 +384,58 @@ void lys_submodule_free(struct lys_submodule *submodule, void (*private_destruct
  */
 int lys_node_addchild(struct lys_node *parent, struct lys_module *module, struct lys_node *child, int options);
 
+/**
+ * @brief Get the subtree summary flags (#LYS_DFLT_DESC and #LYS_MAND_DESC) a schema node contributes to its parent,
+ * that is its own properties combined with the summary of its subtree.
+ *
+ * @param[in] node Schema node to examine.
+ * @return Summary flags of \p node.
+ */
+uint16_t lys_subtree_flags(const struct lys_node *node);
+
+/**
+ * @brief Recompute the subtree summary flags of all the inner nodes in the subtree of \p node (including it).
+ *
+ * @param[in] node Root of the schema subtree.
+ */
+void lys_summary_subtree(struct lys_node *node);
+
+/**
+ * @brief Update the subtree summary flags of \p node and its parents after \p node or its children changed.
+ *
+ * @param[in] node Changed schema node.
+ */
+void lys_summary_update(struct lys_node *node);
+
+/**
+ * @brief Compute the subtree summary flags of a complete module, the targets of its augments and
+ * the modules it deviates.
+ *
+ * @param[in] module Module to summarize.
+ */
+void lys_summary_module(struct lys_module *module);
+
+/**
+ * @brief Assign schema-order ordinals (lys_node::order) to the data siblings of a schema node.
+ *
+ * @param[in] node Schema node whose siblings were added or moved.
+ */
+void lys_order_update(const struct lys_node *node);
+
+/**
+ * @brief Assign schema-order ordinals to the nodes of an applied augment and their new siblings.
+ *
+ * @param[in] aug Applied augment.
+ */
+void lys_order_augment(const struct lys_node_augment *aug);
+
+/**
+ * @brief Assign schema-order ordinals to the modules of a context and to all the data nodes of a new module.
+ *
+ * @param[in] module Module just added into its context.
+ */
+void lys_order_module(struct lys_module *module);
+
 /**
  * @brief Find a valid grouping definition relative to a node.
  *
@@ -509,6 +723,52 @@ int lys_make_implemented_r(struct lys_module *module, struct unres_schema *unres
 int lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
                              int options);
 
+/**
+ * @brief Get and check the variable arguments of the data parser functions.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] options Standard @ref parseroptions.
+ * @param[in] ap Variable arguments as described for lyd_parse_mem().
+ * @param[out] rpc_act RPC/action request for #LYD_OPT_RPCREPLY.
+ * @param[out] data_tree Additional data tree for #LYD_OPT_RPC, #LYD_OPT_RPCREPLY, and #LYD_OPT_NOTIF.
+ * @param[out] yang_data_name Name of the yang-data template for #LYD_OPT_DATA_TEMPLATE.
+ * @param[out] filter Schema nodes of the subtrees to parse for #LYD_OPT_FILTER.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyd_parse_data_args(struct ly_ctx *ctx, int options, va_list ap, const struct lyd_node **rpc_act,
+                        const struct lyd_node **data_tree, const char **yang_data_name, const struct ly_set **filter);
+
+/**
+ * @brief Decide whether a data subtree is skipped by #LYD_OPT_FILTER. Its parent is expected not to be skipped.
+ *
+ * @param[in] filter Schema nodes of the subtrees to parse.
+ * @param[in] schema Schema node of the subtree root.
+ * @return 0 if the subtree is parsed, 1 if it is skipped.
+ */
+int lyd_filter_skip(const struct ly_set *filter, const struct lys_node *schema);
+
+/**
+ * @brief Finish the parsed data tree - check #ly_errno and sort the nodes if required.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] result Parsed data tree, freed on error.
+ * @param[in] format Format of the parsed data.
+ * @param[in] options Standard @ref parseroptions.
+ * @return Final data tree, NULL on error.
+ */
+struct lyd_node *lyd_parse_data_end(struct ly_ctx *ctx, struct lyd_node *result, LYD_FORMAT format, int options);
+
+/**
+ * @brief Append top-level nodes parsed separately (see #LYD_OPT_PARALLEL) to the already parsed ones and check
+ * the number of instances and the choices they instantiate against the previous nodes.
+ *
+ * @param[in,out] result First of the already parsed top-level nodes, set if there were none.
+ * @param[in] first First of the top-level nodes to append, the nodes are part of \p result even on error.
+ * @param[in] options Standard @ref parseroptions.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyd_parse_append(struct lyd_node **result, struct lyd_node *first, int options);
+
 /**
  * @brief Check if the provided node is inside a grouping.
  *
@@ -543,6 +803,50 @@ int lyd_defaults_add_unres(struct lyd_node **root, int options, struct ly_ctx *c
                            int mod_count, const struct lyd_node *data_tree, struct lyd_node *act_notif,
                            struct unres_data *unres, int wd);
 
+/**
+ * @brief Instantiate the implicit default leaf children of a node deferred by #LYD_OPT_LAZY_DFLT.
+ *
+ * @param[in] node Data node with lyd_node::lazy_dflt set.
+ * @param[in] name Dictionary name of the only child to instantiate, NULL to instantiate all of them and clear the flag.
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+int lyd_wd_materialize_node(struct lyd_node *node, const char *name);
+
+/**
+ * @brief Compare two schema nodes of data siblings in the schema order (module order first).
+ *
+ * @param[in] schema1 First schema node.
+ * @param[in] schema2 Second schema node.
+ * @return Negative, 0, or positive as in qsort() callbacks.
+ */
+int lyd_schema_order_cmp(const struct lys_node *schema1, const struct lys_node *schema2);
+
+/**
+ * @brief Find the position of a new node among its siblings to keep the schema order (#LY_CTX_SCHEMA_ORDER).
+ *
+ * @param[in] last Last sibling, NULL if there are none.
+ * @param[in] schema Schema node of the new node.
+ * @return Sibling to insert the new node before, NULL to append it.
+ */
+struct lyd_node *lyd_schema_order_next(struct lyd_node *last, const struct lys_node *schema);
+
+/**
+ * @brief Create a node to look for an instance of a compiled path step.
+ *
+ * Containers, leaves, and anydata are matched only by their schema node so \p tmp is used for them
+ * and nothing is allocated. Lists and leaf-lists are created with their keys or value.
+ *
+ * @param[in] snode Schema node of the path step.
+ * @param[in] keys Key values of the list, if \p snode is a list.
+ * @param[in] value Value of the leaf-list, if \p snode is a leaf-list.
+ * @param[in] dflt Whether the created list or leaf-list is a default node.
+ * @param[in] tmp Memory for the node of other schema nodes.
+ * @param[out] target Node to search for.
+ * @return Created node that must be freed or linked into a tree, NULL if \p tmp was used or on error.
+ */
+struct lyd_node *lyd_path_target(const struct lys_node *snode, const char **keys, const char *value, int dflt,
+                                 struct lyd_node_leaf_list *tmp, struct lyd_node **target);
+
 void lys_enable_deviations(struct lys_module *module);
 
 void lys_disable_deviations(struct lys_module *module);
@@ -426,6 +426,11 @@ lys_node_unlink(struct lys_node *node)
         return;
     }
 
+    if (ly_err_lazy_count && node->module) {
+        /* the node is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(node->module->ctx);
+    }
+
     /* unlink from data model if necessary */
     if (node->module) {
         /* get main module with data tree */
@@ -1053,6 +1058,331 @@ skip_nodetype_check:
     return EXIT_SUCCESS;
 }
 
+#define LYS_SUMMARY_NODES (LYS_CONTAINER | LYS_LIST | LYS_CHOICE | LYS_CASE | LYS_USES | LYS_INPUT | LYS_OUTPUT \
+                           | LYS_NOTIF | LYS_RPC | LYS_ACTION)
+
+/**
+ * @brief Learn whether a type (or any of the typedefs it is derived from) has a default value.
+ */
+static int
+lys_type_has_dflt(const struct lys_type *type)
+{
+    const struct lys_tpdf *tpdf;
+
+    for (tpdf = type->der; tpdf; tpdf = tpdf->type.der) {
+        if (tpdf->dflt) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint16_t
+lys_subtree_flags(const struct lys_node *node)
+{
+    const struct lys_node_leaf *leaf;
+    const struct lys_node_leaflist *llist;
+    uint16_t flags = 0;
+
+    switch (node->nodetype) {
+    case LYS_LEAF:
+        leaf = (const struct lys_node_leaf *)node;
+        if (node->flags & LYS_MAND_TRUE) {
+            flags |= LYS_MAND_DESC;
+        } else if (leaf->dflt || lys_type_has_dflt(&leaf->type)) {
+            flags |= LYS_DFLT_DESC;
+        }
+        break;
+    case LYS_LEAFLIST:
+        llist = (const struct lys_node_leaflist *)node;
+        if (llist->min || llist->max) {
+            flags |= LYS_MAND_DESC;
+        }
+        if ((llist->module->version >= LYS_VERSION_1_1)
+                && (llist->dflt_size || (!llist->min && lys_type_has_dflt(&llist->type)))) {
+            flags |= LYS_DFLT_DESC;
+        }
+        break;
+    case LYS_ANYXML:
+    case LYS_ANYDATA:
+        if (node->flags & LYS_MAND_TRUE) {
+            flags |= LYS_MAND_DESC;
+        }
+        break;
+    case LYS_CONTAINER:
+        if (!((struct lys_node_container *)node)->presence) {
+            /* non-presence containers are always created */
+            flags |= LYS_DFLT_DESC;
+        }
+        flags |= node->flags & (LYS_DFLT_DESC | LYS_MAND_DESC);
+        break;
+    case LYS_LIST:
+        if (((struct lys_node_list *)node)->min || ((struct lys_node_list *)node)->max) {
+            flags |= LYS_MAND_DESC;
+        }
+        flags |= node->flags & (LYS_DFLT_DESC | LYS_MAND_DESC);
+        break;
+    case LYS_CHOICE:
+        if (node->flags & LYS_MAND_TRUE) {
+            flags |= LYS_MAND_DESC;
+        }
+        flags |= node->flags & (LYS_DFLT_DESC | LYS_MAND_DESC);
+        break;
+    default:
+        if (node->nodetype & LYS_SUMMARY_NODES) {
+            flags |= node->flags & (LYS_DFLT_DESC | LYS_MAND_DESC);
+        }
+        break;
+    }
+
+    if (!(flags & LYS_MAND_DESC) && (node->nodetype & (LYS_CONTAINER | LYS_CHOICE | LYS_LEAF | LYS_LEAFLIST | LYS_LIST
+            | LYS_ANYDATA | LYS_CASE | LYS_USES)) && resolve_applies_when(node, 0, NULL)) {
+        /* mandatory checks evaluate when conditions of the missing nodes */
+        flags |= LYS_MAND_DESC;
+    }
+
+    return flags;
+}
+
+/**
+ * @brief Set the subtree summary flags of an inner node from its (already summarized) children.
+ *
+ * @param[in] node Node to update.
+ * @return Whether the flags of \p node were changed.
+ */
+static int
+lys_summary_set(struct lys_node *node)
+{
+    struct lys_node *child;
+    uint16_t flags = 0;
+
+    if (!(node->nodetype & LYS_SUMMARY_NODES)) {
+        return 0;
+    }
+
+    LY_TREE_FOR(node->child, child) {
+        if (child->nodetype != LYS_GROUPING) {
+            flags |= lys_subtree_flags(child);
+        }
+    }
+
+    if ((node->flags & (LYS_DFLT_DESC | LYS_MAND_DESC)) == flags) {
+        return 0;
+    }
+    node->flags = (node->flags & ~(LYS_DFLT_DESC | LYS_MAND_DESC)) | flags;
+    return 1;
+}
+
+void
+lys_summary_subtree(struct lys_node *node)
+{
+    struct lys_node *child;
+
+    if (!(node->nodetype & LYS_SUMMARY_NODES)) {
+        return;
+    }
+
+    LY_TREE_FOR(node->child, child) {
+        lys_summary_subtree(child);
+    }
+    lys_summary_set(node);
+}
+
+void
+lys_summary_update(struct lys_node *node)
+{
+    struct lys_node *parent;
+
+    lys_summary_set(node);
+
+    /* the parent always needs updating since the properties of the node itself may have changed */
+    for (parent = lys_parent(node); parent && (parent->nodetype & LYS_SUMMARY_NODES); parent = lys_parent(parent)) {
+        if (!lys_summary_set(parent) && (parent != lys_parent(node))) {
+            /* nothing changed, the rest of the parents are up-to-date */
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Learn whether a module was completely parsed and added into its context, its nodes
+ * cannot be summarized before that.
+ */
+static int
+lys_summary_ready(const struct lys_module *module)
+{
+    int i;
+
+    for (i = module->ctx->models.used - 1; i >= 0; --i) {
+        if (module->ctx->models.list[i] == module) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void
+lys_summary_module(struct lys_module *module)
+{
+    struct lys_node *node;
+    struct lys_node_augment *aug;
+    struct lys_deviation *dev;
+    struct lys_module *target_mod;
+    uint8_t u, v;
+
+    LY_TREE_FOR(module->data, node) {
+        lys_summary_subtree(node);
+    }
+
+    /* applied augments of the module and its submodules */
+    for (v = 0; v <= module->inc_size; ++v) {
+        for (u = 0; u < (v ? module->inc[v - 1].submodule->augment_size : module->augment_size); ++u) {
+            aug = v ? &module->inc[v - 1].submodule->augment[u] : &module->augment[u];
+            if ((aug->flags & LYS_NOTAPPLIED) || !aug->target || !aug->child) {
+                continue;
+            }
+            for (node = aug->child; node && (node->parent == (struct lys_node *)aug); node = node->next) {
+                lys_summary_subtree(node);
+            }
+            lys_summary_update(aug->target);
+        }
+
+        /* deviations can change any node of the target module */
+        for (u = 0; u < (v ? module->inc[v - 1].submodule->deviation_size : module->deviation_size); ++u) {
+            dev = v ? &module->inc[v - 1].submodule->deviation[u] : &module->deviation[u];
+            if (!dev->orig_node) {
+                continue;
+            }
+            target_mod = lys_node_module(dev->orig_node);
+            if (target_mod != module) {
+                LY_TREE_FOR(target_mod->data, node) {
+                    lys_summary_subtree(node);
+                }
+            }
+        }
+    }
+}
+
+/* schema nodes whose data instances have children */
+#define LYS_ORDER_NODES (LYS_CONTAINER | LYS_LIST | LYS_NOTIF | LYS_RPC | LYS_ACTION)
+
+/**
+ * @brief Get the schema node whose data children are ordered together with the data children of a node.
+ *
+ * @param[in] node Schema node, NULL for top-level.
+ * @return Schema node of the data parent, NULL for top-level data.
+ */
+static const struct lys_node *
+lys_order_scope(const struct lys_node *node)
+{
+    for (; node && !(node->nodetype & LYS_ORDER_NODES); node = lys_parent(node));
+    return node;
+}
+
+/**
+ * @brief Assign ordinals to the data children of a schema node in the order lyd_schema_sort() keeps them.
+ *
+ * @param[in] parent Schema node of the data parent, NULL for top-level data.
+ * @param[in] module Main module of the top-level data.
+ */
+static void
+lys_order_set(const struct lys_node *parent, const struct lys_module *module)
+{
+    const struct lys_node *next = NULL;
+    const struct lys_node_list *list;
+    uint32_t order = 0;
+    uint8_t i;
+
+    if (parent && (parent->nodetype == LYS_LIST)) {
+        /* keys are always the first children of a list instance */
+        list = (const struct lys_node_list *)parent;
+        for (i = 0; list->keys && (i < list->keys_size); ++i) {
+            list->keys[i]->order = ++order;
+        }
+    }
+
+    while ((next = lys_getnext(next, parent, module, LYS_GETNEXT_NOSTATECHECK))) {
+        if (order && (next->nodetype == LYS_LEAF) && lys_is_key((struct lys_node_leaf *)next, NULL)) {
+            continue;
+        }
+        ((struct lys_node *)next)->order = ++order;
+    }
+}
+
+/**
+ * @brief Assign ordinals to the data children of all the data descendants of a schema node.
+ *
+ * @param[in] parent Schema node, NULL for top-level data.
+ * @param[in] module Main module of the top-level data.
+ */
+static void
+lys_order_descend(const struct lys_node *parent, const struct lys_module *module)
+{
+    const struct lys_node *next = NULL;
+
+    while ((next = lys_getnext(next, parent, module, LYS_GETNEXT_NOSTATECHECK | LYS_GETNEXT_PARENTUSES))) {
+        if (next->nodetype & LYS_ORDER_NODES) {
+            lys_order_set(next, NULL);
+            lys_order_descend(next, NULL);
+        }
+    }
+}
+
+void
+lys_order_update(const struct lys_node *node)
+{
+    const struct lys_node *scope;
+
+    scope = lys_order_scope(lys_parent(node));
+    lys_order_set(scope, scope ? NULL : lys_node_module(node));
+}
+
+void
+lys_order_augment(const struct lys_node_augment *aug)
+{
+    const struct lys_node *child;
+
+    lys_order_update(aug->child);
+
+    /* the augmenting subtrees are new */
+    for (child = aug->child; child && (child->parent == (struct lys_node *)aug); child = child->next) {
+        if (child->nodetype & LYS_ORDER_NODES) {
+            lys_order_set(child, NULL);
+            lys_order_descend(child, NULL);
+        } else if (child->nodetype & (LYS_CHOICE | LYS_CASE | LYS_USES)) {
+            lys_order_descend(child, NULL);
+        }
+    }
+}
+
+void
+lys_order_module(struct lys_module *module)
+{
+    struct lys_node_augment *aug;
+    struct ly_ctx *ctx = module->ctx;
+    uint8_t u, v;
+    int i;
+
+    /* module ordinals follow the context list, they must fit */
+    for (i = 0; i < ctx->models.used; ++i) {
+        ctx->models.list[i]->order = (i < UINT16_MAX) ? i + 1 : 0;
+    }
+
+    lys_order_set(NULL, module);
+    lys_order_descend(NULL, module);
+
+    /* applied augments of the module and its submodules */
+    for (v = 0; v <= module->inc_size; ++v) {
+        for (u = 0; u < (v ? module->inc[v - 1].submodule->augment_size : module->augment_size); ++u) {
+            aug = v ? &module->inc[v - 1].submodule->augment[u] : &module->augment[u];
+            if ((aug->flags & LYS_NOTAPPLIED) || !aug->target || !aug->child) {
+                continue;
+            }
+            lys_order_augment(aug);
+        }
+    }
+}
+
 const struct lys_module *
 lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const char *revision, int internal, int implement)
 {
@@ -1064,6 +1394,9 @@ lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const
         LOGARG;
         return NULL;
     }
+    if (ly_ctx_check_frozen(ctx)) {
+        return NULL;
+    }
 
     if (!internal && format == LYS_IN_YANG) {
         /* enlarge data by 2 bytes for flex */
@@ -1321,18 +1654,77 @@ lys_sub_parse_fd(struct lys_module *module, int fd, LYS_INFORMAT format, struct
 
 }
 
+int
+lys_search_match_file(struct lys_search_match *match, char **path, size_t dir_len)
+{
+    const char *filename = *path + dir_len + 1;
+    size_t flen;
+    LYS_INFORMAT format;
+
+    if (strncmp(match->name, filename, match->len) || (filename[match->len] != '.' && filename[match->len] != '@')) {
+        /* different filename than the module we search for */
+        return 0;
+    }
+
+    /* get type according to filename suffix */
+    flen = strlen(filename);
+    if ((flen > 4) && !strcmp(&filename[flen - 4], ".yin")) {
+        format = LYS_IN_YIN;
+    } else if ((flen > 5) && !strcmp(&filename[flen - 5], ".yang")) {
+        format = LYS_IN_YANG;
+    } else {
+        /* not supported suffix/file format */
+        return 0;
+    }
+
+    if (match->revision) {
+        /* we look for the specific revision, try to get it from the filename */
+        if (filename[match->len] == '@') {
+            /* check revision from the filename */
+            if (strncmp(match->revision, &filename[match->len + 1], strlen(match->revision))) {
+                /* another revision */
+                return 0;
+            }
+
+            /* exact revision */
+            free(match->match_name);
+            match->match_name = *path;
+            *path = NULL;
+            match->match_len = dir_len + 1 + match->len;
+            match->match_format = format;
+            return 1;
+        }
+
+        /* continue trying to find exact revision match, use this only if not found */
+    } else if (match->match_name) {
+        /* remember the revision and try to find the newest one */
+        if (filename[match->len] != '@' || lyp_check_date(NULL, &filename[match->len + 1])) {
+            return 0;
+        } else if (match->match_name[match->match_len] == '@' &&
+                (strncmp(&match->match_name[match->match_len + 1], &filename[match->len + 1], LY_REV_SIZE - 1) >= 0)) {
+            return 0;
+        }
+    }
+
+    free(match->match_name);
+    match->match_name = *path;
+    *path = NULL;
+    match->match_len = dir_len + 1 + match->len;
+    match->match_format = format;
+    return 0;
+}
+
 API int
 lys_search_localfile(const char * const *searchpaths, int cwd, const char *name, const char *revision, char **localfile, LYS_INFORMAT *format)
 {
     FUN_IN;
 
-    size_t len, flen, match_len = 0, dir_len;
+    size_t dir_len;
     int i, implicit_cwd = 0, ret = EXIT_FAILURE;
     char *wd, *wn = NULL;
     DIR *dir = NULL;
     struct dirent *file;
-    char *match_name = NULL;
-    LYS_INFORMAT format_aux, match_format = 0;
+    struct lys_search_match match = {name, 0, revision, NULL, 0, 0};
     unsigned int u;
     struct ly_set *dirs;
     struct stat st;
@@ -1350,7 +1742,7 @@ lys_search_localfile(const char * const *searchpaths, int cwd, const char *name,
         return EXIT_FAILURE;
     }
 
-    len = strlen(name);
+    match.len = strlen(name);
     if (cwd) {
         wd = get_current_dir_name();
         if (!wd) {
@@ -1431,75 +1823,18 @@ lys_search_localfile(const char * const *searchpaths, int cwd, const char *name,
                 }
 
                 /* here we know that the item is a file which can contain a module */
-                if (strncmp(name, file->d_name, len) ||
-                        (file->d_name[len] != '.' && file->d_name[len] != '@')) {
-                    /* different filename than the module we search for */
-                    continue;
-                }
-
-                /* get type according to filename suffix */
-                flen = strlen(file->d_name);
-                if (!strcmp(&file->d_name[flen - 4], ".yin")) {
-                    format_aux = LYS_IN_YIN;
-                } else if (!strcmp(&file->d_name[flen - 5], ".yang")) {
-                    format_aux = LYS_IN_YANG;
-                } else {
-                    /* not supportde suffix/file format */
-                    continue;
-                }
-
-                if (revision) {
-                    /* we look for the specific revision, try to get it from the filename */
-                    if (file->d_name[len] == '@') {
-                        /* check revision from the filename */
-                        if (strncmp(revision, &file->d_name[len + 1], strlen(revision))) {
-                            /* another revision */
-                            continue;
-                        } else {
-                            /* exact revision */
-                            free(match_name);
-                            match_name = wn;
-                            wn = NULL;
-                            match_len = dir_len + 1 + len;
-                            match_format = format_aux;
-                            goto success;
-                        }
-                    } else {
-                        /* continue trying to find exact revision match, use this only if not found */
-                        free(match_name);
-                        match_name = wn;
-                        wn = NULL;
-                        match_len = dir_len + 1 +len;
-                        match_format = format_aux;
-                        continue;
-                    }
-                } else {
-                    /* remember the revision and try to find the newest one */
-                    if (match_name) {
-                        if (file->d_name[len] != '@' || lyp_check_date(NULL, &file->d_name[len + 1])) {
-                            continue;
-                        } else if (match_name[match_len] == '@' &&
-                                (strncmp(&match_name[match_len + 1], &file->d_name[len + 1], LY_REV_SIZE - 1) >= 0)) {
-                            continue;
-                        }
-                        free(match_name);
-                    }
-
-                    match_name = wn;
-                    wn = NULL;
-                    match_len = dir_len + 1 + len;
-                    match_format = format_aux;
-                    continue;
+                if (lys_search_match_file(&match, &wn, dir_len)) {
+                    goto success;
                 }
             }
         }
     }
 
 success:
-    (*localfile) = match_name;
-    match_name = NULL;
+    (*localfile) = match.match_name;
+    match.match_name = NULL;
     if (format) {
-        (*format) = match_format;
+        (*format) = match.match_format;
     }
     ret = EXIT_SUCCESS;
 
@@ -1509,7 +1844,7 @@ cleanup:
     if (dir) {
         closedir(dir);
     }
-    free(match_name);
+    free(match.match_name);
     for (u = 0; u < dirs->number; u++) {
         free(dirs->set.g[u]);
     }
@@ -2485,6 +2820,7 @@ lys_ident_free(struct ly_ctx *ctx, struct lys_ident *ident,
 
     free(ident->base);
     ly_set_free(ident->der);
+    resolve_identity_index_remove(ctx, ident);
     lydict_remove(ctx, ident->name);
     lydict_remove(ctx, ident->dsc);
     lydict_remove(ctx, ident->ref);
@@ -2808,6 +3144,11 @@ lys_node_free(struct lys_node *node, void (*private_destructor)(const struct lys
 
     ctx = node->module->ctx;
 
+    if (ly_err_lazy_count) {
+        /* the node is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(ctx);
+    }
+
     /* remove private object */
     if (node->priv && private_destructor) {
         private_destructor(node, node->priv);
@@ -3822,8 +4163,13 @@ lys_free(struct lys_module *module, void (*private_destructor)(const struct lys_
         return;
     }
 
-    /* remove schema from the context */
     ctx = module->ctx;
+    if (ly_err_lazy_count) {
+        /* the module is going to be freed, generate paths of stored errors that may reference its nodes */
+        ly_err_build_lazy_paths(ctx);
+    }
+
+    /* remove schema from the context */
     if (remove_from_ctx && ctx->models.used) {
         for (i = 0; i < ctx->models.used; i++) {
             if (ctx->models.list[i] == module) {
@@ -3896,6 +4242,9 @@ lys_features_change(const struct lys_module *module, const char *name, int op, i
         LOGARG;
         return EXIT_FAILURE;
     }
+    if (ly_ctx_check_frozen(module->ctx)) {
+        return EXIT_FAILURE;
+    }
 
     if (!strcmp(name, "*")) {
         /* enable all */
@@ -4534,6 +4883,15 @@ apply_aug(struct lys_node_augment *augment, struct unres_schema *unres)
         augment->target->child = augment->child;
     }
 
+    /* update the subtree summaries up from the target, a module being parsed is summarized once complete */
+    if (lys_summary_ready(lys_node_module((struct lys_node *)augment))) {
+        for (child = augment->child; child && (child->parent == (struct lys_node *)augment); child = child->next) {
+            lys_summary_subtree(child);
+        }
+        lys_summary_update(augment->target);
+        lys_order_augment(augment);
+    }
+
 success:
     /* remove the flag about not applicability */
     augment->flags &= ~LYS_NOTAPPLIED;
@@ -4653,6 +5011,13 @@ lys_switch_deviation(struct lys_deviation *dev, const struct lys_module *module,
                 lys_node_addchild(NULL, lys_node_module(dev->orig_node), dev->orig_node, 0);
             }
 
+            /* the subtree summaries of the parents are not lowered when removing the node, but they must include it */
+            if (lys_summary_ready(lys_main_module(module))) {
+                lys_summary_subtree(dev->orig_node);
+                lys_summary_update(dev->orig_node);
+                lys_order_update(dev->orig_node);
+            }
+
             dev->orig_node = NULL;
         } else {
             /* adding not-supported deviation */
@@ -4708,6 +5073,11 @@ lys_switch_deviation(struct lys_deviation *dev, const struct lys_module *module,
 
         /* contents are switched */
         lys_node_switch(target, dev->orig_node);
+
+        /* the deviated properties (default, mandatory, ...) may change the subtree summaries */
+        if (lys_summary_ready(lys_main_module(module))) {
+            lys_summary_update(target);
+        }
     }
 }
 
@@ -5084,6 +5454,9 @@ lys_set_implemented(const struct lys_module *module)
     }
 
     module = lys_main_module(module);
+    if ((module->disabled || !module->implemented) && ly_ctx_check_frozen(module->ctx)) {
+        return EXIT_FAILURE;
+    }
 
     if (module->disabled) {
         disabled = 1;
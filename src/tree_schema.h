@@ -686,7 +686,7 @@ struct lys_module {
     uint8_t latest_revision:1;       /**< flag if the module was loaded without specific revision and is
                                           the latest revision found */
     uint8_t padding1:7;              /**< padding for 32b alignment */
-    uint8_t padding2[2];
+    uint16_t order;                  /**< ordinal of the module in the context, internal use only, 0 if unknown */
 
     /* array sizes */
     uint8_t rev_size;                /**< number of elements in #rev array */
@@ -1124,8 +1124,11 @@ struct lys_iffeature {
  *     12 LYS_LEAFREF_DEP  |x|x|x|x|x|x|x|x|x|x|x| |x|x| | | |r| |
  *                         +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *     13 LYS_DFLTJSON     | | |x|x| | | | | | | | | | | |x| |r| |
+ *        LYS_MAND_DESC    |x|x| | |x| |x|x|x|x|x| |x| | | | | | |
  *                         +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *     14 LYS_VALID_EXT    |x| |x|x|x|x| | | | | | | | | |x| | | |
+ *                         +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *     16 LYS_DFLT_DESC    |x|x| | |x| |x|x|x|x|x| |x| | | | | | |
  *     --------------------+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *
  *     x - used
@@ -1175,6 +1178,16 @@ struct lys_iffeature {
 #define LYS_VALID_EXT    0x2000      /**< flag marking nodes that need to be validated using an extension validation function */
 #define LYS_VALID_EXT_SUBTREE 0x4000 /**< flag marking nodes that need to be validated using an extension
                                           validation function when one of their children nodes is modified */
+#define LYS_MAND_DESC    0x1000      /**< flag marking inner nodes whose subtree includes nodes with mandatory,
+                                          min-elements or max-elements restriction or with when condition (deciding
+                                          whether the restrictions apply), so the mandatory checks of data can skip
+                                          subtrees without it (applicable only to ::lys_node_container,
+                                          ::lys_node_list, ::lys_node_choice, ::lys_node_case, ::lys_node_uses,
+                                          ::lys_node_inout, ::lys_node_notif and ::lys_node_rpc_action) */
+#define LYS_DFLT_DESC    0x8000      /**< flag marking inner nodes whose subtree can create implicit data nodes (default
+                                          leaves and leaf-lists or non-presence containers), so adding default nodes
+                                          into data can skip subtrees without it (applicable to the same nodes as
+                                          #LYS_MAND_DESC) */
 
 /**
  * @}
@@ -1241,6 +1254,8 @@ struct lys_node {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 };
 
 /**
@@ -1283,6 +1298,8 @@ struct lys_node_container {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific container's data */
     struct lys_when *when;           /**< when statement (optional) */
@@ -1372,6 +1389,8 @@ struct lys_node_leaf {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific leaf's data */
     struct lys_when *when;           /**< when statement (optional) */
@@ -1426,6 +1445,8 @@ struct lys_node_leaflist {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific leaf-list's data */
     struct lys_when *when;           /**< when statement (optional) */
@@ -1481,6 +1502,8 @@ struct lys_node_list {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific list's data */
     struct lys_when *when;           /**< when statement (optional) */
@@ -1538,6 +1561,8 @@ struct lys_node_anydata {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific anyxml's data */
     struct lys_when *when;           /**< when statement (optional) */
@@ -1756,6 +1781,8 @@ struct lys_node_notif {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific rpc's data */
     struct lys_tpdf *tpdf;           /**< array of typedefs */
@@ -1802,6 +1829,8 @@ struct lys_node_rpc_action {
 #ifdef LY_ENABLED_CACHE
     uint8_t hash[LYS_NODE_HASH_COUNT]; /**< schema hash required for LYB printer/parser */
 #endif
+    uint32_t order;                  /**< ordinal of the node among its data siblings in the schema order (list keys
+                                          first), internal use only, see lyd_schema_sort() */
 
     /* specific rpc's data */
     struct lys_tpdf *tpdf;           /**< array of typedefs */
@@ -194,7 +194,7 @@ uniquecheck:
                 }
             }
 
-            if (!val1 || !val2 || !ly_strequal(val1, val2, 1)) {
+            if (!val1 || !val2 || !ly_strequal(val1, val2, 0)) {
                 /* values differ or either one is not set */
                 break;
             }
@@ -395,7 +395,7 @@ lyv_list_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data
         }
         /* compare values */
         if (ly_strequal(((struct lyd_node_leaf_list *)first)->value_str,
-                        ((struct lyd_node_leaf_list *)second)->value_str, 1)) {
+                        ((struct lyd_node_leaf_list *)second)->value_str, 0)) {
             LOGVAL(ctx, LYE_DUPLEAFLIST, LY_VLOG_LYD, second, second->schema->name,
                    ((struct lyd_node_leaf_list *)second)->value_str);
             return 1;
@@ -424,7 +424,7 @@ lyv_list_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data
                         break;
                     }
                 }
-                if (!ly_strequal(val1, val2, 1)) {
+                if (!ly_strequal(val1, val2, 0)) {
                     return 0;
                 }
             }
@@ -324,6 +324,11 @@ lyxml_unlink_elem(struct ly_ctx *ctx, struct lyxml_elem *elem, int copy_ns)
         return;
     }
 
+    if (ly_err_lazy_count) {
+        /* the element is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(ctx);
+    }
+
     /* store pointers to important nodes */
     parent = elem->parent;
 
@@ -453,6 +458,11 @@ lyxml_free_elem(struct ly_ctx *ctx, struct lyxml_elem *elem)
         return;
     }
 
+    if (ly_err_lazy_count) {
+        /* the element is going to be changed or freed, generate paths of stored errors that may reference it */
+        ly_err_build_lazy_paths(ctx);
+    }
+
     lyxml_free_attrs(ctx, elem);
     LY_TREE_FOR_SAFE(elem->child, next, e) {
         lyxml_free_elem(ctx, e);
@@ -669,10 +679,21 @@ parse_text(struct ly_ctx *ctx, const char *data, char delim, unsigned int *len)
 
     char buf[BUFSIZE];
     char *result = NULL, *aux;
+    const char stop[] = {delim, '&', '<', ']', '\0'};
     unsigned int r;
     int o, size = 0;
     int cdsect = 0;
     int32_t n;
+    size_t span;
+
+    /* most texts need no processing, use them directly */
+    span = lyp_text_span(data, stop, 1);
+    if ((data[span] == delim) && ((delim != '<') || strncmp(&data[span], "<![CDATA[", 9))) {
+        *len = span;
+        result = strndup(data, span);
+        LY_CHECK_ERR_RETURN(!result, LOGMEM(ctx), NULL);
+        return result;
+    }
 
     for (*len = o = 0; cdsect || data[*len] != delim; o++) {
         if (!data[*len] || (!cdsect && !strncmp(&data[*len], "]]>", 3))) {
@@ -770,6 +791,14 @@ loop:
                 o += r - 1;     /* o is ++ in for loop */
                 (*len)++;
             }
+        } else if ((span = lyp_text_span(&data[*len], stop, 1))) {
+            /* copy a run of plain characters at once */
+            if (span > (size_t)(BUFSIZE - o)) {
+                span = BUFSIZE - o;
+            }
+            memcpy(&buf[o], &data[*len], span);
+            o += span - 1;  /* o is ++ in for loop */
+            (*len) += span;
         } else {
             r = copyutf8(ctx, &buf[o], &data[*len]);
             if (!r) {
@@ -1365,33 +1394,44 @@ error:
 int
 lyxml_dump_text(struct lyout *out, const char *text, LYXML_DATA_TYPE type)
 {
-    unsigned int i, n;
+    size_t i, len, span;
+    unsigned int n;
 
     if (!text) {
         return 0;
     }
 
-    for (i = n = 0; text[i]; i++) {
+    len = strlen(text);
+    for (i = n = 0; i < len; i++) {
+        /* print all the characters that do not need escaping at once */
+        span = ly_escape_span(&text[i], len - i, (type == LYXML_DATA_ATTR) ? LY_ESC_XML_ATTR : LY_ESC_XML_ELEM);
+        if (span) {
+            ly_write(out, &text[i], span);
+            n += span;
+            i += span;
+            if (i == len) {
+                break;
+            }
+        }
+
         switch (text[i]) {
         case '&':
-            n += ly_print(out, "&amp;");
+            ly_write(out, "&amp;", 5);
+            n += 5;
             break;
         case '<':
-            n += ly_print(out, "&lt;");
+            ly_write(out, "&lt;", 4);
+            n += 4;
             break;
         case '>':
             /* not needed, just for readability */
-            n += ly_print(out, "&gt;");
+            ly_write(out, "&gt;", 4);
+            n += 4;
             break;
         case '"':
-            if (type == LYXML_DATA_ATTR) {
-                n += ly_print(out, "&quot;");
-                break;
-            }
-            /* falls through */
-        default:
-            ly_write(out, &text[i], 1);
-            n++;
+            ly_write(out, "&quot;", 6);
+            n += 6;
+            break;
         }
     }
 
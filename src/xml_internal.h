@@ -67,6 +67,19 @@ void lyxml_correct_elem_ns(struct ly_ctx *ctx, struct lyxml_elem *elem, struct l
 struct lyxml_elem *lyxml_dup_elem(struct ly_ctx *ctx, struct lyxml_elem *elem,
                                   struct lyxml_elem *parent, int recursive, int with_siblings);
 
+/**
+ * @brief Parse a single XML element (with its subtree).
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in] data Input data pointing to the element's '<'.
+ * @param[out] len Number of bytes of the parsed element.
+ * @param[in] parent Parent of the element, NULL for a root element.
+ * @param[in] options Parser options, see @ref xmlreadoptions.
+ * @return Parsed element, NULL on error.
+ */
+struct lyxml_elem *lyxml_parse_elem(struct ly_ctx *ctx, const char *data, unsigned int *len, struct lyxml_elem *parent,
+                                    int options);
+
 /**
  * @brief Free attribute. Includes unlinking from an element if the attribute
  * is placed anywhere.
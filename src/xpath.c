@@ -3677,34 +3677,40 @@ xpath_deref(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node
     return EXIT_SUCCESS;
 }
 
-/* return 0 - match, 1 - mismatch */
-static int
-xpath_derived_from_ident_cmp(struct lys_ident *ident, const char *ident_str)
+/**
+ * @brief Resolve the identity argument of derived-from() and derived-from-or-self() functions so that
+ *        the identities of all the nodes can then be checked only by comparing pointers.
+ *
+ * @param[in] ident_str Identity name with an optional (JSON) module name prefix.
+ * @param[in] local_mod Module to use for an identity without a prefix.
+ * @return Resolved identity, NULL if there is no such identity (nothing can be derived from it).
+ */
+static struct lys_ident *
+xpath_derived_from_ident_resolve(const char *ident_str, struct lys_module *local_mod)
 {
+    const struct lys_module *mod;
     const char *ptr;
     int len;
 
     ptr = strchr(ident_str, ':');
     if (ptr) {
         len = ptr - ident_str;
-        if (strncmp(ident->module->name, ident_str, len)
-                || ident->module->name[len]) {
-            /* module name mismatch BUG we expect JSON format prefix, but if the 2nd argument was
-             * not a literal, we may easily be mistaken */
-            return 1;
+        /* BUG we expect JSON format prefix, but if the 2nd argument was
+         * not a literal, we may easily be mistaken */
+        mod = ly_ctx_nget_module(local_mod->ctx, ident_str, len, NULL, 1);
+        if (!mod) {
+            mod = ly_ctx_nget_module(local_mod->ctx, ident_str, len, NULL, 0);
+        }
+        if (!mod) {
+            return NULL;
         }
         ++ptr;
     } else {
+        mod = lys_main_module(local_mod);
         ptr = ident_str;
     }
 
-    len = strlen(ptr);
-    if (strncmp(ident->name, ptr, len) || ident->name[len]) {
-        /* name mismatch */
-        return 1;
-    }
-
-    return 0;
+    return resolve_identity_find(mod, ptr, 0);
 }
 
 /**
@@ -3724,8 +3730,9 @@ static int
 xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *cur_node, struct lys_module *local_mod,
                    struct lyxp_set *set, int options)
 {
-    uint16_t i, j;
+    uint16_t i;
     struct lyd_node_leaf_list *leaf;
+    struct lys_ident *ident;
     struct lys_node_leaf *sleaf;
     lyd_val *val;
     int ret = EXIT_SUCCESS;
@@ -3764,7 +3771,8 @@ xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct ly
     }
 
     set_fill_boolean(set, 0);
-    if (args[0]->type != LYXP_SET_EMPTY) {
+    ident = xpath_derived_from_ident_resolve(args[1]->val.str, local_mod);
+    if (ident && (args[0]->type != LYXP_SET_EMPTY)) {
         for (i = 0; i < args[0]->used; ++i) {
             val = NULL;
             if (args[0]->val.nodes[i].type == LYXP_NODE_ELEM) {
@@ -3778,17 +3786,9 @@ xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct ly
                     val = &args[0]->val.attrs[i].attr->value;
                 }
             }
-            if (val) {
-                for (j = 0; j < val->ident->base_size; ++j) {
-                    if (!xpath_derived_from_ident_cmp(val->ident->base[j], args[1]->val.str)) {
-                        set_fill_boolean(set, 1);
-                        break;
-                    }
-                }
-
-                if (j < val->ident->base_size) {
-                    break;
-                }
+            if (val && (val->ident != ident) && resolve_identity_derived(val->ident, ident)) {
+                set_fill_boolean(set, 1);
+                break;
             }
         }
     }
@@ -3813,8 +3813,9 @@ static int
 xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *cur_node,
                            struct lys_module *local_mod, struct lyxp_set *set, int options)
 {
-    uint16_t i, j;
+    uint16_t i;
     struct lyd_node_leaf_list *leaf;
+    struct lys_ident *ident;
     struct lys_node_leaf *sleaf;
     lyd_val *val;
     int ret = EXIT_SUCCESS;
@@ -3853,7 +3854,8 @@ xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), s
     }
 
     set_fill_boolean(set, 0);
-    if (args[0]->type != LYXP_SET_EMPTY) {
+    ident = xpath_derived_from_ident_resolve(args[1]->val.str, local_mod);
+    if (ident && (args[0]->type != LYXP_SET_EMPTY)) {
         for (i = 0; i < args[0]->used; ++i) {
             val = NULL;
             if (args[0]->val.nodes[i].type == LYXP_NODE_ELEM) {
@@ -3867,22 +3869,9 @@ xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), s
                     val = &args[0]->val.attrs[i].attr->value;
                 }
             }
-            if (val) {
-                if (!xpath_derived_from_ident_cmp(val->ident, args[1]->val.str)) {
-                    set_fill_boolean(set, 1);
-                    break;
-                }
-
-                for (j = 0; j < val->ident->base_size; ++j) {
-                    if (!xpath_derived_from_ident_cmp(val->ident->base[j], args[1]->val.str)) {
-                        set_fill_boolean(set, 1);
-                        break;
-                    }
-                }
-
-                if (j < val->ident->base_size) {
-                    break;
-                }
+            if (val && resolve_identity_derived(val->ident, ident)) {
+                set_fill_boolean(set, 1);
+                break;
             }
         }
     }
@@ -5647,6 +5636,11 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
         } else if (!(set->val.nodes[i].node->validity & LYD_VAL_INUSE)
                 && !(set->val.nodes[i].node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
 
+            if (set->val.nodes[i].node->lazy_dflt
+                    && lyd_wd_materialize_node(set->val.nodes[i].node, (name_dict[0] == '*') ? NULL : name_dict)) {
+                lydict_remove(ctx, name_dict);
+                return -1;
+            }
             LY_TREE_FOR(set->val.nodes[i].node->child, sub) {
                 ret = moveto_node_check(sub, root_type, name_dict, moveto_mod, options);
                 if (!ret) {
@@ -5909,6 +5903,10 @@ moveto_node_alldesc(struct lyxp_set *set, struct lyd_node *cur_node, const char
             if (elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
                 next = NULL;
             } else {
+                if (elem->lazy_dflt && lyd_wd_materialize_node(elem, NULL)) {
+                    set_free_content(&ret_set);
+                    return -1;
+                }
                 next = elem->child;
             }
             if (!next) {
@@ -6359,6 +6357,9 @@ moveto_self_add_children_r(const struct lyd_node *parent, uint32_t parent_pos, e
     case LYXP_NODE_ELEM:
         /* add all the children ... */
         if (!(parent->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))) {
+            if (parent->lazy_dflt && lyd_wd_materialize_node((struct lyd_node *)parent, NULL)) {
+                return -1;
+            }
             LY_TREE_FOR(parent->child, sub) {
                 /* context check */
                 if ((root_type == LYXP_NODE_ROOT_CONFIG) && (sub->schema->flags & LYS_CONFIG_R)) {
@@ -107,6 +107,8 @@ using S_Xml_Elem = std::shared_ptr<Xml_Elem>;
 
 class Value;
 class Data_Node;
+class Data_Node_Ref;
+class Data_Node_Range;
 class Data_Node_Leaf_List;
 class Data_Node_Anydata;
 class Attr;
@@ -139,6 +141,8 @@ class Type;
 class Iffeature;
 class Ext_Instance;
 class Schema_Node;
+class Schema_Node_Ref;
+class Schema_Node_Range;
 class Schema_Node_Container;
 class Schema_Node_Choice;
 class Schema_Node_Leaf;
@@ -385,6 +385,12 @@ std::vector<S_Schema_Node> Set::schema() {
 
     return s_vector;
 };
+Data_Node_Range Set::data_range() {
+    return Data_Node_Range(set, deleter);
+}
+Schema_Node_Range Set::schema_range() {
+    return Schema_Node_Range(set, deleter);
+}
 S_Set Set::dup() {
     ly_set *new_set = ly_set_dup(set);
     if (!new_set) {
@@ -198,6 +198,10 @@ public:
     std::vector<S_Data_Node> data();
     /** get s variable from [ly_set_set](@ref ly_set_set)*/
     std::vector<S_Schema_Node> schema();
+    /** lazy range of d variable from [ly_set_set](@ref ly_set_set), for (auto n : set->data_range()) */
+    Data_Node_Range data_range();
+    /** lazy range of s variable from [ly_set_set](@ref ly_set_set), for (auto n : set->schema_range()) */
+    Schema_Node_Range schema_range();
 
     /* functions */
     /** wrapper for [ly_set_dup](@ref ly_set_dup) */
@@ -538,6 +538,98 @@ std::vector<S_Data_Node> Data_Node::tree_dfs() {
     return s_vector;
 }
 
+Data_Node_Range Data_Node::siblings() {
+    return Data_Node_Range(node, Data_Node_Range::Walk::SIBLINGS, deleter);
+}
+Data_Node_Range Data_Node::dfs() {
+    return Data_Node_Range(node, Data_Node_Range::Walk::DFS, deleter);
+}
+Data_Node_Range Data_Node::find(const char *expr) {
+    struct ly_set *set = lyd_find_path(node, expr);
+    if (!set) {
+        check_libyang_error(node->schema->module->ctx);
+    }
+
+    return Data_Node_Range(set, std::make_shared<Deleter>(set, deleter));
+}
+
+std::string Data_Node_Ref::path() {
+    char *path = nullptr;
+
+    path = lyd_path(node);
+    if (!path) {
+        check_libyang_error(node->schema->module->ctx);
+        return nullptr;
+    }
+
+    std::string s_path = path;
+    free(path);
+    return s_path;
+}
+S_Data_Node Data_Node_Ref::shared() {
+    return std::make_shared<Data_Node>(node, *deleter);
+}
+
+Data_Node_Range::Data_Node_Range(struct lyd_node *start, Walk walk, S_Deleter deleter):
+    start(start),
+    set(nullptr),
+    walk(walk),
+    deleter(deleter)
+{};
+Data_Node_Range::Data_Node_Range(struct ly_set *set, S_Deleter deleter):
+    start(nullptr),
+    set(set),
+    walk(Walk::SET),
+    deleter(deleter)
+{};
+Data_Node_Range::iterator Data_Node_Range::begin() const {
+    if (walk == Walk::SET) {
+        return set->number ? iterator(this, set->set.d[0], 0) : end();
+    }
+    return iterator(this, start, 0);
+}
+Data_Node_Range::iterator &Data_Node_Range::iterator::operator++() {
+    struct lyd_node *next = nullptr;
+
+    switch (range->walk) {
+    case Walk::SIBLINGS:
+        elem = elem->next;
+        break;
+    case Walk::SET:
+        if (++index < range->set->number) {
+            elem = range->set->set.d[index];
+        } else {
+            /* the end iterator */
+            elem = nullptr;
+            index = 0;
+        }
+        break;
+    case Walk::DFS:
+        /* the same as LY_TREE_DFS_END() */
+        if (!(elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+            next = elem->child;
+        }
+        if (!next) {
+            if (elem == range->start) {
+                elem = nullptr;
+                break;
+            }
+            next = elem->next;
+        }
+        while (!next) {
+            elem = elem->parent;
+            if (elem->parent == range->start->parent) {
+                break;
+            }
+            next = elem->next;
+        }
+        elem = next;
+        break;
+    }
+
+    return *this;
+}
+
 Data_Node_Leaf_List::Data_Node_Leaf_List(S_Data_Node derived):
     Data_Node(derived->node, derived->deleter),
     node(derived->node),
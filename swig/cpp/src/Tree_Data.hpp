@@ -96,6 +96,86 @@ private:
     S_Deleter deleter;
 };
 
+/**
+ * @brief Non-owning view of a [lyd_node](@ref lyd_node) yielded by [Data_Node_Range](@ref Data_Node_Range).
+ * @class Data_Node_Ref
+ *
+ * It does not hold the tree, so it is valid only as long as the range it comes from.
+ */
+class Data_Node_Ref
+{
+public:
+    /** wrapper for struct [lyd_node](@ref lyd_node), for internal use only */
+    Data_Node_Ref(struct lyd_node *node, const S_Deleter *deleter): node(node), deleter(deleter) {};
+    /** get name of the schema variable from [lyd_node](@ref lyd_node)*/
+    const char *name() {return node->schema->name;};
+    /** get nodetype of the schema variable from [lyd_node](@ref lyd_node)*/
+    LYS_NODE nodetype() {return node->schema->nodetype;};
+    /** get dflt variable from [lyd_node](@ref lyd_node)*/
+    uint8_t dflt() {return node->dflt;};
+    /** get value_str variable from [lyd_node_leaf_list](@ref lyd_node_leaf_list), NULL for other nodes*/
+    const char *value_str() {
+        return node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST) ? ((struct lyd_node_leaf_list *) node)->value_str : nullptr;
+    };
+    /** wrapper for [lyd_path](@ref lyd_path) */
+    std::string path();
+    /** owning [Data_Node](@ref Data_Node) of the same node, allocated only here */
+    S_Data_Node shared();
+
+    /** libnetconf2 related wrappers, for internal use only */
+    struct lyd_node *C_lyd_node() {return node;};
+
+private:
+    struct lyd_node *node;
+    const S_Deleter *deleter;
+};
+
+/**
+ * @brief Lazy range of data nodes for range-based for loops.
+ * @class Data_Node_Range
+ *
+ * The range holds the tree once, its iterators yield [Data_Node_Ref](@ref Data_Node_Ref) views without any allocation.
+ */
+class Data_Node_Range
+{
+public:
+    /** how the range walks the nodes */
+    enum class Walk {
+        SIBLINGS,   /**< like [LY_TREE_FOR](@ref LY_TREE_FOR) */
+        DFS,        /**< like [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN) */
+        SET         /**< nodes of a [ly_set](@ref ly_set) */
+    };
+
+    /** forward iterator of the range */
+    class iterator
+    {
+    public:
+        iterator(const Data_Node_Range *range, struct lyd_node *elem, unsigned int index): range(range), elem(elem), index(index) {};
+        Data_Node_Ref operator*() const {return Data_Node_Ref(elem, &range->deleter);};
+        iterator &operator++();
+        bool operator==(const iterator &other) const {return (elem == other.elem) && (index == other.index);};
+        bool operator!=(const iterator &other) const {return !(*this == other);};
+
+    private:
+        const Data_Node_Range *range;
+        struct lyd_node *elem;
+        unsigned int index;
+    };
+
+    /** wrapper for a walk starting at [lyd_node](@ref lyd_node), for internal use only */
+    Data_Node_Range(struct lyd_node *start, Walk walk, S_Deleter deleter);
+    /** wrapper for [ly_set](@ref ly_set) of data nodes, for internal use only */
+    Data_Node_Range(struct ly_set *set, S_Deleter deleter);
+    iterator begin() const;
+    iterator end() const {return iterator(this, nullptr, 0);};
+
+private:
+    struct lyd_node *start;
+    struct ly_set *set;
+    Walk walk;
+    S_Deleter deleter;
+};
+
 /**
  * @brief classes for wrapping [lyd_node](@ref lyd_node).
  * @class Data_Node
@@ -206,6 +286,12 @@ public:
     std::vector<S_Data_Node> tree_for();
     /** wrapper for macro [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN) and [LY_TREE_DFS_END](@ref LY_TREE_DFS_END) */
     std::vector<S_Data_Node> tree_dfs();
+    /** lazy [LY_TREE_FOR](@ref LY_TREE_FOR), for (auto n : node->siblings()) */
+    Data_Node_Range siblings();
+    /** lazy [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN), for (auto n : node->dfs()) */
+    Data_Node_Range dfs();
+    /** wrapper for [lyd_find_path](@ref lyd_find_path) returning a lazy range */
+    Data_Node_Range find(const char *expr);
 
     /** SWIG related wrappers, for internal use only */
     struct lyd_node *swig_node() {return node;};
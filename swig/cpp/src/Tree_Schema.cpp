@@ -325,6 +325,102 @@ std::vector<S_Schema_Node> Schema_Node::tree_dfs() {
     return s_vector;
 }
 
+Schema_Node_Range Schema_Node::siblings() {
+    return Schema_Node_Range(node, Schema_Node_Range::Walk::SIBLINGS, deleter);
+}
+Schema_Node_Range Schema_Node::dfs() {
+    return Schema_Node_Range(node, Schema_Node_Range::Walk::DFS, deleter);
+}
+Schema_Node_Range Schema_Node::children(int options) {
+    return Schema_Node_Range(node, Schema_Node_Range::Walk::CHILDREN, deleter, options);
+}
+
+std::string Schema_Node_Ref::path(int options) {
+    char *path = nullptr;
+
+    path = lys_path(node, options);
+    if (!path) {
+        return nullptr;
+    }
+
+    std::string s_path = path;
+    free(path);
+    return s_path;
+}
+S_Schema_Node Schema_Node_Ref::shared() {
+    return std::make_shared<Schema_Node>(node, *deleter);
+}
+
+Schema_Node_Range::Schema_Node_Range(struct lys_node *start, Walk walk, S_Deleter deleter, int options):
+    start(start),
+    set(nullptr),
+    walk(walk),
+    options(options),
+    deleter(deleter)
+{};
+Schema_Node_Range::Schema_Node_Range(struct ly_set *set, S_Deleter deleter):
+    start(nullptr),
+    set(set),
+    walk(Walk::SET),
+    options(0),
+    deleter(deleter)
+{};
+Schema_Node_Range::iterator Schema_Node_Range::begin() const {
+    switch (walk) {
+    case Walk::SET:
+        return set->number ? iterator(this, set->set.s[0], 0) : end();
+    case Walk::CHILDREN:
+        return iterator(this, (struct lys_node *)lys_getnext(nullptr, start, start->module, options), 0);
+    default:
+        return iterator(this, start, 0);
+    }
+}
+Schema_Node_Range::iterator &Schema_Node_Range::iterator::operator++() {
+    struct lys_node *next = nullptr;
+
+    switch (range->walk) {
+    case Walk::SIBLINGS:
+        elem = elem->next;
+        break;
+    case Walk::CHILDREN:
+        elem = (struct lys_node *)lys_getnext(elem, range->start, range->start->module, range->options);
+        break;
+    case Walk::SET:
+        if (++index < range->set->number) {
+            elem = range->set->set.s[index];
+        } else {
+            /* the end iterator */
+            elem = nullptr;
+            index = 0;
+        }
+        break;
+    case Walk::DFS:
+        /* the same as LY_TREE_DFS_END() */
+        if (!(elem->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+            next = elem->child;
+        }
+        if (!next) {
+            if (elem == range->start) {
+                elem = nullptr;
+                break;
+            }
+            next = elem->next;
+        }
+        while (!next) {
+            /* due to possible augments */
+            elem = (elem->parent->nodetype == LYS_AUGMENT) ? elem->parent->prev : elem->parent;
+            if (lys_parent(elem) == lys_parent(range->start)) {
+                break;
+            }
+            next = elem->next;
+        }
+        elem = next;
+        break;
+    }
+
+    return *this;
+}
+
 Schema_Node_Container::~Schema_Node_Container() {};
 S_When Schema_Node_Container::when() LY_NEW_CASTED(lys_node_container, node, when, When);
 S_Restr Schema_Node_Container::must() {
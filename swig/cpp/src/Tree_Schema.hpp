@@ -523,6 +523,84 @@ private:
     S_Deleter deleter;
 };
 
+/**
+ * @brief Non-owning view of a [lys_node](@ref lys_node) yielded by [Schema_Node_Range](@ref Schema_Node_Range).
+ * @class Schema_Node_Ref
+ *
+ * It does not hold the context, so it is valid only as long as the range it comes from.
+ */
+class Schema_Node_Ref
+{
+public:
+    /** wrapper for struct [lys_node](@ref lys_node), for internal use only */
+    Schema_Node_Ref(struct lys_node *node, const S_Deleter *deleter): node(node), deleter(deleter) {};
+    /** get name variable from [lys_node](@ref lys_node)*/
+    const char *name() {return node->name;};
+    /** get flags variable from [lys_node](@ref lys_node)*/
+    uint16_t flags() {return node->flags;};
+    /** get nodetype variable from [lys_node](@ref lys_node)*/
+    LYS_NODE nodetype() {return node->nodetype;};
+    /** wrapper for [lys_path](@ref lys_path) */
+    std::string path(int options = 0);
+    /** owning [Schema_Node](@ref Schema_Node) of the same node, allocated only here */
+    S_Schema_Node shared();
+
+    /* SWIG can not access private variables so it needs public getters */
+    struct lys_node *swig_node() {return node;};
+
+private:
+    struct lys_node *node;
+    const S_Deleter *deleter;
+};
+
+/**
+ * @brief Lazy range of schema nodes for range-based for loops.
+ * @class Schema_Node_Range
+ *
+ * The range holds the context once, its iterators yield [Schema_Node_Ref](@ref Schema_Node_Ref) views without any allocation.
+ */
+class Schema_Node_Range
+{
+public:
+    /** how the range walks the nodes */
+    enum class Walk {
+        SIBLINGS,   /**< like [LY_TREE_FOR](@ref LY_TREE_FOR) */
+        DFS,        /**< like [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN) */
+        CHILDREN,   /**< like [lys_getnext](@ref lys_getnext) */
+        SET         /**< nodes of a [ly_set](@ref ly_set) */
+    };
+
+    /** forward iterator of the range */
+    class iterator
+    {
+    public:
+        iterator(const Schema_Node_Range *range, struct lys_node *elem, unsigned int index): range(range), elem(elem), index(index) {};
+        Schema_Node_Ref operator*() const {return Schema_Node_Ref(elem, &range->deleter);};
+        iterator &operator++();
+        bool operator==(const iterator &other) const {return (elem == other.elem) && (index == other.index);};
+        bool operator!=(const iterator &other) const {return !(*this == other);};
+
+    private:
+        const Schema_Node_Range *range;
+        struct lys_node *elem;
+        unsigned int index;
+    };
+
+    /** wrapper for a walk starting at (or, for CHILDREN, under) [lys_node](@ref lys_node), for internal use only */
+    Schema_Node_Range(struct lys_node *start, Walk walk, S_Deleter deleter, int options = 0);
+    /** wrapper for [ly_set](@ref ly_set) of schema nodes, for internal use only */
+    Schema_Node_Range(struct ly_set *set, S_Deleter deleter);
+    iterator begin() const;
+    iterator end() const {return iterator(this, nullptr, 0);};
+
+private:
+    struct lys_node *start;
+    struct ly_set *set;
+    Walk walk;
+    int options;
+    S_Deleter deleter;
+};
+
 class Schema_Node
 {
 public:
@@ -577,6 +655,12 @@ public:
     std::vector<S_Schema_Node> tree_for();
     /** wrapper for macro [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN) and [LY_TREE_DFS_END](@ref LY_TREE_DFS_END) */
     std::vector<S_Schema_Node> tree_dfs();
+    /** lazy [LY_TREE_FOR](@ref LY_TREE_FOR), for (auto n : node->siblings()) */
+    Schema_Node_Range siblings();
+    /** lazy [LY_TREE_DFS_BEGIN](@ref LY_TREE_DFS_BEGIN), for (auto n : node->dfs()) */
+    Schema_Node_Range dfs();
+    /** lazy [lys_getnext](@ref lys_getnext) over the children, for (auto n : node->children()) */
+    Schema_Node_Range children(int options = 0);
 
     /* SWIG can not access private variables so it needs public getters */
     struct lys_node *swig_node() {return node;};
@@ -458,6 +458,60 @@ TEST(test_ly_data_node_find_path)
     }
 }
 
+TEST(test_ly_data_node_range)
+{
+    const char *yang_folder = TESTS_DIR "/api/files";
+    const char *config_file = TESTS_DIR "/api/files/a.xml";
+
+    try {
+        auto ctx = std::make_shared<libyang::Context>(yang_folder);
+        ASSERT_NOTNULL(ctx);
+        ctx->parse_module_mem(lys_module_a, LYS_IN_YIN);
+        auto root = ctx->parse_data_path(config_file, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+        ASSERT_NOTNULL(root);
+
+        auto dfs = root->tree_dfs();
+        unsigned int i = 0;
+        for (auto n : root->dfs()) {
+            ASSERT_TRUE(i < dfs.size());
+            ASSERT_TRUE(n.C_lyd_node() == dfs[i]->C_lyd_node());
+            ++i;
+        }
+        ASSERT_EQ(dfs.size(), i);
+
+        auto siblings = root->tree_for();
+        i = 0;
+        for (auto n : root->siblings()) {
+            ASSERT_TRUE(i < siblings.size());
+            ASSERT_TRUE(n.C_lyd_node() == siblings[i]->C_lyd_node());
+            ++i;
+        }
+        ASSERT_EQ(siblings.size(), i);
+
+        i = 0;
+        for (auto n : root->find("/a:x/bubba")) {
+            ASSERT_STREQ("bubba", n.name());
+            ASSERT_STREQ("test", n.value_str());
+            ASSERT_STREQ("/a:x/bubba", n.path().c_str());
+            ASSERT_NOTNULL(n.shared());
+            ++i;
+        }
+        ASSERT_EQ(1, i);
+
+        auto set = root->find_path("/a:x/*");
+        ASSERT_NOTNULL(set);
+        i = 0;
+        for (auto n : set->data_range()) {
+            ASSERT_TRUE(n.C_lyd_node() == set->data()[i]->C_lyd_node());
+            ++i;
+        }
+        ASSERT_EQ(set->number(), i);
+    } catch (const std::exception& e) {
+        mt::printFailed(e.what(), stdout);
+        throw;
+    }
+}
+
 TEST(test_ly_data_node_find_instance)
 {
     const char *yang_folder = TESTS_DIR "/api/files";
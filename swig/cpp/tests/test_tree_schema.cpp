@@ -567,6 +567,55 @@ TEST(test_ly_schema_child_instatiables)
     }
 }
 
+TEST(test_ly_schema_node_range)
+{
+    const char *yang_folder = TESTS_DIR "/api/files";
+    const char *module_name = "b";
+
+    try {
+        auto ctx = std::make_shared<libyang::Context>(yang_folder);
+        ASSERT_NOTNULL(ctx);
+
+        auto module = ctx->load_module(module_name);
+        ASSERT_NOTNULL(module);
+
+        auto list = module->data_instantiables(0);
+        ASSERT_EQ(1, list.size());
+        auto node = list.front();
+
+        auto children = node->child_instantiables(0);
+        unsigned int i = 0;
+        for (auto n : node->children()) {
+            ASSERT_TRUE(i < children.size());
+            ASSERT_TRUE(n.swig_node() == children[i]->swig_node());
+            ++i;
+        }
+        ASSERT_EQ(3, i);
+
+        auto dfs = node->tree_dfs();
+        i = 0;
+        for (auto n : node->dfs()) {
+            ASSERT_TRUE(i < dfs.size());
+            ASSERT_TRUE(n.swig_node() == dfs[i]->swig_node());
+            ++i;
+        }
+        ASSERT_EQ(dfs.size(), i);
+
+        auto set = node->find_path("/b:x/*");
+        ASSERT_NOTNULL(set);
+        i = 0;
+        for (auto n : set->schema_range()) {
+            ASSERT_STREQ(set->schema()[i]->name(), n.name());
+            ASSERT_NOTNULL(n.shared());
+            ++i;
+        }
+        ASSERT_EQ(set->number(), i);
+    } catch( const std::exception& e ) {
+        mt::printFailed(e.what(), stdout);
+        throw;
+    }
+}
+
 TEST(test_iffeature)
 {
     const char *yang_folder = TESTS_DIR "/api/files";
@@ -53,6 +53,8 @@
 
 %shared_ptr(libyang::Set);
 %newobject Set::dup;
+%ignore    Set::data_range;
+%ignore    Set::schema_range;
 
 %newobject create_new_Context;
 
@@ -81,6 +83,11 @@
 %newobject Data_Node::find_instance;
 %ignore    Data_Node::swig_node;
 %ignore    Data_Node::swig_deleter;
+%ignore    Data_Node::siblings;
+%ignore    Data_Node::dfs;
+%ignore    Data_Node::find;
+%ignore    Data_Node_Ref;
+%ignore    Data_Node_Range;
 %newobject Data_Node::diff;
 %newobject Data_Node::new_path;
 %newobject Data_Node::node_module;
@@ -215,6 +222,11 @@
 %newobject Schema_Node::xpath_atomize;
 %ignore    Schema_Node::swig_node;
 %ignore    Schema_Node::swig_deleter;
+%ignore    Schema_Node::siblings;
+%ignore    Schema_Node::dfs;
+%ignore    Schema_Node::children;
+%ignore    Schema_Node_Ref;
+%ignore    Schema_Node_Range;
 
 %shared_ptr(libyang::Schema_Node_Container);
 %newobject Schema_Node_Container::parent;
@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <limits.h>
+#include <pthread.h>
 
 #include "tests/config.h"
 #include "libyang.h"
@@ -275,6 +276,265 @@ test_ly_ctx_new_ylmem(void **state)
     ly_ctx_destroy(new_ctx, NULL);
 }
 
+static void
+test_ly_ctx_new_image(void **state)
+{
+    (void) state; /* unused */
+    const struct lys_module *mod, *new_mod;
+    struct ly_ctx *new_ctx;
+    struct lyd_node *node;
+    const char **features, **new_features;
+    uint8_t *states, *new_states;
+    char *str1, *str2, path[] = "/tmp/libyang-image-XXXXXX";
+    void *image;
+    size_t size;
+    uint32_t idx = 0;
+    int i, fd;
+
+    assert_int_equal(lys_features_enable(ly_ctx_get_module(ctx, "a", NULL, 1), "foo"), 0);
+    assert_int_equal(ly_ctx_print_image_mem(ctx, &image, &size), 0);
+
+    new_ctx = ly_ctx_new_image(NULL, image, size, 0);
+    assert_non_null(new_ctx);
+    assert_int_equal(ly_ctx_get_options(new_ctx), 0);
+
+    /* the same modules with the same features */
+    while ((mod = ly_ctx_get_module_iter(ctx, &idx))) {
+        new_mod = ly_ctx_get_module(new_ctx, mod->name, mod->rev_size ? mod->rev[0].date : NULL, 0);
+        assert_non_null(new_mod);
+        assert_int_equal(new_mod->implemented, mod->implemented);
+
+        features = lys_features_list(mod, &states);
+        new_features = lys_features_list(new_mod, &new_states);
+        for (i = 0; features[i]; ++i) {
+            assert_string_equal(new_features[i], features[i]);
+            assert_int_equal(new_states[i], states[i]);
+        }
+        assert_null(new_features[i]);
+        free(features);
+        free(states);
+        free(new_features);
+        free(new_states);
+
+        assert_int_equal(lys_print_mem(&str1, mod, LYS_OUT_YANG, NULL, 0, 0), 0);
+        assert_int_equal(lys_print_mem(&str2, new_mod, LYS_OUT_YANG, NULL, 0, 0), 0);
+        assert_string_equal(str1, str2);
+        free(str1);
+        free(str2);
+    }
+
+    /* the same data */
+    node = lyd_parse_path(new_ctx, TESTS_DIR"/api/files/a.xml", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_non_null(node);
+    assert_int_equal(lyd_print_mem(&str1, root, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&str2, node, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_string_equal(str1, str2);
+    free(str1);
+    free(str2);
+    lyd_free_withsiblings(node);
+    ly_ctx_destroy(new_ctx, NULL);
+
+    /* from a file */
+    fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    assert_int_equal(write(fd, image, size), size);
+    close(fd);
+    new_ctx = ly_ctx_new_image_path(NULL, path, 0);
+    unlink(path);
+    assert_non_null(new_ctx);
+    assert_non_null(ly_ctx_get_module(new_ctx, "b", NULL, 1));
+    ly_ctx_destroy(new_ctx, NULL);
+
+    /* different internal modules */
+    assert_null(ly_ctx_new_image(NULL, image, size, LY_CTX_NOYANGLIBRARY));
+
+    /* invalid images */
+    assert_null(ly_ctx_new_image(NULL, image, size - 1, 0));
+    ((char *)image)[0] = 'X';
+    assert_null(ly_ctx_new_image(NULL, image, size, 0));
+    free(image);
+}
+
+static void
+test_ly_ctx_clone(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *new_ctx;
+    const struct lys_module *mod;
+    const char * const *dirs;
+
+    ly_ctx_set_disable_searchdir_cwd(ctx);
+    assert_int_equal(lys_features_enable(ly_ctx_get_module(ctx, "b", NULL, 1), "*"), 0);
+
+    new_ctx = ly_ctx_clone(ctx);
+    assert_non_null(new_ctx);
+    assert_int_equal(ly_ctx_get_options(new_ctx), ly_ctx_get_options(ctx));
+    dirs = ly_ctx_get_searchdirs(new_ctx);
+    assert_non_null(dirs);
+    assert_string_equal(dirs[0], ly_ctx_get_searchdirs(ctx)[0]);
+    assert_null(dirs[1]);
+
+    mod = ly_ctx_get_module(new_ctx, "b", NULL, 1);
+    assert_non_null(mod);
+    assert_ptr_not_equal(mod, ly_ctx_get_module(ctx, "b", NULL, 1));
+    assert_int_equal(lys_features_state(mod, "foo"), 1);
+
+    /* the copy is modified independently */
+    assert_int_equal(lys_features_disable(mod, "foo"), 0);
+    assert_int_equal(lys_features_state(ly_ctx_get_module(ctx, "b", NULL, 1), "foo"), 1);
+    assert_non_null(ly_ctx_load_module(new_ctx, "c", NULL));
+    assert_null(ly_ctx_get_module(ctx, "c", NULL, 0));
+
+    ly_ctx_destroy(new_ctx, NULL);
+}
+
+static void
+test_ly_ctx_load_modules(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *new_ctx;
+    const char *names[] = {"c", "b", "INVALID_NAME", "a"};
+    const char *revisions[] = {NULL, "2016-03-01", NULL, NULL};
+    const struct lys_module *mods[4];
+    unsigned int threads;
+
+    assert_int_equal(ly_ctx_load_modules(NULL, names, revisions, 2, 0, mods), EXIT_FAILURE);
+    assert_int_equal(ly_ctx_load_modules(ctx, NULL, revisions, 2, 0, mods), EXIT_FAILURE);
+
+    for (threads = 0; threads < 3; ++threads) {
+        new_ctx = ly_ctx_new(TESTS_DIR"/api/files", LY_CTX_DISABLE_SEARCHDIR_CWD);
+        assert_non_null(new_ctx);
+
+        assert_int_equal(ly_ctx_load_modules(new_ctx, names, revisions, 2, threads, mods), EXIT_SUCCESS);
+        assert_string_equal(mods[0]->name, "c");
+        assert_string_equal(mods[1]->name, "b");
+        assert_string_equal(mods[1]->rev[0].date, "2016-03-01");
+        assert_int_equal(mods[1]->inc_size, 2);
+
+        /* imports of c */
+        assert_non_null(ly_ctx_get_module(new_ctx, "a", "2015-01-01", 0));
+        assert_non_null(ly_ctx_get_module(new_ctx, "b", "2015-01-01", 0));
+        assert_non_null(mods[0]->imp[0].module->filepath);
+
+        /* loading stops on the first failure */
+        assert_int_equal(ly_ctx_load_modules(new_ctx, names, NULL, 4, threads, mods), EXIT_FAILURE);
+        assert_ptr_equal(mods[0], ly_ctx_get_module(new_ctx, "c", NULL, 1));
+        assert_null(mods[2]);
+        assert_null(mods[3]);
+
+        ly_ctx_destroy(new_ctx, NULL);
+    }
+}
+
+static void
+test_ly_ctx_check_searchdirs(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *new_ctx;
+    char dir[] = "/tmp/libyang-searchdir-XXXXXX", path[64];
+    FILE *f;
+
+    assert_non_null(mkdtemp(dir));
+    new_ctx = ly_ctx_new(dir, LY_CTX_DISABLE_SEARCHDIR_CWD);
+    assert_non_null(new_ctx);
+    assert_null(ly_ctx_load_module(new_ctx, "d", NULL));
+
+    snprintf(path, sizeof path, "%s/d.yang", dir);
+    f = fopen(path, "w");
+    assert_non_null(f);
+    fputs("module d {namespace urn:d; prefix d; leaf l {type string;}}", f);
+    fclose(f);
+
+    /* the directory was already indexed */
+    assert_null(ly_ctx_load_module(new_ctx, "d", NULL));
+
+    ly_ctx_set_check_searchdirs(new_ctx);
+    assert_non_null(ly_ctx_load_module(new_ctx, "d", NULL));
+
+    ly_ctx_destroy(new_ctx, NULL);
+    unlink(path);
+    rmdir(dir);
+}
+
+struct frozen_parser {
+    const char *expected;
+    int fail;
+};
+
+static void *
+frozen_parser_thread(void *arg)
+{
+    struct frozen_parser *parser = (struct frozen_parser *)arg;
+    struct lyd_node *node;
+    char *str;
+    int i;
+
+    for (i = 0; i < 50; ++i) {
+        node = lyd_parse_path(ctx, TESTS_DIR"/api/files/a.xml", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+        if (!node || lyd_print_mem(&str, node, LYD_XML, LYP_WITHSIBLINGS)) {
+            parser->fail = 1;
+            lyd_free_withsiblings(node);
+            break;
+        }
+        if (strcmp(str, parser->expected)) {
+            parser->fail = 1;
+        }
+        free(str);
+        lyd_free_withsiblings(node);
+    }
+
+    return NULL;
+}
+
+static void
+test_ly_ctx_freeze(void **state)
+{
+    (void) state; /* unused */
+    struct frozen_parser parsers[4];
+    pthread_t threads[4];
+    const char *str1, *str2;
+    char *expected;
+    int i;
+
+    assert_int_equal(ly_ctx_is_frozen(ctx), 0);
+    assert_int_equal(ly_ctx_freeze(ctx), 0);
+    assert_int_equal(ly_ctx_is_frozen(ctx), 1);
+
+    /* the schemas cannot change */
+    assert_null(ly_ctx_load_module(ctx, "c", NULL));
+    assert_ptr_equal(ly_ctx_load_module(ctx, "b", NULL), module);
+    assert_null(lys_parse_path(ctx, TESTS_DIR"/api/files/c.yin", LYS_IN_YIN));
+    assert_int_not_equal(lys_features_enable(module, "*"), 0);
+    assert_int_not_equal(lys_set_disabled(module), 0);
+    assert_int_not_equal(ly_ctx_remove_module(module, NULL), 0);
+    assert_non_null(ly_ctx_get_module(ctx, "b", NULL, 1));
+
+    /* strings of the frozen dictionary are only looked up */
+    assert_ptr_equal(lydict_insert(ctx, module->name, 0), module->name);
+    lydict_remove(ctx, module->name);
+    assert_string_equal(module->name, "b");
+
+    /* new strings are still stored and freed */
+    str1 = lydict_insert(ctx, "frozen-ctx-new-string", 0);
+    str2 = lydict_insert(ctx, "frozen-ctx-new-string", 0);
+    assert_ptr_equal(str1, str2);
+    lydict_remove(ctx, str1);
+    lydict_remove(ctx, str2);
+
+    /* data can be parsed concurrently */
+    assert_int_equal(lyd_print_mem(&expected, root, LYD_XML, LYP_WITHSIBLINGS), 0);
+    for (i = 0; i < 4; ++i) {
+        parsers[i].expected = expected;
+        parsers[i].fail = 0;
+        assert_int_equal(pthread_create(&threads[i], NULL, frozen_parser_thread, &parsers[i]), 0);
+    }
+    for (i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        assert_int_equal(parsers[i].fail, 0);
+    }
+    free(expected);
+}
+
 static void
 test_ly_ctx_module_clb(void **state)
 {
@@ -1122,6 +1382,63 @@ test_ly_log_options(void **state)
     assert_null(i);
 }
 
+static void
+test_ly_log_deferred_path(void **state)
+{
+    (void)state;
+    const struct ly_err_item *i;
+    struct ly_ctx *new_ctx;
+    struct lyd_node *tree;
+    const char *mod = "module dp {yang-version 1.1; namespace urn:dp; prefix dp;"
+        "container c {leaf t {type string;} leaf r {type leafref {path ../t;}}"
+        "leaf u {type union {type leafref {path ../t;} type int8;}}}}";
+
+    new_ctx = ly_ctx_new(NULL, 0);
+    assert_non_null(new_ctx);
+    assert_non_null(lys_parse_mem(new_ctx, mod, LYS_IN_YANG));
+    ly_log_options(LY_LOSTORE);
+
+    /* error stored while resolving the unres data, the node is freed with the tree */
+    tree = lyd_parse_mem(new_ctx, "<c xmlns=\"urn:dp\"><t>x</t><r>y</r></c>", LYD_XML, LYD_OPT_CONFIG);
+    assert_null(tree);
+    assert_int_equal(ly_vecode(new_ctx), LYVE_NOLEAFREF);
+    assert_string_equal(ly_errpath(new_ctx), "/dp:c/r");
+    i = ly_err_first(new_ctx);
+    assert_non_null(i);
+    assert_ptr_equal(i->prev, i);
+    assert_string_equal(i->path, "/dp:c/r");
+    ly_err_clean(new_ctx, NULL);
+
+    /* the same error from validating a tree that is freed before reading it */
+    tree = lyd_parse_mem(new_ctx, "<c xmlns=\"urn:dp\"><t>x</t><r>y</r></c>", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_TRUSTED);
+    assert_non_null(tree);
+    assert_int_not_equal(lyd_validate(&tree, LYD_OPT_CONFIG, NULL), 0);
+    lyd_free_withsiblings(tree);
+    assert_string_equal(ly_errpath(new_ctx), "/dp:c/r");
+    i = ly_err_first(new_ctx);
+    assert_non_null(i);
+    assert_string_equal(i->prev->path, "/dp:c/r");
+    ly_err_clean(new_ctx, NULL);
+
+    /* errors of the union types tried before the matching one are discarded */
+    tree = lyd_parse_mem(new_ctx, "<c xmlns=\"urn:dp\"><t>x</t><u>5</u></c>", LYD_XML, LYD_OPT_CONFIG);
+    assert_non_null(tree);
+    assert_null(ly_err_first(new_ctx));
+    lyd_free_withsiblings(tree);
+
+    /* and only the final error is kept if none matches */
+    tree = lyd_parse_mem(new_ctx, "<c xmlns=\"urn:dp\"><t>x</t><u>y</u></c>", LYD_XML, LYD_OPT_CONFIG);
+    assert_null(tree);
+    i = ly_err_first(new_ctx);
+    assert_non_null(i);
+    assert_ptr_equal(i->prev, i);
+    assert_string_equal(i->path, "/dp:c/u");
+    ly_err_clean(new_ctx, NULL);
+
+    ly_log_options(LY_LOLOG | LY_LOSTORE_LAST);
+    ly_ctx_destroy(new_ctx, NULL);
+}
+
 static void
 test_ly_path_data2schema(void **state)
 {
@@ -1610,10 +1927,15 @@ int main(void)
         cmocka_unit_test(test_ly_ctx_set_searchdir_invalid),
         cmocka_unit_test_setup_teardown(test_ly_ctx_info, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_new_ylmem, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_new_image, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_clone, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_module_clb, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_get_module, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_get_module_older, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_load_module, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_load_modules, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_check_searchdirs, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_freeze, setup_f, teardown_f),
         cmocka_unit_test_teardown(test_ly_ctx_remove_module, teardown_f),
         cmocka_unit_test_teardown(test_ly_ctx_remove_module2, teardown_f),
         cmocka_unit_test_teardown(test_lys_set_enabled, teardown_f),
@@ -1632,6 +1954,7 @@ int main(void)
         cmocka_unit_test(test_ly_get_log_clb),
         cmocka_unit_test(test_ly_set_log_clb),
         cmocka_unit_test_setup_teardown(test_ly_log_options, setup_f, teardown_f),
+        cmocka_unit_test(test_ly_log_deferred_path),
         cmocka_unit_test_setup_teardown(test_ly_path_data2schema, setup_f, teardown_f),
         cmocka_unit_test(test_ly_get_loaded_plugins),
         cmocka_unit_test(test_ly_ctx_internal_modules_count),
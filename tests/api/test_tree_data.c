@@ -26,6 +26,7 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "tests/config.h"
 #include "libyang.h"
@@ -731,6 +732,96 @@ test_lyd_new_path(void **state)
     lyd_free_withsiblings(root);
 }
 
+static void
+test_lyd_new_path_compiled(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_path *xpath, *lpath, *rpath;
+    struct lyd_node *node, *match, *root;
+    const char *keys[2];
+
+    xpath = lyd_path_compile(ctx, "/a:x/number32", 0);
+    assert_non_null(xpath);
+    lpath = lyd_path_compile(ctx, "/a:l/value", 0);
+    assert_non_null(lpath);
+    rpath = lyd_path_compile(ctx, "/a:rpc1/rpc-container/output-leaf3", LYD_PATH_OPT_OUTPUT);
+    assert_non_null(rpath);
+
+    /* predicates and list keys are not allowed */
+    assert_null(lyd_path_compile(ctx, "/a:l[key1='1'][key2='2']/value", 0));
+    assert_null(lyd_path_compile(ctx, "/a:l/key1", 0));
+    assert_null(lyd_path_compile(ctx, "/a:x/number32/value", 0));
+    assert_null(lyd_path_compile(ctx, "/a:rpc1/rpc-container", 0));
+
+    root = lyd_new_path_compiled(NULL, xpath, NULL, "3", 0, 0);
+    assert_non_null(root);
+    assert_string_equal(root->schema->name, "x");
+    assert_string_equal(root->child->schema->name, "number32");
+
+    /* the leaf exists */
+    assert_null(lyd_new_path_compiled(root, xpath, NULL, "3", 0, 0));
+    assert_int_equal(ly_errno, LY_EVALID);
+    ly_errno = 0;
+
+    node = lyd_new_path_compiled(root, xpath, NULL, "4", 0, LYD_PATH_OPT_UPDATE);
+    assert_ptr_equal(node, root->child);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "4");
+
+    keys[0] = "1";
+    keys[1] = "2";
+    node = lyd_new_path_compiled(root, lpath, keys, "val", 0, 0);
+    assert_non_null(node);
+    assert_ptr_equal(node, root->next);
+    assert_string_equal(node->schema->name, "l");
+    assert_string_equal(node->child->schema->name, "key1");
+    assert_string_equal(node->child->next->schema->name, "key2");
+    assert_string_equal(node->child->next->next->schema->name, "value");
+
+    keys[1] = "3";
+    node = lyd_new_path_compiled(root, lpath, keys, "val2", 0, LYD_PATH_OPT_NOPARENTRET);
+    assert_non_null(node);
+    assert_string_equal(node->schema->name, "value");
+    assert_ptr_equal(node->parent, root->prev);
+
+    /* non-canonical key values find the same instance */
+    keys[0] = "+1";
+    keys[1] = "02";
+    assert_int_equal(lyd_find_path_compiled(root, lpath, keys, NULL, &match), 0);
+    assert_non_null(match);
+    assert_string_equal(((struct lyd_node_leaf_list *)match)->value_str, "val");
+
+    node = lyd_new_path_compiled(root, lpath, keys, "val3", 0, LYD_PATH_OPT_UPDATE);
+    assert_ptr_equal(node, match);
+    assert_string_equal(((struct lyd_node_leaf_list *)match)->value_str, "val3");
+
+    keys[1] = "4";
+    assert_int_equal(lyd_find_path_compiled(root, lpath, keys, NULL, &match), 0);
+    assert_null(match);
+
+    /* the parent must exist */
+    assert_null(lyd_new_path_compiled(root, lpath, keys, "val", 0, LYD_PATH_OPT_NOPARENT));
+    assert_int_equal(ly_errno, LY_EVALID);
+    ly_errno = 0;
+
+    keys[0] = "256";
+    assert_null(lyd_new_path_compiled(root, lpath, keys, "val", 0, 0));
+    ly_errno = 0;
+    assert_int_equal(lyd_find_path_compiled(root, xpath, NULL, NULL, &match), 0);
+    assert_ptr_equal(match, root->child);
+
+    lyd_free_withsiblings(root);
+
+    root = lyd_new_path_compiled(NULL, rpath, NULL, "cc", 0, 0);
+    assert_non_null(root);
+    assert_string_equal(root->schema->name, "rpc1");
+    assert_string_equal(root->child->child->schema->name, "output-leaf3");
+    lyd_free(root);
+
+    lyd_path_free(xpath);
+    lyd_path_free(lpath);
+    lyd_path_free(rpath);
+}
+
 static void
 test_lyd_dup(void **state)
 {
@@ -974,6 +1065,61 @@ test_lyd_schema_sort(void **state)
     lyd_free_withsiblings(root);
 }
 
+static void
+test_lyd_schema_order(void **state)
+{
+    (void) state; /* unused */
+    const struct lys_module *module;
+    struct lyd_node *root, *node;
+    const char *json = "{\"a:x\":{\"number64\":\"64\",\"bubba\":\"a\",\"bar-gggg\":\"b\"}}";
+
+    module = ly_ctx_get_module(ctx, "a", NULL, 0);
+    assert_non_null(module);
+    lys_features_enable(module, "bar");
+    ly_ctx_set_schema_order(ctx);
+
+    root = lyd_new(NULL, module, "x");
+    assert_non_null(root);
+    assert_non_null(lyd_new_leaf(root, NULL, "number64", "64"));
+    assert_non_null(lyd_new_leaf(root, NULL, "bubba", "a"));
+    assert_non_null(lyd_new_leaf(root, NULL, "number32", "32"));
+    assert_non_null(lyd_new_leaf(root, NULL, "bar-gggg", "b"));
+
+    node = lyd_new(NULL, module, "l");
+    assert_non_null(node);
+    assert_non_null(lyd_new_leaf(node, NULL, "key2", "2"));
+    assert_non_null(lyd_new_leaf(node, NULL, "key1", "1"));
+    assert_int_equal(lyd_insert_sibling(&root, node), 0);
+
+    /* created in the schema order */
+    assert_string_equal(root->schema->name, "x");
+    assert_string_equal(root->child->schema->name, "bar-gggg");
+    assert_string_equal(root->child->next->schema->name, "bubba");
+    assert_string_equal(root->child->next->next->schema->name, "number32");
+    assert_string_equal(root->child->next->next->next->schema->name, "number64");
+    assert_string_equal(root->next->schema->name, "l");
+    assert_string_equal(root->next->child->schema->name, "key1");
+    assert_string_equal(root->next->child->next->schema->name, "key2");
+
+    /* nothing to sort */
+    assert_int_equal(lyd_schema_sort(root, 1), 0);
+    assert_string_equal(root->child->schema->name, "bar-gggg");
+    lyd_free_withsiblings(root);
+
+    /* parsed in the schema order */
+    root = lyd_parse_mem(ctx, json, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_non_null(root);
+    /* implicit top-level defaults may precede x */
+    for (node = root; node && strcmp(node->schema->name, "x"); node = node->next);
+    assert_non_null(node);
+    assert_string_equal(node->child->schema->name, "bar-gggg");
+    assert_string_equal(node->child->next->schema->name, "bubba");
+    assert_string_equal(node->child->next->next->schema->name, "number64");
+    lyd_free_withsiblings(root);
+
+    ly_ctx_unset_schema_order(ctx);
+}
+
 static void
 test_lyd_find_path(void **state)
 {
@@ -1118,6 +1264,250 @@ test_lyd_find_sibling(void **state)
     lyd_free_withsiblings(data);
 }
 
+static void
+test_lyd_builder(void **state)
+{
+    struct ly_ctx *ctx = (struct ly_ctx *)*state;
+    const char *yang =
+    "module test {"
+        "namespace urn:test;"
+        "prefix t;"
+        "container cont {"
+            "leaf l {"
+                "type string;"
+                "default \"dflt\";"
+            "}"
+            "list lt {"
+                "key \"k1 k2\";"
+                "unique \"u\";"
+                "leaf k1 {"
+                    "type string;"
+                "}"
+                "leaf k2 {"
+                    "type uint8;"
+                "}"
+                "leaf u {"
+                    "type string;"
+                "}"
+            "}"
+        "}"
+    "}";
+    const struct lys_module *mod;
+    struct lyd_builder *builder;
+    struct lyd_node *cont, *node, *first, *match;
+    char buf[16];
+    int i;
+
+    mod = lys_parse_mem(ctx, yang, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    cont = lyd_new(NULL, mod, "cont");
+    assert_non_null(cont);
+    assert_int_equal(lyd_validate(&cont, LYD_OPT_CONFIG, NULL), 0);
+    assert_non_null(cont->child);
+    assert_int_equal(cont->child->dflt, 1);
+
+    builder = lyd_builder_new(cont);
+    assert_non_null(builder);
+
+    /* keys must be created first and in their order */
+    node = lyd_builder_add(builder, NULL, NULL, "lt");
+    assert_non_null(node);
+    assert_null(lyd_builder_add_leaf(builder, node, NULL, "k2", "0"));
+    assert_null(lyd_builder_add_leaf(builder, node, NULL, "u", "u0"));
+    assert_non_null(lyd_builder_add_leaf(builder, node, NULL, "k1", "a0"));
+    assert_non_null(lyd_builder_add_leaf(builder, node, NULL, "k2", "0"));
+    assert_non_null(lyd_builder_add_leaf(builder, node, NULL, "u", "u0"));
+
+    for (i = 1; i < 100; ++i) {
+        node = lyd_builder_add(builder, NULL, NULL, "lt");
+        assert_non_null(node);
+        sprintf(buf, "a%d", i);
+        assert_non_null(lyd_builder_add_leaf(builder, node, NULL, "k1", buf));
+        sprintf(buf, "%d", i);
+        assert_non_null(lyd_builder_add_leaf(builder, node, NULL, "k2", buf));
+    }
+    assert_non_null(lyd_builder_add_leaf(builder, NULL, NULL, "l", "val"));
+
+    first = lyd_builder_finish(builder);
+    assert_non_null(first);
+    assert_string_equal(first->schema->name, "lt");
+
+    /* the default leaf was replaced */
+    assert_ptr_equal(cont->child, first);
+    assert_string_equal(cont->child->prev->schema->name, "l");
+    assert_int_equal(cont->child->prev->dflt, 0);
+
+    /* the new instances are hashed */
+    assert_int_equal(lyd_find_sibling_val(cont->child, first->schema, "[k1='a42'][k2='42']", &match), 0);
+    assert_non_null(match);
+    assert_string_equal(((struct lyd_node_leaf_list *)match->child)->value_str, "a42");
+    assert_int_equal(lyd_find_sibling_val(cont->child, first->schema, "[k1='a42'][k2='43']", &match), 0);
+    assert_null(match);
+
+    /* a new instance with the same keys is a duplicate */
+    node = lyd_new(cont, NULL, "lt");
+    assert_non_null(lyd_new_leaf(node, NULL, "k1", "a99"));
+    assert_non_null(lyd_new_leaf(node, NULL, "k2", "99"));
+    assert_int_not_equal(lyd_validate(&cont, LYD_OPT_CONFIG, NULL), 0);
+    lyd_free(node);
+
+    assert_int_equal(lyd_validate(&cont, LYD_OPT_CONFIG, NULL), 0);
+    lyd_free_withsiblings(cont);
+}
+
+struct snapshot_reader {
+    struct lyd_snapshot_head *head;
+    int fail;
+};
+
+static void *
+snapshot_reader_thread(void *arg)
+{
+    struct snapshot_reader *reader = (struct snapshot_reader *)arg;
+    struct lyd_snapshot *snapshot;
+    struct ly_set *set;
+    char *str;
+    uint32_t count;
+    int i;
+
+    for (i = 0; i < 200; ++i) {
+        snapshot = lyd_snapshot_get(reader->head);
+        if (!snapshot) {
+            reader->fail = 1;
+            break;
+        }
+
+        /* the number of list instances is always written in the leaf */
+        set = lyd_find_path(lyd_snapshot_tree(snapshot), "/test:cont/lt");
+        count = set ? set->number : 0;
+        ly_set_free(set);
+        set = lyd_find_path(lyd_snapshot_tree(snapshot), "/test:cont/l");
+        if (!set || (set->number != 1) || (atoi(((struct lyd_node_leaf_list *)set->set.d[0])->value_str) != (signed)count)) {
+            reader->fail = 1;
+        }
+        ly_set_free(set);
+
+        if (lyd_print_mem(&str, lyd_snapshot_tree(snapshot), LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL)) {
+            reader->fail = 1;
+        }
+        free(str);
+
+        lyd_snapshot_free(snapshot);
+    }
+
+    return NULL;
+}
+
+static void
+test_lyd_snapshot(void **state)
+{
+    struct ly_ctx *ctx = (struct ly_ctx *)*state;
+    const char *yang =
+    "module test {"
+        "namespace urn:test;"
+        "prefix t;"
+        "container cont {"
+            "leaf l {"
+                "type uint32;"
+            "}"
+            "leaf d {"
+                "type string;"
+                "default \"dflt\";"
+            "}"
+            "list lt {"
+                "key \"k\";"
+                "leaf k {"
+                    "type uint32;"
+                "}"
+            "}"
+        "}"
+    "}";
+    const struct lys_module *mod;
+    struct lyd_snapshot_head *head;
+    struct lyd_snapshot *snapshot, *snapshot2;
+    struct snapshot_reader readers[4];
+    pthread_t threads[4];
+    struct lyd_node *tree;
+    struct ly_set *set;
+    char path[32];
+    int i;
+
+    mod = lys_parse_mem(ctx, yang, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    /* empty snapshot */
+    snapshot = lyd_snapshot_new(NULL);
+    assert_non_null(snapshot);
+    assert_null(lyd_snapshot_tree(snapshot));
+    lyd_snapshot_free(snapshot);
+
+    tree = lyd_new_path(NULL, ctx, "/test:cont/l", "0", 0, 0);
+    assert_non_null(tree);
+    assert_int_equal(lyd_validate(&tree, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT, NULL), 0);
+    assert_int_equal(tree->lazy_dflt, 1);
+
+    /* only a nested node cannot be used */
+    assert_null(lyd_snapshot_new(tree->child));
+
+    /* lazy defaults are created in the snapshot, not in the tree */
+    snapshot = lyd_snapshot_new(tree);
+    assert_non_null(snapshot);
+    assert_ptr_not_equal(lyd_snapshot_tree(snapshot), tree);
+    assert_int_equal(lyd_snapshot_tree(snapshot)->lazy_dflt, 0);
+    assert_int_equal(tree->lazy_dflt, 1);
+    set = lyd_find_path(lyd_snapshot_tree(snapshot), "/test:cont/d");
+    assert_non_null(set);
+    assert_int_equal(set->number, 1);
+    ly_set_free(set);
+
+    /* later changes of the tree are not visible */
+    assert_non_null(lyd_new_path(tree, NULL, "/test:cont/lt[k='0']", NULL, 0, 0));
+    set = lyd_find_path(lyd_snapshot_tree(snapshot), "/test:cont/lt");
+    assert_non_null(set);
+    assert_int_equal(set->number, 0);
+    ly_set_free(set);
+    lyd_free(tree->child->prev);
+
+    /* publishing, the previous snapshot survives while referenced */
+    head = lyd_snapshot_head_new();
+    assert_non_null(head);
+    assert_null(lyd_snapshot_get(head));
+    lyd_snapshot_publish(head, snapshot);
+    snapshot2 = lyd_snapshot_get(head);
+    assert_ptr_equal(snapshot2, snapshot);
+    lyd_snapshot_publish(head, lyd_snapshot_new(tree));
+    set = lyd_find_path(lyd_snapshot_tree(snapshot2), "/test:cont/d");
+    assert_non_null(set);
+    assert_int_equal(set->number, 1);
+    ly_set_free(set);
+    snapshot = lyd_snapshot_get(head);
+    assert_ptr_not_equal(snapshot, snapshot2);
+    lyd_snapshot_free(snapshot);
+    lyd_snapshot_free(snapshot2);
+
+    /* concurrent readers of the snapshots published by a writer */
+    for (i = 0; i < 4; ++i) {
+        readers[i].head = head;
+        readers[i].fail = 0;
+        assert_int_equal(pthread_create(&threads[i], NULL, snapshot_reader_thread, &readers[i]), 0);
+    }
+    for (i = 1; i <= 200; ++i) {
+        sprintf(path, "/test:cont/lt[k='%d']", i);
+        assert_non_null(lyd_new_path(tree, NULL, path, NULL, 0, 0));
+        sprintf(path, "%d", i);
+        assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)tree->child, path), 0);
+        lyd_snapshot_publish(head, lyd_snapshot_new(tree));
+    }
+    for (i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        assert_int_equal(readers[i].fail, 0);
+    }
+
+    lyd_snapshot_head_free(head);
+    lyd_free_withsiblings(tree);
+}
+
 static void
 test_lyd_validate(void **state)
 {
@@ -2032,15 +2422,19 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyd_change_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_output_new_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_path, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_new_path_compiled, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_dup, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert_sibling, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert_before, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert_after, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_schema_sort, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_schema_order, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_find_path, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_find_instance, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_find_sibling, setup_f2, teardown_f2),
+        cmocka_unit_test_setup_teardown(test_lyd_builder, setup_f2, teardown_f2),
+        cmocka_unit_test_setup_teardown(test_lyd_snapshot, setup_f2, teardown_f2),
         cmocka_unit_test_setup_teardown(test_lyd_validate, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_unlink, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_free, setup_f, teardown_f),
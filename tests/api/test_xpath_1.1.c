@@ -46,6 +46,18 @@ static const char *data2 =
 "</top>"
 ;
 
+static const char *data3 =
+"<top xmlns=\"urn:xpath-1.1\">"
+    "<identref>ident3</identref>"
+"</top>"
+;
+
+static const char *data4 =
+"<top xmlns=\"urn:xpath-1.1\">"
+    "<identref>ident5</identref>"
+"</top>"
+;
+
 static int
 setup_f(void **state)
 {
@@ -179,6 +191,49 @@ test_func_derived_from4(void **state)
     assert_int_equal(st->set->number, 0);
 }
 
+static void
+test_func_derived_from5(void **state)
+{
+    struct state *st = (*state);
+
+    st->dt = lyd_parse_mem(st->ctx, data3, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident1')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+}
+
+static void
+test_func_derived_from6(void **state)
+{
+    struct state *st = (*state);
+    const char *bases[] = {"ident1", "ident2", "ident3", "ident4"};
+    char path[128];
+    unsigned int i;
+
+    /* ident5 is derived from ident1 along two paths */
+    st->dt = lyd_parse_mem(st->ctx, data4, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    for (i = 0; i < sizeof bases / sizeof *bases; ++i) {
+        sprintf(path, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:%s')]", bases[i]);
+        st->set = lyd_find_path(st->dt, path);
+        assert_ptr_not_equal(st->set, NULL);
+        assert_int_equal(st->set->number, 1);
+        ly_set_free(st->set);
+    }
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident5')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 0);
+    ly_set_free(st->set);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from-or-self(., 'xpath-1.1:ident5')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+}
+
 static void
 test_func_derived_from_or_self1(void **state)
 {
@@ -293,6 +348,8 @@ main(void)
         cmocka_unit_test_setup_teardown(test_func_derived_from2, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from3, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from4, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_func_derived_from5, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_func_derived_from6, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self1, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self2, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self3, setup_f, teardown_f),
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <valgrind/callgrind.h>
+
+#include "libyang.h"
+#include "tests/config.h"
+
+#define SCHEMA TESTS_DIR "/callgrind/files/ietf-interfaces.yang"
+#define SCHEMA2 TESTS_DIR "/callgrind/files/iana-if-type.yang"
+
+#define IF_COUNT 5000
+
+/* mostly plain values, some long, some with characters to escape */
+static void
+gen_description(char *buf, int i)
+{
+    switch (i % 10) {
+    case 0:
+        sprintf(buf, "Uplink to core router <cr%d> via patch panel 7 & 8, port %d, do not disconnect "
+                "without notifying the network operations center, see ticket \"NOC-%d\" for details", i, i % 48, i);
+        break;
+    case 1:
+    case 2:
+    case 3:
+        sprintf(buf, "Trunk port %d carrying the management, voice and guest VLANs of building B, floor %d, "
+                "the allowed VLAN list is maintained by the automation and must not be changed manually", i, i % 5);
+        break;
+    default:
+        sprintf(buf, "Access port %d in building B, floor %d", i, i % 5);
+        break;
+    }
+}
+
+static int
+gen_data(struct ly_ctx *ctx, struct lyd_node **data)
+{
+    int i;
+    char path[128], desc[512];
+    struct lyd_node *node;
+
+    for (i = 0; i < IF_COUNT; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces/interface[name='eth%d']/description", i);
+        gen_description(desc, i);
+        node = lyd_new_path(*data, ctx, path, desc, 0, 0);
+        if (!node) {
+            return 1;
+        }
+        if (!*data) {
+            *data = node;
+        }
+
+        sprintf(path, "/ietf-interfaces:interfaces/interface[name='eth%d']/type", i);
+        if (!lyd_new_path(*data, ctx, path, "iana-if-type:ethernetCsmacd", 0, 0)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int
+main(void)
+{
+    int ret = 0;
+    struct ly_ctx *ctx = NULL;
+    struct lyd_node *data = NULL, *xml_data = NULL, *json_data = NULL;
+    char *xml = NULL, *json = NULL;
+
+    ctx = ly_ctx_new(NULL, 0);
+    if (!ctx) {
+        ret = 1;
+        goto finish;
+    }
+
+    if (!lys_parse_path(ctx, SCHEMA, LYS_YANG) || !lys_parse_path(ctx, SCHEMA2, LYS_YANG)) {
+        ret = 1;
+        goto finish;
+    }
+
+    if (gen_data(ctx, &data)) {
+        ret = 1;
+        goto finish;
+    }
+
+    if (lyd_print_mem(&xml, data, LYD_XML, LYP_WITHSIBLINGS | LYP_FORMAT)
+            || lyd_print_mem(&json, data, LYD_JSON, LYP_WITHSIBLINGS | LYP_FORMAT)) {
+        ret = 1;
+        goto finish;
+    }
+
+    CALLGRIND_START_INSTRUMENTATION;
+    xml_data = lyd_parse_mem(ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_TRUSTED);
+    json_data = lyd_parse_mem(ctx, json, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_TRUSTED);
+    CALLGRIND_STOP_INSTRUMENTATION;
+
+    if (!xml_data || !json_data) {
+        ret = 1;
+    }
+
+finish:
+    free(xml);
+    free(json);
+    lyd_free_withsiblings(data);
+    lyd_free_withsiblings(xml_data);
+    lyd_free_withsiblings(json_data);
+    ly_ctx_destroy(ctx, NULL);
+    return ret;
+}
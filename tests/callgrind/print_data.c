@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <valgrind/callgrind.h>
+
+#include "libyang.h"
+#include "tests/config.h"
+
+#define SCHEMA TESTS_DIR "/callgrind/files/ietf-interfaces.yang"
+#define SCHEMA2 TESTS_DIR "/callgrind/files/iana-if-type.yang"
+
+#define IF_COUNT 2000
+
+/* mostly plain short values, some with characters to escape, some long ones */
+static void
+gen_description(char *buf, int i)
+{
+    switch (i % 10) {
+    case 0:
+        sprintf(buf, "Uplink to core router <cr%d> via patch panel 7 & 8, port %d, do not disconnect "
+                "without notifying the network operations center, see ticket \"NOC-%d\" for details", i, i % 48, i);
+        break;
+    case 1:
+    case 2:
+        sprintf(buf, "Customer \"ACME-%d\" & partners", i);
+        break;
+    default:
+        sprintf(buf, "Access port %d in building B, floor %d", i, i % 5);
+        break;
+    }
+}
+
+int
+main(void)
+{
+    int ret = 0, i, fd = -1;
+    struct ly_ctx *ctx = NULL;
+    struct lyd_node *data = NULL, *node;
+    char path[128], desc[512], *str = NULL;
+
+    ctx = ly_ctx_new(NULL, 0);
+    if (!ctx) {
+        ret = 1;
+        goto finish;
+    }
+
+    if (!lys_parse_path(ctx, SCHEMA, LYS_YANG) || !lys_parse_path(ctx, SCHEMA2, LYS_YANG)) {
+        ret = 1;
+        goto finish;
+    }
+
+    for (i = 0; i < IF_COUNT; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces/interface[name='eth%d']/description", i);
+        gen_description(desc, i);
+        node = lyd_new_path(data, ctx, path, desc, 0, 0);
+        if (!node) {
+            ret = 1;
+            goto finish;
+        }
+        if (!data) {
+            data = node;
+        }
+    }
+
+    fd = open("/dev/null", O_WRONLY);
+    if (fd == -1) {
+        ret = 1;
+        goto finish;
+    }
+
+    CALLGRIND_START_INSTRUMENTATION;
+    if (lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS)) {
+        ret = 1;
+        goto finish;
+    }
+    free(str);
+    str = NULL;
+
+    if (lyd_print_mem(&str, data, LYD_JSON, LYP_WITHSIBLINGS)) {
+        ret = 1;
+        goto finish;
+    }
+
+    if (lyd_print_fd(fd, data, LYD_XML, LYP_WITHSIBLINGS) || lyd_print_fd(fd, data, LYD_JSON, LYP_WITHSIBLINGS)) {
+        ret = 1;
+        goto finish;
+    }
+    CALLGRIND_STOP_INSTRUMENTATION;
+
+finish:
+    if (fd != -1) {
+        close(fd);
+    }
+    free(str);
+    lyd_free_withsiblings(data);
+    ly_ctx_destroy(ctx, NULL);
+    return ret;
+}
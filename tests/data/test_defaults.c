@@ -673,6 +673,289 @@ test_leaflist_yang(void **state)
     assert_string_equal(st->xml, xml_three);
 }
 
+static void
+test_augment_dflt(void **state)
+{
+    struct state *st = (*state);
+    const char *yang_a = "module a {"
+"  namespace \"urn:a\";"
+"  prefix a;"
+"  container p {"
+"    presence \"p\";"
+"    leaf k {"
+"      type string;"
+"    }"
+"  }}";
+    const char *yang_b = "module b {"
+"  namespace \"urn:b\";"
+"  prefix b;"
+"  import a {"
+"    prefix a;"
+"  }"
+"  augment /a:p {"
+"    leaf d {"
+"      type string;"
+"      default \"dflt\";"
+"    }"
+"  }}";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang_a, LYS_IN_YANG), NULL);
+
+    /* nothing to add into the presence container */
+    assert_ptr_not_equal(st->dt = lyd_new_path(NULL, st->ctx, "/a:p", NULL, 0, 0), NULL);
+    assert_int_equal(lyd_validate(&(st->dt), LYD_OPT_CONFIG, st->ctx), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, "<p xmlns=\"urn:a\"/>");
+    free(st->xml);
+    st->xml = NULL;
+    lyd_free_withsiblings(st->dt);
+
+    /* the augment brings a default value into the (previously skipped) subtree */
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang_b, LYS_IN_YANG), NULL);
+
+    assert_ptr_not_equal(st->dt = lyd_new_path(NULL, st->ctx, "/a:p", NULL, 0, 0), NULL);
+    assert_int_equal(lyd_validate(&(st->dt), LYD_OPT_CONFIG, st->ctx), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, "<p xmlns=\"urn:a\"><d xmlns=\"urn:b\">dflt</d></p>");
+}
+
+static void
+test_lazy_dflt(void **state)
+{
+    struct state *st = (*state);
+    struct ly_set *set;
+    const char *yang = "module lz {"
+"  namespace \"urn:lz\";"
+"  prefix lz;"
+"  container c {"
+"    leaf a {"
+"      type string;"
+"      default \"x\";"
+"    }"
+"    leaf b {"
+"      type uint8;"
+"      default 5;"
+"    }"
+"    leaf m {"
+"      type string;"
+"      must \"../b > 1\";"
+"      default \"m\";"
+"    }"
+"    list l {"
+"      key k;"
+"      leaf k {"
+"        type string;"
+"      }"
+"      leaf v {"
+"        type string;"
+"        default \"v\";"
+"      }"
+"    }"
+"  }}";
+    const char *xml = "<c xmlns=\"urn:lz\"><b>7</b><l><k>1</k></l></c>";
+    const char *xml_all = "<c xmlns=\"urn:lz\"><b>7</b><l><k>1</k><v>v</v></l><m>m</m><a>x</a></c>";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang, LYS_IN_YANG), NULL);
+
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* only the leaf with must was instantiated */
+    assert_int_equal(st->dt->lazy_dflt, 1);
+    assert_string_equal(st->dt->child->prev->schema->name, "m");
+    assert_int_equal(st->dt->child->next->lazy_dflt, 1);
+
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_string_equal(st->xml, xml);
+    free(st->xml);
+    st->xml = NULL;
+
+    /* printing resolves the defaults without changing the tree */
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_all);
+    free(st->xml);
+    st->xml = NULL;
+    assert_int_equal(st->dt->lazy_dflt, 1);
+
+    /* XPath instantiates them */
+    set = lyd_find_path(st->dt, "/lz:c/lz:a");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    assert_int_equal(set->set.d[0]->dflt, 1);
+    assert_string_equal(((struct lyd_node_leaf_list *)set->set.d[0])->value_str, "x");
+    ly_set_free(set);
+    assert_string_equal(st->dt->child->prev->schema->name, "a");
+    assert_int_equal(st->dt->lazy_dflt, 1);
+    assert_int_equal(st->dt->child->next->lazy_dflt, 1);
+
+    set = lyd_find_path(st->dt, "//lz:v");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    ly_set_free(set);
+    assert_int_equal(st->dt->lazy_dflt, 0);
+    assert_int_equal(st->dt->child->next->lazy_dflt, 0);
+
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_all);
+    free(st->xml);
+    st->xml = NULL;
+    lyd_free_withsiblings(st->dt);
+
+    /* explicit instantiation gives the same tree as without the option */
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(lyd_wd_materialize(st->dt), 0);
+    assert_int_equal(st->dt->lazy_dflt, 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_all);
+}
+
+static void
+test_lazy_dflt_find(void **state)
+{
+    struct state *st = (*state);
+    struct ly_set *set;
+    const struct lys_node *schema;
+    struct lyd_node *match, *iter;
+    int count;
+    const char *yang = "module lz {"
+"  namespace \"urn:lz\";"
+"  prefix lz;"
+"  container c {"
+"    leaf a {"
+"      type string;"
+"      default \"x\";"
+"    }"
+"    leaf b {"
+"      type uint8;"
+"      default 5;"
+"    }"
+"  }}";
+    const char *xml = "<c xmlns=\"urn:lz\"><b>7</b></c>";
+    const char *yang_hash = "module lzh {"
+"  namespace \"urn:lzh\";"
+"  prefix lzh;"
+"  container h {"
+"    leaf p { type string; default \"p\"; }"
+"    leaf q { type string; default \"q\"; }"
+"    leaf r { type string; default \"r\"; }"
+"    leaf s { type string; default \"s\"; }"
+"    leaf t { type string; default \"t\"; }"
+"  }}";
+    const char *xml_hash = "<h xmlns=\"urn:lzh\"><p>1</p><q>2</q><r>3</r><s>4</s></h>";
+    const char *xml_hash_all = "<h xmlns=\"urn:lzh\"><p>1</p><q>2</q><r>3</r><s>4</s><t>t</t></h>";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang, LYS_IN_YANG), NULL);
+    schema = ly_ctx_get_node(st->ctx, NULL, "/lz:c/lz:a", 0);
+    assert_ptr_not_equal(schema, NULL);
+
+    /* searching siblings instantiates the default */
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(st->dt->lazy_dflt, 1);
+    assert_int_equal(lyd_find_sibling_val(st->dt->child, schema, NULL, &match), 0);
+    assert_ptr_not_equal(match, NULL);
+    assert_int_equal(match->dflt, 1);
+    assert_string_equal(((struct lyd_node_leaf_list *)match)->value_str, "x");
+
+    /* only once */
+    assert_int_equal(lyd_find_sibling_set(st->dt->child, match, &set), 0);
+    assert_int_equal(set->number, 1);
+    assert_ptr_equal(set->set.d[0], match);
+    ly_set_free(set);
+    lyd_free_withsiblings(st->dt);
+
+    /* a materialized tree is not modified by searching it */
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(lyd_wd_materialize(st->dt), 0);
+    count = 0;
+    LY_TREE_FOR(st->dt->child, iter) {
+        ++count;
+    }
+    assert_int_equal(count, 2);
+
+    set = lyd_find_path(st->dt, "//*");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 3);
+    ly_set_free(set);
+    assert_int_equal(lyd_find_sibling_val(st->dt->child, schema, NULL, &match), 0);
+    assert_ptr_not_equal(match, NULL);
+    LY_TREE_FOR(st->dt->child, iter) {
+        --count;
+    }
+    assert_int_equal(count, 0);
+    lyd_free_withsiblings(st->dt);
+
+    /* explicit values among enough siblings to be hashed are kept */
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang_hash, LYS_IN_YANG), NULL);
+    st->dt = lyd_parse_mem(st->ctx, xml_hash, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(st->dt->lazy_dflt, 1);
+    assert_int_equal(lyd_wd_materialize(st->dt), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_hash_all);
+}
+
+static void
+test_lazy_dflt_diff(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *eager;
+    struct lyd_difflist *diff;
+    const char *yang = "module lz {"
+"  namespace \"urn:lz\";"
+"  prefix lz;"
+"  container c {"
+"    leaf a {"
+"      type string;"
+"      default \"x\";"
+"    }"
+"    leaf b {"
+"      type uint8;"
+"      default 5;"
+"    }"
+"    list l {"
+"      key k;"
+"      leaf k {"
+"        type string;"
+"      }"
+"      leaf d {"
+"        type string;"
+"        default \"d\";"
+"      }"
+"    }"
+"  }}";
+    const char *xml = "<c xmlns=\"urn:lz\"><b>7</b><l><k>1</k></l></c>";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang, LYS_IN_YANG), NULL);
+
+    eager = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(eager, NULL);
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(st->dt->lazy_dflt, 1);
+
+    /* the defaults not instantiated yet are compared as well */
+    diff = lyd_diff(st->dt, eager, LYD_DIFFOPT_WITHDEFAULTS);
+    assert_ptr_not_equal(diff, NULL);
+    assert_int_equal(diff->type[0], LYD_DIFF_END);
+    lyd_free_diff(diff);
+    assert_int_equal(st->dt->lazy_dflt, 0);
+    assert_int_equal(st->dt->child->next->lazy_dflt, 0);
+    lyd_free_withsiblings(st->dt);
+
+    /* only the subtree */
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_LAZY_DFLT);
+    assert_ptr_not_equal(st->dt, NULL);
+    diff = lyd_diff(eager, st->dt, LYD_DIFFOPT_WITHDEFAULTS | LYD_DIFFOPT_NOSIBLINGS);
+    assert_ptr_not_equal(diff, NULL);
+    assert_int_equal(diff->type[0], LYD_DIFF_END);
+    lyd_free_diff(diff);
+
+    lyd_free_withsiblings(eager);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -693,7 +976,11 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_feature, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_leaflist_in10, setup_clean_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_leaflist_yang, setup_clean_f, teardown_f),
-                    cmocka_unit_test_setup_teardown(test_leaflist_yin, setup_clean_f, teardown_f), };
+                    cmocka_unit_test_setup_teardown(test_leaflist_yin, setup_clean_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_augment_dflt, setup_clean_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_lazy_dflt, setup_clean_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_lazy_dflt_find, setup_clean_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_lazy_dflt_diff, setup_clean_f, teardown_f), };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,387 @@
+/**
+ * @file test_flat.c
+ * @brief Cmocka tests for flat data tree images.
+ *
+ * Copyright (c) 2018 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+#define ITEM_COUNT 20
+
+static const char *base_yang =
+    "module flat-base {"
+    "  namespace urn:flat-base;"
+    "  prefix fb;"
+    "  identity base;"
+    "  identity foreign { base base; }"
+    "}";
+
+static const char *flat_yang =
+    "module flat {"
+    "  yang-version 1.1;"
+    "  namespace urn:flat;"
+    "  prefix f;"
+    "  import ietf-yang-types { prefix yang; }"
+    "  import flat-base { prefix fb; }"
+    "  identity own { base fb:base; }"
+    "  container top {"
+    "    list item {"
+    "      key \"name idx\";"
+    "      leaf name { type string; }"
+    "      leaf idx { type uint8; }"
+    "      leaf val { type string; }"
+    "      leaf-list tag { type string; }"
+    "    }"
+    "    leaf-list num { type int32; ordered-by user; }"
+    "    leaf ref { type instance-identifier; }"
+    "    leaf xp { type yang:xpath1.0; }"
+    "    leaf own-id { type identityref { base fb:base; } }"
+    "    leaf foreign-id { type identityref { base fb:base; } }"
+    "    leaf flag { type empty; }"
+    "    leaf text { type string; }"
+    "    leaf dflt { type string; default \"d\"; }"
+    "    choice ch { case a { leaf ca { type string; } } }"
+    "    container pres { presence \"p\"; }"
+    "  }"
+    "  leaf top-leaf { type string; }"
+    "}";
+
+static const char *aug_yang =
+    "module flat-aug {"
+    "  namespace urn:flat-aug;"
+    "  prefix fa;"
+    "  import flat { prefix f; }"
+    "  augment /f:top { leaf aug { type string; } }"
+    "}";
+
+struct state {
+    struct ly_ctx *ctx;
+    struct lyd_node *dt;
+    void *image;
+    size_t size;
+    struct lyd_flat *flat;
+    char *str1;
+    char *str2;
+};
+
+static struct ly_ctx *
+flat_ctx_new(void)
+{
+    struct ly_ctx *ctx;
+
+    ctx = ly_ctx_new(TESTS_DIR"/data/files", 0);
+    if (!ctx) {
+        return NULL;
+    }
+    if (!lys_parse_mem(ctx, base_yang, LYS_IN_YANG) || !lys_parse_mem(ctx, flat_yang, LYS_IN_YANG)
+            || !lys_parse_mem(ctx, aug_yang, LYS_IN_YANG) || !ly_ctx_load_module(ctx, "types", NULL)) {
+        ly_ctx_destroy(ctx, NULL);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+    char *data, *p;
+    int i;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    st->ctx = flat_ctx_new();
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    data = malloc(8192);
+    if (!data) {
+        goto error;
+    }
+    p = data;
+    p += sprintf(p, "<top xmlns=\"urn:flat\">");
+    for (i = 0; i < ITEM_COUNT; ++i) {
+        p += sprintf(p, "<item><name>item%d</name><idx>%d</idx><val>v%d</val><tag>a</tag><tag>b%d</tag></item>",
+                     i % 7, i, i, i);
+    }
+    p += sprintf(p, "<num>3</num><num>1</num><num>2</num>"
+                 "<ref xmlns:f=\"urn:flat\">/f:top/f:item[f:name='item1'][f:idx='1']/f:val</ref>"
+                 "<xp xmlns:f=\"urn:flat\">/f:top/f:text</xp>"
+                 "<own-id>own</own-id>"
+                 "<foreign-id xmlns:fb=\"urn:flat-base\">fb:foreign</foreign-id>"
+                 "<flag/><text>&lt;&amp;\"tab\t\"&gt;</text><ca>c</ca><pres/>"
+                 "<aug xmlns=\"urn:flat-aug\">aug</aug>"
+                 "</top>"
+                 "<top-leaf xmlns=\"urn:flat\">t</top-leaf>");
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    if (!st->dt) {
+        fprintf(stderr, "Failed to parse data.\n");
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    lyd_flat_close(st->flat);
+    free(st->image);
+    lyd_free_withsiblings(st->dt);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st->str1);
+    free(st->str2);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+static void
+check_print(struct state *st, struct lyd_node *dt, int write_options)
+{
+    const LYD_FORMAT formats[] = {LYD_XML, LYD_JSON};
+    const int options[] = {0, LYP_FORMAT};
+    unsigned int i, j;
+
+    free(st->image);
+    st->image = NULL;
+    lyd_flat_close(st->flat);
+    assert_int_equal(lyd_flat_write_mem(&st->image, &st->size, dt, write_options), 0);
+    st->flat = lyd_flat_open(st->ctx, st->image, st->size);
+    assert_non_null(st->flat);
+
+    for (i = 0; i < sizeof formats / sizeof *formats; ++i) {
+        for (j = 0; j < sizeof options / sizeof *options; ++j) {
+            assert_int_equal(lyd_print_mem(&st->str1, dt, formats[i], LYP_WITHSIBLINGS | write_options | options[j]), 0);
+            assert_int_equal(lyd_flat_print_mem(&st->str2, st->flat, formats[i], options[j]), 0);
+            assert_string_equal(st->str1, st->str2);
+            free(st->str1);
+            free(st->str2);
+            st->str1 = st->str2 = NULL;
+        }
+    }
+}
+
+static void
+test_print(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *types;
+
+    check_print(st, st->dt, 0);
+    check_print(st, st->dt, LYP_WD_ALL);
+    check_print(st, st->dt, LYP_WD_TRIM);
+
+    /* all the types */
+    types = lyd_parse_path(st->ctx, TESTS_DIR"/data/files/types.xml", LYD_XML, LYD_OPT_CONFIG);
+    assert_non_null(types);
+    check_print(st, types, 0);
+    lyd_free_withsiblings(types);
+
+    /* no data */
+    check_print(st, NULL, 0);
+}
+
+static void
+test_navigation(void **state)
+{
+    struct state *st = (*state);
+    const struct lyd_flat_node *top, *node, *last = NULL;
+    const struct lyd_node *iter;
+    int count = 0;
+
+    assert_int_equal(lyd_flat_write_mem(&st->image, &st->size, st->dt, LYP_WD_ALL), 0);
+    st->flat = lyd_flat_open(st->ctx, st->image, st->size);
+    assert_non_null(st->flat);
+
+    top = lyd_flat_first(st->flat);
+    assert_non_null(top);
+    assert_ptr_equal(lyd_flat_schema(st->flat, top), st->dt->schema);
+    assert_null(lyd_flat_parent(st->flat, top));
+    assert_null(lyd_flat_value(st->flat, top));
+
+    node = lyd_flat_next(st->flat, top);
+    assert_non_null(node);
+    assert_string_equal(lyd_flat_schema(st->flat, node)->name, "top-leaf");
+    assert_string_equal(lyd_flat_value(st->flat, node), "t");
+    assert_null(lyd_flat_next(st->flat, node));
+
+    /* the children are in the same order as in the data tree */
+    for (node = lyd_flat_child(st->flat, top), iter = st->dt->child; node;
+            node = lyd_flat_next(st->flat, node), iter = iter->next) {
+        assert_non_null(iter);
+        assert_ptr_equal(lyd_flat_schema(st->flat, node), iter->schema);
+        assert_ptr_equal(lyd_flat_parent(st->flat, node), top);
+        assert_int_equal(lyd_flat_dflt(st->flat, node), iter->dflt);
+        last = node;
+        ++count;
+    }
+    assert_null(iter);
+    assert_int_equal(count, ITEM_COUNT + 13);
+
+    /* augment and choice children are resolved */
+    assert_string_equal(lyd_flat_schema(st->flat, last)->name, "dflt");
+    assert_int_equal(lyd_flat_dflt(st->flat, last), 1);
+}
+
+static void
+test_find(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_path *path;
+    const struct lyd_flat_node *match;
+    const char *keys[2];
+    char name[16], idx[16];
+    int i;
+
+    assert_int_equal(lyd_flat_write_mem(&st->image, &st->size, st->dt, 0), 0);
+    st->flat = lyd_flat_open(st->ctx, st->image, st->size);
+    assert_non_null(st->flat);
+
+    /* list instances, found through the index of the many children of top */
+    path = lyd_path_compile(st->ctx, "/flat:top/item/val", 0);
+    assert_non_null(path);
+    keys[0] = name;
+    keys[1] = idx;
+    for (i = 0; i < ITEM_COUNT; ++i) {
+        sprintf(name, "item%d", i % 7);
+        sprintf(idx, "%d", i);
+        assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, keys, NULL, &match), 0);
+        assert_non_null(match);
+        sprintf(name, "v%d", i);
+        assert_string_equal(lyd_flat_value(st->flat, match), name);
+    }
+    keys[0] = "item1";
+    keys[1] = "2";
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, keys, NULL, &match), 0);
+    assert_null(match);
+    lyd_path_free(path);
+
+    /* leaf-list instances */
+    path = lyd_path_compile(st->ctx, "/flat:top/item/tag", 0);
+    assert_non_null(path);
+    keys[0] = "item5";
+    keys[1] = "12";
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, keys, "b12", &match), 0);
+    assert_non_null(match);
+    assert_string_equal(lyd_flat_value(st->flat, match), "b12");
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, keys, "b11", &match), 0);
+    assert_null(match);
+    lyd_path_free(path);
+
+    /* canonical value */
+    path = lyd_path_compile(st->ctx, "/flat:top/num", 0);
+    assert_non_null(path);
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, NULL, "+02", &match), 0);
+    assert_non_null(match);
+    assert_string_equal(lyd_flat_value(st->flat, match), "2");
+    lyd_path_free(path);
+
+    /* augment and top-level nodes */
+    path = lyd_path_compile(st->ctx, "/flat:top/flat-aug:aug", 0);
+    assert_non_null(path);
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, NULL, NULL, &match), 0);
+    assert_non_null(match);
+    assert_string_equal(lyd_flat_value(st->flat, match), "aug");
+    lyd_path_free(path);
+
+    path = lyd_path_compile(st->ctx, "/flat:top-leaf", 0);
+    assert_non_null(path);
+    assert_int_equal(lyd_flat_find_path_compiled(st->flat, path, NULL, NULL, &match), 0);
+    assert_non_null(match);
+    assert_string_equal(lyd_flat_value(st->flat, match), "t");
+    lyd_path_free(path);
+}
+
+static void
+test_fd(void **state)
+{
+    struct state *st = (*state);
+    struct ly_ctx *ctx;
+    char fname[] = "/tmp/libyang-flat-XXXXXX";
+    off_t size;
+    int fd;
+
+    fd = mkstemp(fname);
+    assert_int_not_equal(fd, -1);
+    unlink(fname);
+
+    assert_int_equal(lyd_flat_write_fd(fd, st->dt, LYP_WD_ALL), 0);
+    size = lseek(fd, 0, SEEK_CUR);
+    assert_true(size > 0);
+    st->size = size;
+    st->image = malloc(size);
+    assert_non_null(st->image);
+    assert_int_equal(pread(fd, st->image, size, 0), size);
+    close(fd);
+
+    /* opened in another context with the same modules */
+    ctx = flat_ctx_new();
+    assert_non_null(ctx);
+    st->flat = lyd_flat_open(ctx, st->image, st->size);
+    assert_non_null(st->flat);
+    assert_int_equal(lyd_print_mem(&st->str1, st->dt, LYD_JSON, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_int_equal(lyd_flat_print_mem(&st->str2, st->flat, LYD_JSON, 0), 0);
+    assert_string_equal(st->str1, st->str2);
+    lyd_flat_close(st->flat);
+    st->flat = NULL;
+    ly_ctx_destroy(ctx, NULL);
+
+    /* the modules are missing */
+    ctx = ly_ctx_new(NULL, 0);
+    assert_non_null(ctx);
+    assert_null(lyd_flat_open(ctx, st->image, st->size));
+    ly_ctx_destroy(ctx, NULL);
+
+    /* corrupted image */
+    ((char *)st->image)[0] = 'X';
+    assert_null(lyd_flat_open(st->ctx, st->image, st->size));
+    assert_null(lyd_flat_open(st->ctx, st->image, 8));
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_print, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_navigation, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_find, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_fd, setup_f, teardown_f),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -14,6 +14,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <setjmp.h>
 #include <stdarg.h>
 #include <cmocka.h>
@@ -694,6 +696,201 @@ test_parse_string(void **state)
     assert_ptr_equal(st->dt, NULL);
 }
 
+static void
+test_parse_pinned(void **state)
+{
+    struct state *st;
+    const char *modules[] = {"ietf-interfaces", "ietf-ip", "iana-if-type"};
+    int module_count = 3, fd;
+    char file_name[] = "/tmp/libyang-test-json-XXXXXX";
+    char dup_file_name[2][32] = {"/tmp/libyang-test-json-XXXXXX", "/tmp/libyang-test-json-XXXXXX"};
+    const char *pinned_dup_data[2] = {
+        "{\"pin:l\":[{\"k\":\"a\",\"u\":\"x\"},{\"k\":\"a\",\"u\":\"y\"}]}",
+        "{\"pin:l\":[{\"k\":\"a\",\"u\":\"x\"},{\"k\":\"b\",\"u\":\"x\"}]}"
+    };
+    const LY_VECODE pinned_dup_vecode[2] = {LYVE_DUPLIST, LYVE_NOUNIQ};
+    const char *pinned_schema = "module pin {namespace urn:pin; prefix p;"
+        "list l {key k; unique u; leaf k {type string;} leaf u {type string;}}}";
+    char *printed, *expected;
+    struct lyd_node *dup;
+    struct ly_set *set;
+    int i;
+
+    if (setup_f(&st, TESTS_DIR "/schema/yin/ietf", modules, module_count)) {
+        fail();
+    }
+
+    (*state) = st;
+
+    fd = mkstemp(file_name);
+    assert_int_not_equal(fd, -1);
+    assert_int_equal(write(fd, if_data, strlen(if_data)), strlen(if_data));
+    close(fd);
+
+    st->dt = lyd_parse_mem(st->ctx, if_data, LYD_JSON, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&expected, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    lyd_free_withsiblings(st->dt);
+
+    st->dt = lyd_parse_path(st->ctx, file_name, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_PIN_INPUT);
+    unlink(file_name);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&printed, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    assert_string_equal(printed, expected);
+    free(printed);
+
+    /* values referencing the input are compared by content */
+    set = lyd_find_path(st->dt, "/ietf-interfaces:interfaces/interface[description='iface1 dsc']");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)set->set.d[0]->child->next, "changed"), 0);
+    ly_set_free(set);
+
+    /* the duplicate does not depend on the input */
+    dup = lyd_dup_withsiblings(st->dt, LYD_DUP_OPT_RECURSIVE);
+    assert_ptr_not_equal(dup, NULL);
+    lyd_free_withsiblings(st->dt);
+    st->dt = dup;
+
+    lyd_print_mem(&printed, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    assert_ptr_not_equal(strstr(printed, "\"description\":\"changed\""), NULL);
+    assert_ptr_not_equal(strstr(printed, "\"name\":\"iface1\""), NULL);
+    free(printed);
+    free(expected);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    /* duplicate keys and unique values are detected even if they reference the input */
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, pinned_schema, LYS_IN_YANG), NULL);
+    for (i = 0; i < 2; ++i) {
+        fd = mkstemp(dup_file_name[i]);
+        assert_int_not_equal(fd, -1);
+        assert_int_equal(write(fd, pinned_dup_data[i], strlen(pinned_dup_data[i])), strlen(pinned_dup_data[i]));
+        close(fd);
+
+        st->dt = lyd_parse_path(st->ctx, dup_file_name[i], LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_PIN_INPUT);
+        unlink(dup_file_name[i]);
+        assert_ptr_equal(st->dt, NULL);
+        assert_int_equal(ly_vecode(st->ctx), pinned_dup_vecode[i]);
+    }
+}
+
+static void
+test_parse_stream(void **state)
+{
+    struct state *st;
+    const char *modules[] = {"ietf-interfaces", "ietf-ip", "iana-if-type"};
+    int module_count = 3;
+    size_t chunks[] = {1, 2, 3, 5, 7, 64, 0}, chunk, len, i, j;
+    char *printed, *expected;
+    struct lyd_json_stream *stream;
+    const char *invalid = "{\"ietf-interfaces:interfaces\": {\"interface\": [}";
+
+    if (setup_f(&st, TESTS_DIR "/schema/yin/ietf", modules, module_count)) {
+        fail();
+    }
+
+    (*state) = st;
+
+    st->dt = lyd_parse_mem(st->ctx, if_data, LYD_JSON, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&expected, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    /* the same tree regardless of where the chunks are split */
+    len = strlen(if_data);
+    for (j = 0; j < sizeof chunks / sizeof *chunks; ++j) {
+        chunk = chunks[j] ? chunks[j] : len;
+        stream = lyd_json_stream_new(st->ctx, LYD_OPT_CONFIG);
+        assert_ptr_not_equal(stream, NULL);
+        for (i = 0; i < len; i += chunk) {
+            assert_int_equal(lyd_json_stream_feed(stream, &if_data[i], (len - i < chunk) ? len - i : chunk), 0);
+        }
+        st->dt = lyd_json_stream_finish(stream);
+        assert_ptr_not_equal(st->dt, NULL);
+
+        lyd_print_mem(&printed, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+        assert_string_equal(printed, expected);
+        free(printed);
+        lyd_free_withsiblings(st->dt);
+        st->dt = NULL;
+    }
+    free(expected);
+
+    /* incomplete data */
+    stream = lyd_json_stream_new(st->ctx, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(stream, NULL);
+    assert_int_equal(lyd_json_stream_feed(stream, if_data, len / 2), 0);
+    assert_ptr_equal(lyd_json_stream_finish(stream), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_EOF);
+
+    /* invalid data */
+    stream = lyd_json_stream_new(st->ctx, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(stream, NULL);
+    assert_int_equal(lyd_json_stream_feed(stream, invalid, strlen(invalid)), 1);
+    lyd_json_stream_free(stream);
+}
+
+static void
+test_parse_parallel(void **state)
+{
+    struct state *st;
+    const char *modules[] = {"ietf-interfaces"};
+    int module_count = 1;
+    const char *schema =
+        "module par {namespace urn:par; prefix p;"
+        "  leaf l {type string;}"
+        "  container c {leaf x {type int8;}}"
+        "  list lst {key k; leaf k {type string;} leaf v {type leafref {path /p:l;}}}"
+        "  leaf-list ll {type uint8;}"
+        "  choice ch {leaf a {type string;} leaf b {type string;}}"
+        "}";
+    const char *data =
+        "{\"par:lst\": [{\"k\": \"1\", \"v\": \"x\"}, {\"k\": \"2\"}],"
+        " \"par:ll\": [1, 2], \"par:c\": {\"x\": 1}, \"par:a\": \"a\", \"par:l\": \"x\","
+        " \"ietf-interfaces:interfaces\": {\"interface\": [{\"name\": \"eth0\", \"type\": \"iana-if-type:ethernetCsmacd\"}]}}";
+    char *printed, *expected;
+
+    if (setup_f(&st, TESTS_DIR "/schema/yin/ietf", modules, module_count)) {
+        fail();
+    }
+
+    (*state) = st;
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, schema, LYS_IN_YANG), NULL);
+    assert_ptr_not_equal(ly_ctx_load_module(st->ctx, "iana-if-type", NULL), NULL);
+
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_JSON, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&expected, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    lyd_free_withsiblings(st->dt);
+
+    /* every top-level member is big enough to be parsed separately */
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_PARALLEL);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&printed, st->dt, LYD_JSON, LYP_WITHSIBLINGS);
+    assert_string_equal(printed, expected);
+    free(printed);
+    free(expected);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    /* the checks between the separately parsed members */
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "{\"par:l\": \"x\", \"par:c\": {}, \"par:l\": \"y\"}", LYD_JSON,
+                                   LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_TOOMANY);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "{\"par:a\": \"a\", \"par:l\": \"x\", \"par:b\": \"b\"}", LYD_JSON,
+                                   LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_MCASEDATA);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "{\"par:lst\": [{\"k\": \"1\", \"v\": \"y\"}], \"par:l\": \"x\"}", LYD_JSON,
+                                   LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOLEAFREF);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "{\"par:l\": \"x\", \"par:c\": {\"x\": 1000}}", LYD_JSON,
+                                   LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_INVAL);
+}
+
 int
 main(void)
 {
@@ -702,6 +899,9 @@ main(void)
                     cmocka_unit_test_teardown(test_parse_numbers, teardown_f),
                     cmocka_unit_test_teardown(test_parse_error_numbers, teardown_f),
                     cmocka_unit_test_teardown(test_parse_string, teardown_f),
+                    cmocka_unit_test_teardown(test_parse_pinned, teardown_f),
+                    cmocka_unit_test_teardown(test_parse_stream, teardown_f),
+                    cmocka_unit_test_teardown(test_parse_parallel, teardown_f),
                     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -1777,6 +1777,148 @@ test_parse_noncharacters_xml(void **state)
 
 }
 
+static void
+test_parse_parallel_xml(void **state)
+{
+    struct state *st;
+    const char *mod =
+        "module par {namespace urn:par; prefix p;"
+        "  leaf l {type string;}"
+        "  container c {leaf x {type int8;}}"
+        "  list lst {key k; leaf k {type string;} leaf v {type leafref {path /p:l;}}}"
+        "  choice ch {leaf a {type string;} leaf b {type string;}}"
+        "}";
+    const char *data =
+        "<?xml version=\"1.0\"?>\n"
+        "<lst xmlns=\"urn:par\"><k>1</k><v>x</v></lst>\n"
+        "<!-- comment <with> markup -->\n"
+        "<c xmlns=\"urn:par\"><x>1</x></c>"
+        "<lst xmlns=\"urn:par\" xmlns:q=\"urn:q\" q:attr=\"a>b\"><k>2</k></lst>\n"
+        "<a xmlns=\"urn:par\"><![CDATA[</a>]]></a>\n"
+        "<l xmlns=\"urn:par\">x</l>\n";
+
+    assert_ptr_not_equal(((*state) = st = calloc(1, sizeof *st)), NULL);
+    assert_ptr_not_equal((st->ctx = ly_ctx_new(NULL, 0)), NULL);
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, mod, LYS_IN_YANG), NULL);
+
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&st->str1, st->dt, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_free_withsiblings(st->dt);
+
+    /* every top-level element is big enough to be parsed separately */
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_PARALLEL);
+    assert_ptr_not_equal(st->dt, NULL);
+    lyd_print_mem(&st->str2, st->dt, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(st->str2, st->str1);
+
+    /* the checks between the separately parsed elements */
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "<lst xmlns=\"urn:par\"><k>1</k></lst><l xmlns=\"urn:par\">x</l>"
+                                   "<lst xmlns=\"urn:par\"><k>1</k></lst>", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_DUPLIST);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "<l xmlns=\"urn:par\">x</l><c xmlns=\"urn:par\"/><l xmlns=\"urn:par\">y</l>",
+                                   LYD_XML, LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_TOOMANY);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "<a xmlns=\"urn:par\">a</a><l xmlns=\"urn:par\">x</l><b xmlns=\"urn:par\">b</b>",
+                                   LYD_XML, LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_MCASEDATA);
+
+    /* not well-formed, reported by the sequential parser */
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "<l xmlns=\"urn:par\">x</l><c xmlns=\"urn:par\">", LYD_XML,
+                                   LYD_OPT_CONFIG | LYD_OPT_PARALLEL), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+}
+
+static void
+test_parse_filter(void **state)
+{
+    struct state *st;
+    struct ly_set *filter;
+    const char *mod =
+        "module flt {namespace urn:flt; prefix f;"
+        "  container sys {leaf name {type string;} container clock {leaf tz {type string;} leaf utc {type boolean;}}}"
+        "  list iface {key name; leaf name {type string;} leaf mtu {type uint16;}"
+        "    container stats {leaf in {type uint64;} leaf out {type uint64;}}}"
+        "  leaf other {type string;}"
+        "}";
+    const char *data =
+        "<sys xmlns=\"urn:flt\"><name>host</name><clock><tz>UTC</tz><utc>true</utc></clock></sys>"
+        "<iface xmlns=\"urn:flt\"><name>eth0</name><mtu>1500</mtu><stats><in>10</in><out>20</out></stats></iface>"
+        "<iface xmlns=\"urn:flt\"><name>eth1</name><mtu>9000</mtu><stats><in>30</in><out>40</out></stats></iface>"
+        "<other xmlns=\"urn:flt\">x</other>";
+    const char *filtered =
+        "<sys xmlns=\"urn:flt\"><clock><tz>UTC</tz><utc>true</utc></clock></sys>"
+        "<iface xmlns=\"urn:flt\"><name>eth0</name><stats><in>10</in><out>20</out></stats></iface>"
+        "<iface xmlns=\"urn:flt\"><name>eth1</name><stats><in>30</in><out>40</out></stats></iface>";
+    const char *json_esc =
+        "{\"flt:other\":\"a\\\"b\\\\\","
+        "\"flt:iface\":[{\"name\":\"eth0\\\\\",\"mtu\":1500}],"
+        "\"flt:sys\":{\"name\":\"\\\\\",\"clock\":{\"tz\":\"UTC\"}}}";
+    const char *filtered_esc =
+        "<sys xmlns=\"urn:flt\"><clock><tz>UTC</tz></clock></sys>";
+    LYD_FORMAT formats[] = {LYD_XML, LYD_JSON, LYD_LYB};
+    struct lyd_json_stream *stream;
+    char *printed;
+    unsigned int i, j;
+
+    assert_ptr_not_equal(((*state) = st = calloc(1, sizeof *st)), NULL);
+    assert_ptr_not_equal((st->ctx = ly_ctx_new(NULL, 0)), NULL);
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, mod, LYS_IN_YANG), NULL);
+
+    filter = ly_ctx_find_path(st->ctx, "/flt:sys/flt:clock");
+    assert_ptr_not_equal(filter, NULL);
+    assert_int_equal(ly_set_merge(filter, ly_ctx_find_path(st->ctx, "/flt:iface/flt:stats"), 0), 1);
+
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_GET);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* the same subtrees kept from all the formats */
+    for (i = 0; i < sizeof formats / sizeof *formats; ++i) {
+        assert_int_equal(lyd_print_mem(&st->str1, st->dt, formats[i], LYP_WITHSIBLINGS), 0);
+        st->rpc_act = lyd_parse_mem(st->ctx, st->str1, formats[i], LYD_OPT_GET | LYD_OPT_FILTER, filter);
+        assert_ptr_not_equal(st->rpc_act, NULL);
+        lyd_print_mem(&printed, st->rpc_act, LYD_XML, LYP_WITHSIBLINGS);
+        assert_string_equal(printed, filtered);
+        free(printed);
+        free(st->str1);
+        st->str1 = NULL;
+        lyd_free_withsiblings(st->rpc_act);
+        st->rpc_act = NULL;
+    }
+
+    /* skipped values ending with an escaped backslash, by both JSON parsers */
+    ly_set_free(filter);
+    filter = ly_ctx_find_path(st->ctx, "/flt:sys/flt:clock");
+    assert_ptr_not_equal(filter, NULL);
+    st->rpc_act = lyd_parse_mem(st->ctx, json_esc, LYD_JSON, LYD_OPT_GET | LYD_OPT_FILTER, filter);
+    assert_ptr_not_equal(st->rpc_act, NULL);
+    lyd_print_mem(&printed, st->rpc_act, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(printed, filtered_esc);
+    free(printed);
+    lyd_free_withsiblings(st->rpc_act);
+
+    for (i = 1; i < strlen(json_esc); i *= 3) {
+        stream = lyd_json_stream_new(st->ctx, LYD_OPT_GET | LYD_OPT_FILTER, filter);
+        assert_ptr_not_equal(stream, NULL);
+        for (j = 0; j < strlen(json_esc); j += i) {
+            assert_int_equal(lyd_json_stream_feed(stream, &json_esc[j], (strlen(json_esc) - j < i) ? strlen(json_esc) - j : i), 0);
+        }
+        st->rpc_act = lyd_json_stream_finish(stream);
+        assert_ptr_not_equal(st->rpc_act, NULL);
+        lyd_print_mem(&printed, st->rpc_act, LYD_XML, LYP_WITHSIBLINGS);
+        assert_string_equal(printed, filtered_esc);
+        free(printed);
+        lyd_free_withsiblings(st->rpc_act);
+    }
+    st->rpc_act = NULL;
+
+    /* only with get replies */
+    assert_ptr_equal(lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_FILTER, filter), NULL);
+    assert_int_equal(ly_errno, LY_EINVAL);
+
+    ly_set_free(filter);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -1789,6 +1931,8 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_parse_print_oookeys_xml, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_parse_print_oookeys_json, setup_f, teardown_f),
                     cmocka_unit_test_teardown(test_parse_noncharacters_xml, teardown_f),
+                    cmocka_unit_test_teardown(test_parse_parallel_xml, teardown_f),
+                    cmocka_unit_test_teardown(test_parse_filter, teardown_f),
                     cmocka_unit_test_teardown(test_parse_print_yin_error_prefix, teardown_f),
                     cmocka_unit_test_teardown(test_parse_print_yin_error_contact, teardown_f),
                     cmocka_unit_test_teardown(test_parse_print_yin_error_organization, teardown_f),
@@ -321,6 +321,43 @@ test_canonical(void **state)
     assert_string_equal(st->data, result);
 }
 
+static void
+test_union_types(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *node;
+    const char *yang = "module x {"
+                    "  yang-version 1.1;"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  container x {"
+                    "    leaf-list u { type union {"
+                    "      type empty;"
+                    "      type boolean;"
+                    "      type uint8;"
+                    "      type decimal64 { fraction-digits 2; }"
+                    "      type enumeration { enum one; enum two; }"
+                    "      type string;"
+                    "    } }"
+                    "} }";
+    const char *input = "<x xmlns=\"urn:x\">"
+                    "<u></u><u>true</u><u> 10</u><u>-10</u><u>1.5</u><u>two</u><u>three</u><u>300</u>"
+                    "</x>";
+    LY_DATA_TYPE types[] = {LY_TYPE_EMPTY, LY_TYPE_BOOL, LY_TYPE_UINT8, LY_TYPE_DEC64, LY_TYPE_DEC64, LY_TYPE_ENUM,
+                            LY_TYPE_STRING, LY_TYPE_DEC64};
+    int i = 0;
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang, LYS_IN_YANG), NULL);
+    st->dt = lyd_parse_mem(st->ctx, input, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    LY_TREE_FOR(st->dt->child, node) {
+        assert_int_equal(((struct lyd_node_leaf_list *)node)->value_type, types[i]);
+        ++i;
+    }
+    assert_int_equal(i, 8);
+}
+
 static void
 test_validate_value(void **state)
 {
@@ -515,6 +552,7 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_xmltojson_identityref2, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_xmltojson_instanceid, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_canonical, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_union_types, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_validate_value, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_xmltojson_anydata, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_xmltojson_extension, setup_f, teardown_f),
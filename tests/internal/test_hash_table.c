@@ -15,6 +15,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -129,7 +130,9 @@ static void
 test_resize(void **state)
 {
     int i;
+#ifndef LY_ENABLED_HT_GROUPS
     struct ht_rec *rec;
+#endif
     (void)state;
 
     for (i = 2; i < 8; ++i) {
@@ -138,6 +141,7 @@ test_resize(void **state)
 
     assert_int_equal(ht->size, 16);
 
+#ifndef LY_ENABLED_HT_GROUPS
     for (i = 0; i < 2; ++i) {
         rec = lyht_get_rec(ht->recs, ht->rec_size, i);
         assert_int_equal(rec->hits, 0);
@@ -151,6 +155,7 @@ test_resize(void **state)
         rec = lyht_get_rec(ht->recs, ht->rec_size, i);
         assert_int_equal(rec->hits, 0);
     }
+#endif
 
     for (i = 0; i < 2; ++i) {
         assert_int_equal(lyht_find(ht, &i, i, NULL), 1);
@@ -173,6 +178,8 @@ test_resize(void **state)
     }
 }
 
+#ifndef LY_ENABLED_HT_GROUPS
+
 #define GET_REC_VAL(rec) (*((int *)&(rec)->val))
 
 static void
@@ -310,6 +317,87 @@ test_invalid_move(void **state)
     assert_int_equal(rec->hits, 1);
 }
 
+#else
+
+static void
+test_groups(void **state)
+{
+    int i, a[18];
+    void *match;
+
+    (void)state;
+
+    /* 2 groups */
+    ht = lyht_new(32, sizeof(int), val_equal, NULL, 0);
+    assert_non_null(ht);
+
+    for (i = 0; i < 18; ++i) {
+        a[i] = i;
+    }
+
+    /* fill the whole first group */
+    for (i = 0; i < 16; ++i) {
+        assert_int_equal(lyht_insert(ht, &a[i], i, NULL), 0);
+    }
+    for (i = 0; i < 16; ++i) {
+        assert_int_equal(*(int *)lyht_get_val(ht, i), i);
+    }
+    assert_null(lyht_get_val(ht, 16));
+
+    /* continues in the second group */
+    assert_int_equal(lyht_insert(ht, &a[16], 0, NULL), 0);
+    assert_int_equal(*(int *)lyht_get_val(ht, 16), 16);
+
+    /* the first group is full so the removed record must stay deleted */
+    assert_int_equal(lyht_remove(ht, &a[3], 3), 0);
+    assert_null(lyht_get_val(ht, 3));
+    assert_int_equal(ht->ctrl[3], 0xfe);
+    assert_int_equal(ht->deleted, 1);
+    assert_int_equal(lyht_find(ht, &a[16], 0, NULL), 0);
+
+    /* the deleted record is reused */
+    assert_int_equal(lyht_insert(ht, &a[17], 0, NULL), 0);
+    assert_int_equal(*(int *)lyht_get_val(ht, 3), 17);
+    assert_int_equal(ht->deleted, 0);
+
+    /* equal hashes are returned in probing order */
+    assert_int_equal(lyht_find(ht, &a[0], 0, &match), 0);
+    assert_int_equal(*(int *)match, 0);
+    assert_int_equal(lyht_find_next(ht, match, 0, &match), 0);
+    assert_int_equal(*(int *)match, 17);
+    assert_int_equal(lyht_find_next(ht, match, 0, &match), 0);
+    assert_int_equal(*(int *)match, 16);
+    assert_int_equal(lyht_find_next(ht, match, 0, &match), 1);
+
+    /* the second group has empty records so the removed record is empty again */
+    assert_int_equal(lyht_remove(ht, &a[16], 0), 0);
+    assert_int_equal(ht->ctrl[16], 0x80);
+    assert_int_equal(ht->deleted, 0);
+    assert_int_equal(ht->used, 16);
+
+    /* too many deleted records are dropped */
+    for (i = 0; i < 8; ++i) {
+        assert_int_equal(lyht_remove(ht, &a[i + 4], i + 4), 0);
+    }
+    assert_int_equal(ht->deleted, 8);
+    assert_int_equal(ht->used, 8);
+    for (i = 0; i < 7; ++i) {
+        assert_int_equal(lyht_insert(ht, &a[i], 128 + i, NULL), 0);
+    }
+    assert_int_equal(ht->deleted, 8);
+    assert_int_equal(lyht_insert(ht, &a[7], 128 + 7, NULL), 0);
+    assert_int_equal(ht->deleted, 0);
+    assert_int_equal(ht->used, 16);
+    assert_int_equal(ht->size, 32);
+    for (i = 0; i < 8; ++i) {
+        assert_int_equal(lyht_find(ht, &a[i], 128 + i, NULL), 0);
+    }
+    assert_int_equal(lyht_find(ht, &a[17], 0, NULL), 0);
+    assert_int_equal(lyht_find(ht, &a[4], 4, NULL), 1);
+}
+
+#endif
+
 static void
 test_invalid_move2(void **state)
 {
@@ -353,15 +441,152 @@ test_invalid_move2(void **state)
     assert_int_equal(lyht_find(ht, &a[8 + 3], 3, NULL), 0);
 }
 
+static int
+count_equal_hash(int *val, uint32_t hash)
+{
+    int count = 1;
+    void *match = val;
+
+    while (!lyht_find_next(ht, match, hash, &match)) {
+        assert_int_equal(*(int *)match / 4, hash);
+        ++count;
+    }
+    return count;
+}
+
+static void
+test_incremental(void **state)
+{
+    int i, j, a[1000], migrating = 0;
+    void *match;
+    struct hash_table *dup;
+
+    (void)state;
+
+    lyht_set_incremental(ht, 1);
+
+    /* every 4 values have equal hash */
+    for (i = 0; i < 1000; ++i) {
+        a[i] = i;
+        assert_int_equal(lyht_insert(ht, &a[i], i / 4, NULL), 0);
+        assert_int_equal(lyht_insert(ht, &a[i], i / 4, &match), 1);
+        assert_int_equal(*(int *)match, i);
+
+        if (ht->old) {
+            ++migrating;
+            for (j = 0; j <= i; ++j) {
+                assert_int_equal(lyht_find(ht, &a[j], j / 4, &match), 0);
+                assert_int_equal(*(int *)match, j);
+            }
+            if (i % 4 == 3) {
+                /* all the values with equal hash are returned, whether they were migrated or not */
+                assert_int_equal(count_equal_hash(&a[i - 3], i / 4) + count_equal_hash(&a[i - 2], i / 4)
+                                 + count_equal_hash(&a[i - 1], i / 4) + count_equal_hash(&a[i], i / 4), 10);
+            }
+            if (migrating == 1) {
+                dup = lyht_dup(ht);
+                assert_non_null(dup);
+                assert_int_equal(dup->used, ht->used);
+                assert_int_equal(lyht_finish_resize(dup), 0);
+                assert_null(dup->old);
+                for (j = 0; j <= i; ++j) {
+                    assert_int_equal(lyht_find(dup, &a[j], j / 4, NULL), 0);
+                }
+                lyht_free(dup);
+            }
+        }
+    }
+    assert_int_not_equal(migrating, 0);
+    assert_int_equal(ht->used, 1000);
+
+    j = 1000;
+    assert_int_equal(lyht_find(ht, &j, j / 4, NULL), 1);
+
+    for (i = 0; i < 1000; ++i) {
+        assert_int_equal(lyht_remove(ht, &a[i], i / 4), 0);
+        assert_int_equal(lyht_remove(ht, &a[i], i / 4), 1);
+        if (i % 97 == 0) {
+            for (j = i + 1; j < 1000; ++j) {
+                assert_int_equal(lyht_find(ht, &a[j], j / 4, NULL), 0);
+            }
+        }
+    }
+    assert_int_equal(ht->used, 0);
+    assert_int_equal(lyht_finish_resize(ht), 0);
+    assert_null(ht->old);
+    assert_int_equal(ht->size, LYHT_MIN_SIZE);
+}
+
+static uint32_t
+hash_str(uint32_t (*hash_f)(uint32_t, const char *, size_t), const char *str, size_t len)
+{
+    return hash_f(hash_f(0, str, len), NULL, 0);
+}
+
+static void
+test_hash_functions(void **state)
+{
+    char str[72], buf[80];
+    uint32_t hashes[65], hash;
+    int i, j;
+    (void)state;
+
+    /* LYB depends on these values */
+    hash = dict_hash_stable_multi(0, "ietf-interfaces", 15);
+    hash = dict_hash_stable_multi(hash, "interfaces", 10);
+    assert_int_equal(dict_hash_stable_multi(hash, NULL, 0), 0x45574e00);
+    assert_int_equal(hash_str(dict_hash_stable_multi, "a", 1), 0xca2e9442);
+    assert_int_equal(hash_str(dict_hash_stable_multi, "", 0), 0);
+
+    for (i = 0; i < 72; ++i) {
+        str[i] = 'a' + i % 26;
+    }
+
+    /* all the prefixes (covering every way of reading the tail) hash differently */
+    for (i = 0; i < 65; ++i) {
+        hashes[i] = hash_str(dict_hash_multi, str, i);
+        for (j = 0; j < i; ++j) {
+            assert_int_not_equal(hashes[i], hashes[j]);
+        }
+    }
+
+    /* alignment does not matter */
+    for (i = 1; i < 8; ++i) {
+        memcpy(buf + i, str, 64);
+        for (j = 0; j < 65; ++j) {
+            assert_int_equal(hash_str(dict_hash_multi, buf + i, j), hashes[j]);
+        }
+    }
+
+    /* changing any single byte changes the hash */
+    for (i = 0; i < 40; ++i) {
+        str[i] ^= 0x01;
+        assert_int_not_equal(hash_str(dict_hash_multi, str, 40), hashes[40]);
+        str[i] ^= 0x01;
+    }
+
+    /* hashing several parts, their order matters */
+    hash = dict_hash_multi(0, str, 20);
+    hash = dict_hash_multi(dict_hash_multi(hash, str + 20, 30), NULL, 0);
+    assert_int_equal(dict_hash_multi(dict_hash_multi(dict_hash_multi(0, buf + 7, 20), buf + 27, 30), NULL, 0), hash);
+    assert_int_not_equal(dict_hash_multi(dict_hash_multi(dict_hash_multi(0, str + 20, 30), str, 20), NULL, 0), hash);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_simple, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_half_full, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_resize, setup_f_resize, teardown_f),
+        cmocka_unit_test_setup_teardown(test_incremental, setup_f_resize, teardown_f),
+#ifndef LY_ENABLED_HT_GROUPS
         cmocka_unit_test_setup_teardown(test_collisions, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_invalid_move, setup_f, teardown_f),
+#else
+        cmocka_unit_test_teardown(test_groups, teardown_f),
+#endif
         cmocka_unit_test_setup_teardown(test_invalid_move2, setup_f, teardown_f),
+        cmocka_unit_test(test_hash_functions),
     };
 
     //ly_verb(LY_LLDBG);
@@ -0,0 +1,259 @@
+/**
+ * @file hash_table.c
+ * @brief Microbenchmark of the internal hash table.
+ *
+ * Copyright (c) 2018 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+/*
+ * Inserts, finds (both present and missing values) and removes values in a table of a fixed size
+ * filled to several load factors and prints the average time of one operation. Build libyang
+ * with and without ENABLE_HT_GROUPS to compare the two hash table implementations.
+ *
+ * Then grows a resizing table to the same number of values and empties it again, timing every
+ * operation, and prints the latency percentiles with resizing all at once and incrementally.
+ *
+ * Finally hashes strings of several lengths with dict_hash_multi() (differs with ENABLE_FAST_HASH)
+ * and with dict_hash_stable_multi() used for LYB.
+ *
+ * Usage: bench_hash_table [log2 of the table size] [rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "libyang.h"
+#include "hash_table.h"
+
+static int
+val_equal(void *val1_p, void *val2_p, int mod, void *cb_data)
+{
+    (void)mod;
+    (void)cb_data;
+
+    return *(uint32_t *)val1_p == *(uint32_t *)val2_p;
+}
+
+static uint32_t
+key_hash(uint32_t key)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&key, sizeof key);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int
+cmp_double(const void *d1, const void *d2)
+{
+    double diff = *(const double *)d1 - *(const double *)d2;
+
+    return (diff > 0) - (diff < 0);
+}
+
+static void
+print_latency(const char *op, const char *mode, double *lat, uint32_t count)
+{
+    qsort(lat, count, sizeof *lat, cmp_double);
+    printf("%-7s %-12s %9.0f %9.0f %9.0f %9.0f %11.0f\n", op, mode, lat[count / 2], lat[(uint32_t)(count * 0.99)],
+           lat[(uint32_t)(count * 0.999)], lat[(uint32_t)(count * 0.9999)], lat[count - 1]);
+}
+
+static int
+bench_latency(uint32_t count, const uint32_t *hashes, int incremental, double *lat)
+{
+    struct hash_table *ht;
+    uint32_t i;
+    double start;
+    const char *mode = incremental ? "incremental" : "all at once";
+
+    ht = lyht_new(1, sizeof(uint32_t), val_equal, NULL, 1);
+    if (!ht) {
+        return 1;
+    }
+    lyht_set_incremental(ht, incremental);
+
+    for (i = 0; i < count; ++i) {
+        start = now_ns();
+        if (lyht_insert(ht, &i, hashes[i], NULL)) {
+            fprintf(stderr, "Inserting value %u failed.\n", i);
+            return 1;
+        }
+        lat[i] = now_ns() - start;
+    }
+    print_latency("insert", mode, lat, count);
+
+    for (i = 0; i < count; ++i) {
+        start = now_ns();
+        if (lyht_remove(ht, &i, hashes[i])) {
+            fprintf(stderr, "Removing value %u failed.\n", i);
+            return 1;
+        }
+        lat[i] = now_ns() - start;
+    }
+    print_latency("remove", mode, lat, count);
+
+    lyht_free(ht);
+    return 0;
+}
+
+static double
+bench_hash(uint32_t (*hash_f)(uint32_t, const char *, size_t), const char *str, size_t len, uint32_t count)
+{
+    volatile uint32_t sink;
+    uint32_t i, hash = 0;
+    double start;
+
+    start = now_ns();
+    for (i = 0; i < count; ++i) {
+        /* chain the hashes so that the calls cannot overlap */
+        hash = hash_f(hash_f(hash & 1, str, len), NULL, 0);
+    }
+    sink = hash;
+    (void)sink;
+    return (now_ns() - start) / count;
+}
+
+int
+main(int argc, char **argv)
+{
+    const size_t lens[] = {4, 8, 16, 32, 64, 256};
+    char str[256];
+    const int loads[] = {25, 50, 75, 90};
+    uint32_t size, count, i, *hashes;
+    double *lat;
+    int l, round, rounds, size_exp;
+    size_t j;
+    double insert, find_hit, find_miss, removal, start;
+    struct hash_table *ht;
+
+    size_exp = (argc > 1) ? atoi(argv[1]) : 16;
+    rounds = (argc > 2) ? atoi(argv[2]) : 5;
+    if ((size_exp < 3) || (size_exp > 28) || (rounds < 1)) {
+        fprintf(stderr, "Usage: %s [log2 of the table size (3 - 28)] [rounds]\n", argv[0]);
+        return 1;
+    }
+    size = (uint32_t)1 << size_exp;
+
+    /* hashes of the present values followed by the missing ones */
+    hashes = malloc(2 * size * sizeof *hashes);
+    if (!hashes) {
+        return 1;
+    }
+    for (i = 0; i < 2 * size; ++i) {
+        hashes[i] = key_hash(i);
+    }
+
+#ifdef LY_ENABLED_HT_GROUPS
+# ifdef __SSE2__
+    printf("hash table with groups of control bytes (SSE2)");
+# else
+    printf("hash table with groups of control bytes");
+# endif
+#else
+    printf("hash table with linear probing");
+#endif
+    printf(", %u records, %d rounds, ns per operation\n", size, rounds);
+    printf("%6s %10s %10s %10s %10s\n", "load", "insert", "find hit", "find miss", "remove");
+
+    for (l = 0; l < (signed)(sizeof loads / sizeof *loads); ++l) {
+        count = (uint32_t)(((uint64_t)size * loads[l]) / 100);
+        insert = find_hit = find_miss = removal = 0;
+
+        for (round = 0; round < rounds; ++round) {
+            ht = lyht_new(size, sizeof(uint32_t), val_equal, NULL, 0);
+            if (!ht) {
+                free(hashes);
+                return 1;
+            }
+
+            start = now_ns();
+            for (i = 0; i < count; ++i) {
+                if (lyht_insert(ht, &i, hashes[i], NULL)) {
+                    fprintf(stderr, "Inserting value %u failed.\n", i);
+                    return 1;
+                }
+            }
+            insert += now_ns() - start;
+
+            start = now_ns();
+            for (i = 0; i < count; ++i) {
+                if (lyht_find(ht, &i, hashes[i], NULL)) {
+                    fprintf(stderr, "Value %u not found.\n", i);
+                    return 1;
+                }
+            }
+            find_hit += now_ns() - start;
+
+            start = now_ns();
+            for (i = size; i < size + count; ++i) {
+                if (!lyht_find(ht, &i, hashes[i], NULL)) {
+                    fprintf(stderr, "Value %u found.\n", i);
+                    return 1;
+                }
+            }
+            find_miss += now_ns() - start;
+
+            start = now_ns();
+            for (i = 0; i < count; ++i) {
+                if (lyht_remove(ht, &i, hashes[i])) {
+                    fprintf(stderr, "Removing value %u failed.\n", i);
+                    return 1;
+                }
+            }
+            removal += now_ns() - start;
+
+            lyht_free(ht);
+        }
+
+        printf("%5d%% %10.1f %10.1f %10.1f %10.1f\n", loads[l], insert / rounds / count, find_hit / rounds / count,
+               find_miss / rounds / count, removal / rounds / count);
+    }
+
+
+    /* latency of single operations while the table is resized */
+    lat = malloc(size * sizeof *lat);
+    if (!lat) {
+        free(hashes);
+        return 1;
+    }
+    printf("\nresizing table grown to %u values and emptied, ns per operation\n", size);
+    printf("%-7s %-12s %9s %9s %9s %9s %11s\n", "", "resize", "p50", "p99", "p99.9", "p99.99", "max");
+    if (bench_latency(size, hashes, 0, lat) || bench_latency(size, hashes, 1, lat)) {
+        free(lat);
+        free(hashes);
+        return 1;
+    }
+
+    free(lat);
+    free(hashes);
+
+    /* hashing of single strings */
+    for (j = 0; j < sizeof str; ++j) {
+        str[j] = 'a' + j % 26;
+    }
+    printf("\nhashing a string, ns per hash\n");
+    printf("%6s %10s %10s\n", "length", "default", "stable");
+    for (l = 0; l < (signed)(sizeof lens / sizeof *lens); ++l) {
+        printf("%6zu %10.1f %10.1f\n", lens[l], bench_hash(dict_hash_multi, str, lens[l], size * rounds),
+               bench_hash(dict_hash_stable_multi, str, lens[l], size * rounds));
+    }
+    return 0;
+}